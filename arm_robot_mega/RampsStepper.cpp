@@ -17,9 +17,15 @@ RampsStepper::RampsStepper(int aStepPin, int aDirPin, int aEnablePin, int aLimit
 
     currentStep = 0;
     targetStep = 0;
-    moving = false;
-    stepDelay = 100; // Default delay
-    lastStepTime = 0;
+    plannedStep = 0;
+    // Default: 100 us per langkah tanpa akselerasi, sama dengan perilaku lama
+    maxStepRate = 10000.0;
+    acceleration = 0.0;
+    jerkStepRate = 10000.0;
+    stepPositive = true;
+    stepTowardsLimit = false;
+    limitHit = false;
+    limitTripped = false;
 
     reductionRatio = 1.0; // Default tanpa pengurangan gigi
     stepsPerRevolutionRaw = 200 * 16; // Default untuk motor 1.8 derajat dengan 1/16 microstepping
@@ -37,21 +43,18 @@ void RampsStepper::disable() {
 
 // Menggerakkan motor sejumlah langkah relatif dari posisi saat ini
 void RampsStepper::stepRelative(long steps) {
-    targetStep = currentStep + steps;
-    moving = true;
+    targetStep = getPosition() + steps;
 }
 
 // Menggerakkan motor ke posisi langkah absolut
 void RampsStepper::stepToPosition(long steps) {
     targetStep = steps;
-    moving = true;
 }
 
 // Menggerakkan motor ke posisi sudut absolut (radian)
 void RampsStepper::stepToPositionRad(float rad) {
     // Konversi radian ke langkah menggunakan faktor konversi
-    targetStep = (long)(rad * getRadToStepFactor());
-    moving = true;
+    targetStep = radToSteps(rad);
 }
 
 // Mengatur rasio pengurangan gigi dan langkah per putaran motor mentah
@@ -60,31 +63,53 @@ void RampsStepper::setReductionRatio(float gearRatio, long stepsPerRevRaw) {
     stepsPerRevolutionRaw = stepsPerRevRaw;
 }
 
-// Mengatur delay antar langkah (dalam mikrodetik)
+// Mengatur delay antar langkah (dalam mikrodetik) sebagai kecepatan konstan tanpa akselerasi
 void RampsStepper::setStepDelay(unsigned int delayUs) {
-    stepDelay = delayUs;
+    float rate = 1000000.0 / delayUs;
+    setMotionLimits(rate, 0.0, rate);
 }
 
-// Memeriksa apakah motor sedang bergerak
+// Mengatur batas kecepatan, akselerasi, dan jerk sumbu (dalam langkah motor)
+void RampsStepper::setMotionLimits(float aMaxStepRate, float aAcceleration, float aJerkStepRate) {
+    maxStepRate = aMaxStepRate;
+    acceleration = aAcceleration;
+    // Kecepatan start tidak boleh melebihi kecepatan maksimum
+    jerkStepRate = (aJerkStepRate < aMaxStepRate) ? aJerkStepRate : aMaxStepRate;
+}
+
+// Memeriksa apakah motor sedang bergerak (posisi belum mencapai target)
 bool RampsStepper::isMoving() const {
-    return moving;
+    return !isOnTarget();
 }
 
-// Mengatur posisi langkah internal motor
+// Mengatur posisi langkah internal motor.
+// Hanya boleh dipanggil saat StepEngine tidak sedang mengeksekusi blok.
 void RampsStepper::setPosition(long steps) {
+    noInterrupts();
     currentStep = steps;
+    interrupts();
     targetStep = steps;
-    moving = false;
+    plannedStep = steps;
 }
 
 // Mendapatkan posisi langkah internal motor saat ini
 long RampsStepper::getPosition() const {
-    return currentStep;
+    // currentStep 32-bit diubah oleh ISR, baca secara atomik
+    noInterrupts();
+    long steps = currentStep;
+    interrupts();
+    return steps;
 }
 
 // Memeriksa apakah motor telah mencapai target posisi
 bool RampsStepper::isOnTarget() const {
-    return currentStep == targetStep;
+    return getPosition() == targetStep;
+}
+
+// Samakan target dan posisi terencana dengan posisi aktual
+void RampsStepper::syncTargetToPosition() {
+    targetStep = getPosition();
+    plannedStep = targetStep;
 }
 
 // Mendapatkan faktor konversi dari radian ke langkah
@@ -104,71 +129,40 @@ bool RampsStepper::isLimitActive() const {
     return digitalRead(limitPin) == LOW; // Asumsi limit switch aktif LOW
 }
 
-// Fungsi update utama, dipanggil di loop Arduino
-void RampsStepper::update() {
-    if (!moving) return;
-
-    if (currentStep != targetStep) {
-        unsigned long currentTime = micros();
-        if (currentTime - lastStepTime >= stepDelay) {
-            // Tentukan arah langkah yang diinginkan (apakah target lebih besar atau lebih kecil dari posisi saat ini)
-            bool steppingTowardsPositiveSteps = (targetStep > currentStep);
-
-            // Tentukan keadaan pin arah mentah berdasarkan `dirHighToHome`
-            // `dirHighToHome` TRUE berarti HIGH pada dirPin menggerakkan motor ke arah limit switch.
-            // Asumsi: arah limit switch adalah arah "negatif" untuk homing.
-            // Jadi, jika `dirHighToHome` TRUE, maka HIGH adalah arah negatif. LOW adalah arah positif.
-            // Jika `dirHighToHome` FALSE, maka LOW adalah arah negatif. HIGH adalah arah positif.
-            
-            // Keadaan pin arah fisik yang akan diatur, TANPA mempertimbangkan `reverseDirection` dulu.
-            // Jika kita melangkah ke arah positif langkah:
-            //   Jika `dirHighToHome` TRUE (HIGH = negatif), maka kita butuh LOW untuk positif.
-            //   Jika `dirHighToHome` FALSE (LOW = negatif), maka kita butuh HIGH untuk positif.
-            // Jadi, `rawDirPinState` untuk langkah positif adalah `!dirHighToHome`.
-            bool rawDirPinState;
-            if (steppingTowardsPositiveSteps) {
-                rawDirPinState = !dirHighToHome; 
-            } else { // steppingTowardsNegativeSteps
-                rawDirPinState = dirHighToHome;
-            }
-            
-            // Terapkan `reverseDirection` untuk mendapatkan keadaan pin arah fisik yang sebenarnya
-            bool actualDirPinState = reverseDirection ? !rawDirPinState : rawDirPinState;
-
-            // --- Pengecekan Limit Switch ---
-            // Hanya hentikan pergerakan jika limit switch aktif DAN kita mencoba bergerak menuju limit.
-            // Bergerak menuju limit berarti `actualDirPinState` sama dengan `dirHighToHome`.
-            if (isLimitActive()) {
-                if (actualDirPinState == dirHighToHome) {
-                    Serial.print("WARNING: Limit switch ");
-                    Serial.print(limitPin);
-                    Serial.print(" active for stepper ");
-                    Serial.print(stepPin);
-                    Serial.println(". Stopping movement.");
-                    moving = false;
-                    targetStep = currentStep; // Atur target ke posisi saat ini untuk berhenti
-                    return; // Keluar dari siklus update
-                }
-            }
-
-            // Atur pin arah
-            digitalWrite(dirPin, actualDirPinState); 
-
-            // Lakukan satu langkah
-            digitalWrite(stepPin, HIGH);
-            delayMicroseconds(stepDelay / 2); // Durasi pulsa HIGH
-            digitalWrite(stepPin, LOW);
-            delayMicroseconds(stepDelay / 2); // Durasi pulsa LOW
-
-            // Perbarui posisi saat ini
-            if (targetStep > currentStep) {
-                currentStep++;
-            } else {
-                currentStep--;
-            }
-            lastStepTime = currentTime;
-        }
+// Mengatur pin arah untuk blok berikutnya (dipanggil dari ISR)
+void RampsStepper::setStepDirection(bool positive) {
+    // `dirHighToHome` TRUE berarti HIGH pada dirPin menggerakkan motor ke arah limit switch,
+    // yang dianggap sebagai arah langkah negatif. Jadi pin arah untuk langkah positif
+    // adalah `!dirHighToHome`, lalu dibalik lagi jika `reverseDirection` aktif.
+    bool rawDirPinState = positive ? !dirHighToHome : dirHighToHome;
+    bool actualDirPinState = reverseDirection ? !rawDirPinState : rawDirPinState;
+
+    stepPositive = positive;
+    // Bergerak menuju limit berarti `actualDirPinState` sama dengan `dirHighToHome`.
+    stepTowardsLimit = (actualDirPinState == dirHighToHome);
+    digitalWrite(dirPin, actualDirPinState);
+}
+
+// Mulai satu pulsa langkah (dipanggil dari ISR)
+bool RampsStepper::stepPulseHigh() {
+    // --- Pengecekan Limit Switch ---
+    // Hanya blokir langkah jika limit switch terpicu DAN kita mencoba bergerak menuju limit.
+    if (stepTowardsLimit && limitTripped) {
+        limitHit = true;
+        return false;
+    }
+    digitalWrite(stepPin, HIGH);
+    if (stepPositive) {
+        currentStep++;
     } else {
-        moving = false; // Berhenti bergerak jika sudah di target
+        currentStep--;
     }
+    return true;
+}
+
+// Membaca dan mereset flag limitHit
+bool RampsStepper::consumeLimitHit() {
+    if (!limitHit) return false;
+    limitHit = false;
+    return true;
 }
@@ -9,6 +9,11 @@ public:
   // Konstruktor baru dengan pin limit, arah homing, dan arah terbalik
   RampsStepper(int stepPin, int dirPin, int enablePin, int limitPin, bool dirHighToHome, bool reverseDirection);
   
+  // Pin diakses lewat digitalWrite()/digitalRead(). FastAxis (fastAxis.h) menyembunyikan
+  // enable/disable, isLimitActive, dan fungsi ISR di bawah dengan akses register langsung.
+  // Fungsi ini sengaja tidak virtual: ISR StepEngine memanggil FastAxis lewat tipe konkretnya
+  // (inline, tanpa vcall per sumbu per langkah). Lewat RampsStepper* (Homing, LimitSwitches,
+  // loop) yang terpanggil versi digitalWrite/digitalRead: perilaku sama, hanya lebih lambat.
   void enable(bool flag);
   void disable();
   void stepRelative(long steps); // Menggunakan long untuk langkah
@@ -17,17 +22,39 @@ public:
 
   // Set rasio gearbox dan steps/rev (untuk konversi rad -> steps)
   void setReductionRatio(float gearRatio, long stepsPerRevRaw); // Menggunakan long untuk raw steps
-  void setStepDelay(unsigned int delayUs); // Menggunakan unsigned int untuk delay
+  void setStepDelay(unsigned int delayUs); // Setara setMotionLimits dengan kecepatan maks 1/delayUs
+
+  // Batas gerak sumbu untuk planner (dalam langkah motor):
+  // maxStepRate [langkah/s], acceleration [langkah/s^2],
+  // jerkStepRate [langkah/s] = kecepatan yang boleh dimulai/dihentikan seketika tanpa stall
+  void setMotionLimits(float maxStepRate, float acceleration, float jerkStepRate);
+  float getMaxStepRate() const { return maxStepRate; }
+  float getAcceleration() const { return acceleration; }
+  float getJerkStepRate() const { return jerkStepRate; }
   
   bool isMoving() const; 
   void setPosition(long steps); // Menggunakan long untuk posisi
   long getPosition() const; // Menggunakan long untuk posisi
   bool isOnTarget() const;
 
+  long radToSteps(float rad) const { return (long)(rad * getRadToStepFactor()); }
   float getRadToStepFactor() const; // Getter untuk faktor konversi
   float getStepToRadFactor() const; // Getter untuk faktor konversi
 
-  void update(); // Fungsi update utama, dipanggil di loop
+  // Posisi akhir dari blok terakhir yang sudah diantrikan ke StepEngine
+  long getPlannedPosition() const { return plannedStep; }
+  void setPlannedPosition(long steps) { plannedStep = steps; }
+  long getTargetPosition() const { return targetStep; }
+  void syncTargetToPosition(); // Batalkan sisa target (misal setelah limit switch aktif)
+
+  // === Dipanggil dari ISR StepEngine (tanpa delay, tanpa Serial) ===
+  // Atur pin arah untuk langkah berikutnya. positive = menuju langkah positif.
+  void setStepDirection(bool positive);
+  // Naikkan pin step. Mengembalikan false (tanpa melangkah) jika flag limit terpicu
+  // dan arah gerak menuju limit; flag limitHit kemudian di-set. Pin limit tidak dibaca di sini.
+  bool stepPulseHigh();
+  void stepPulseLow() { digitalWrite(stepPin, LOW); }
+  bool consumeLimitHit(); // Baca dan reset flag limitHit (dipanggil dari loop)
 
   // Getter functions
   int getStepPin() const { return stepPin; }
@@ -36,23 +63,30 @@ public:
   int getLimitPin() const { return limitPin; }
   bool getDirHighToHome() const { return dirHighToHome; }
   bool getReverseDirection() const { return reverseDirection; } // New getter for reverseDirection
-  bool isLimitActive() const; // Fungsi untuk memeriksa status limit switch
+  bool isLimitActive() const; // Level pin limit switch saat ini (tanpa debounce)
+  // Flag terpicu yang dijaga ISR LimitSwitches (limitSwitch.h): di-set saat switch tertekan,
+  // di-reset setelah lepas melewati debounce
+  bool isLimitTripped() const { return limitTripped; }
+  void setLimitTripped(bool tripped) { limitTripped = tripped; }
 
-private:
+protected:
+  // Dipakai juga oleh jalur ISR FastAxis
   int stepPin, dirPin, enablePin, limitPin;
   bool dirHighToHome;
   bool reverseDirection; // New member variable
-  long currentStep, targetStep; 
-  bool moving; // Status apakah motor sedang bergerak
-  unsigned int stepDelay; // Variabel anggota untuk menyimpan nilai step delay
-  unsigned long lastStepTime; // Waktu terakhir langkah diambil
+  volatile long currentStep; // Diperbarui oleh ISR StepEngine
+  bool stepPositive; // Arah blok yang sedang dieksekusi
+  bool stepTowardsLimit; // TRUE jika arah saat ini menuju limit switch
+  volatile bool limitHit; // Di-set ISR saat langkah diblokir limit switch
+  volatile bool limitTripped; // Ditulis ISR limit switch, dibaca ISR step
+
+private:
+  long targetStep; // Target yang diminta (stepToPosition*)
+  long plannedStep; // Target yang sudah diubah menjadi blok langkah
+  float maxStepRate, acceleration, jerkStepRate; // Batas gerak untuk planner
 
   float reductionRatio;
   long stepsPerRevolutionRaw; // Langkah mentah per putaran motor (misal 200 * 16 microsteps)
-  
-  // Fungsi helper untuk melakukan satu langkah, sekarang diimplementasikan di RampsStepper.cpp
-  // dan akan menggunakan logika reverseDirection.
-  // void stepMotor(int pin, bool direction); // Tidak lagi diperlukan sebagai prototipe di sini
 };
 
 #endif
@@ -1,58 +1,90 @@
 // arduino_robot_code.ino
 #include <Arduino.h>
-#include <Stepper.h>
 #include "pinout.h"
 #include "robotGeometry.h" 
 #include "interpolation.h"
 #include "fanControl.h" 
 #include "RampsStepper.h"
-#include "queue.h"
+#include "robotAxes.h"
+#include "stepEngine.h"
+#include "planner.h"
 #include "command.h"
+#include "commandQueue.h"
+#include "binaryFrame.h"
+#include "macro.h"
+#include "gripper.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "limitSwitch.h"
+#include "homing.h"
+#include "calibration.h"
 #include <math.h> 
 
+// Ukuran buffer RX HardwareSerial (ring buffer menyimpan paling banyak SIZE - 1 byte)
+#ifndef SERIAL_RX_BUFFER_SIZE
+#define SERIAL_RX_BUFFER_SIZE 64
+#endif
+
 // === GLOBAL OBJECTS ===
-Stepper gripperStepper(2400, GRIPPER_PIN0, GRIPPER_PIN1, GRIPPER_PIN2, GRIPPER_PIN3);
-// RampsStepper(stepPin, dirPin, enablePin, limitPin, dirHighToHome, reverseDirection)
-// dirHighToHome: TRUE jika HIGH (CW) pada dirPin menggerakkan motor menuju limit switch.
-// reverseDirection: TRUE jika arah fisik motor terbalik dari arah logis yang diinginkan (misalnya, CW motor memutar berlawanan arah dengan definisi positif).
-// PENTING: Konfigurasi ini adalah yang BENAR dan TIDAK BOLEH DIUBAH.
-RampsStepper stepperBase(ROTATE_STEP_PIN, ROTATE_DIR_PIN, ROTATE_ENABLE_PIN, ROTATE_LIMIT_PIN, false, false); // Base (RAMPS Z-Axis)
-RampsStepper stepperShoulder(SHOULDER_STEP_PIN, SHOULDER_DIR_PIN, SHOULDER_ENABLE_PIN, SHOULDER_LIMIT_PIN, true, false); // Shoulder (RAMPS Y-Axis)
-RampsStepper stepperElbow(ELBOW_STEP_PIN, ELBOW_DIR_PIN, ELBOW_ENABLE_PIN, ELBOW_LIMIT_PIN, false, false); // Elbow (RAMPS X-Axis)
-RampsStepper stepperSlider(SLIDER_STEP_PIN, SLIDER_DIR_PIN, SLIDER_ENABLE_PIN, SLIDER_LIMIT_PIN, true, false); // Slider
+Gripper gripper; // Stepper gripper non-blocking (Timer3)
+// Pin dan arah tiap sumbu ditetapkan saat kompilasi di robotAxes.h (FastAxis: akses register
+// langsung di ISR step lewat tipe konkretnya); di luar ISR dipakai sebagai RampsStepper.
+BaseAxis stepperBase; // Base (RAMPS Z-Axis)
+ShoulderAxis stepperShoulder; // Shoulder (RAMPS Y-Axis)
+ElbowAxis stepperElbow; // Elbow (RAMPS X-Axis)
+SliderAxis stepperSlider; // Slider
+StepEngine stepEngine; // Step generator berbasis timer interrupt untuk keempat sumbu
+Planner planner; // Perencana profil kecepatan (akselerasi) untuk blok StepEngine
 FanControl fan(FAN_PIN); 
 RobotGeometry geom; // Objek kinematika
 Interpolation interpolator; // Objek interpolasi
-Queue<Cmd> queue(15); // Antrian perintah G-code (M-code dan G28)
+// Antrian perintah G-code (M-code dan G28) dalam bentuk terpaket (commandQueue.h);
+// produsen dan konsumen sama-sama loop()
+CommandQueue queue;
 Command command; // Parser perintah G-code
-
-// Variabel global untuk step delay (satu sumber kebenatan)
-static const int GLOBAL_STEP_DELAY = 100; // Anda bisa ubah ini ke 500 jika ingin lebih lambat untuk testing
-
-static float radPerMmSlider;
-// Global constants for slider mechanics
-const float pitch_mm_per_rev = 20.0; 
-const float microstep_per_rev = 3200.0; 
-
-// Definisikan posisi home End-Effector yang diinginkan dalam milimeter
-// Ini adalah posisi (X, Y, Z) End-Effector ketika robot dianggap berada di "home"
-// Menggunakan nilai yang Anda inginkan: X 0 Y210 Z235
-const float ROBOT_HOME_X = 0.0; 
-const float ROBOT_HOME_Y = 210.0;  
-const float ROBOT_HOME_Z = 235.0; 
-const float ROBOT_HOME_E = 0.0;  // Slider di posisi 0 mm
+MacroRunner macro; // Makro pick-and-place P1..P3 (macro.h)
+Telemetry telemetry; // Frame telemetri realtime (M155)
+Homing homing; // Homing bersamaan dua tahap (seek cepat, sentuh ulang pelan)
+LimitSwitches limitSwitches; // Limit switch berbasis interrupt pin (flag terpicu per sumbu)
+CalibrationStore calibrationStore; // Kalibrasi dan posisi terakhir di EEPROM (M500/M501/M503)
+CalibrationData calibration; // Kalibrasi aktif; perubahan berlaku lewat applyCalibration()
+// CRC kalibrasi yang terakhir diterapkan, dan apakah posisi sumbu dapat dipercaya (setelah
+// homing atau posisi tersimpan). Posisi hanya disimpan M500 jika keduanya cocok.
+static uint16_t appliedCalibrationCrc = 0;
+static bool positionKnown = false;
+// TRUE selama host mengirim frame biner: echo teks per gerakan G0-G3 dimatikan agar
+// jalur TX tidak menahan loop(). Kembali FALSE begitu host mengirim baris ASCII.
+static bool binaryHost = false;
+
+// Kelompok homing, dijalankan berurutan; sumbu dalam satu kelompok bergerak bersamaan.
+// Shoulder dan Elbow melipat lengan ke posisi home-nya bersama Slider (sumbu linier yang
+// tidak bersinggungan dengan lengan), baru kemudian Base berputar dengan lengan sudah
+// terlipat sehingga sapuannya sekecil mungkin.
+static const uint8_t HOMING_GROUPS[] = {
+  HOMING_SHOULDER | HOMING_ELBOW | HOMING_SLIDER,
+  HOMING_BASE
+};
+
+static float radPerMmSlider; // Dari pitch slider di kalibrasi (applyCalibration)
 
 // === FUNCTION DECLARATIONS (Prototypes) ===
-void homingAll();
-void homeAxis(RampsStepper& stepper); 
-void stepMotor(int pin); // Fungsi helper untuk satu langkah, digunakan internal
+bool homeAndCalibrate(); // Homing semua sumbu, gerakan kalibrasi J0, lalu set posisi home
+void applyCalibration(); // Terapkan `calibration` ke stepper, geometri, dan makro
+void restoreStoredPosition(const StoredPosition &stored); // Start tanpa homing
+void printCalibration(); // M503
 void executeCommand(const Cmd &cmd); // Diubah: tidak lagi menerima posisi Kartesian
-bool handleDebugCommands(const String &line); // Diubah nama dan fungsionalitas
-void parseAndMoveJoint(const String &line); // Pertahankan: untuk kontrol sendi langsung
-void waitForMovement(long timeout_ms = 120000); 
-
-// Prototype for smarter back-off function
-void backOffUntilLimitReleased(RampsStepper& stepper, int maxSteps, int debounceDelayMs);
+bool handleDebugCommands(const char *line); // Diubah nama dan fungsionalitas
+void parseAndMoveJoint(const char *line); // Pertahankan: untuk kontrol sendi langsung
+void waitForMovement(unsigned long timeout_ms = 120000);
+void synchronizeMotion(); // Tunggu semua blok planner selesai dieksekusi
+void sendAck(); // "OK Q<slot antrian kosong> B<byte RX kosong>"
+bool linkCalibrationSupported(const Cmd &cmd); // M665/M666 dalam batas backend IK
+void handleFrame(); // Frame perintah biner (binaryFrame.h)
+// Aksi blok event planner (Planner::bufferAction), dijalankan ISR step generator
+void suctionAction(long on);
+void fanAction(long on);
+void gripperAction(long steps);
+bool planJointMove(float x, float y, float z, float e); // G0: IK sekali, gerak sinkron di ruang sendi
 
 void setup() {
   Serial.begin(115200);
@@ -65,84 +97,63 @@ void setup() {
   digitalWrite(SHOULDER_ENABLE_PIN, HIGH);
   digitalWrite(ELBOW_ENABLE_PIN, HIGH);
   digitalWrite(SLIDER_ENABLE_PIN, HIGH);
-
-  // Set step delay untuk setiap objek stepper
-  stepperBase.setStepDelay(GLOBAL_STEP_DELAY);
-  stepperShoulder.setStepDelay(GLOBAL_STEP_DELAY);
-  stepperElbow.setStepDelay(GLOBAL_STEP_DELAY);
-  stepperSlider.setStepDelay(GLOBAL_STEP_DELAY);
-
-  // Menerapkan rasio gigi yang baru: 10:1 untuk sendi rotasi
-  stepperBase.setReductionRatio(-10.0, 200 * 16); // Base: 10:1, negatif jika arah fisik motor terbalik
-  stepperShoulder.setReductionRatio(10.0, 200 * 16); // Shoulder: 10:1
-  stepperElbow.setReductionRatio(10.0, 200 * 16); // Elbow: 10:1
-  stepperSlider.setReductionRatio(1.0, microstep_per_rev); // Slider: 1:1
-  
-  radPerMmSlider = (2.0 * M_PI) / pitch_mm_per_rev; // Konversi mm ke radian (untuk konsistensi internal RampsStepper)
+  pinMode(SUCTION_PIN, OUTPUT);
+  digitalWrite(SUCTION_PIN, LOW);
+
+  // Set batas kecepatan/akselerasi/jerk untuk setiap objek stepper
+  stepperBase.setMotionLimits(JOINT_MAX_STEP_RATE, JOINT_ACCELERATION, JOINT_JERK_STEP_RATE);
+  stepperShoulder.setMotionLimits(JOINT_MAX_STEP_RATE, JOINT_ACCELERATION, JOINT_JERK_STEP_RATE);
+  stepperElbow.setMotionLimits(JOINT_MAX_STEP_RATE, JOINT_ACCELERATION, JOINT_JERK_STEP_RATE);
+  stepperSlider.setMotionLimits(SLIDER_MAX_STEP_RATE, SLIDER_ACCELERATION, SLIDER_JERK_STEP_RATE);
+
+  // Kalibrasi (rasio gigi, link, offset nol, posisi home, makro) dari EEPROM jika valid,
+  // selain itu nilai default firmware
+  CalibrationStore::defaults(calibration);
+  CalibrationStatus calibrationStatus = calibrationStore.load(calibration);
+  Serial.print("Kalibrasi EEPROM: ");
+  Serial.print(CalibrationStore::statusName(calibrationStatus));
+  Serial.println(calibrationStatus == CALIBRATION_OK ? "" : ", memakai nilai default");
+  applyCalibration();
+
+  // Mulai timer interrupt step generator. Homing di bawah sudah bergerak melalui planner.
+  stepEngine.begin(&stepperBase, &stepperShoulder, &stepperElbow, &stepperSlider);
+  planner.begin(&stepEngine);
+  limitSwitches.begin(&stepEngine); // Interrupt pin limit, sebelum homing
+  homing.begin(&stepEngine, &planner, &limitSwitches);
+  gripper.begin();
+  telemetry.begin(&stepEngine);
+  profileBegin(); // Probe PROFILE_SCOPE (hanya build -DPROFILE=1)
 
   geom.setUseElbowDownSolution(true); // Default IK ke solusi siku ke bawah
 
   // Offset Kartesian global akan diatur ke 0 di sini, karena FK/IK akan menghitung relatif terhadap origin internalnya.
-  // Posisi ROBOT_HOME_X/Y/Z akan menjadi target yang diinginkan dalam sistem koordinat global.
+  // Posisi home kalibrasi (homeX/Y/Z) akan menjadi target yang diinginkan dalam sistem koordinat global.
   geom.setCartesianOffset(0.0, 0.0, 0.0); 
 
-  Serial.println("==== Memulai homing semua sumbu ====");
-  homingAll(); // Melakukan homing untuk setiap sumbu
-  Serial.println("==== Homing selesai. Robot siap menerima perintah ====");
-
-  // --- Mundur dari limit switch setelah homing untuk menghindari kontak terus-menerus ---
-  Serial.println("→ Melakukan back-off dari limit switch...");
-  int backOffMaxSteps = 5000; // Batas langkah pengaman untuk back-off
-  int debounceDelayMs = 50;  // Debounce delay untuk memastikan limit switch benar-benar terlepas
-
-  backOffUntilLimitReleased(stepperBase, backOffMaxSteps, debounceDelayMs);
-  backOffUntilLimitReleased(stepperShoulder, backOffMaxSteps, debounceDelayMs);
-  backOffUntilLimitReleased(stepperElbow, backOffMaxSteps, debounceDelayMs);
-  backOffUntilLimitReleased(stepperSlider, backOffMaxSteps, debounceDelayMs);
-  
-  Serial.println("→ Back-off selesai.");
-
-  // --- LANGKAH KALIBRASI HOME BARU ---
-  // 1. Gerakkan J0 ke -165 derajat dari limit switch home (posisi 0 langkah stepper)
-  Serial.println("→ Melakukan gerakan kalibrasi J0 -165 derajat...");
-  stepperBase.stepToPositionRad(radians(-165.0)); // Gerakkan ke -165 deg dari 0 langkah stepper
-  waitForMovement(); // Tunggu hingga gerakan J0 selesai
-  Serial.println("→ Gerakan kalibrasi J0 selesai.");
+  // Warm restart: posisi yang disimpan M500 dipakai sekali tanpa homing
+  StoredPosition stored;
+  if (calibrationStore.takePosition(stored, CalibrationStore::crc(calibration))) {
+    restoreStoredPosition(stored);
+  } else {
+    Serial.println("==== Memulai homing semua sumbu ====");
+    homeAndCalibrate();
+  }
 
-  // 2. Reset posisi internal stepper ke 0 pada posisi fisik saat ini.
-  // Ini mendefinisikan posisi fisik saat ini sebagai '0' langkah untuk setiap stepper.
-  Serial.println("→ Mengatur ulang posisi internal stepper ke 0 langkah (posisi fisik saat ini).");
-  stepperBase.setPosition(0); 
-  stepperShoulder.setPosition(0);
-  stepperElbow.setPosition(0);
-  stepperSlider.setPosition(0);
-
-  // 3. Set offset nol kinematik.
-  // Offset ini akan memastikan bahwa ketika stepper berada di posisi 0 langkah (yaitu, setelah gerakan J0 -165),
-  // model kinematika akan menginterpretasikan sudut-sudutnya sebagai 90, -14.00, dan -91.77 derajat.
-  // kinematic_angle = physical_angle_from_stepper_zero + kinematic_zero_offset
-  // Karena physical_angle_from_stepper_zero sekarang 0, maka kinematic_zero_offset = desired_kinematic_angle.
-  geom.setKinematicZeroOffsets(
-      radians(90.0),   // Base offset: Ketika stepper Base di 0 langkah, sudut kinematik adalah 90 deg.
-      radians(-14.00), // Shoulder offset: Ketika stepper Shoulder di 0 langkah, sudut kinematik adalah -14.00 deg.
-      radians(-91.77)  // Elbow offset: Ketika stepper Elbow di 0 langkah, sudut kinematik adalah -91.77 deg.
-  );
-
-  // 4. Inisialisasi interpolator ke posisi Kartesian yang diinginkan (ROBOT_HOME_X/Y/Z/E)
-  interpolator.setCurrentPos(ROBOT_HOME_X, ROBOT_HOME_Y, ROBOT_HOME_Z, ROBOT_HOME_E);
-  Serial.print("Initial interpolator position set to desired ROBOT_HOME: [");
+  Serial.print("Initial interpolator position: [");
   Serial.print(interpolator.getX()); Serial.print(", ");
   Serial.print(interpolator.getY()); Serial.print(", ");
   Serial.print(interpolator.getZ()); Serial.print(", ");
   Serial.print(interpolator.getE()); Serial.println("]");
 
   // Debugging: Hitung FK langsung dari sudut kinematik yang diinginkan untuk posisi home target
-  // Ini seharusnya mencetak [ROBOT_HOME_X, ROBOT_HOME_Y, ROBOT_HOME_Z] jika IK dan FK bekerja dengan benar.
-  float debugFKBaseRad = radians(90.0);
-  float debugFKShoulderRad = radians(-14.00);
-  float debugFKElbowRad = radians(-91.77);
-  geom.calculateFK(debugFKBaseRad, debugFKShoulderRad, debugFKElbowRad); // Panggil FK dengan sudut kinematik yang diinginkan
-  float fkX_debug = geom.getFKX() + ROBOT_HOME_E; // Tambahkan kontribusi slider ke X
+  // Ini seharusnya mencetak posisi home kalibrasi jika IK dan FK bekerja dengan benar.
+  // calculateFK menerima sudut dari '0 langkah' stepper dan menambahkan offset nol sendiri,
+  // jadi posisi home (0 langkah) adalah sudut fisik 0; sudut kinematiknya = calibration.zeroDeg.
+  float debugFKBaseRad = radians(calibration.zeroDeg[0]);
+  float debugFKShoulderRad = radians(calibration.zeroDeg[1]);
+  float debugFKElbowRad = radians(calibration.zeroDeg[2]);
+  geom.calculateFK(0.0, 0.0, 0.0);
+  float fkX_debug = geom.getFKX() + calibration.homeE; // Tambahkan kontribusi slider ke X
   float fkY_debug = geom.getFKY();
   float fkZ_debug = geom.getFKZ();
 
@@ -152,27 +163,62 @@ void setup() {
   Serial.print(degrees(debugFKElbowRad), 2); Serial.print("): X="); Serial.print(fkX_debug, 2);
   Serial.print(", Y="); Serial.print(fkY_debug, 2);
   Serial.print(", Z="); Serial.print(fkZ_debug, 2);
-  Serial.print(" (Expected: ["); Serial.print(ROBOT_HOME_X, 2);
-  Serial.print(", "); Serial.print(ROBOT_HOME_Y, 2);
-  Serial.print(", "); Serial.print(ROBOT_HOME_Z, 2);
+  Serial.print(" (Expected: ["); Serial.print(calibration.homeX, 2);
+  Serial.print(", "); Serial.print(calibration.homeY, 2);
+  Serial.print(", "); Serial.print(calibration.homeZ, 2);
   Serial.println("])"); 
 
   Serial.println("Robot siap menerima perintah G-code atau J-code.");
 }
 
 void loop() {
-  if (Serial.available()) {
-    String line = Serial.readStringUntil('\n');
-    line.trim();
-    if (line.length() > 0) {
+  limitSwitches.update(); // Pelepasan switch yang tertunda debounce
+  // Telemetri (jika aktif lewat M155): sampel ke ring buffer, kirim selama TX tidak penuh
+  telemetry.update(queue.size());
+
+  // Rakit baris (atau frame biner) dari byte yang sudah diterima interrupt RX tanpa menunggu sisanya,
+  // sehingga produksi sub-segmen di bawah tetap berjalan selama baris belum lengkap.
+  // Saat antrian penuh baris berikutnya tidak dibaca: byte-nya menunggu di buffer RX dan
+  // ack tertunda sampai ada slot, sehingga perintah tidak pernah ditolak (lihat sendAck()).
+  InputStatus input = queue.isFull() ? INPUT_NONE : command.pollInput();
+  if (input == INPUT_FRAME) {
+    handleFrame();
+  } else if (input == INPUT_LINE_TOO_LONG) {
+    // Baris terpotong tidak pernah dieksekusi. Baris bernomor tidak dapat diperiksa checksum-nya,
+    // jadi diperlakukan seperti checksum salah (nomor baris tidak maju, host mengirim ulang).
+    binaryHost = false;
+    if (Command::hasLineNumber(command.getLine())) {
+      Serial.print("Error: Line too long, Last Line: ");
+      Serial.println(command.getLastLineNumber());
+      Serial.print("Resend: ");
+      Serial.println(command.getLastLineNumber() + 1);
+    } else {
+      Serial.println("Error: Line too long");
+    }
+  } else if (input == INPUT_LINE) {
+    char *line = command.getLine();
+    binaryHost = false;
+    // Normalisasi di tempat: checksum, nomor baris, komentar, huruf besar
+    LineStatus status = command.prepareLine(line);
+    if (status == LINE_CHECKSUM_ERROR || status == LINE_NUMBER_ERROR) {
+      Serial.print(status == LINE_CHECKSUM_ERROR ? "Error: Checksum mismatch, Last Line: "
+                                                 : "Error: Line number is not Last Line Number+1, Last Line: ");
+      Serial.println(command.getLastLineNumber());
+      Serial.print("Resend: ");
+      Serial.println(command.getLastLineNumber() + 1);
+    } else if (status == LINE_HANDLED) {
+      sendAck();
+    } else if (status == LINE_READY) {
       if (handleDebugCommands(line)) { // Menangani perintah debug (POS, J0, J1, J2, J3)
         return; 
       }
-      // Jika bukan perintah debug, coba parsing sebagai G-code (G0, G1, G4, G28, M-code)
+      // Jika bukan perintah debug, coba parsing sebagai G-code (G0-G4, G28, M-code, makro P)
       if (command.handleGcodeLine(line)) {
-          if (!queue.isFull()) {
+          if (!linkCalibrationSupported(command.getCmd())) {
+              Serial.println("Error: Link lengths out of range for the IK backend (M665/M666)");
+          } else if (!queue.isFull()) {
               queue.push(command.getCmd());
-              Serial.println("OK");
+              sendAck();
           } else {
               Serial.println("Error: Command queue is full. Please wait.");
           }
@@ -182,14 +228,23 @@ void loop() {
     }
   }
 
-  // Proses perintah dari antrian
-  if (!queue.isEmpty() && interpolator.isFinished()) { // Hanya proses jika interpolator selesai
-    Cmd cmd = queue.pop();
-    executeCommand(cmd); 
+  // Proses perintah dari antrian. Cukup menunggu interpolator selesai MEMPRODUKSI
+  // sub-segmen (bukan menunggu motor berhenti), sehingga planner dapat menyambung
+  // G0/G1 berikutnya tanpa berhenti.
+  // Langkah makro yang sedang berjalan didahulukan dari perintah antrian berikutnya.
+  if (interpolator.isFinished() && !stepEngine.isBufferFull()) {
+    Cmd cmd;
+    if (macro.next(cmd)) {
+      executeCommand(cmd);
+    } else if (queue.pop(cmd)) {
+      // Rekaman terpaket baru didekode di sini, tepat sebelum dieksekusi
+      executeCommand(cmd);
+    }
   }
 
-  // Jika interpolator sedang berjalan, perbarui posisi dan gerakkan motor
-  if (!interpolator.isFinished()) {
+  // Produksi satu sub-segmen per iterasi selama buffer planner masih ada ruang.
+  // IK berjalan di depan step generator; motor digerakkan oleh ISR.
+  if (!interpolator.isFinished() && !stepEngine.isBufferFull()) {
     interpolator.updateActualPosition();
     float x_interp = interpolator.getX();
     float y_interp = interpolator.getY();
@@ -202,14 +257,9 @@ void loop() {
     // Gunakan Inverse Kinematics untuk mendapatkan sudut sendi dari posisi Kartesian yang diinginkan
     geom.setPositionCartesianOffset(x_ik_target, y_interp, z_interp); // Hanya X,Y,Z
     
-    // Periksa apakah solusi IK valid
-    // Di robotGeometry.cpp, jika solusi tidak ditemukan, nilai NaN akan dihasilkan.
-    // Kita perlu memeriksa ini.
+    // Periksa apakah solusi IK valid: target di luar jangkauan atau batas sendi
+    // menghasilkan NaN (RobotGeometry::getReachStatus() berisi alasannya)
     if (!isnan(geom.getBaseRad()) && !isnan(geom.getShoulderRad()) && !isnan(geom.getElbowRad())) { 
-      float theta1 = geom.getBaseRad();
-      float theta2 = geom.getShoulderRad();
-      float theta3 = geom.getElbowRad();
-
       stepperBase.enable(true);
       stepperShoulder.enable(true);
       stepperElbow.enable(true);
@@ -217,144 +267,179 @@ void loop() {
 
       float slider_rad = e_interp * radPerMmSlider; // Konversi mm slider ke radian untuk stepper
 
-      stepperBase.stepToPositionRad(theta1);
-      stepperShoulder.stepToPositionRad(theta2);
-      stepperElbow.stepToPositionRad(theta3);
-      stepperSlider.stepToPositionRad(slider_rad);
+      long target[STEP_ENGINE_AXES] = {
+        stepperBase.radToSteps(geom.getBaseRad()),
+        stepperShoulder.radToSteps(geom.getShoulderRad()),
+        stepperElbow.radToSteps(geom.getElbowRad()),
+        stepperSlider.radToSteps(slider_rad)
+      };
+      // Durasi minimum sub-segmen dari feedrate (mm/min)
+      planner.bufferMove(target, interpolator.getSegmentDuration());
     } else {
       // Jika IK gagal, hentikan interpolasi dan laporkan error
-      Serial.println("Error: Target Kartesian tidak dapat dijangkau. Menghentikan gerakan.");
+      Serial.print("Alarm: Target Kartesian tidak dapat dijangkau (");
+      Serial.print(RobotGeometry::reachStatusName(geom.getReachStatus()));
+      Serial.println("). Menghentikan gerakan.");
       interpolator.setCurrentPos(x_interp, y_interp, z_interp, e_interp); // Hentikan interpolasi di posisi saat ini
+      macro.abort(); // Sisa langkah makro mengandaikan gerakan ini selesai
     }
   }
   
-  // Update motor terus-menerus di loop untuk pergerakan halus
-  stepperBase.update(); 
-  stepperShoulder.update(); 
-  stepperElbow.update(); 
-  stepperSlider.update(); 
+  // Ubah target sendi terbaru menjadi blok langkah untuk ISR step generator
+  planner.update();
 
   digitalWrite(LED_PIN, (millis() % 500 < 250) ? HIGH : LOW);
 }
 
-void homingAll() {
-  // Urutan homing untuk setiap sumbu
-  homeAxis(stepperBase);
-  Serial.println("→ Homing Base (RAMPS Z-Axis) selesai.");
+// Homing semua sumbu (HOMING_GROUPS), lalu kalibrasi posisi home. Dipakai setup() dan G28.
+// Mengembalikan false jika homing gagal; posisi sumbu kemudian tidak dapat dipercaya.
+bool homeAndCalibrate() {
+  // Kalibrasi yang diubah (M92/M206/M665/M666/M501/M502) berlaku mulai homing ini
+  applyCalibration();
+  positionKnown = false;
+  if (!homing.home(HOMING_GROUPS, sizeof(HOMING_GROUPS))) {
+    Serial.println("ERROR: Homing gagal. Periksa limit switch atau jika robot macet, lalu kirim G28.");
+    homing.report();
+    return false;
+  }
+  Serial.println("==== Homing selesai. Robot siap menerima perintah ====");
+  homing.report();
 
-  homeAxis(stepperShoulder); 
-  Serial.println("→ Homing Shoulder (RAMPS Y-Axis) selesai."); 
+  // --- LANGKAH KALIBRASI HOME ---
+  // 1. Gerakkan J0 ke -165 derajat (kalibrasi) dari limit switch home (posisi 0 langkah stepper)
+  Serial.print("→ Melakukan gerakan kalibrasi J0 "); Serial.print(calibration.j0CalibrationDeg); Serial.println(" derajat...");
+  stepperBase.stepToPositionRad(radians(calibration.j0CalibrationDeg));
+  waitForMovement(); // Tunggu hingga gerakan J0 selesai
+  Serial.println("→ Gerakan kalibrasi J0 selesai.");
 
-  homeAxis(stepperElbow); 
-  Serial.println("→ Homing Elbow (RAMPS X-Axis) selesai."); 
+  // 2. Reset posisi internal stepper ke 0 pada posisi fisik saat ini.
+  // Ini mendefinisikan posisi fisik saat ini sebagai '0' langkah untuk setiap stepper.
+  Serial.println("→ Mengatur ulang posisi internal stepper ke 0 langkah (posisi fisik saat ini).");
+  homing.zeroAxes();
 
-  homeAxis(stepperSlider);
-  Serial.println("→ Homing Slider selesai.");
+  // 3. Offset nol kinematik (calibration.zeroDeg, diterapkan applyCalibration()) memastikan
+  // bahwa ketika stepper berada di posisi 0 langkah (yaitu, setelah gerakan J0 -165), model
+  // kinematika menginterpretasikan sudut-sudutnya sebagai 90, -14.00, dan -91.77 derajat.
+  // kinematic_angle = physical_angle_from_stepper_zero + kinematic_zero_offset
+
+  // 4. Inisialisasi interpolator ke posisi Kartesian home kalibrasi
+  interpolator.setCurrentPos(calibration.homeX, calibration.homeY, calibration.homeZ, calibration.homeE);
+  positionKnown = true;
+  return true;
 }
 
-void homeAxis(RampsStepper& stepper) {
-  // Aktifkan motor sebelum pergerakan homing
-  digitalWrite(stepper.getEnablePin(), LOW); 
-  delay(10); // Memberi waktu driver untuk aktif
-  
-  Serial.print("    Homing stepPin=");
-  Serial.print(stepper.getStepPin()); 
-  Serial.print(" → menunggu limit switch (Pin ");
-  Serial.print(stepper.getLimitPin()); 
-  Serial.print(")... Limit state: ");
-  Serial.println(digitalRead(stepper.getLimitPin()));
-
-  // Jika sudah pada limit switch, gerakkan menjauh dulu untuk memastikan homing dari luar limit
-  if (digitalRead(stepper.getLimitPin()) == LOW) {
-    Serial.println("    [Limit switch sudah aktif. Bergerak menjauh dari limit...]");
-    // Tentukan arah berlawanan untuk menjauh dari limit
-    // Gunakan getReverseDirection() untuk membalik arah pin jika diperlukan
-    digitalWrite(stepper.getDirPin(), stepper.getReverseDirection() ? (stepper.getDirHighToHome() ? HIGH : LOW) : (stepper.getDirHighToHome() ? LOW : HIGH)); 
-    // Gerakkan beberapa langkah kecil atau sampai limit dilepas
-    int backOffStepsInitial = 2000; 
-    for (int i = 0; i < backOffStepsInitial && digitalRead(stepper.getLimitPin()) == LOW; i++) {
-        stepMotor(stepper.getStepPin());
-    }
-    delay(100); // Penundaan untuk memastikan pelepasan mekanis limit
-    if (digitalRead(stepper.getLimitPin()) == LOW) {
-        Serial.println("    WARNING: Tidak dapat bergerak menjauh dari limit switch. Periksa koneksi atau jika robot macet.");
-        // Anda mungkin ingin menambahkan logika error handling di sini
-    } else {
-        Serial.println("    Berhasil bergerak menjauh dari limit switch.");
-    }
+void applyCalibration() {
+  RampsStepper* steppers[CALIBRATION_AXES] = {&stepperBase, &stepperShoulder, &stepperElbow, &stepperSlider};
+  for (uint8_t i = 0; i < CALIBRATION_AXES; i++) {
+    steppers[i]->setReductionRatio(calibration.reductionRatio[i], calibration.stepsPerRev[i]);
   }
-
-  // Sekarang, bergerak ke arah limit switch sampai aktif
-  // Gunakan getReverseDirection() untuk membalik arah pin jika diperlukan
-  digitalWrite(stepper.getDirPin(), stepper.getReverseDirection() ? (stepper.getDirHighToHome() ? LOW : HIGH) : (stepper.getDirHighToHome() ? HIGH : LOW)); 
-  
-  while (digitalRead(stepper.getLimitPin()) != LOW) { // Loop selama limit BELUM aktif (HIGH)
-    stepMotor(stepper.getStepPin()); 
+  radPerMmSlider = (2.0 * M_PI) / calibration.sliderPitch; // Konversi mm ke radian (untuk konsistensi internal RampsStepper)
+  if (!geom.setLinkLengths(calibration.linkL1, calibration.linkL2, calibration.linkL3,
+                           calibration.eeForward, calibration.eeDown)) {
+    // Mis. data EEPROM dari firmware dengan backend IK lain: geometri tetap seperti sebelumnya
+    Serial.println("Alarm: Panjang link kalibrasi di luar batas backend IK, tidak dipakai");
+    calibration.linkL1 = geom.getL1();
+    calibration.linkL2 = geom.getL2();
+    calibration.linkL3 = geom.getL3();
+    calibration.eeForward = geom.getEeForwardMm();
+    calibration.eeDown = geom.getEeDownMm();
   }
-  Serial.println("     [Limit switch aktif]");
-  delay(50); // Debounce delay tambahan setelah limit switch terpicu
-
-  // --- PENTING: Atur ulang posisi internal stepper ke 0 ---
-  // Ini mendefinisikan posisi fisik motor di limit switch sebagai '0' langkah.
-  // Ini adalah titik referensi fisik untuk semua perhitungan langkah berikutnya.
-  stepper.setPosition(0); 
-  Serial.println("    >> Posisi internal stepper diatur ke 0 (Titik Referensi Home Fisik).");
-
-  // Motor tetap diaktifkan sementara selama urutan homing untuk menjaga posisi.
+  geom.setKinematicZeroOffsets(radians(calibration.zeroDeg[0]), radians(calibration.zeroDeg[1]),
+                               radians(calibration.zeroDeg[2]));
+  // Batas sendi di sisi limit switch. Setelah homing switch berada di sudut fisik 0
+  // (Shoulder/Elbow) atau -j0CalibrationDeg (Base, karena gerakan kalibrasi J0). Langkah
+  // negatif menuju switch, jadi sisi batasnya mengikuti tanda rasio gigi. Sisi lain tanpa
+  // switch sehingga tidak dibatasi.
+  float switchRad[GEOMETRY_JOINTS] = {(float)radians(-calibration.j0CalibrationDeg), 0.0, 0.0};
+  for (uint8_t i = 0; i < GEOMETRY_JOINTS; i++) {
+    if (calibration.reductionRatio[i] > 0) geom.setJointLimits(i, switchRad[i], INFINITY);
+    else geom.setJointLimits(i, -INFINITY, switchRad[i]);
+  }
+  macro.getParams() = calibration.macro;
+  appliedCalibrationCrc = CalibrationStore::crc(calibration);
 }
 
-// Fungsi pembantu untuk back-off dari limit switch
-void backOffUntilLimitReleased(RampsStepper& stepper, int maxSteps, int debounceDelayMs) {
-  stepper.enable(true); // Aktifkan motor untuk pergerakan back-off
-  Serial.print("    → Mundur ");
-  // Identifikasi nama sumbu untuk pesan log yang lebih jelas
-  if (stepper.getStepPin() == ROTATE_STEP_PIN) Serial.print("Base");
-  else if (stepper.getStepPin() == SHOULDER_STEP_PIN) Serial.print("Shoulder"); 
-  else if (stepper.getStepPin() == ELBOW_STEP_PIN) Serial.print("Elbow");
-  else if (stepper.getStepPin() == SLIDER_STEP_PIN) Serial.print("Slider");
-  Serial.println(" dari limit switch...");
-
-  // Tentukan arah berlawanan untuk menjauh dari limit
-  // Gunakan getReverseDirection() untuk membalik arah pin jika diperlukan
-  digitalWrite(stepper.getDirPin(), stepper.getReverseDirection() ? (stepper.getDirHighToHome() ? HIGH : LOW) : (stepper.getDirHighToHome() ? LOW : HIGH)); 
-
-  int stepsMoved = 0;
-  // Bergerak menjauh selama limit masih aktif DAN belum mencapai batas langkah maksimum
-  while (stepper.isLimitActive() && stepsMoved < maxSteps) {
-    stepMotor(stepper.getStepPin());
-    stepsMoved++;
-  }
-  delay(debounceDelayMs); // Debounce delay setelah limit dilepas
-
-  if (stepper.isLimitActive()) {
-      Serial.print("    PERINGATAN: ");
-      if (stepper.getStepPin() == ROTATE_STEP_PIN) Serial.print("Base");
-      else if (stepper.getStepPin() == SHOULDER_STEP_PIN) Serial.print("Shoulder"); 
-      else if (stepper.getStepPin() == ELBOW_STEP_PIN) Serial.print("Elbow");
-      else if (stepper.getStepPin() == SLIDER_STEP_PIN) Serial.print("Slider");
-      Serial.println(" tidak dapat bergerak menjauh dari limit switch. Periksa koneksi atau jika robot macet.");
-  } else {
-      Serial.print("    ");
-      if (stepper.getStepPin() == ROTATE_STEP_PIN) Serial.print("Base");
-      else if (stepper.getStepPin() == SHOULDER_STEP_PIN) Serial.print("Shoulder"); 
-      else if (stepper.getStepPin() == ELBOW_STEP_PIN) Serial.print("Elbow");
-      else if (stepper.getStepPin() == SLIDER_STEP_PIN) Serial.print("Slider");
-      Serial.print(" mundur "); Serial.print(stepsMoved); Serial.println(" langkah.");
+void restoreStoredPosition(const StoredPosition &stored) {
+  RampsStepper* steppers[CALIBRATION_AXES] = {&stepperBase, &stepperShoulder, &stepperElbow, &stepperSlider};
+  for (uint8_t i = 0; i < CALIBRATION_AXES; i++) {
+    steppers[i]->enable(true);
+    steppers[i]->setPosition(stored.steps[i]);
   }
+  interpolator.setCurrentPos(stored.x, stored.y, stored.z, stored.e);
+  positionKnown = true;
+  Serial.println("==== Posisi tersimpan (M500) dipakai, homing dilewati. Robot siap menerima perintah ====");
+  Serial.println("    Kirim G28 jika robot sempat digerakkan saat mati.");
 }
 
-void stepMotor(int pin) { 
-  digitalWrite(pin, HIGH);
-  delayMicroseconds(GLOBAL_STEP_DELAY); 
-  digitalWrite(pin, LOW);
-  delayMicroseconds(GLOBAL_STEP_DELAY); 
+void printCalibration() {
+  bool same;
+  CalibrationStatus status = calibrationStore.verify(calibration, same);
+  Serial.print("M503: EEPROM "); Serial.print(CalibrationStore::statusName(status));
+  if (status == CALIBRATION_OK) Serial.print(same ? ", sama dengan nilai aktif" : ", berbeda dari nilai aktif");
+  if (CalibrationStore::crc(calibration) != appliedCalibrationCrc) Serial.print(" (perubahan berlaku setelah G28)");
+  Serial.println();
+  Serial.print("M206 X"); Serial.print(calibration.zeroDeg[0]);
+  Serial.print(" Y"); Serial.print(calibration.zeroDeg[1]);
+  Serial.print(" Z"); Serial.print(calibration.zeroDeg[2]);
+  Serial.print(" E"); Serial.println(calibration.j0CalibrationDeg);
+  Serial.print("M92 X"); Serial.print(calibration.reductionRatio[0]);
+  Serial.print(" Y"); Serial.print(calibration.reductionRatio[1]);
+  Serial.print(" Z"); Serial.print(calibration.reductionRatio[2]);
+  Serial.print(" E"); Serial.println(calibration.sliderPitch);
+  Serial.print("M665 X"); Serial.print(calibration.linkL1);
+  Serial.print(" Y"); Serial.print(calibration.linkL2);
+  Serial.print(" Z"); Serial.println(calibration.linkL3);
+  Serial.print("M666 X"); Serial.print(calibration.eeForward);
+  Serial.print(" Z"); Serial.println(calibration.eeDown);
+  Serial.print("Steps/rev=");
+  for (uint8_t i = 0; i < CALIBRATION_AXES; i++) {
+    if (i > 0) Serial.print("/");
+    Serial.print(calibration.stepsPerRev[i]);
+  }
+  Serial.println();
+  Serial.print("Home X"); Serial.print(calibration.homeX);
+  Serial.print(" Y"); Serial.print(calibration.homeY);
+  Serial.print(" Z"); Serial.print(calibration.homeZ);
+  Serial.print(" E"); Serial.println(calibration.homeE);
 }
 
-// executeCommand sekarang menangani G0, G1, G4, G28, dan M-code
+// executeCommand sekarang menangani G0, G1, G2/G3, G4, G28, M-code, dan makro P
 void executeCommand(const Cmd &cmd) { 
+  // G0/G1, busur G2/G3, dwell G4, dan aksi gripper/suction/fan masuk timeline planner sebagai blok dan
+  // dieksekusi ISR pada urutannya, sehingga loop() tidak menunggu. Perintah lain (homing,
+  // driver) harus terjadi setelah gerakan sebelumnya benar-benar selesai.
+  bool isTimeline = (cmd.id == 'G' && (cmd.num == 0 || cmd.num == 1 || cmd.num == 2 || cmd.num == 3 || cmd.num == 4)) ||
+                    (cmd.id == 'M' && (cmd.num == 3 || cmd.num == 5 || cmd.num == 8 || cmd.num == 9 ||
+                                       cmd.num == 106 || cmd.num == 107));
+  // M910/M930 hanya membaca statistik dan tidak boleh mengosongkan buffer yang sedang diukur;
+  // M155 mengatur telemetri yang justru mengamati gerakan yang sedang berjalan; M870 hanya
+  // menghitung IK, sehingga host dapat menguji titik ambil selama lengan bergerak
+  bool isReport = (cmd.id == 'M' && (cmd.num == 910 || cmd.num == 930 || cmd.num == 155 || cmd.num == 870));
+  // P hanya memulai makro; langkah-langkahnya sendiri yang menunggu bila perlu
+  bool isMacro = (cmd.id == 'P');
+  if (!isTimeline && !isReport && !isMacro) synchronizeMotion();
+
   if (cmd.id == 'G') {
     switch (cmd.num) {
-      case 0: // G0: Rapid move (sama seperti G1 tanpa interpolasi halus)
+      case 0: { // G0: Rapid move di ruang sendi
+        float targetX = isnan(cmd.valueX) ? interpolator.getX() : cmd.valueX;
+        float targetY = isnan(cmd.valueY) ? interpolator.getY() : cmd.valueY;
+        float targetZ = isnan(cmd.valueZ) ? interpolator.getZ() : cmd.valueZ;
+        float targetE = isnan(cmd.valueE) ? interpolator.getE() : cmd.valueE;
+
+        if (!binaryHost) {
+          Serial.print("G0: Joint move to X"); Serial.print(targetX);
+          Serial.print(" Y"); Serial.print(targetY); Serial.print(" Z"); Serial.print(targetZ);
+          Serial.print(" E"); Serial.println(targetE);
+        }
+        if (!planJointMove(targetX, targetY, targetZ, targetE)) {
+          Serial.print("Alarm: Target Kartesian tidak dapat dijangkau (");
+          Serial.print(RobotGeometry::reachStatusName(geom.getReachStatus()));
+          Serial.println("). G0 diabaikan.");
+          macro.abort();
+        }
+        break;
+      }
       case 1: { // G1: Linear move
         float targetX = isnan(cmd.valueX) ? interpolator.getX() : cmd.valueX;
         float targetY = isnan(cmd.valueY) ? interpolator.getY() : cmd.valueY;
@@ -362,64 +447,72 @@ void executeCommand(const Cmd &cmd) {
         float targetE = isnan(cmd.valueE) ? interpolator.getE() : cmd.valueE;
         float feedF  = cmd.valueF; // Kecepatan dalam mm/min
 
-        // Jika feedRate tidak diberikan, gunakan default atau rapid
-        if (feedF == 0.0) feedF = 1000.0; // Default rapid feedrate
-
+        // Jika feedRate tidak diberikan, gunakan default
+        if (isnan(feedF) || feedF <= 0.0) feedF = 1000.0; // Default feedrate
+
+        // Titik akhir di luar jangkauan ditolak sebelum lengan bergerak. Titik di tengah garis
+        // tetap diperiksa per sub-segmen di loop() (garis dapat melewati daerah dekat Base).
+        geom.setPositionCartesianOffset(targetX - targetE, targetY, targetZ);
+        if (geom.getReachStatus() != REACH_OK) {
+          Serial.print("Alarm: Target Kartesian tidak dapat dijangkau (");
+          Serial.print(RobotGeometry::reachStatusName(geom.getReachStatus()));
+          Serial.println("). G1 diabaikan.");
+          macro.abort();
+          break;
+        }
         interpolator.setInterpolation(targetX, targetY, targetZ, targetE, feedF);
-        Serial.print("G"); Serial.print(cmd.num); Serial.print(": Interpolating to X"); Serial.print(targetX);
-        Serial.print(" Y"); Serial.print(targetY); Serial.print(" Z"); Serial.print(targetZ);
-        Serial.print(" E"); Serial.print(targetE); Serial.print(" F"); Serial.println(feedF);
+        if (!binaryHost) {
+          Serial.print("G"); Serial.print(cmd.num); Serial.print(": Interpolating to X"); Serial.print(targetX);
+          Serial.print(" Y"); Serial.print(targetY); Serial.print(" Z"); Serial.print(targetZ);
+          Serial.print(" E"); Serial.print(targetE); Serial.print(" F"); Serial.println(feedF);
+        }
         break;
       }
-      case 28: {
-        stepperBase.enable(true);
-        stepperShoulder.enable(true);
-        stepperElbow.enable(true);
-        stepperSlider.enable(true);
-        Serial.println("<<< G28 → Homing all axes >>>");
-        homingAll();
-        // Setelah homing, lakukan back-off seperti di setup
-        Serial.println("→ Melakukan back-off dari limit switch setelah G28...");
-        int backOffMaxSteps = 5000; 
-        int debounceDelayMs = 50;  
-        backOffUntilLimitReleased(stepperBase, backOffMaxSteps, debounceDelayMs);
-        backOffUntilLimitReleased(stepperShoulder, backOffMaxSteps, debounceDelayMs);
-        backOffUntilLimitReleased(stepperElbow, backOffMaxSteps, debounceDelayMs);
-        backOffUntilLimitReleased(stepperSlider, backOffMaxSteps, debounceDelayMs);
-        Serial.println("→ Back-off setelah G28 selesai.");
-
-        // --- LANGKAH KALIBRASI HOME BARU (Sama seperti di setup()) ---
-        // 1. Gerakkan J0 ke -165 derajat dari limit switch home (posisi 0 langkah stepper)
-        Serial.println("→ Melakukan gerakan kalibrasi J0 -165 derajat...");
-        stepperBase.stepToPositionRad(radians(-165.0)); // Gerakkan ke -165 deg dari 0 langkah stepper
-        waitForMovement(); // Tunggu hingga gerakan J0 selesai
-        Serial.println("→ Gerakan kalibrasi J0 selesai.");
-
-        // 2. Reset posisi internal stepper ke 0 pada posisi fisik saat ini.
-        Serial.println("→ Mengatur ulang posisi internal stepper ke 0 langkah (posisi fisik saat ini).");
-        stepperBase.setPosition(0); 
-        stepperShoulder.setPosition(0);
-        stepperElbow.setPosition(0);
-        stepperSlider.setPosition(0);
-
-        // 3. Set offset nol kinematik.
-        geom.setKinematicZeroOffsets(
-            radians(90.0),   // Base offset: Ketika stepper Base di 0 langkah, sudut kinematik adalah 90 deg.
-            radians(-14.00), // Shoulder offset: Ketika stepper Shoulder di 0 langkah, sudut kinematik adalah -14.00 deg.
-            radians(-91.77)  // Elbow offset: Ketika stepper Elbow di 0 langkah, sudut kinematik adalah -91.77 deg.
-        );
-
-        // 4. Inisialisasi interpolator ke posisi Kartesian yang diinginkan (ROBOT_HOME_X/Y/Z/E)
-        interpolator.setCurrentPos(ROBOT_HOME_X, ROBOT_HOME_Y, ROBOT_HOME_Z, ROBOT_HOME_E);
-        Serial.println("G28: Homing dan kalibrasi posisi selesai.");
+      case 2:
+      case 3: { // G2/G3: busur searah/berlawanan jarum jam di bidang XY, pusat I/J atau jari-jari R
+        float targetX = isnan(cmd.valueX) ? interpolator.getX() : cmd.valueX;
+        float targetY = isnan(cmd.valueY) ? interpolator.getY() : cmd.valueY;
+        float targetZ = isnan(cmd.valueZ) ? interpolator.getZ() : cmd.valueZ;
+        float targetE = isnan(cmd.valueE) ? interpolator.getE() : cmd.valueE;
+        float feedF = cmd.valueF;
+        if (isnan(feedF) || feedF <= 0.0) feedF = 1000.0; // Default feedrate, sama dengan G1
+
+        // Seperti G1: titik akhir diperiksa di sini, titik sepanjang busur per sub-segmen di loop()
+        geom.setPositionCartesianOffset(targetX - targetE, targetY, targetZ);
+        if (geom.getReachStatus() != REACH_OK) {
+          Serial.print("Alarm: Target Kartesian tidak dapat dijangkau (");
+          Serial.print(RobotGeometry::reachStatusName(geom.getReachStatus()));
+          Serial.print("). G"); Serial.print(cmd.num); Serial.println(" diabaikan.");
+          macro.abort();
+          break;
+        }
+        ArcStatus arcStatus = interpolator.setArc(targetX, targetY, targetZ, targetE,
+                                                  cmd.valueI, cmd.valueJ, cmd.valueR, cmd.num == 2, feedF);
+        if (arcStatus != ARC_OK) {
+          Serial.print("Alarm: Busur tidak valid (");
+          Serial.print(Interpolation::arcStatusName(arcStatus));
+          Serial.print("). G"); Serial.print(cmd.num); Serial.println(" diabaikan.");
+          macro.abort();
+          break;
+        }
+        if (!binaryHost) {
+          Serial.print("G"); Serial.print(cmd.num); Serial.print(": Arc to X"); Serial.print(targetX);
+          Serial.print(" Y"); Serial.print(targetY); Serial.print(" Z"); Serial.print(targetZ);
+          Serial.print(" E"); Serial.print(targetE); Serial.print(" F"); Serial.println(feedF);
+        }
         break;
       }
-      case 4: {
-        int t_ms = (int)(cmd.valueT * 1000.0);
+      case 28:
+        Serial.println("<<< G28 → Homing all axes >>>");
+        if (homeAndCalibrate()) Serial.println("G28: Homing dan kalibrasi posisi selesai.");
+        break;
+      case 4: { // Dwell: lengan berhenti, tetapi loop() tetap membaca Serial dan mengisi antrian
+        float seconds = isnan(cmd.valueT) ? 0.0 : cmd.valueT;
         Serial.print("G4: Dwell ");
-        Serial.print(t_ms);
+        Serial.print((int)(seconds * 1000.0));
         Serial.println(" ms");
-        delay(t_ms); // Menambahkan delay aktual
+        // Pemanggil (loop) sudah memastikan buffer tidak penuh
+        planner.bufferDwell(seconds);
         break;
       }
       default:
@@ -430,24 +523,22 @@ void executeCommand(const Cmd &cmd) {
   }
   else if (cmd.id == 'M') {
     switch (cmd.num) {
-      case 3: {
-        Serial.println("M3: Gripper ON");
-        gripperStepper.setSpeed(200); 
-        gripperStepper.step((int)cmd.valueT);
-        break;
-      }
+      // Gripper mulai bergerak saat gerakan sebelumnya selesai dan berjalan bersamaan
+      // dengan gerakan berikutnya. Untuk menutup sambil turun, pecah gerakan turun:
+      // G1 hampir ke bawah, M3, lalu G1 sisanya.
+      case 3:
       case 5: {
-        Serial.println("M5: Gripper OFF");
-        gripperStepper.setSpeed(200); 
-        gripperStepper.step(-((int)cmd.valueT));
+        long steps = isnan(cmd.valueT) ? GRIPPER_DEFAULT_STEPS : (long)cmd.valueT;
+        Serial.println(cmd.num == 3 ? "M3: Gripper ON" : "M5: Gripper OFF");
+        planner.bufferAction(gripperAction, cmd.num == 3 ? steps : -steps);
         break;
       }
       case 8:
-        digitalWrite(SUCTION_PIN, HIGH);
+        planner.bufferAction(suctionAction, 1);
         Serial.println("M8: Suction ACTIVE");
         break;
       case 9:
-        digitalWrite(SUCTION_PIN, LOW);
+        planner.bufferAction(suctionAction, 0);
         Serial.println("M9: Suction INACTIVE");
         break;
       case 17:
@@ -463,14 +554,137 @@ void executeCommand(const Cmd &cmd) {
         stepperShoulder.disable();
         stepperElbow.disable();
         stepperSlider.disable();
+        homing.clearReference(); // Posisi dapat bergeser selama driver mati
+        positionKnown = false;
+        break;
+      // Kalibrasi: M92/M206/M665/M666 mengubah nilai aktif, berlaku pada G28 berikutnya; M500 menyimpan
+      // ke EEPROM (beserta posisi saat ini untuk start tanpa homing), M501 membaca ulang,
+      // M502 kembali ke default firmware, M503 mencetak nilai aktif dan memeriksa EEPROM.
+      case 92: // Rasio gigi Base/Shoulder/Elbow (X/Y/Z), pitch slider mm/putaran (E)
+        if (!isnan(cmd.valueX)) calibration.reductionRatio[0] = cmd.valueX;
+        if (!isnan(cmd.valueY)) calibration.reductionRatio[1] = cmd.valueY;
+        if (!isnan(cmd.valueZ)) calibration.reductionRatio[2] = cmd.valueZ;
+        if (!isnan(cmd.valueE) && cmd.valueE > 0.0) calibration.sliderPitch = cmd.valueE;
+        Serial.println("M92: OK, berlaku setelah G28");
+        break;
+      case 206: // Sudut nol kinematik Base/Shoulder/Elbow (X/Y/Z), gerakan kalibrasi J0 (E), derajat
+        if (!isnan(cmd.valueX)) calibration.zeroDeg[0] = cmd.valueX;
+        if (!isnan(cmd.valueY)) calibration.zeroDeg[1] = cmd.valueY;
+        if (!isnan(cmd.valueZ)) calibration.zeroDeg[2] = cmd.valueZ;
+        if (!isnan(cmd.valueE)) calibration.j0CalibrationDeg = cmd.valueE;
+        Serial.println("M206: OK, berlaku setelah G28");
+        break;
+      case 665: // Panjang link L1/L2/L3 (X/Y/Z), mm; satu firmware untuk beberapa varian lengan
+        // Diperiksa lagi di sini: M665/M666 lain di antrian dapat mengubah kalibrasi setelah
+        // baris ini diterima
+        if (!linkCalibrationSupported(cmd)) {
+          Serial.println("Alarm: M665 di luar batas backend IK, diabaikan");
+          break;
+        }
+        if (!isnan(cmd.valueX)) calibration.linkL1 = cmd.valueX;
+        if (!isnan(cmd.valueY)) calibration.linkL2 = cmd.valueY;
+        if (!isnan(cmd.valueZ)) calibration.linkL3 = cmd.valueZ;
+        Serial.println("M665: OK, berlaku setelah G28");
         break;
+      case 666: // Offset end-effector dari wrist: ke depan (X) dan ke bawah (Z), mm
+        if (!linkCalibrationSupported(cmd)) {
+          Serial.println("Alarm: M666 di luar batas backend IK, diabaikan");
+          break;
+        }
+        if (!isnan(cmd.valueX)) calibration.eeForward = cmd.valueX;
+        if (!isnan(cmd.valueZ)) calibration.eeDown = cmd.valueZ;
+        Serial.println("M666: OK, berlaku setelah G28");
+        break;
+      case 500:
+        calibrationStore.save(calibration);
+        if (positionKnown && CalibrationStore::crc(calibration) == appliedCalibrationCrc) {
+          StoredPosition stored;
+          stored.steps[0] = stepperBase.getPosition();
+          stored.steps[1] = stepperShoulder.getPosition();
+          stored.steps[2] = stepperElbow.getPosition();
+          stored.steps[3] = stepperSlider.getPosition();
+          stored.x = interpolator.getX();
+          stored.y = interpolator.getY();
+          stored.z = interpolator.getZ();
+          stored.e = interpolator.getE();
+          stored.calibrationCrc = appliedCalibrationCrc;
+          calibrationStore.savePosition(stored);
+          Serial.println("M500: Kalibrasi dan posisi disimpan");
+        } else {
+          Serial.println("M500: Kalibrasi disimpan (posisi tidak disimpan, jalankan G28 dulu)");
+        }
+        break;
+      case 501: {
+        CalibrationStatus status = calibrationStore.load(calibration);
+        Serial.print("M501: EEPROM "); Serial.print(CalibrationStore::statusName(status));
+        Serial.println(status == CALIBRATION_OK ? ", berlaku setelah G28" : ", nilai aktif tidak diubah");
+        break;
+      }
+      case 502:
+        CalibrationStore::defaults(calibration);
+        Serial.println("M502: Default firmware, berlaku setelah G28 (M500 untuk menyimpan)");
+        break;
+      case 503:
+        printCalibration();
+        break;
+      case 870: { // Uji jangkauan tanpa gerak: M870 X Y Z [E], nilai yang tidak ada = posisi saat ini
+        float x = isnan(cmd.valueX) ? interpolator.getX() : cmd.valueX;
+        float y = isnan(cmd.valueY) ? interpolator.getY() : cmd.valueY;
+        float z = isnan(cmd.valueZ) ? interpolator.getZ() : cmd.valueZ;
+        float e = isnan(cmd.valueE) ? interpolator.getE() : cmd.valueE;
+        geom.setPositionCartesianOffset(x - e, y, z);
+        Serial.print("M870: "); Serial.print(RobotGeometry::reachStatusName(geom.getReachStatus()));
+        Serial.print(" X"); Serial.print(x); Serial.print(" Y"); Serial.print(y);
+        Serial.print(" Z"); Serial.print(z); Serial.print(" E"); Serial.print(e);
+        if (geom.getReachStatus() == REACH_OK) {
+          // Sudut sendi dari '0 langkah' stepper, derajat
+          Serial.print(" A"); Serial.print(degrees(geom.getBaseRad()));
+          Serial.print(" B"); Serial.print(degrees(geom.getShoulderRad()));
+          Serial.print(" C"); Serial.print(degrees(geom.getElbowRad()));
+        }
+        Serial.println();
+        break;
+      }
       case 106:
         Serial.println("M106: Fan ON");
-        fan.enable(true);
+        planner.bufferAction(fanAction, 1);
         break;
       case 107:
         Serial.println("M107: Fan OFF");
-        fan.enable(false);
+        planner.bufferAction(fanAction, 0);
+        break;
+      case 155: { // Telemetri: M155 T<interval detik>, T0 = mati
+        float seconds = isnan(cmd.valueT) ? 0.0 : cmd.valueT;
+        telemetry.setInterval(seconds > 0.0 ? (unsigned long)(seconds * 1000000.0) : 0);
+        if (telemetry.isEnabled()) {
+          Serial.print("M155: Telemetry every ");
+          Serial.print(telemetry.getInterval() / 1000.0, 1);
+          Serial.println(" ms");
+        } else {
+          Serial.println("M155: Telemetry OFF");
+        }
+        break;
+      }
+      case 910: { // Laporkan statistik pipeline sejak M910 terakhir, lalu reset
+        StepEngineStats stats;
+        stepEngine.getStats(stats);
+        stepEngine.resetStats();
+        Serial.print("M910: Blocks="); Serial.print(stats.blocksExecuted);
+        Serial.print(" Underruns="); Serial.print(stats.underruns);
+        Serial.print(" Depth min/avg/max=");
+        if (stats.blocksExecuted > 0) {
+          Serial.print(stats.minDepth); Serial.print("/");
+          Serial.print((float)stats.depthSum / stats.blocksExecuted, 1); Serial.print("/");
+          Serial.print(stats.maxDepth);
+        } else {
+          Serial.print("-/-/-");
+        }
+        Serial.print(" Buffered="); Serial.print(stepEngine.bufferedBlocks());
+        Serial.print("/"); Serial.println(STEP_ENGINE_BUFFER_SIZE - 1);
+        break;
+      }
+      case 930: // Statistik probe profiling sejak M930 terakhir, lalu reset
+        profileReport();
         break;
       default:
         Serial.print("Unknown M-code: M");
@@ -478,9 +692,17 @@ void executeCommand(const Cmd &cmd) {
         break;
     }
   }
+  else if (cmd.id == 'P') { // Makro pick-and-place: P<wadah> [X<x>] [Y<y>]
+    if (macro.start(cmd)) {
+      Serial.print("P"); Serial.print(cmd.num); Serial.println(": Pick and place");
+    } else {
+      Serial.print("Alarm: Unknown macro: P");
+      Serial.println(cmd.num);
+    }
+  }
 }
 
-void waitForMovement(long timeout_ms) {
+void waitForMovement(unsigned long timeout_ms) {
     Serial.print("    Waiting for movement to finish (timeout: ");
     Serial.print(timeout_ms);
     Serial.println(" ms)...");
@@ -489,11 +711,7 @@ void waitForMovement(long timeout_ms) {
             stepperElbow.isMoving() || stepperSlider.isMoving()) &&
            (millis() - start_time < timeout_ms))
     {
-        stepperBase.update();
-        stepperShoulder.update();
-        stepperElbow.update();
-        stepperSlider.update();
-        delayMicroseconds(50); 
+        planner.update();
     }
     if (millis() - start_time >= timeout_ms) {
         Serial.println("    Movement timed out!");
@@ -502,10 +720,112 @@ void waitForMovement(long timeout_ms) {
     }
 }
 
+// G0: selesaikan IK hanya sekali di titik akhir, lalu antrikan satu blok sendi.
+// Karena satu blok Bresenham menggerakkan semua sumbu, semuanya tiba bersamaan,
+// dan kecepatannya hanya dibatasi batas sumbu (tanpa feedrate dan tanpa IK per tick).
+// Lintasan Kartesian di antara kedua titik tidak lurus.
+bool planJointMove(float x, float y, float z, float e) {
+    geom.setPositionCartesianOffset(x - e, y, z); // Target X untuk IK dikurangi posisi slider
+    if (isnan(geom.getBaseRad()) || isnan(geom.getShoulderRad()) || isnan(geom.getElbowRad())) {
+        return false;
+    }
+
+    stepperBase.enable(true);
+    stepperShoulder.enable(true);
+    stepperElbow.enable(true);
+    stepperSlider.enable(true);
+
+    long target[STEP_ENGINE_AXES] = {
+        stepperBase.radToSteps(geom.getBaseRad()),
+        stepperShoulder.radToSteps(geom.getShoulderRad()),
+        stepperElbow.radToSteps(geom.getElbowRad()),
+        stepperSlider.radToSteps(e * radPerMmSlider)
+    };
+    // Pemanggil (loop) sudah memastikan buffer tidak penuh
+    planner.bufferMove(target);
+    interpolator.setCurrentPos(x, y, z, e);
+    return true;
+}
+
+// Aksi blok event: dijalankan di dalam ISR step generator tepat setelah blok gerak
+// sebelumnya selesai, jadi hanya boleh menulis pin atau memberi target baru.
+void suctionAction(long on) {
+    digitalWrite(SUCTION_PIN, on ? HIGH : LOW);
+}
+
+void fanAction(long on) {
+    fan.enable(on != 0);
+}
+
+void gripperAction(long steps) {
+    gripper.move(steps);
+}
+
+void synchronizeMotion() {
+    while (stepEngine.isBusy()) {
+        planner.update();
+        telemetry.update(queue.size());
+        yield(); // Hook Arduino untuk busy-wait (juga memajukan jam virtual di simulasi host)
+    }
+}
+
+// Ack untuk flow control host: setiap ack membawa jumlah slot antrian perintah yang masih
+// kosong (Q) dan byte buffer RX Serial yang masih kosong (B). Host menghitung byte baris
+// yang belum di-ack dan boleh terus mengirim selama totalnya muat di buffer RX; baris yang
+// menunggu di buffer langsung dibaca begitu antrian punya slot, tanpa menunggu round-trip
+// (lihat python/gcode_sender.py).
+// Setiap baris G/M/P dijawab tepat satu kali, saat dibaca: "OK ..." atau, jika ditolak,
+// "Error: ..." (Unknown command, Link lengths out of range, Line too long; Checksum/Line number/Line too long bernomor
+// diikuti "Resend"). Error yang baru muncul saat perintah dieksekusi (target tidak terjangkau,
+// busur tidak valid, makro tidak dikenal) memakai awalan "Alarm:": baris itu sudah di-ack dan
+// byte-nya sudah dibebaskan, jadi host tidak boleh menganggapnya jawaban baris.
+void sendAck() {
+    Serial.print("OK Q");
+    Serial.print(queue.freeSlots());
+    Serial.print(" B");
+    Serial.println(SERIAL_RX_BUFFER_SIZE - 1 - Serial.available());
+}
+
+// Nilai M665/M666 digabung dengan kalibrasi saat ini harus dapat dipakai backend IK
+// (RobotGeometry::linkLengthsSupported); perintah lain selalu lolos.
+bool linkCalibrationSupported(const Cmd &cmd) {
+    if (cmd.id != 'M' || (cmd.num != 665 && cmd.num != 666)) return true;
+    float l1 = calibration.linkL1, l2 = calibration.linkL2, l3 = calibration.linkL3;
+    float eeForward = calibration.eeForward, eeDown = calibration.eeDown;
+    if (cmd.num == 665) {
+        if (!isnan(cmd.valueX)) l1 = cmd.valueX;
+        if (!isnan(cmd.valueY)) l2 = cmd.valueY;
+        if (!isnan(cmd.valueZ)) l3 = cmd.valueZ;
+    } else {
+        if (!isnan(cmd.valueX)) eeForward = cmd.valueX;
+        if (!isnan(cmd.valueZ)) eeDown = cmd.valueZ;
+    }
+    return RobotGeometry::linkLengthsSupported(l1, l2, l3, eeForward, eeDown);
+}
+
+// Frame biner dijawab dengan frame balasan 7 byte berisi Q dan B yang sama dengan sendAck().
+// Frame hanya dibaca saat antrian punya slot, jadi frame yang valid selalu masuk antrian
+// (kecuali FRAME_REJECTED, lihat linkCalibrationSupported()).
+// Setelah error, host mengirim ulang mulai dari seq di balasan (go-back-N).
+void handleFrame() {
+    FrameStatus status = command.decodeFrame();
+    if (status == FRAME_IGNORED) return;
+    if (status == FRAME_OK) {
+        binaryHost = true;
+        Cmd cmd = command.getCmd();
+        if (!linkCalibrationSupported(cmd)) status = FRAME_REJECTED;
+        else if (cmd.id != FRAME_ID_SYNC) queue.push(cmd);
+    }
+    writeFrameReply(command.getFrameSeq(), status, queue.freeSlots(), SERIAL_RX_BUFFER_SIZE - 1 - Serial.available());
+}
+
 // Fungsi untuk Joint Space Control (gerakan langsung per sendi)
-void parseAndMoveJoint(const String &line) {
-    char jointChar = line.charAt(1); // J0, J1, J2, J3
-    float targetValue = line.substring(2).toFloat(); // Ini adalah sudut kinematik yang diinginkan (dalam derajat)
+void parseAndMoveJoint(const char *line) {
+    char jointChar = line[1]; // J0, J1, J2, J3
+    const char *valueText = line + 2;
+    while (*valueText == ' ') valueText++;
+    float targetValue = 0.0; // Ini adalah sudut kinematik yang diinginkan (dalam derajat)
+    Command::parseNumber(valueText, targetValue);
 
     Serial.print("JOINT_DEBUG >> Moving J");
     Serial.print(jointChar);
@@ -557,11 +877,10 @@ void parseAndMoveJoint(const String &line) {
 
     if (currentStepper) {
         currentStepper->enable(true); // Pastikan motor aktif untuk pergerakan
-        long single_axis_timeout_ms = 120000; // Timeout default yang cukup besar
+        unsigned long single_axis_timeout_ms = 120000; // Timeout default yang cukup besar
         unsigned long start_time_joint = millis();
         while (currentStepper->isMoving() && (millis() - start_time_joint < single_axis_timeout_ms)) {
-            currentStepper->update();
-            delayMicroseconds(50); 
+            planner.update();
         }
         if (millis() - start_time_joint >= single_axis_timeout_ms) {
             Serial.println("    Joint Movement timed out!");
@@ -572,11 +891,9 @@ void parseAndMoveJoint(const String &line) {
 }
 
 // handleDebugCommands sekarang menangani perintah POS dan J-code
-bool handleDebugCommands(const String &line) {
-    String cmd = line;
-    cmd.toUpperCase();
-
-    if (cmd.equalsIgnoreCase("POS")) {
+// (baris sudah dinormalisasi oleh Command::prepareLine: huruf besar, tanpa komentar)
+bool handleDebugCommands(const char *line) {
+    if (strcmp(line, "POS") == 0) {
         // Dapatkan posisi langkah motor saat ini
         long base_steps = stepperBase.getPosition();
         long shoulder_steps = stepperShoulder.getPosition();
@@ -587,7 +904,7 @@ bool handleDebugCommands(const String &line) {
         float base_rad_physical = base_steps / stepperBase.getRadToStepFactor();
         float shoulder_rad_physical = shoulder_steps / stepperShoulder.getRadToStepFactor();
         float elbow_rad_physical = elbow_steps / stepperElbow.getRadToStepFactor();
-        float slider_mm = slider_steps * (pitch_mm_per_rev / microstep_per_rev);
+        float slider_mm = slider_steps * (calibration.sliderPitch / calibration.stepsPerRev[3]);
 
         // Hitung posisi Kartesian menggunakan Forward Kinematics
         // calculateFK sudah memperhitungkan kinematicZeroOffsets secara internal
@@ -639,27 +956,17 @@ bool handleDebugCommands(const String &line) {
     }
 
     // DEBUG FUNCTION: Move physical motors directly (Joint Space Control)
-    if (cmd.startsWith("J0") || cmd.startsWith("J1") || cmd.startsWith("J2") || cmd.startsWith("J3")) {
+    if (line[0] == 'J' && line[1] >= '0' && line[1] <= '3') {
         parseAndMoveJoint(line);
         return true;
     }
 
     // Untuk GOTO (IK)
-    if (cmd.startsWith("GOTO")) {
-        // Ekstrak X, Y, Z, E dari perintah GOTO
-        float targetX = NAN, targetY = NAN, targetZ = NAN, targetE = NAN;
-        String temp = line;
-        temp.toUpperCase();
-
-        int idxX = temp.indexOf('X');
-        int idxY = temp.indexOf('Y');
-        int idxZ = temp.indexOf('Z');
-        int idxE = temp.indexOf('E');
-
-        if (idxX >= 0) targetX = temp.substring(idxX + 1).toFloat();
-        if (idxY >= 0) targetY = temp.substring(idxY + 1).toFloat();
-        if (idxZ >= 0) targetZ = temp.substring(idxZ + 1).toFloat();
-        if (idxE >= 0) targetE = temp.substring(idxE + 1).toFloat();
+    if (strncmp(line, "GOTO", 4) == 0) {
+        // Ekstrak X, Y, Z, E dari perintah GOTO (nilai yang tidak ada tetap NAN)
+        Cmd args;
+        Command::parseArguments(line + 4, args);
+        float targetX = args.valueX, targetY = args.valueY, targetZ = args.valueZ, targetE = args.valueE;
 
         // Jika ada nilai yang tidak diberikan, gunakan posisi interpolator saat ini
         if (isnan(targetX)) targetX = interpolator.getX();
@@ -0,0 +1,162 @@
+// binaryFrame.cpp
+#include "binaryFrame.h"
+#include "command.h"
+#include <string.h>
+#if defined(__AVR__)
+#include <util/crc16.h>
+#endif
+
+uint16_t frameCrc16(uint16_t crc, uint8_t data) {
+#if defined(__AVR__)
+  return _crc_xmodem_update(crc, data);
+#else
+  // Byte-wise form of the bit loop, same result as _crc_xmodem_update()
+  crc = (crc >> 8) | (crc << 8);
+  crc ^= data;
+  crc ^= (crc & 0xFF) >> 4;
+  crc ^= crc << 12;
+  crc ^= (crc & 0xFF) << 5;
+  return crc;
+#endif
+}
+
+static uint16_t frameCrc(const uint8_t *data, uint8_t length) {
+  uint16_t crc = 0;
+  for (uint8_t i = 0; i < length; i++) crc = frameCrc16(crc, data[i]);
+  return crc;
+}
+
+static const uint8_t FRAME_BASE_MASK = (1 << FRAME_BASE_VALUE_COUNT) - 1;
+static const uint8_t FRAME_EXT_MASK = (1 << (FRAME_VALUE_COUNT - FRAME_BASE_VALUE_COUNT)) - 1;
+
+FrameStatus unpackFrame(const uint8_t *frame, uint8_t length, uint8_t &seq, Cmd &cmd) {
+  if (length < FRAME_HEADER_SIZE) return FRAME_CRC_ERROR;
+  uint8_t payloadLength = frame[2];
+  if (payloadLength < FRAME_PAYLOAD_MIN || payloadLength > FRAME_PAYLOAD_MAX ||
+      length != FRAME_HEADER_SIZE + payloadLength + FRAME_CRC_SIZE) {
+    return FRAME_CRC_ERROR;
+  }
+  uint8_t crcEnd = FRAME_HEADER_SIZE + payloadLength;
+  uint16_t crc = frame[crcEnd] | ((uint16_t)frame[crcEnd + 1] << 8);
+  if (frameCrc(frame + 1, crcEnd - 1) != crc) return FRAME_CRC_ERROR;
+
+  // Every set bit needs its value, short bits only for present values, and nothing may
+  // follow the last value
+  const uint8_t *p = frame + FRAME_HEADER_SIZE;
+  uint8_t headerLength = FRAME_PAYLOAD_MIN;
+  uint16_t present = p[3] & FRAME_BASE_MASK;
+  uint16_t shortBits = 0;
+  if (p[3] & FRAME_PRESENT_EXT) {
+    if (payloadLength < headerLength + 1) return FRAME_CRC_ERROR;
+    uint8_t ext = p[headerLength++];
+    if (ext & ~(FRAME_EXT_MASK | (FRAME_EXT_MASK << FRAME_EXT_SHORT_SHIFT))) return FRAME_CRC_ERROR;
+    present |= (uint16_t)(ext & FRAME_EXT_MASK) << FRAME_BASE_VALUE_COUNT;
+    shortBits |= (uint16_t)(ext >> FRAME_EXT_SHORT_SHIFT) << FRAME_BASE_VALUE_COUNT;
+  }
+  if (p[3] & FRAME_PRESENT_SHORT) {
+    if (payloadLength < headerLength + 1) return FRAME_CRC_ERROR;
+    uint8_t shortByte = p[headerLength++];
+    if (shortByte & ~FRAME_BASE_MASK) return FRAME_CRC_ERROR;
+    shortBits |= shortByte;
+  }
+  if (shortBits & ~present) return FRAME_CRC_ERROR;
+  uint8_t valueBytes = 0;
+  for (uint8_t i = 0; i < FRAME_VALUE_COUNT; i++) {
+    if (present & (1 << i)) valueBytes += (shortBits & (1 << i)) ? 2 : 3;
+  }
+  if (payloadLength != headerLength + valueBytes) return FRAME_CRC_ERROR;
+
+  seq = frame[1];
+  cmd.id = p[0];
+  cmd.num = (int16_t)(p[1] | ((uint16_t)p[2] << 8));
+  p += headerLength;
+  for (uint8_t i = 0; i < FRAME_VALUE_COUNT; i++) {
+    float *value = cmdValue(cmd, i);
+    if (!(present & (1 << i))) {
+      *value = NAN;
+      continue;
+    }
+    // Sign-extend from the top byte
+    int32_t fixed;
+    if (shortBits & (1 << i)) {
+      fixed = (int16_t)(p[0] | ((uint16_t)p[1] << 8));
+      p += 2;
+    } else {
+      fixed = (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+                        (p[2] & 0x80 ? 0xFF000000UL : 0));
+      p += 3;
+    }
+    *value = cmdFromFixed(fixed, cmdFixedScale(i));
+  }
+  if (cmd.id == FRAME_ID_SYNC) return FRAME_OK;
+  return (cmd.id == 'G' || cmd.id == 'M' || cmd.id == 'P') ? FRAME_OK : FRAME_UNKNOWN_COMMAND;
+}
+
+uint8_t packFrame(uint8_t seq, const Cmd &cmd, uint8_t *frame) {
+  Cmd values = cmd;
+  int32_t fixed[FRAME_VALUE_COUNT];
+  uint16_t present = 0, shortBits = 0;
+  for (uint8_t i = 0; i < FRAME_VALUE_COUNT; i++) {
+    float value = *cmdValue(values, i);
+    if (isnan(value)) continue;
+    uint16_t scale = cmdFixedScale(i);
+    if (!cmdToFixed(value, scale, fixed[i])) {
+      // Off the grid (or above 2^16 / scale, where the float product is inexact): nearest point
+      if (!(fabs(value) * scale < 2.0 * CMD_FIXED_MAX)) return 0;
+      fixed[i] = lround(value * scale);
+      if (fixed[i] > CMD_FIXED_MAX || fixed[i] < -CMD_FIXED_MAX) return 0;
+    }
+    present |= 1 << i;
+    if (fixed[i] >= -32768L && fixed[i] <= 32767L) shortBits |= 1 << i;
+  }
+
+  uint8_t *p = frame + FRAME_HEADER_SIZE;
+  p[0] = cmd.id;
+  p[1] = (uint16_t)cmd.num & 0xFF;
+  p[2] = (uint16_t)cmd.num >> 8;
+  p[3] = present & FRAME_BASE_MASK;
+  uint8_t *q = p + FRAME_PAYLOAD_MIN;
+  uint8_t ext = (present >> FRAME_BASE_VALUE_COUNT) | ((shortBits >> FRAME_BASE_VALUE_COUNT) << FRAME_EXT_SHORT_SHIFT);
+  if (ext) {
+    p[3] |= FRAME_PRESENT_EXT;
+    *q++ = ext;
+  }
+  if (shortBits & FRAME_BASE_MASK) {
+    p[3] |= FRAME_PRESENT_SHORT;
+    *q++ = shortBits & FRAME_BASE_MASK;
+  }
+  for (uint8_t i = 0; i < FRAME_VALUE_COUNT; i++) {
+    if (!(present & (1 << i))) continue;
+    *q++ = fixed[i] & 0xFF;
+    *q++ = (fixed[i] >> 8) & 0xFF;
+    if (!(shortBits & (1 << i))) *q++ = (fixed[i] >> 16) & 0xFF;
+  }
+
+  uint8_t payloadLength = q - p;
+  frame[0] = FRAME_SYNC;
+  frame[1] = seq;
+  frame[2] = payloadLength;
+  uint16_t crc = frameCrc(frame + 1, FRAME_HEADER_SIZE - 1 + payloadLength);
+  q[0] = crc & 0xFF;
+  q[1] = crc >> 8;
+  return FRAME_HEADER_SIZE + payloadLength + FRAME_CRC_SIZE;
+}
+
+void writeFrameReply(uint8_t seq, FrameStatus status, uint8_t queueFree, uint8_t rxFree) {
+  uint8_t reply[FRAME_REPLY_SIZE] = {FRAME_SYNC, seq, (uint8_t)status, queueFree, rxFree, 0, 0};
+  uint16_t crc = frameCrc(reply + 1, FRAME_REPLY_SIZE - 1 - FRAME_CRC_SIZE);
+  reply[FRAME_REPLY_SIZE - 2] = crc & 0xFF;
+  reply[FRAME_REPLY_SIZE - 1] = crc >> 8;
+  Serial.write(reply, FRAME_REPLY_SIZE);
+}
+
+void writeTelemetryFrame(const uint8_t *payload) {
+  uint8_t frame[FRAME_TELEMETRY_SIZE];
+  frame[0] = FRAME_TELEMETRY_SYNC;
+  frame[1] = FRAME_TELEMETRY_PAYLOAD;
+  memcpy(frame + 2, payload, FRAME_TELEMETRY_PAYLOAD);
+  uint16_t crc = frameCrc(frame + 1, FRAME_TELEMETRY_SIZE - 1 - FRAME_CRC_SIZE);
+  frame[FRAME_TELEMETRY_SIZE - 2] = crc & 0xFF;
+  frame[FRAME_TELEMETRY_SIZE - 1] = crc >> 8;
+  Serial.write(frame, FRAME_TELEMETRY_SIZE);
+}
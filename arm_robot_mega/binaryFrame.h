@@ -0,0 +1,80 @@
+// binaryFrame.h
+#ifndef BINARY_FRAME_H
+#define BINARY_FRAME_H
+
+#include <Arduino.h>
+
+struct Cmd;
+
+// Optional binary command framing, accepted alongside ASCII G-code lines.
+// A frame starts with FRAME_SYNC, a byte that never appears in ASCII G-code.
+//
+// Host -> firmware:  [SYNC][seq][len][payload: len bytes][crc lo][crc hi]
+//   payload:         [id][num lo][num hi][present][ext][short][values]
+//                    bit i of present = value i (X, Y, Z, E, F, T) follows, in that order
+//                    bit 7 of present = the ext byte follows: bits 0..2 = I, J, R (G2/G3),
+//                    whose values come after those of present
+//                    bit 6 of present = the short byte follows: bit i = value i is 16-bit
+//                    ext bits 4..6 = I, J, R are 16-bit. Bits 3 and 7 of ext are reserved (0).
+//                    Without arc words there is no ext byte, and without 16-bit values no
+//                    short byte.
+//   values:          little-endian signed fixed point, 24-bit (16-bit if marked short), in
+//                    0.01 units (0.001 for T), see cmdFromFixed(): +-83886.07 mm, and
+//                    +-327.67 mm in 16 bits. Values are decoded with the same arithmetic as
+//                    the ASCII parser, so "X10.05" gives the same float either way.
+//   id FRAME_ID_SYNC carries no command: it is always accepted and restarts the sequence at seq + 1
+// Firmware -> host:  [SYNC][seq][status][queue free][rx free][crc lo][crc hi]
+//   seq is the frame the status refers to; for the error statuses it is the sequence
+//   number the host must resend from.
+// Firmware -> host, telemetry (M155, see telemetry.h):
+//                    [TELEMETRY SYNC][len][payload: len bytes][crc lo][crc hi]
+//   payload:         [sample seq][time us u32][step position i32 x4][planner blocks]
+//                    [queue used][max loop time us u16][limit bits][dropped samples]
+//   Little-endian. Only sent between complete text lines and reply frames.
+//
+// The CRC is CRC-16/XMODEM (poly 0x1021, init 0) over everything between SYNC and the CRC.
+#define FRAME_SYNC 0xA5
+#define FRAME_TELEMETRY_SYNC 0xA6
+#define FRAME_ID_SYNC 0
+#define FRAME_HEADER_SIZE 3
+#define FRAME_CRC_SIZE 2
+#define FRAME_VALUE_COUNT 9       // X Y Z E F T I J R
+#define FRAME_BASE_VALUE_COUNT 6  // Values in the present byte; the rest are in ext
+#define FRAME_PRESENT_EXT 0x80
+#define FRAME_PRESENT_SHORT 0x40
+#define FRAME_EXT_SHORT_SHIFT 4   // ext bits 4..6: I, J, R are 16-bit
+#define FRAME_PAYLOAD_MIN 4
+#define FRAME_PAYLOAD_MAX (FRAME_PAYLOAD_MIN + 2 + FRAME_VALUE_COUNT * 3)
+#define FRAME_MAX_SIZE (FRAME_HEADER_SIZE + FRAME_PAYLOAD_MAX + FRAME_CRC_SIZE)
+#define FRAME_REPLY_SIZE 7
+#define FRAME_TELEMETRY_PAYLOAD 27
+#define FRAME_TELEMETRY_SIZE (2 + FRAME_TELEMETRY_PAYLOAD + FRAME_CRC_SIZE)
+
+enum FrameStatus {
+  FRAME_OK = 0,               // Accepted and queued
+  FRAME_DUPLICATE = 1,        // Already accepted earlier; seq is the last accepted frame
+  FRAME_CRC_ERROR = 2,        // Corrupted frame; resend from seq
+  FRAME_SEQUENCE_ERROR = 3,   // A frame was lost; resend from seq
+  FRAME_UNKNOWN_COMMAND = 4,  // Accepted, but not a G, M or P command
+  FRAME_IGNORED = 5,          // Dropped while recovering from an error; never sent as a reply
+  FRAME_REJECTED = 6          // Accepted, but values out of range (M665/M666); not queued
+};
+
+uint16_t frameCrc16(uint16_t crc, uint8_t data);
+
+// Check the length and CRC of a complete frame and decode its payload into cmd.
+// seq receives the frame's sequence number. Sequencing is handled by Command::decodeFrame().
+FrameStatus unpackFrame(const uint8_t *frame, uint8_t length, uint8_t &seq, Cmd &cmd);
+
+// Encode cmd as a frame (host side; used by the simulator's sender and benchmarks).
+// NAN values are left out, and values off the 0.01 grid are rounded to the nearest point.
+// Returns the frame length, or 0 if a value is out of the 24-bit range (send it as text).
+uint8_t packFrame(uint8_t seq, const Cmd &cmd, uint8_t *frame);
+
+// Write a reply frame to Serial
+void writeFrameReply(uint8_t seq, FrameStatus status, uint8_t queueFree, uint8_t rxFree);
+
+// Write a telemetry frame around a FRAME_TELEMETRY_PAYLOAD byte payload to Serial
+void writeTelemetryFrame(const uint8_t *payload);
+
+#endif
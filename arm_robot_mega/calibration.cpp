@@ -0,0 +1,121 @@
+// calibration.cpp
+#include "calibration.h"
+#include "binaryFrame.h"
+#include "robotGeometry.h"
+#include <EEPROM.h>
+
+// Tata letak rekaman kalibrasi: [magic u16][versi u8][ukuran u16][CalibrationData][crc u16]
+static const int HEADER_SIZE = 5;
+static const int DATA_ADDRESS = CALIBRATION_ADDRESS + HEADER_SIZE;
+static const int CRC_ADDRESS = DATA_ADDRESS + sizeof(CalibrationData);
+// Rekaman posisi: [penanda u8][StoredPosition][crc u16]; penanda selain POSITION_VALID = kosong
+static const uint8_t POSITION_VALID = 0xA5;
+static const int POSITION_DATA_ADDRESS = CALIBRATION_POSITION_ADDRESS + 1;
+static const int POSITION_CRC_ADDRESS = POSITION_DATA_ADDRESS + sizeof(StoredPosition);
+
+static uint16_t crcBytes(uint16_t crc, const void* data, size_t length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (size_t i = 0; i < length; i++) crc = frameCrc16(crc, bytes[i]);
+  return crc;
+}
+
+static uint16_t readWord(int address) {
+  return EEPROM.read(address) | ((uint16_t)EEPROM.read(address + 1) << 8);
+}
+
+static void updateWord(int address, uint16_t value) {
+  EEPROM.update(address, value & 0xFF);
+  EEPROM.update(address + 1, value >> 8);
+}
+
+void CalibrationStore::defaults(CalibrationData& data) {
+  data.zeroDeg[0] = 90.0;   // Base
+  data.zeroDeg[1] = -14.00; // Shoulder
+  data.zeroDeg[2] = -91.77; // Elbow
+  data.linkL1 = RobotGeometry::DEFAULT_L1;
+  data.linkL2 = RobotGeometry::DEFAULT_L2;
+  data.linkL3 = RobotGeometry::DEFAULT_L3;
+  data.eeForward = RobotGeometry::DEFAULT_EE_FORWARD_OFFSET_MM;
+  data.eeDown = RobotGeometry::DEFAULT_EE_DOWN_OFFSET_MM;
+  // Sendi rotasi 10:1 (Base negatif karena arah fisik motor terbalik), slider 1:1
+  data.reductionRatio[0] = -10.0;
+  data.reductionRatio[1] = 10.0;
+  data.reductionRatio[2] = 10.0;
+  data.reductionRatio[3] = 1.0;
+  for (uint8_t i = 0; i < CALIBRATION_AXES; i++) data.stepsPerRev[i] = 200 * 16;
+  data.sliderPitch = 20.0;
+  data.j0CalibrationDeg = -165.0;
+  data.homeX = 0.0;
+  data.homeY = 210.0;
+  data.homeZ = 235.0;
+  data.homeE = 0.0; // Slider di posisi 0 mm
+  MacroRunner::loadDefaults(data.macro);
+}
+
+uint16_t CalibrationStore::crc(const CalibrationData& data) {
+  return crcBytes(0, &data, sizeof(data));
+}
+
+CalibrationStatus CalibrationStore::load(CalibrationData& data) {
+  bool same;
+  CalibrationStatus status = verify(data, same);
+  if (status == CALIBRATION_OK) EEPROM.get(DATA_ADDRESS, data);
+  return status;
+}
+
+CalibrationStatus CalibrationStore::verify(const CalibrationData& data, bool& same) {
+  same = false;
+  if (readWord(CALIBRATION_ADDRESS) != CALIBRATION_MAGIC) return CALIBRATION_EMPTY;
+  if (EEPROM.read(CALIBRATION_ADDRESS + 2) != CALIBRATION_VERSION ||
+      readWord(CALIBRATION_ADDRESS + 3) != sizeof(CalibrationData)) {
+    return CALIBRATION_VERSION_MISMATCH;
+  }
+  CalibrationData stored;
+  EEPROM.get(DATA_ADDRESS, stored);
+  if (crc(stored) != readWord(CRC_ADDRESS)) return CALIBRATION_CRC_ERROR;
+  same = memcmp(&stored, &data, sizeof(stored)) == 0;
+  return CALIBRATION_OK;
+}
+
+void CalibrationStore::save(const CalibrationData& data) {
+  invalidatePosition();
+  // Magic ditulis terakhir: rekaman yang terputus di tengah penulisan tidak dianggap valid
+  updateWord(CALIBRATION_ADDRESS, 0xFFFF);
+  EEPROM.update(CALIBRATION_ADDRESS + 2, CALIBRATION_VERSION);
+  updateWord(CALIBRATION_ADDRESS + 3, sizeof(CalibrationData));
+  EEPROM.put(DATA_ADDRESS, data);
+  updateWord(CRC_ADDRESS, crc(data));
+  updateWord(CALIBRATION_ADDRESS, CALIBRATION_MAGIC);
+}
+
+void CalibrationStore::savePosition(const StoredPosition& position) {
+  EEPROM.update(CALIBRATION_POSITION_ADDRESS, 0);
+  EEPROM.put(POSITION_DATA_ADDRESS, position);
+  updateWord(POSITION_CRC_ADDRESS, crcBytes(0, &position, sizeof(position)));
+  EEPROM.update(CALIBRATION_POSITION_ADDRESS, POSITION_VALID);
+}
+
+bool CalibrationStore::takePosition(StoredPosition& position, uint16_t calibrationCrc) {
+  if (EEPROM.read(CALIBRATION_POSITION_ADDRESS) != POSITION_VALID) return false;
+  StoredPosition stored;
+  EEPROM.get(POSITION_DATA_ADDRESS, stored);
+  invalidatePosition();
+  if (crcBytes(0, &stored, sizeof(stored)) != readWord(POSITION_CRC_ADDRESS)) return false;
+  if (stored.calibrationCrc != calibrationCrc) return false;
+  position = stored;
+  return true;
+}
+
+void CalibrationStore::invalidatePosition() {
+  EEPROM.update(CALIBRATION_POSITION_ADDRESS, 0);
+}
+
+const char* CalibrationStore::statusName(CalibrationStatus status) {
+  switch (status) {
+    case CALIBRATION_OK: return "OK";
+    case CALIBRATION_EMPTY: return "kosong";
+    case CALIBRATION_VERSION_MISMATCH: return "versi berbeda";
+    case CALIBRATION_CRC_ERROR: return "CRC salah";
+  }
+  return "?";
+}
@@ -0,0 +1,70 @@
+// calibration.h
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <Arduino.h>
+#include "macro.h"
+
+// Kalibrasi robot yang disimpan di EEPROM (M500), dibaca saat start dan dengan M501.
+// Rekaman diawali magic, versi, dan ukuran struct, lalu ditutup CRC-16 (frameCrc16, sama
+// dengan frame biner). Versi atau ukuran yang berbeda (firmware baru mengubah struct)
+// berarti rekaman diabaikan dan nilai default firmware dipakai sampai M500 berikutnya.
+#define CALIBRATION_MAGIC 0x4B41
+#define CALIBRATION_VERSION 1
+#define CALIBRATION_ADDRESS 0
+// Rekaman posisi terakhir terpisah dari kalibrasi agar dapat dibatalkan dengan satu byte
+#define CALIBRATION_POSITION_ADDRESS 512
+#define CALIBRATION_AXES 4
+
+// Semua nilai dalam derajat, mm, dan langkah. Urutan sumbu: Base, Shoulder, Elbow, Slider.
+// Hanya tipe dengan ukuran tetap agar tata letak sama di AVR dan di simulasi host.
+struct CalibrationData {
+  float zeroDeg[3];        // Sudut kinematik Base/Shoulder/Elbow saat stepper di 0 langkah
+  float linkL1, linkL2, linkL3; // Panjang link (RobotGeometry)
+  float eeForward, eeDown; // Offset end-effector dari wrist
+  float reductionRatio[CALIBRATION_AXES]; // Rasio gigi (negatif = arah dibalik)
+  int32_t stepsPerRev[CALIBRATION_AXES];  // Langkah mentah per putaran motor (dengan microstep)
+  float sliderPitch;       // mm per putaran motor slider
+  float j0CalibrationDeg;  // Gerakan kalibrasi Base dari switch sebelum posisi 0
+  float homeX, homeY, homeZ, homeE; // Posisi Kartesian setelah homing
+  MacroParams macro;       // Titik ambil dan wadah makro P1..P3
+};
+
+// Posisi terakhir yang diketahui, untuk start tanpa homing (warm restart)
+struct StoredPosition {
+  int32_t steps[CALIBRATION_AXES]; // Posisi langkah setiap sumbu
+  float x, y, z, e;                // Posisi interpolator
+  uint16_t calibrationCrc;         // CRC kalibrasi saat posisi disimpan
+};
+
+enum CalibrationStatus : uint8_t {
+  CALIBRATION_OK,
+  CALIBRATION_EMPTY,            // Magic tidak ditemukan (EEPROM belum pernah ditulis)
+  CALIBRATION_VERSION_MISMATCH, // Versi atau ukuran struct berbeda
+  CALIBRATION_CRC_ERROR         // Isi rusak
+};
+
+class CalibrationStore {
+public:
+  // Nilai bawaan firmware (sama dengan konstanta sebelum ada EEPROM)
+  static void defaults(CalibrationData& data);
+  static uint16_t crc(const CalibrationData& data);
+
+  // Baca kalibrasi; data hanya diubah jika hasilnya CALIBRATION_OK
+  CalibrationStatus load(CalibrationData& data);
+  // Tulis kalibrasi (hanya byte yang berubah yang ditulis). Posisi tersimpan dibatalkan
+  // karena mengacu ke kalibrasi lama.
+  void save(const CalibrationData& data);
+  // Periksa rekaman di EEPROM tanpa mengubah data aktif; same = isinya sama dengan data
+  CalibrationStatus verify(const CalibrationData& data, bool& same);
+
+  // Posisi terakhir: simpan, ambil (sekali pakai: rekaman langsung dibatalkan agar start
+  // berikutnya kembali homing kecuali posisi disimpan lagi), dan batalkan
+  void savePosition(const StoredPosition& position);
+  bool takePosition(StoredPosition& position, uint16_t calibrationCrc);
+  void invalidatePosition();
+
+  static const char* statusName(CalibrationStatus status);
+};
+
+#endif
@@ -1,84 +1,318 @@
 #include "command.h"
+#include "profile.h"
+#include <string.h>
+
+static inline bool isDigitChar(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// True if a normalized line is an M110 (set line number) command
+static inline bool isSetLineNumber(const char *line) {
+  return line[0] == 'M' && line[1] == '1' && line[2] == '1' && line[3] == '0' && !isDigitChar(line[4]);
+}
 
 Command::Command() {
   currentCmd.id = -1;
   currentCmd.num = 0;
   currentCmd.valueX = currentCmd.valueY = currentCmd.valueZ =  NAN;
   currentCmd.valueE = currentCmd.valueF = currentCmd.valueT = NAN;
+  currentCmd.valueI = currentCmd.valueJ = currentCmd.valueR = NAN;
+  lastLineNumber = 0;
+  lineLength = 0;
+  lineOverflow = false;
+  frameLength = 0;
+  frameRemaining = 0;
+  frameSeq = 0;
+  expectedSeq = 0;
+  frameRecovering = false;
 }
 
-// Original handleGcode for serial buffer reading (kept for compatibility if needed elsewhere)
-bool Command::handleGcode() {
-  static String buffer = "";
-  while (Serial.available()) {
-    char c = Serial.read();
+// Never waits for the rest of a line or frame: partial input stays in lineBuffer
+// and assembly continues on the next call
+InputStatus Command::pollInput() {
+  while (Serial.available() > 0) {
+    uint8_t c = Serial.read();
+    if (frameRemaining > 0) {
+      lineBuffer[lineLength++] = c;
+      frameRemaining--;
+      if (lineLength == FRAME_HEADER_SIZE) {
+        // Length byte; an impossible length ends the frame here and fails decodeFrame()
+        frameRemaining = (c >= FRAME_PAYLOAD_MIN && c <= FRAME_PAYLOAD_MAX) ? c + FRAME_CRC_SIZE : 0;
+      }
+      if (frameRemaining == 0) {
+        frameLength = lineLength;
+        lineLength = 0;
+        return INPUT_FRAME;
+      }
+      continue;
+    }
+    if (c == FRAME_SYNC) {
+      // Drops any partial line, e.g. noise before the host switched to frames
+      lineBuffer[0] = c;
+      lineLength = 1;
+      lineOverflow = false;
+      frameRemaining = FRAME_HEADER_SIZE - 1;
+      continue;
+    }
     if (c == '\n' || c == '\r') {
-      if (buffer.length() > 0) {
-        // Check if the line starts with 'G' or 'M' before parsing
-        if (buffer.charAt(0) != 'G' && buffer.charAt(0) != 'M') {
-            buffer = ""; // Clear buffer for next line
-            return false; // Not a G or M command
-        }
-        parseLine(buffer);
-        buffer = "";
-        return true;
+      if (lineLength == 0) continue; // Blank line or second half of CRLF
+      lineBuffer[lineLength] = '\0';
+      lineLength = 0;
+      if (lineOverflow) {
+        // A cut-off coordinate would still parse as a different valid move
+        lineOverflow = false;
+        return INPUT_LINE_TOO_LONG;
       }
-    } else {
-      buffer += c;
+      return INPUT_LINE;
     }
+    // Characters beyond COMMAND_LINE_MAX are dropped, and the line is rejected at its end
+    if (lineLength < COMMAND_LINE_MAX) lineBuffer[lineLength++] = c;
+    else lineOverflow = true;
   }
-  return false;
+  return INPUT_NONE;
+}
+
+FrameStatus Command::decodeFrame() {
+  uint8_t seq;
+  Cmd cmd;
+  FrameStatus status;
+  {
+    // Same scope as parseLine(): bytes -> Cmd only, without the sequence bookkeeping below
+    PROFILE_SCOPE(PROFILE_PARSE);
+    status = unpackFrame((const uint8_t *)lineBuffer, frameLength, seq, cmd);
+  }
+  if (status == FRAME_CRC_ERROR) {
+    // The sequence number itself may be corrupted: ask for the expected frame
+    frameRecovering = true;
+    frameSeq = expectedSeq;
+    return status;
+  }
+
+  if (cmd.id == FRAME_ID_SYNC) {
+    expectedSeq = seq + 1;
+    frameRecovering = false;
+  } else if (seq != expectedSeq) {
+    // Behind the expected frame: a resent copy of one already accepted
+    uint8_t behind = expectedSeq - seq;
+    frameSeq = expectedSeq - 1;
+    if (behind <= 128) return FRAME_DUPLICATE;
+    // Ahead: frames were lost. Report once, then drop the rest of the burst
+    frameSeq = expectedSeq;
+    if (frameRecovering) return FRAME_IGNORED;
+    frameRecovering = true;
+    return FRAME_SEQUENCE_ERROR;
+  } else {
+    expectedSeq++;
+    frameRecovering = false;
+  }
+  frameSeq = seq;
+  currentCmd = cmd;
+  return status;
 }
 
-// Definition for handleGcodeLine - processes a single G-code line
-bool Command::handleGcodeLine(const String &line) {
-    // Check if the line starts with 'G' or 'M' before parsing
-    if (line.length() == 0 || (line.charAt(0) != 'G' && line.charAt(0) != 'M')) {
+// Processes a single normalized G-code line
+bool Command::handleGcodeLine(const char *line) {
+    // Check if the line starts with 'G', 'M' or 'P' (macro) before parsing
+    if (line[0] != 'G' && line[0] != 'M' && line[0] != 'P') {
         currentCmd.id = 0; // Indicate an invalid command type
-        return false; // Not a G or M command
+        return false; // Not a G, M or P command
     }
-    parseLine(line); // Pass the const String& directly
-    return true; // Successfully parsed a G or M command (even if the number is unknown)
+    parseLine(line);
+    return true; // Successfully parsed a command (even if the number is unknown)
+}
+
+bool Command::hasLineNumber(const char *line) {
+  while (*line == ' ' || *line == '\t') line++;
+  return (line[0] == 'N' || line[0] == 'n') && isDigitChar(line[1]);
 }
 
 Cmd Command::getCmd() const {
   return currentCmd;
 }
 
-// Modified parseLine to accept a const String&
-void Command::parseLine(const String &line) {
-  // Example parsing: "G1 X10.0 Y20.0 Z5.0 F2000"
-  currentCmd.id = line.charAt(0);
-  // No need for validation here, as it's done in handleGcodeLine/handleGcode
-  currentCmd.num = line.substring(1).toInt();
+LineStatus Command::prepareLine(char *line) {
+  // Checksum covers every byte before '*'. A '*' inside a ';' or '(' comment is comment text.
+  char *star = line + strcspn(line, "*;(");
+  if (*star != '*') star = nullptr;
+  if (star) {
+    uint8_t checksum = 0;
+    for (const char *p = line; p < star; p++) checksum ^= (uint8_t)*p;
+    const char *p = star + 1;
+    int expected = 0;
+    bool digits = false;
+    while (isDigitChar(*p)) {
+      expected = expected * 10 + (*p - '0');
+      p++;
+      digits = true;
+    }
+    *star = '\0';
+    if (!digits || expected != checksum) return LINE_CHECKSUM_ERROR;
+  }
 
-  // Reset values
-  currentCmd.valueX = currentCmd.valueY = currentCmd.valueZ = NAN;
-  currentCmd.valueE = currentCmd.valueF = currentCmd.valueT = NAN;
+  // Compact in place: drop comments and leading whitespace, uppercase the rest
+  char *w = line;
+  bool inComment = false;
+  for (const char *r = line; *r; r++) {
+    char c = *r;
+    if (inComment) {
+      if (c == ')') inComment = false;
+      continue;
+    }
+    if (c == '(') {
+      inComment = true;
+      continue;
+    }
+    if (c == ';' || c == '\r' || c == '\n') break;
+    if (c == '\t') c = ' ';
+    if (c == ' ' && w == line) continue;
+    if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+    *w++ = c;
+  }
+  while (w > line && w[-1] == ' ') w--;
+  *w = '\0';
 
-  int idx = 1;
-  while (idx < line.length()) {
-    char axis = line.charAt(idx);
-    idx++;
-    // Get the number after the axis until a space
-    int nextSpace = line.indexOf(' ', idx);
-    String numStr;
-    if (nextSpace == -1) {
-      numStr = line.substring(idx);
-      idx = line.length();
-    } else {
-      numStr = line.substring(idx, nextSpace);
-      idx = nextSpace + 1;
+  // Leading line number
+  if (line[0] == 'N' && isDigitChar(line[1])) {
+    const char *p = line + 1;
+    long lineNumber = 0;
+    while (isDigitChar(*p)) {
+      lineNumber = lineNumber * 10 + (*p - '0');
+      p++;
     }
-    float val = numStr.toFloat();
-    switch (axis) {
-      case 'X': currentCmd.valueX = val; break;
-      case 'Y': currentCmd.valueY = val; break;
-      case 'Z': currentCmd.valueZ = val; break;
-      case 'E': currentCmd.valueE = val; break;
-      case 'F': currentCmd.valueF = val; break;
-      case 'T': currentCmd.valueT = val; break;
+    while (*p == ' ') p++;
+    memmove(line, p, strlen(p) + 1);
+
+    // A numbered line always carries a checksum; a missing one means the '*' was corrupted
+    if (!star) return LINE_CHECKSUM_ERROR;
+
+    if (isSetLineNumber(line)) {
+      lastLineNumber = lineNumber;
+      return LINE_HANDLED;
+    }
+    if (lineNumber != lastLineNumber + 1) return LINE_NUMBER_ERROR;
+    lastLineNumber = lineNumber;
+  } else if (isSetLineNumber(line)) {
+    // "M110 N<n>" without a leading line number
+    lastLineNumber = 0;
+    for (const char *p = line + 4; *p; p++) {
+      float value;
+      if (*p == 'N' && parseNumber(p + 1, value)) {
+        lastLineNumber = (long)value;
+        break;
+      }
+    }
+    return LINE_HANDLED;
+  }
+
+  return line[0] == '\0' ? LINE_EMPTY : LINE_READY;
+}
+
+const char *Command::parseNumber(const char *p, float &value) {
+  bool negative = false;
+  if (*p == '-' || *p == '+') {
+    negative = (*p == '-');
+    p++;
+  }
+
+  float result = 0.0;
+  bool digits = false;
+  while (isDigitChar(*p)) {
+    result = result * 10.0 + (*p - '0');
+    digits = true;
+    p++;
+  }
+  if (*p == '.') {
+    p++;
+    // Accumulate the fraction as an integer so "0.1" is not built from rounded tenths
+    unsigned long fraction = 0;
+    unsigned long scale = 1;
+    while (isDigitChar(*p)) {
+      if (scale < 100000000UL) {
+        fraction = fraction * 10 + (*p - '0');
+        scale *= 10;
+      }
+      digits = true;
+      p++;
+    }
+    result += (float)fraction / scale;
+  }
+
+  if (!digits) return nullptr;
+  value = negative ? -result : result;
+  return p;
+}
+
+float *cmdValue(Cmd &cmd, uint8_t i) {
+  switch (i) {
+    case 0: return &cmd.valueX;
+    case 1: return &cmd.valueY;
+    case 2: return &cmd.valueZ;
+    case 3: return &cmd.valueE;
+    case 4: return &cmd.valueF;
+    case 5: return &cmd.valueT;
+    case 6: return &cmd.valueI;
+    case 7: return &cmd.valueJ;
+    default: return &cmd.valueR;
+  }
+}
+
+// Integer part, plus the fraction divided by its scale
+float cmdFromFixed(int32_t fixed, uint16_t scale) {
+  uint32_t magnitude = fixed < 0 ? -fixed : fixed;
+  float value = (float)(magnitude / scale);
+  uint16_t fraction = magnitude % scale;
+  if (fraction) value += (float)fraction / scale;
+  return fixed < 0 ? -value : value;
+}
+
+bool cmdToFixed(float value, uint16_t scale, int32_t &fixed) {
+  if (!(fabs(value) * scale < CMD_FIXED_MAX - 1)) return false;
+  // The float product can round onto .5 above 2^16 / scale, so the nearest grid point may be
+  // one step off; try the neighbours too
+  int32_t nearest = lround(value * scale);
+  static const int8_t OFFSETS[] = {0, -1, 1};
+  for (uint8_t i = 0; i < sizeof(OFFSETS); i++) {
+    fixed = nearest + OFFSETS[i];
+    float back = cmdFromFixed(fixed, scale);
+    if (memcmp(&back, &value, sizeof(float)) == 0) return true; // Bitwise: -0.0 is not 0
+  }
+  return false;
+}
+
+void Command::parseArguments(const char *p, Cmd &cmd) {
+  cmd.valueX = cmd.valueY = cmd.valueZ = NAN;
+  cmd.valueE = cmd.valueF = cmd.valueT = NAN;
+  cmd.valueI = cmd.valueJ = cmd.valueR = NAN;
+
+  while (*p) {
+    char letter = *p++;
+    if (letter < 'A' || letter > 'Z') continue;
+    float val;
+    const char *next = parseNumber(p, val);
+    if (!next) continue;
+    p = next;
+    switch (letter) {
+      case 'X': cmd.valueX = val; break;
+      case 'Y': cmd.valueY = val; break;
+      case 'Z': cmd.valueZ = val; break;
+      case 'E': cmd.valueE = val; break;
+      case 'F': cmd.valueF = val; break;
+      case 'T': cmd.valueT = val; break;
+      case 'I': cmd.valueI = val; break;
+      case 'J': cmd.valueJ = val; break;
+      case 'R': cmd.valueR = val; break;
       default: break;
     }
   }
 }
+
+// Parse a normalized line such as "G1 X10.0 Y20.0 Z5.0 F2000" (spaces optional)
+void Command::parseLine(const char *line) {
+  PROFILE_SCOPE(PROFILE_PARSE);
+  currentCmd.id = line[0];
+  // No need for validation here, as it's done in handleGcodeLine/handleGcode
+  float num = 0;
+  const char *p = parseNumber(line + 1, num);
+  currentCmd.num = (int)num;
+  parseArguments(p ? p : line + 1, currentCmd);
+}
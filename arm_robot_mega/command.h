@@ -2,25 +2,101 @@
 #define COMMAND_H
 
 #include <Arduino.h>
+#include "binaryFrame.h"
+
+// Longest accepted line (without terminator). Longer lines are reported as
+// INPUT_LINE_TOO_LONG and never executed.
+#define COMMAND_LINE_MAX 96
+#if FRAME_MAX_SIZE > COMMAND_LINE_MAX
+#error "lineBuffer must hold a binary frame"
+#endif
 
 struct Cmd {
   char id;
   int num;
   float valueX, valueY, valueZ, valueE, valueF, valueT;
+  float valueI, valueJ, valueR; // G2/G3: arc centre offset from the start point, or radius
+};
+
+// Fixed-point form of Cmd values, shared by binary frames and packed queue records.
+// Value i is X, Y, Z, E, F, T, I, J, R in that order (the present bits of both formats),
+// in units of 1 / cmdFixedScale(i): 0.01, or 0.001 for T.
+#define CMD_FIXED_MAX 0x7FFFFF  // Largest magnitude that fits in 24 bits
+float *cmdValue(Cmd &cmd, uint8_t i);
+inline uint16_t cmdFixedScale(uint8_t i) { return i == 5 ? 1000 : 100; }
+// Same steps as Command::parseNumber(), so a value with at most 2 decimals (3 for T) comes
+// out exactly as it would be parsed from ASCII
+float cmdFromFixed(int32_t fixed, uint16_t scale);
+// The grid point that cmdFromFixed() turns back into exactly value; false if there is none
+bool cmdToFixed(float value, uint16_t scale, int32_t &fixed);
+
+// Result of Command::prepareLine()
+enum LineStatus {
+  LINE_EMPTY,           // Nothing left after removing comments and whitespace
+  LINE_READY,           // Normalized line is ready for handleGcodeLine()/debug commands
+  LINE_HANDLED,         // Protocol line consumed by the parser (M110)
+  LINE_CHECKSUM_ERROR,  // *checksum did not match; request a resend
+  LINE_NUMBER_ERROR     // N was not the expected line number; request a resend
+};
+
+// Result of Command::pollInput()
+enum InputStatus {
+  INPUT_NONE,   // Nothing complete yet
+  INPUT_LINE,   // ASCII line ready in getLine()
+  INPUT_FRAME,  // Binary frame ready for decodeFrame() (see binaryFrame.h)
+  INPUT_LINE_TOO_LONG  // Line longer than COMMAND_LINE_MAX; getLine() holds its first part
 };
 
 class Command {
 public:
   Command();
-  // Original method to handle G-code from serial buffer
-  bool handleGcode();
-  // New method to handle a single G-code line passed as a String
-  bool handleGcodeLine(const String &line);
+  // Non-blocking input assembler: drains the bytes the serial RX interrupt has
+  // already buffered and reports a completed ASCII line (terminator removed) once
+  // '\n' or '\r' arrives, or a complete binary frame. FRAME_SYNC starts a frame
+  // even in the middle of a line, since it never occurs in ASCII G-code.
+  // The input stays valid until the next call.
+  InputStatus pollInput();
+  char *getLine() { return lineBuffer; }
+  // True if a raw line starts with "N<digits>" (RepRap line number, see prepareLine)
+  static bool hasLineNumber(const char *line);
+  // Check the frame reported by pollInput() and its sequence number. FRAME_OK
+  // leaves the command in getCmd() (id FRAME_ID_SYNC for a sequence reset).
+  // After a CRC or sequence error, frames are dropped (FRAME_IGNORED) until the
+  // expected one arrives, so a burst of in-flight frames produces a single error.
+  FrameStatus decodeFrame();
+  // Sequence number to put in the reply to the last decoded frame
+  uint8_t getFrameSeq() const { return frameSeq; }
+  // Parse one normalized line (see prepareLine). Returns true for G, M and P (macro) commands.
+  bool handleGcodeLine(const char *line);
   Cmd getCmd() const;
-  // Modified parseLine to accept a const String&
-  void parseLine(const String &line);
+  void parseLine(const char *line);
+
+  // Normalize a raw line in place, without allocating:
+  //  - verifies and strips "*checksum" (XOR of all bytes before '*')
+  //  - verifies and strips a leading "N<line number>" (must be last + 1; M110 resets it);
+  //    numbered lines must carry a checksum
+  //  - removes ';' and '(...)' comments, uppercases, trims whitespace
+  LineStatus prepareLine(char *line);
+  long getLastLineNumber() const { return lastLineNumber; }
+
+  // Hand-written number parser: optional sign, digits, optional fraction.
+  // Returns the position after the number, or nullptr if there were no digits.
+  static const char *parseNumber(const char *p, float &value);
+  // Parse the "X.. Y.. Z.. E.. F.. T.. I.. J.. R.." words of a normalized line into cmd.
+  // Unknown words are skipped; missing values stay NAN.
+  static void parseArguments(const char *p, Cmd &cmd);
+
 private:
   Cmd currentCmd;
+  long lastLineNumber;
+  char lineBuffer[COMMAND_LINE_MAX + 1];  // Also holds a binary frame
+  uint8_t lineLength;
+  bool lineOverflow;        // Bytes of the current line were dropped
+  uint8_t frameLength;      // Size of the last complete frame
+  uint8_t frameRemaining;   // Bytes still missing from the frame being received (0 = line mode)
+  uint8_t frameSeq;
+  uint8_t expectedSeq;
+  bool frameRecovering;     // An error was reported; waiting for expectedSeq
 };
 
 #endif
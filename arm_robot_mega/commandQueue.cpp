@@ -0,0 +1,130 @@
+// commandQueue.cpp
+#include "commandQueue.h"
+#include <math.h>
+#include <string.h>
+
+struct CmdOpcode {
+  char id;
+  uint16_t num;
+};
+
+// Commands handled by executeCommand(), one opcode each. Order only matters within one build.
+static const CmdOpcode OPCODES[] PROGMEM = {
+  {'G', 0}, {'G', 1}, {'G', 2}, {'G', 3}, {'G', 4}, {'G', 28},
+  {'M', 3}, {'M', 5}, {'M', 8}, {'M', 9}, {'M', 17}, {'M', 18}, {'M', 92},
+  {'M', 106}, {'M', 107}, {'M', 155}, {'M', 206},
+  {'M', 500}, {'M', 501}, {'M', 502}, {'M', 503},
+  {'M', 665}, {'M', 666}, {'M', 870}, {'M', 910}, {'M', 930},
+  {'P', 1}, {'P', 2}, {'P', 3}
+};
+static const uint8_t OPCODE_COUNT = sizeof(OPCODES) / sizeof(OPCODES[0]);
+
+static const uint8_t BASE_MASK = (1 << FRAME_BASE_VALUE_COUNT) - 1;
+
+uint8_t packCmd(const Cmd &cmd, uint8_t *record) {
+  uint8_t length = 1;
+  uint8_t opcode = CMD_OPCODE_ESCAPE;
+  for (uint8_t i = 0; i < OPCODE_COUNT; i++) {
+    CmdOpcode entry;
+    memcpy_P(&entry, &OPCODES[i], sizeof(entry));
+    if (entry.id == cmd.id && entry.num == (uint16_t)cmd.num) {
+      opcode = i;
+      break;
+    }
+  }
+  record[length++] = opcode;
+  if (opcode == CMD_OPCODE_ESCAPE) {
+    record[length++] = cmd.id;
+    record[length++] = cmd.num & 0xFF;
+    record[length++] = (cmd.num >> 8) & 0xFF;
+  }
+
+  Cmd source = cmd;
+  int32_t fixed[FRAME_VALUE_COUNT];
+  uint16_t present = 0, raw = 0;
+  for (uint8_t i = 0; i < FRAME_VALUE_COUNT; i++) {
+    float value = *cmdValue(source, i);
+    if (isnan(value)) continue;
+    present |= 1 << i;
+    if (!cmdToFixed(value, cmdFixedScale(i), fixed[i])) raw |= 1 << i;
+  }
+  uint8_t flags = present & BASE_MASK;
+  uint8_t arc = (present >> FRAME_BASE_VALUE_COUNT) | ((raw >> FRAME_BASE_VALUE_COUNT) << 4);
+  if (raw & BASE_MASK) flags |= PACKED_PRESENT_RAW;
+  if (arc) flags |= PACKED_PRESENT_ARC;
+  record[length++] = flags;
+  if (raw & BASE_MASK) record[length++] = raw & BASE_MASK;
+  if (arc) record[length++] = arc;
+
+  for (uint8_t i = 0; i < FRAME_VALUE_COUNT; i++) {
+    if (!(present & (1 << i))) continue;
+    if (raw & (1 << i)) {
+      memcpy(&record[length], cmdValue(source, i), sizeof(float));
+      length += sizeof(float);
+    } else {
+      record[length++] = fixed[i] & 0xFF;
+      record[length++] = (fixed[i] >> 8) & 0xFF;
+      record[length++] = (fixed[i] >> 16) & 0xFF;
+    }
+  }
+  record[0] = length;
+  return length;
+}
+
+void unpackCmd(const uint8_t *record, Cmd &cmd) {
+  uint8_t index = 1;
+  uint8_t opcode = record[index++];
+  if (opcode == CMD_OPCODE_ESCAPE) {
+    cmd.id = record[index];
+    cmd.num = (int16_t)(record[index + 1] | (record[index + 2] << 8));
+    index += 3;
+  } else {
+    CmdOpcode entry;
+    memcpy_P(&entry, &OPCODES[opcode], sizeof(entry));
+    cmd.id = entry.id;
+    cmd.num = entry.num;
+  }
+
+  uint8_t flags = record[index++];
+  uint16_t present = flags & BASE_MASK;
+  uint16_t raw = (flags & PACKED_PRESENT_RAW) ? record[index++] : 0;
+  if (flags & PACKED_PRESENT_ARC) {
+    uint8_t arc = record[index++];
+    present |= (uint16_t)(arc & 0x07) << FRAME_BASE_VALUE_COUNT;
+    raw |= (uint16_t)((arc >> 4) & 0x07) << FRAME_BASE_VALUE_COUNT;
+  }
+  for (uint8_t i = 0; i < FRAME_VALUE_COUNT; i++) {
+    float *value = cmdValue(cmd, i);
+    if (!(present & (1 << i))) {
+      *value = NAN;
+    } else if (raw & (1 << i)) {
+      memcpy(value, &record[index], sizeof(float));
+      index += sizeof(float);
+    } else {
+      // Sign-extend the 24-bit value
+      int32_t fixed = (int32_t)((uint32_t)record[index] | ((uint32_t)record[index + 1] << 8) |
+                                ((uint32_t)record[index + 2] << 16) | (record[index + 2] & 0x80 ? 0xFF000000UL : 0));
+      *value = cmdFromFixed(fixed, cmdFixedScale(i));
+      index += 3;
+    }
+  }
+}
+
+bool CommandQueue::push(const Cmd &cmd) {
+  uint8_t record[PACKED_CMD_MAX_SIZE];
+  uint8_t length = packCmd(cmd, record);
+  if (bytes.freeSlots() < length) return false;
+  bytes.pushBulk(record, length);
+  pushed++;
+  return true;
+}
+
+bool CommandQueue::pop(Cmd &cmd) {
+  const uint8_t *length = bytes.peek();
+  if (!length) return false;
+  uint8_t record[PACKED_CMD_MAX_SIZE];
+  bytes.popBulk(record, *length);
+  unpackCmd(record, cmd);
+  popped++;
+  return true;
+}
@@ -0,0 +1,73 @@
+// commandQueue.h
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include "command.h"
+#include "ringBuffer.h"
+
+// Packed command record, as stored in CommandQueue:
+//   [length][opcode][id][num lo][num hi][present][raw mask][arc][values]
+//   length   size of the whole record, this byte included
+//   opcode   index into the opcode table (G0, G1, G4, M8, ...); CMD_OPCODE_ESCAPE for any
+//            other command, which is then followed by its id and 16-bit num
+//   present  bit i = value i (X, Y, Z, E, F, T) follows, in that order; bit 6 = arc byte
+//            follows; bit 7 = raw mask follows
+//   raw mask bits 0..5 as in present
+//   arc      G2/G3 words: bits 0..2 = I, J, R follow (after T), bits 4..6 = the same values raw
+//   values   little-endian 24-bit fixed point (X..F in 0.01 units, T in 0.001), or the raw
+//            4-byte float when the value's bit is set in the raw mask
+// A value is stored as fixed point only if unpacking gives back the exact same float, so
+// packing never changes a command. The unpacking arithmetic matches Command::parseNumber(),
+// which makes every parsed ASCII value with at most 2 decimals (3 for T) exact in fixed point;
+// anything else (more decimals, out of range) falls back to a raw float. Binary frames carry
+// the same fixed point (see binaryFrame.h), so their values are always on the grid.
+#define CMD_OPCODE_ESCAPE 0xFF
+#define PACKED_PRESENT_RAW 0x80
+#define PACKED_PRESENT_ARC 0x40
+#define PACKED_CMD_MAX_SIZE (1 + 1 + 3 + 1 + 1 + 1 + FRAME_VALUE_COUNT * 4)
+// Largest record without arc words (no arc byte, X..T raw)
+#define PACKED_CMD_BASE_MAX_SIZE (1 + 1 + 3 + 1 + 1 + FRAME_BASE_VALUE_COUNT * 4)
+
+// Bytes of SRAM for queued commands (RingBuffer, power of two). A typical "G1 X.. Y.. Z.."
+// packs into about 12 bytes, so this holds 30-50 of them against 16 unpacked Cmd before.
+#define COMMAND_QUEUE_BYTES 512
+
+// Pack cmd into record (at least PACKED_CMD_MAX_SIZE bytes). Returns the record length.
+uint8_t packCmd(const Cmd &cmd, uint8_t *record);
+// Decode a record written by packCmd(). Missing values become NAN.
+void unpackCmd(const uint8_t *record, Cmd &cmd);
+
+// Command queue holding packed records; commands are decoded only when they are popped
+// for execution. Producer and consumer must both run in loop() (16-bit ring indices).
+class CommandQueue {
+public:
+  CommandQueue() : pushed(0), popped(0) {}
+
+  // Returns false if the packed command does not fit
+  bool push(const Cmd &cmd);
+  // Decode and remove the oldest command. Returns false if the queue is empty.
+  bool pop(Cmd &cmd);
+
+  bool isEmpty() const { return bytes.isEmpty(); }
+  // Full = no room for a record of the largest size, so push() after !isFull() always succeeds
+  bool isFull() const { return bytes.freeSlots() < PACKED_CMD_MAX_SIZE; }
+  // Queued commands
+  uint8_t size() const { return (uint8_t)(pushed - popped); }
+  // Commands that are guaranteed to fit (the Q field of the ack): one record of any size,
+  // then records of up to PACKED_CMD_BASE_MAX_SIZE. 16 when empty; an arc costs at most one
+  // slot more than a line. 0 exactly when isFull().
+  uint8_t freeSlots() const {
+    uint16_t free = bytes.freeSlots();
+    if (free < PACKED_CMD_MAX_SIZE) return 0;
+    return 1 + (free - PACKED_CMD_MAX_SIZE) / PACKED_CMD_BASE_MAX_SIZE;
+  }
+  uint16_t freeBytes() const { return bytes.freeSlots(); }
+
+private:
+  RingBuffer<uint8_t, COMMAND_QUEUE_BYTES, uint16_t> bytes;
+  uint8_t pushed; // Written by the producer only
+  uint8_t popped; // Written by the consumer only
+};
+
+#endif
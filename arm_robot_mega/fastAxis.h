@@ -0,0 +1,56 @@
+// fastAxis.h
+#ifndef FAST_AXIS_H
+#define FAST_AXIS_H
+
+#include <Arduino.h>
+#include "RampsStepper.h"
+#include "fastGpio.h"
+
+// RampsStepper dengan pin dan arah homing yang ditetapkan saat kompilasi. Jalur ISR
+// (setStepDirection, stepPulseHigh, stepPulseLow) dan enable/limit memakai FastPin, sehingga
+// satu langkah menjadi beberapa instruksi register tanpa digitalWrite(). Fungsi ini
+// menyembunyikan (bukan menimpa) versi RampsStepper, jadi hanya terpakai lewat tipe FastAxis
+// sendiri, seperti di ISR StepEngine (robotAxes.h). Status limit datang
+// dari flag limitTripped (LimitSwitches), bukan dari pembacaan pin per langkah.
+// Logika arah dan limit sama dengan RampsStepper; dirHighToHome dan reverseDirection
+// dilipat compiler menjadi satu konstanta level pin per arah.
+template <uint8_t STEP_PIN, uint8_t DIR_PIN, uint8_t ENABLE_PIN, uint8_t LIMIT_PIN,
+          bool DIR_HIGH_TO_HOME, bool REVERSE_DIRECTION>
+class FastAxis final : public RampsStepper {
+public:
+  FastAxis() : RampsStepper(STEP_PIN, DIR_PIN, ENABLE_PIN, LIMIT_PIN, DIR_HIGH_TO_HOME, REVERSE_DIRECTION) {}
+
+  // LOW = ENABLE (A4988/DRV8825); dipanggil dari loop, jadi port H..L ditulis atomik
+  void enable(bool flag) { FastPin<ENABLE_PIN>::writeAtomic(!flag); }
+  void disable() { FastPin<ENABLE_PIN>::writeAtomic(HIGH); }
+  bool isLimitActive() const { return !FastPin<LIMIT_PIN>::read(); }
+
+  // Level pin arah untuk langkah positif (lihat RampsStepper::setStepDirection)
+  static constexpr bool positiveDirLevel = !DIR_HIGH_TO_HOME != REVERSE_DIRECTION;
+
+  void setStepDirection(bool positive) {
+    bool level = (positive == positiveDirLevel);
+    stepPositive = positive;
+    // Menuju limit = pin arah pada level dirHighToHome
+    stepTowardsLimit = (level == DIR_HIGH_TO_HOME);
+    FastPin<DIR_PIN>::write(level);
+  }
+
+  bool stepPulseHigh() {
+    if (stepTowardsLimit && limitTripped) {
+      limitHit = true;
+      return false;
+    }
+    FastPin<STEP_PIN>::high();
+    if (stepPositive) {
+      currentStep++;
+    } else {
+      currentStep--;
+    }
+    return true;
+  }
+
+  void stepPulseLow() { FastPin<STEP_PIN>::low(); }
+};
+
+#endif
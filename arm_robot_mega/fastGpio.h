@@ -0,0 +1,108 @@
+// fastGpio.h
+#ifndef FAST_GPIO_H
+#define FAST_GPIO_H
+
+#include <Arduino.h>
+
+// Akses GPIO dengan nomor pin Arduino Mega yang ditetapkan saat kompilasi. Port, bit, dan
+// alamat register dihitung oleh compiler, sehingga FastPin<46>::high() menjadi satu instruksi
+// tulis register, bukan digitalWrite() yang mencari tabel pin di flash, memeriksa timer PWM,
+// dan menyimpan SREG pada setiap panggilan.
+//
+// Port A..G berada di ruang I/O (alamat < 0x40): high()/low() menjadi sbi/cbi yang atomik.
+// Port H..L hanya dapat diakses lewat lds/sts (baca-ubah-tulis tiga instruksi). Di dalam ISR
+// itu aman; di luar ISR pakai writeAtomic(), yang mematikan interrupt untuk port tersebut.
+//
+// Build host (sim/): akses diteruskan ke HAL simulasi (simFastPinWrite/simFastPinRead), yang
+// menggerakkan model sumbu seperti digitalWrite() dan mencatat biaya instruksi/siklus AVR
+// operasi tersebut (lihat simHal.h).
+
+// Indeks port ATmega2560
+enum FastGpioPort : uint8_t {
+  FAST_PORT_A, FAST_PORT_B, FAST_PORT_C, FAST_PORT_D, FAST_PORT_E, FAST_PORT_F,
+  FAST_PORT_G, FAST_PORT_H, FAST_PORT_J, FAST_PORT_K, FAST_PORT_L
+};
+
+#define FAST_GPIO_PIN_COUNT 70
+#define FAST_GPIO_PIN(port, bit) (uint8_t)(((port) << 3) | (bit))
+
+// Alamat data-space register PINx tiap port; DDRx = PINx + 1, PORTx = PINx + 2
+static constexpr uint16_t FAST_GPIO_PIN_REGISTER[] = {
+  0x20, 0x23, 0x26, 0x29, 0x2C, 0x2F, 0x32, 0x100, 0x103, 0x106, 0x109
+};
+
+// Port dan bit pin Arduino Mega 0..69 (sama dengan variants/mega/pins_arduino.h)
+static constexpr uint8_t FAST_GPIO_PINS[FAST_GPIO_PIN_COUNT] = {
+  FAST_GPIO_PIN(FAST_PORT_E, 0), FAST_GPIO_PIN(FAST_PORT_E, 1), FAST_GPIO_PIN(FAST_PORT_E, 4), FAST_GPIO_PIN(FAST_PORT_E, 5), // 0-3
+  FAST_GPIO_PIN(FAST_PORT_G, 5), FAST_GPIO_PIN(FAST_PORT_E, 3), FAST_GPIO_PIN(FAST_PORT_H, 3), FAST_GPIO_PIN(FAST_PORT_H, 4), // 4-7
+  FAST_GPIO_PIN(FAST_PORT_H, 5), FAST_GPIO_PIN(FAST_PORT_H, 6), FAST_GPIO_PIN(FAST_PORT_B, 4), FAST_GPIO_PIN(FAST_PORT_B, 5), // 8-11
+  FAST_GPIO_PIN(FAST_PORT_B, 6), FAST_GPIO_PIN(FAST_PORT_B, 7), FAST_GPIO_PIN(FAST_PORT_J, 1), FAST_GPIO_PIN(FAST_PORT_J, 0), // 12-15
+  FAST_GPIO_PIN(FAST_PORT_H, 1), FAST_GPIO_PIN(FAST_PORT_H, 0), FAST_GPIO_PIN(FAST_PORT_D, 3), FAST_GPIO_PIN(FAST_PORT_D, 2), // 16-19
+  FAST_GPIO_PIN(FAST_PORT_D, 1), FAST_GPIO_PIN(FAST_PORT_D, 0), FAST_GPIO_PIN(FAST_PORT_A, 0), FAST_GPIO_PIN(FAST_PORT_A, 1), // 20-23
+  FAST_GPIO_PIN(FAST_PORT_A, 2), FAST_GPIO_PIN(FAST_PORT_A, 3), FAST_GPIO_PIN(FAST_PORT_A, 4), FAST_GPIO_PIN(FAST_PORT_A, 5), // 24-27
+  FAST_GPIO_PIN(FAST_PORT_A, 6), FAST_GPIO_PIN(FAST_PORT_A, 7), FAST_GPIO_PIN(FAST_PORT_C, 7), FAST_GPIO_PIN(FAST_PORT_C, 6), // 28-31
+  FAST_GPIO_PIN(FAST_PORT_C, 5), FAST_GPIO_PIN(FAST_PORT_C, 4), FAST_GPIO_PIN(FAST_PORT_C, 3), FAST_GPIO_PIN(FAST_PORT_C, 2), // 32-35
+  FAST_GPIO_PIN(FAST_PORT_C, 1), FAST_GPIO_PIN(FAST_PORT_C, 0), FAST_GPIO_PIN(FAST_PORT_D, 7), FAST_GPIO_PIN(FAST_PORT_G, 2), // 36-39
+  FAST_GPIO_PIN(FAST_PORT_G, 1), FAST_GPIO_PIN(FAST_PORT_G, 0), FAST_GPIO_PIN(FAST_PORT_L, 7), FAST_GPIO_PIN(FAST_PORT_L, 6), // 40-43
+  FAST_GPIO_PIN(FAST_PORT_L, 5), FAST_GPIO_PIN(FAST_PORT_L, 4), FAST_GPIO_PIN(FAST_PORT_L, 3), FAST_GPIO_PIN(FAST_PORT_L, 2), // 44-47
+  FAST_GPIO_PIN(FAST_PORT_L, 1), FAST_GPIO_PIN(FAST_PORT_L, 0), FAST_GPIO_PIN(FAST_PORT_B, 3), FAST_GPIO_PIN(FAST_PORT_B, 2), // 48-51
+  FAST_GPIO_PIN(FAST_PORT_B, 1), FAST_GPIO_PIN(FAST_PORT_B, 0), FAST_GPIO_PIN(FAST_PORT_F, 0), FAST_GPIO_PIN(FAST_PORT_F, 1), // 52-55
+  FAST_GPIO_PIN(FAST_PORT_F, 2), FAST_GPIO_PIN(FAST_PORT_F, 3), FAST_GPIO_PIN(FAST_PORT_F, 4), FAST_GPIO_PIN(FAST_PORT_F, 5), // 56-59
+  FAST_GPIO_PIN(FAST_PORT_F, 6), FAST_GPIO_PIN(FAST_PORT_F, 7), FAST_GPIO_PIN(FAST_PORT_K, 0), FAST_GPIO_PIN(FAST_PORT_K, 1), // 60-63
+  FAST_GPIO_PIN(FAST_PORT_K, 2), FAST_GPIO_PIN(FAST_PORT_K, 3), FAST_GPIO_PIN(FAST_PORT_K, 4), FAST_GPIO_PIN(FAST_PORT_K, 5), // 64-67
+  FAST_GPIO_PIN(FAST_PORT_K, 6), FAST_GPIO_PIN(FAST_PORT_K, 7)                                                                // 68-69
+};
+
+template <uint8_t PIN>
+class FastPin {
+  static_assert(PIN < FAST_GPIO_PIN_COUNT, "FastPin: bukan pin Arduino Mega");
+
+public:
+  static constexpr uint16_t pinRegister = FAST_GPIO_PIN_REGISTER[FAST_GPIO_PINS[PIN] >> 3];
+  static constexpr uint8_t mask = 1 << (FAST_GPIO_PINS[PIN] & 7);
+  // TRUE untuk port H..L (lds/sts, tidak atomik)
+  static constexpr bool extended = pinRegister >= 0x40;
+
+  // Instruksi dan siklus AVR tiap operasi, dipakai penghitung biaya di simulasi host:
+  // high()/low() = sbi/cbi (1 instruksi, 2 siklus) atau lds + ori/andi + sts (3, 5);
+  // write() dengan level runtime menambah cabang (2 instruksi, 3 siklus);
+  // read() = in/lds + andi (2 instruksi, 2 atau 3 siklus);
+  // writeAtomic() di port H..L menambah in SREG, cli, out SREG (3 instruksi, 3 siklus).
+  static constexpr uint8_t writeInstructions = extended ? 3 : 1;
+  static constexpr uint8_t writeCycles = extended ? 5 : 2;
+
+#if defined(__AVR__)
+  static void high() { port() |= mask; }
+  static void low() { port() &= (uint8_t)~mask; }
+  static void write(bool level) {
+    if (level) high();
+    else low();
+  }
+  static bool read() { return (input() & mask) != 0; }
+  // Untuk pemanggil di luar ISR (enable driver)
+  static void writeAtomic(bool level) {
+    if (!extended) {
+      write(level);
+      return;
+    }
+    uint8_t oldSREG = SREG;
+    cli();
+    write(level);
+    SREG = oldSREG;
+  }
+
+private:
+  static volatile uint8_t &input() { return *(volatile uint8_t *)pinRegister; }
+  static volatile uint8_t &port() { return *(volatile uint8_t *)(pinRegister + 2); }
+#else
+  static void high() { simFastPinWrite(PIN, HIGH, writeInstructions, writeCycles); }
+  static void low() { simFastPinWrite(PIN, LOW, writeInstructions, writeCycles); }
+  static void write(bool level) { simFastPinWrite(PIN, level ? HIGH : LOW, writeInstructions + 2, writeCycles + 3); }
+  static bool read() { return simFastPinRead(PIN, 2, extended ? 3 : 2) == HIGH; }
+  static void writeAtomic(bool level) {
+    simFastPinWrite(PIN, level ? HIGH : LOW, writeInstructions + 2 + (extended ? 3 : 0), writeCycles + 3 + (extended ? 3 : 0));
+  }
+#endif
+};
+
+#endif
@@ -0,0 +1,65 @@
+// fixedMath.cpp
+#include "fixedMath.h"
+
+// atan(i / 128) untuk i = 0..128, Q14 radian
+static const uint16_t ATAN_TABLE[129] PROGMEM = {
+  0, 128, 256, 384, 512, 640, 767, 895, 1023, 1150, 1277, 1405,
+  1532, 1658, 1785, 1911, 2037, 2163, 2289, 2414, 2539, 2664, 2789, 2913,
+  3037, 3160, 3283, 3406, 3528, 3650, 3772, 3893, 4014, 4134, 4254, 4373,
+  4492, 4610, 4728, 4846, 4962, 5079, 5195, 5310, 5425, 5539, 5653, 5766,
+  5878, 5990, 6101, 6212, 6322, 6432, 6541, 6649, 6757, 6864, 6971, 7076,
+  7182, 7286, 7390, 7494, 7596, 7698, 7800, 7901, 8001, 8100, 8199, 8297,
+  8395, 8492, 8588, 8684, 8779, 8873, 8967, 9060, 9152, 9244, 9335, 9425,
+  9515, 9604, 9693, 9781, 9868, 9954, 10040, 10126, 10210, 10295, 10378, 10461,
+  10543, 10625, 10706, 10786, 10866, 10945, 11024, 11102, 11179, 11256, 11332, 11408,
+  11483, 11557, 11631, 11705, 11777, 11850, 11921, 11992, 12063, 12133, 12202, 12271,
+  12340, 12407, 12475, 12542, 12608, 12674, 12739, 12804, 12868
+};
+
+uint16_t fxSqrt(uint32_t value) {
+  // Metode digit-per-digit (basis 4): hanya geser, tambah, dan bandingkan
+  uint32_t result = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value) bit >>= 2;
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  // Sisa > result berarti value >= (result + 0.5)^2: bulatkan ke atas
+  if (value > result) result++;
+  return (uint16_t)result;
+}
+
+long fxAcosRatio(long num, long den) {
+  if (num > den) num = den;
+  if (num < -den) num = -den;
+  uint16_t sinHalf = fxSqrt((uint32_t)(den - num));
+  uint16_t cosHalf = fxSqrt((uint32_t)(den + num));
+  return 2 * fxAtan2(sinHalf, cosHalf);
+}
+
+long fxAtan2(long y, long x) {
+  if (x == 0 && y == 0) return 0;
+  long ax = (x < 0) ? -x : x;
+  long ay = (y < 0) ? -y : y;
+
+  // Reduksi ke oktan pertama: atan(t) dengan 0 <= t <= 1
+  bool swapped = ay > ax;
+  long t = swapped ? (ax << FX_ANGLE_SHIFT) / ay : (ay << FX_ANGLE_SHIFT) / ax;
+  uint8_t index = t >> 7;
+  long angle = pgm_read_word(&ATAN_TABLE[index]);
+  if (index < 128) {
+    long next = pgm_read_word(&ATAN_TABLE[index + 1]);
+    angle += ((next - angle) * (t & 127)) >> 7;
+  }
+
+  if (swapped) angle = FX_HALF_PI - angle;
+  if (x < 0) angle = FX_PI - angle;
+  if (y < 0) angle = -angle;
+  return angle;
+}
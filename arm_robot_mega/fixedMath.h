@@ -0,0 +1,52 @@
+// fixedMath.h
+#ifndef FIXED_MATH_H
+#define FIXED_MATH_H
+
+#include <Arduino.h>
+
+// Aritmetika fixed-point untuk backend IK tanpa FPU (ATmega2560).
+// Panjang: Q6 (1/64 mm), sehingga kuadrat jarak hingga ~1000 mm masih muat di uint32.
+// Sudut dan rasio: Q14 (1.0 = 16384), sudut dalam radian.
+#define FX_LENGTH_SHIFT 6
+#define FX_ANGLE_SHIFT 14
+#define FX_ONE (1L << FX_ANGLE_SHIFT)
+#define FX_PI 51472L      // pi * 16384
+#define FX_HALF_PI 25736L // pi/2 * 16384
+
+// Konversi float <-> fixed-point
+inline long fxFromMm(float mm) { return (long)lround(mm * (1 << FX_LENGTH_SHIFT)); }
+inline float fxAngleToFloat(long angle) { return angle * (1.0f / FX_ONE); }
+inline long fxAngleFromFloat(float rad) { return (long)lround(rad * FX_ONE); }
+
+// Batas |panjang| (mm) untuk fxSquare()/fxSquareSum(). Panjang link yang diterima backend
+// fixed-point diperiksa RobotGeometry::fixedIkSupports().
+#define FX_LENGTH_MAX_MM 1024.0
+
+// Kuadrat panjang Q6 sebagai Q12 tanpa overflow untuk |value| < 1024 mm
+inline uint32_t fxSquare(long value) {
+  uint32_t magnitude = (value < 0) ? -value : value;
+  return magnitude * magnitude;
+}
+
+// Jumlah dua kuadrat Q12, jenuh di 65535^2 (akar ~1024 mm) alih-alih wrap ke bilangan kecil.
+// Tiap |value| tetap harus < 1024 mm.
+#define FX_SQUARE_SUM_MAX 0xFFFE0001UL
+inline uint32_t fxSquareSum(long a, long b) {
+  uint32_t sa = fxSquare(a), sb = fxSquare(b);
+  return (sa > FX_SQUARE_SUM_MAX - sb) ? FX_SQUARE_SUM_MAX : sa + sb;
+}
+
+// Akar kuadrat bilangan bulat, dibulatkan ke terdekat
+uint16_t fxSqrt(uint32_t value);
+
+// acos(num / den) untuk den > 0 (num dibatasi ke [-den, den]), hasil Q14 radian.
+// Memakai identitas setengah sudut acos(c) = 2 atan2(sqrt(1 - c), sqrt(1 + c)) langsung
+// pada num dan den, sehingga rasio tidak dikuantisasi ke Q14 dulu. Ini penting di dekat
+// c = +-1, tempat turunan acos tak terhingga. num + den harus muat di uint32.
+long fxAcosRatio(long num, long den);
+
+// atan2(y, x) untuk |x|, |y| < 2^17, hasil Q14 radian dalam [-pi, pi].
+// Tabel atan 129 titik di PROGMEM dengan interpolasi linier.
+long fxAtan2(long y, long x);
+
+#endif
@@ -1 +1,93 @@
+// gripper.cpp
+#include "gripper.h"
+#include "fastGpio.h"
+#include "pinout.h"
 
+// Gripper yang dilayani ISR timer
+static Gripper* activeGripper = nullptr;
+
+#if defined(__AVR__)
+ISR(TIMER3_COMPA_vect) {
+  OCR3A = activeGripper->isr();
+}
+#else
+uint16_t gripperTimerIsr() {
+  if (activeGripper == nullptr) return GRIPPER_IDLE_INTERVAL;
+  return activeGripper->isr();
+}
+#endif
+
+// Level pin 1..4 untuk setiap fase (urutan 4 kawat library Stepper Arduino)
+static const uint8_t PHASE_PATTERN[4] = {0b1010, 0b0110, 0b0101, 0b1001};
+
+Gripper::Gripper() {
+  remaining = 0;
+  position = 0;
+  phase = 0;
+  stepInterval = GRIPPER_IDLE_INTERVAL;
+  setSpeed(GRIPPER_DEFAULT_RPM);
+}
+
+void Gripper::begin() {
+  pinMode(GRIPPER_PIN0, OUTPUT);
+  pinMode(GRIPPER_PIN1, OUTPUT);
+  pinMode(GRIPPER_PIN2, OUTPUT);
+  pinMode(GRIPPER_PIN3, OUTPUT);
+  activeGripper = this;
+
+#if defined(__AVR__)
+  // Timer3 mode CTC (reset pada OCR3A), prescaler 8 -> 2 MHz
+  noInterrupts();
+  TCCR3A = 0;
+  TCCR3B = (1 << WGM32) | (1 << CS31);
+  TCNT3 = 0;
+  OCR3A = GRIPPER_IDLE_INTERVAL;
+  TIMSK3 |= (1 << OCIE3A);
+  interrupts();
+#endif
+}
+
+void Gripper::setSpeed(long rpm) {
+  if (rpm <= 0) return;
+  unsigned long interval = GRIPPER_TIMER_FREQ * 60UL / GRIPPER_STEPS_PER_REV / rpm;
+  stepInterval = (interval > 0xFFFF) ? 0xFFFF : (interval < 16 ? 16 : (uint16_t)interval);
+}
+
+bool Gripper::isMoving() const {
+  noInterrupts();
+  bool moving = remaining != 0;
+  interrupts();
+  return moving;
+}
+
+long Gripper::getPosition() const {
+  noInterrupts();
+  long value = position;
+  interrupts();
+  return value;
+}
+
+// Di ISR Timer3: empat tulis register (port G, F, K) ~1.6 us, bukan empat digitalWrite()
+// (~15 us) yang menunda ISR step generator dan menambah jitter langkah lengan
+void Gripper::writePhase() {
+  uint8_t pattern = PHASE_PATTERN[phase];
+  FastPin<GRIPPER_PIN0>::write(pattern & 0b1000);
+  FastPin<GRIPPER_PIN1>::write(pattern & 0b0100);
+  FastPin<GRIPPER_PIN2>::write(pattern & 0b0010);
+  FastPin<GRIPPER_PIN3>::write(pattern & 0b0001);
+}
+
+uint16_t Gripper::isr() {
+  if (remaining == 0) return GRIPPER_IDLE_INTERVAL;
+  if (remaining > 0) {
+    phase = (phase + 1) & 3;
+    remaining--;
+    position++;
+  } else {
+    phase = (phase - 1) & 3;
+    remaining++;
+    position--;
+  }
+  writePhase();
+  return stepInterval;
+}
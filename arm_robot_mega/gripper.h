@@ -1,10 +1,53 @@
+// gripper.h
+#ifndef GRIPPER_H
+#define GRIPPER_H
+
 #include <Arduino.h>
 
+// Gripper: motor stepper 4 kawat dengan urutan full-step yang sama seperti library
+// Stepper Arduino, tetapi langkahnya dibangkitkan ISR Timer3 sehingga move() langsung
+// kembali. Gripper dapat bergerak bersamaan dengan lengan dan loop() tidak tertahan.
+// Pin koil GRIPPER_PIN0..3 (pinout.h) ditetapkan saat kompilasi dan ditulis lewat FastPin.
+#define GRIPPER_STEPS_PER_REV 2400
+// Kecepatan default (rpm) dan jumlah langkah M3/M5 tanpa T
+#define GRIPPER_DEFAULT_RPM 200
+#define GRIPPER_DEFAULT_STEPS 1000
+// Timer3 dengan prescaler 8 pada 16 MHz = 2 MHz, sama seperti Timer1 step engine
+#define GRIPPER_TIMER_FREQ 2000000UL
+// Interval ISR saat gripper diam (tick)
+#define GRIPPER_IDLE_INTERVAL 1000
+
+class Gripper {
+public:
+  Gripper();
+
+  // Atur pin dan mulai timer interrupt
+  void begin();
+  void setSpeed(long rpm);
+
+  // Tambahkan langkah relatif (positif = menutup, seperti M3) ke gerakan yang sedang
+  // berjalan. Dipanggil dari aksi blok StepEngine, yaitu di dalam ISR step generator
+  // saat interrupt sudah mati; dari loop harus diapit noInterrupts()/interrupts().
+  void move(long steps) { remaining += steps; }
+  bool isMoving() const;
+  long getPosition() const;
+
+  // Satu langkah gripper. Dipanggil dari ISR Timer3 (atau timer simulasi di host).
+  // Mengembalikan interval sampai langkah berikutnya, dalam tick timer.
+  uint16_t isr();
+
+private:
+  volatile long remaining;  // Sisa langkah; tanda = arah
+  volatile long position;
+  uint8_t phase;            // Fase koil 0..3
+  uint16_t stepInterval;    // Tick per langkah
+
+  void writePhase();
+};
 
-void gripperOpen(int i = 1000) {
-  stepper.step(i);
-}
+#if !defined(__AVR__)
+// Build host (sim/): jam virtual memanggil fungsi ini sebagai pengganti ISR Timer3.
+uint16_t gripperTimerIsr();
+#endif
 
-void gripperClose(int i = 1000) {
-  stepper.step(-i);
-}
+#endif
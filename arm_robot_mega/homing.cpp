@@ -0,0 +1,196 @@
+// homing.cpp
+#include "homing.h"
+
+static const char* const AXIS_NAMES[STEP_ENGINE_AXES] = {"Base", "Shoulder", "Elbow", "Slider"};
+
+Homing::Homing() {
+  engine = nullptr;
+  planner = nullptr;
+  limits = nullptr;
+  lastDuration = 0;
+  referenceValid = 0;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    reference[i] = 0;
+    stats[i].seekToTouch = 0;
+    stats[i].drift = 0;
+    stats[i].driftMin = 0;
+    stats[i].driftMax = 0;
+    stats[i].samples = 0;
+  }
+}
+
+void Homing::begin(StepEngine* aEngine, Planner* aPlanner, LimitSwitches* aLimits) {
+  engine = aEngine;
+  planner = aPlanner;
+  limits = aLimits;
+}
+
+bool Homing::home(const uint8_t* groups, uint8_t groupCount) {
+  unsigned long start = millis();
+  bool ok = true;
+  for (uint8_t g = 0; g < groupCount && ok; g++) {
+    Serial.print("→ Homing ");
+    printAxes(groups[g]);
+    Serial.println("...");
+    ok = homeGroup(groups[g]);
+  }
+  lastDuration = millis() - start;
+  return ok;
+}
+
+bool Homing::homeGroup(uint8_t mask) {
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    if (mask & (1 << i)) engine->getAxis(i)->enable(true);
+  }
+  delay(10); // Memberi waktu driver untuk aktif
+
+  // Sumbu yang sudah berada di switch dilepas dulu agar seek selalu mendekat dari luar
+  uint8_t active = activeLimits(mask);
+  if (active && moveUntil(active, HOMING_RELEASE_MAX, HOMING_PULLOFF_RATE, STOP_AT_RELEASE) != active) {
+    Serial.print("ERROR: Tidak dapat bergerak menjauh dari limit switch: ");
+    printAxes(active & activeLimits(active));
+    Serial.println();
+    return false;
+  }
+
+  // Seek cepat: setiap sumbu berhenti di switch-nya, blok dibuang begitu semua sumbu tiba
+  uint8_t reached = moveUntil(mask, -HOMING_MAX_TRAVEL, HOMING_SEEK_RATE, STOP_AT_LIMIT);
+  if (reached != mask) {
+    Serial.print("ERROR: Limit switch tidak tercapai: ");
+    printAxes(mask & ~reached);
+    Serial.println();
+    return false;
+  }
+  long seekPosition[STEP_ENGINE_AXES];
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) seekPosition[i] = engine->getAxis(i)->getPosition();
+
+  // Mundur, lalu pastikan semua switch lepas (switch dengan histeresis besar)
+  moveUntil(mask, HOMING_PULLOFF_STEPS, HOMING_PULLOFF_RATE, STOP_NONE);
+  active = activeLimits(mask);
+  if (active && moveUntil(active, HOMING_RELEASE_MAX, HOMING_PULLOFF_RATE, STOP_AT_RELEASE) != active) {
+    Serial.print("ERROR: Tidak dapat bergerak menjauh dari limit switch: ");
+    printAxes(active & activeLimits(active));
+    Serial.println();
+    return false;
+  }
+
+  // Sentuh ulang pelan: jarak cukup untuk kembali ke titik picu seek, plus cadangan
+  long touchDistance = 0;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    if (!(mask & (1 << i))) continue;
+    long distance = engine->getAxis(i)->getPosition() - seekPosition[i];
+    if (distance > touchDistance) touchDistance = distance;
+  }
+  reached = moveUntil(mask, -(touchDistance + HOMING_PULLOFF_STEPS), HOMING_TOUCH_RATE, STOP_AT_LIMIT);
+  if (reached != mask) {
+    Serial.print("ERROR: Limit switch tidak tercapai saat sentuhan pelan: ");
+    printAxes(mask & ~reached);
+    Serial.println();
+    return false;
+  }
+
+  // Titik sentuhan pelan adalah titik referensi home fisik
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    if (!(mask & (1 << i))) continue;
+    RampsStepper* axis = engine->getAxis(i);
+    long touch = axis->getPosition();
+    HomingAxisStats& s = stats[i];
+    s.seekToTouch = touch - seekPosition[i];
+    if (referenceValid & (1 << i)) {
+      s.drift = touch - reference[i];
+      if (s.samples == 0 || s.drift < s.driftMin) s.driftMin = s.drift;
+      if (s.samples == 0 || s.drift > s.driftMax) s.driftMax = s.drift;
+      if (s.samples < 255) s.samples++;
+    }
+    axis->setPosition(0);
+    reference[i] = 0;
+    referenceValid |= (1 << i);
+  }
+
+  // Mundur sampai switch lepas agar tidak terus menekan switch. Seperti back-off
+  // lama, titik lepas menjadi 0 langkah; kalibrasi J0 dan offset kinematik diukur dari sini.
+  uint8_t released = moveUntil(mask, HOMING_RELEASE_MAX, HOMING_PULLOFF_RATE, STOP_AT_RELEASE);
+  if (released != mask) {
+    Serial.print("ERROR: Tidak dapat bergerak menjauh dari limit switch: ");
+    printAxes(mask & ~released);
+    Serial.println();
+    return false;
+  }
+  zeroAxes(mask);
+  return true;
+}
+
+// Gerakkan sumbu dalam mask sejauh distance langkah (negatif = menuju limit) dalam satu
+// blok planner. Mengembalikan bit sumbu yang memenuhi kondisi stop; blok dibuang begitu
+// semua sumbu memenuhinya.
+uint8_t Homing::moveUntil(uint8_t mask, long distance, float rate, StopCondition stop) {
+  long target[STEP_ENGINE_AXES];
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    RampsStepper* axis = engine->getAxis(i);
+    axis->consumeLimitHit(); // Flag lama tidak boleh menghentikan blok ini
+    target[i] = axis->getPlannedPosition() + ((mask & (1 << i)) ? distance : 0);
+  }
+  planner->bufferMove(target, labs(distance) / rate);
+
+  uint8_t reached = 0;
+  while (true) {
+    bool busy = engine->isBusy();
+    if (stop == STOP_AT_LIMIT) reached = activeLimits(mask);
+    else if (stop == STOP_AT_RELEASE) reached |= mask & ~activeLimits(mask);
+    if (stop != STOP_NONE && reached == mask) {
+      engine->flush();
+      break;
+    }
+    if (!busy) break;
+    yield(); // Hook Arduino untuk busy-wait (juga memajukan jam virtual di simulasi host)
+  }
+
+  // Langkah yang diblokir switch sudah ditangani di sini, bukan oleh Planner::update()
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    engine->getAxis(i)->consumeLimitHit();
+    engine->getAxis(i)->syncTargetToPosition();
+  }
+  return reached;
+}
+
+uint8_t Homing::activeLimits(uint8_t mask) {
+  // Loop homing tidak melewati loop(), jadi pelepasan yang tertunda debounce diselesaikan di sini
+  limits->update();
+  return limits->getTrippedMask() & mask;
+}
+
+void Homing::zeroAxes(uint8_t mask) {
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    if (!(mask & (1 << i))) continue;
+    RampsStepper* axis = engine->getAxis(i);
+    reference[i] -= axis->getPosition();
+    axis->setPosition(0);
+  }
+}
+
+void Homing::report() {
+  Serial.print("Homing: "); Serial.print(lastDuration); Serial.println(" ms");
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    const HomingAxisStats& s = stats[i];
+    Serial.print("  "); Serial.print(AXIS_NAMES[i]);
+    Serial.print(": seek-touch="); Serial.print(s.seekToTouch);
+    if (s.samples > 0) {
+      Serial.print(" drift="); Serial.print(s.drift);
+      Serial.print(" min/max="); Serial.print(s.driftMin);
+      Serial.print("/"); Serial.print(s.driftMax);
+      Serial.print(" n="); Serial.println(s.samples);
+    } else {
+      Serial.println(" drift=-");
+    }
+  }
+}
+
+void Homing::printAxes(uint8_t mask) {
+  bool first = true;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    if (!(mask & (1 << i))) continue;
+    if (!first) Serial.print("+");
+    Serial.print(AXIS_NAMES[i]);
+    first = false;
+  }
+}
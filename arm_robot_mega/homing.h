@@ -0,0 +1,83 @@
+// homing.h
+#ifndef HOMING_H
+#define HOMING_H
+
+#include <Arduino.h>
+#include "stepEngine.h"
+#include "planner.h"
+#include "limitSwitch.h"
+
+// Bit sumbu untuk kelompok homing, sesuai urutan sumbu StepEngine
+#define HOMING_BASE     (1 << 0)
+#define HOMING_SHOULDER (1 << 1)
+#define HOMING_ELBOW    (1 << 2)
+#define HOMING_SLIDER   (1 << 3)
+
+// Kecepatan dalam langkah/s. Seek cepat (dengan akselerasi planner) berhenti seketika saat
+// switch aktif, sehingga posisinya hanya perkiraan; titik referensi diambil dari sentuhan
+// ulang pelan setelah mundur HOMING_PULLOFF_STEPS. Mundur memakai kecepatan di bawah jerk
+// sumbu agar dapat dimulai dan dihentikan tanpa rampa.
+#define HOMING_SEEK_RATE 10000.0
+#define HOMING_PULLOFF_RATE 2500.0
+#define HOMING_TOUCH_RATE 500.0
+#define HOMING_PULLOFF_STEPS 200
+// Jarak maksimum seek (lebih dari satu putaran sendi 10:1) dan mundur dari switch
+#define HOMING_MAX_TRAVEL 48000L
+#define HOMING_RELEASE_MAX 5000L
+
+// Statistik per sumbu. drift adalah posisi sentuhan pelan relatif terhadap titik home
+// sebelumnya (langkah) dan hanya berarti jika posisi tidak hilang di antara dua homing.
+struct HomingAxisStats {
+  long seekToTouch;        // Selisih titik picu seek cepat dan sentuhan pelan
+  long drift;              // Drift homing terakhir
+  long driftMin, driftMax; // Rentang drift sejak referensi pertama
+  uint8_t samples;         // Jumlah drift yang tercatat
+};
+
+// Homing semua sumbu melalui StepEngine. Sumbu dalam satu kelompok bergerak bersamaan
+// dalam satu blok; tiap sumbu berhenti sendiri di switch-nya karena ISR memblokir langkah
+// menuju limit yang aktif (RampsStepper::stepPulseHigh), sedangkan sumbu lain terus
+// bergerak. Kelompok berikutnya mulai setelah kelompok sebelumnya selesai.
+//
+// Per kelompok: lepas dari switch yang sudah aktif, seek cepat, mundur, sentuh ulang pelan
+// (titik referensi), lalu mundur sampai switch lepas (posisi 0 langkah, seperti
+// back-off lama).
+class Homing {
+public:
+  Homing();
+  void begin(StepEngine* engine, Planner* planner, LimitSwitches* limits);
+
+  // Jalankan homing untuk setiap kelompok secara berurutan. Mengembalikan false jika
+  // sebuah sumbu tidak mencapai atau tidak dapat lepas dari switch-nya.
+  bool home(const uint8_t* groups, uint8_t groupCount);
+
+  // Jadikan posisi saat ini 0 langkah untuk sumbu dalam mask (setelah gerakan kalibrasi),
+  // dengan tetap mengingat letak switch dalam koordinat baru untuk drift berikutnya
+  void zeroAxes(uint8_t mask = HOMING_BASE | HOMING_SHOULDER | HOMING_ELBOW | HOMING_SLIDER);
+  // Posisi tidak lagi dapat dipercaya (mis. driver dimatikan): drift berikutnya tidak dicatat
+  void clearReference() { referenceValid = 0; }
+
+  unsigned long getLastDuration() const { return lastDuration; }
+  const HomingAxisStats& getStats(uint8_t axis) const { return stats[axis]; }
+  // Cetak durasi homing terakhir dan statistik setiap sumbu ke Serial
+  void report();
+
+private:
+  StepEngine* engine;
+  Planner* planner;
+  LimitSwitches* limits;
+  unsigned long lastDuration; // ms
+  HomingAxisStats stats[STEP_ENGINE_AXES];
+  long reference[STEP_ENGINE_AXES]; // Posisi switch dalam koordinat langkah saat ini
+  uint8_t referenceValid;           // Bit sumbu yang reference-nya berlaku
+
+  // Kapan moveUntil() berhenti sebelum jaraknya habis
+  enum StopCondition : uint8_t { STOP_NONE, STOP_AT_LIMIT, STOP_AT_RELEASE };
+
+  bool homeGroup(uint8_t mask);
+  uint8_t moveUntil(uint8_t mask, long distance, float rate, StopCondition stop);
+  uint8_t activeLimits(uint8_t mask); // Flag terpicu (LimitSwitches), bukan level pin
+  void printAxes(uint8_t mask);
+};
+
+#endif
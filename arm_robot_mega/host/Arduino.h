@@ -0,0 +1,34 @@
+// Arduino.h (pustaka host)
+// Pengganti Arduino core minimal untuk membangun robotGeometry.cpp dan fixedMath.cpp sebagai
+// pustaka PC (armReach.h). Berbeda dengan sim/Arduino.h tidak ada jam virtual atau HAL:
+// hanya makro matematika, PROGMEM, dan Serial yang membuang output debug geometri.
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DEC 10
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+
+#define radians(deg) ((deg) * M_PI / 180.0)
+#define degrees(rad) ((rad) * 180.0 / M_PI)
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+class HostSerial {
+public:
+  template <typename T> size_t print(const T&) { return 0; }
+  template <typename T> size_t print(const T&, int) { return 0; }
+  size_t println() { return 0; }
+  template <typename T> size_t println(const T&) { return 0; }
+  template <typename T> size_t println(const T&, int) { return 0; }
+};
+
+static HostSerial Serial __attribute__((unused)); // Tidak semua unit memakai output debug
+
+#endif
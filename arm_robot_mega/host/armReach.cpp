@@ -0,0 +1,51 @@
+// armReach.cpp
+#include "armReach.h"
+#include <Arduino.h>
+#include "robotGeometry.h"
+
+void armReachDefaults(ArmReachConfig* config) {
+  config->l1 = RobotGeometry::DEFAULT_L1;
+  config->l2 = RobotGeometry::DEFAULT_L2;
+  config->l3 = RobotGeometry::DEFAULT_L3;
+  config->eeForward = RobotGeometry::DEFAULT_EE_FORWARD_OFFSET_MM;
+  config->eeDown = RobotGeometry::DEFAULT_EE_DOWN_OFFSET_MM;
+  config->zeroDeg[0] = 90.0;
+  config->zeroDeg[1] = -14.00;
+  config->zeroDeg[2] = -91.77;
+  // Sisi limit switch: Base (rasio gigi negatif) maksimum -J0 kalibrasi (165 derajat),
+  // Shoulder/Elbow minimum 0 (titik lepas switch saat homing)
+  config->jointMinDeg[0] = -INFINITY;
+  config->jointMaxDeg[0] = 165.0;
+  for (int i = 1; i < GEOMETRY_JOINTS; i++) {
+    config->jointMinDeg[i] = 0.0;
+    config->jointMaxDeg[i] = INFINITY;
+  }
+  config->sliderMm = 0.0;
+  config->elbowDown = 1; // setup(): setUseElbowDownSolution(true)
+}
+
+int32_t armReachCheck(const ArmReachConfig* config, const float* points, int32_t count,
+                      uint8_t* status, float* jointsDeg) {
+  RobotGeometry geom;
+  geom.setLinkLengths(config->l1, config->l2, config->l3, config->eeForward, config->eeDown);
+  geom.setKinematicZeroOffsets(radians(config->zeroDeg[0]), radians(config->zeroDeg[1]),
+                               radians(config->zeroDeg[2]));
+  for (uint8_t i = 0; i < GEOMETRY_JOINTS; i++) {
+    geom.setJointLimits(i, radians(config->jointMinDeg[i]), radians(config->jointMaxDeg[i]));
+  }
+  geom.setUseElbowDownSolution(config->elbowDown != 0);
+
+  int32_t reachable = 0;
+  for (int32_t i = 0; i < count; i++) {
+    const float* p = points + 3 * i;
+    geom.setPositionCartesianOffset(p[0] - config->sliderMm, p[1], p[2]);
+    status[i] = geom.getReachStatus();
+    if (status[i] == REACH_OK) reachable++;
+    if (jointsDeg) {
+      jointsDeg[3 * i] = degrees(geom.getBaseRad());
+      jointsDeg[3 * i + 1] = degrees(geom.getShoulderRad());
+      jointsDeg[3 * i + 2] = degrees(geom.getElbowRad());
+    }
+  }
+  return reachable;
+}
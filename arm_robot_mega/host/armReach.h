@@ -0,0 +1,41 @@
+// armReach.h
+// Uji jangkauan dan batas sendi untuk PC (mis. pipeline vision), dibangun dari
+// robotGeometry.cpp yang sama dengan firmware sehingga hasilnya sama dengan M870 dan
+// dengan penolakan G0/G1. API C agar dapat dipanggil dari Python (python/arm_reach.py, ctypes).
+//
+// Bangun: arm_robot_mega/host/build.sh (menghasilkan libarmreach.so)
+#ifndef ARM_REACH_H
+#define ARM_REACH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Parameter geometri, sama dengan kalibrasi firmware (M503). Sudut dalam derajat.
+typedef struct {
+  float l1, l2, l3;            // Panjang link (M665)
+  float eeForward, eeDown;     // Offset end-effector (M666)
+  float zeroDeg[3];            // Sudut nol kinematik Base/Shoulder/Elbow (M206 X/Y/Z)
+  float jointMinDeg[3];        // Batas sendi dari '0 langkah' stepper; -INFINITY/INFINITY = bebas
+  float jointMaxDeg[3];
+  float sliderMm;              // Posisi slider; target X untuk IK = x - sliderMm
+  int32_t elbowDown;           // 1 = solusi Elbow Down (default firmware), 0 = Elbow Up
+} ArmReachConfig;
+
+// Nilai bawaan firmware (CalibrationStore::defaults() dan batas sendi dari applyCalibration())
+void armReachDefaults(ArmReachConfig* config);
+
+// Uji count titik (x, y, z berurutan, mm). status[i] berisi ReachStatus (robotGeometry.h:
+// 0 OK, 1 TOO_FAR, 2 TOO_CLOSE, 3 JOINT_LIMIT). Jika jointsDeg tidak NULL, sudut sendi
+// Base/Shoulder/Elbow titik ke-i ditulis ke jointsDeg[3*i..3*i+2] (NaN jika tidak terjangkau).
+// Mengembalikan jumlah titik yang terjangkau.
+int32_t armReachCheck(const ArmReachConfig* config, const float* points, int32_t count,
+                      uint8_t* status, float* jointsDeg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,13 @@
+#!/bin/sh
+# build.sh [OUT_FILE] [flag g++ tambahan...]
+# Bangun pustaka uji jangkauan (armReach.h) untuk PC dari sumber geometri firmware.
+# Contoh: arm_robot_mega/host/build.sh libarmreach.so -DIK_BACKEND=IK_BACKEND_FIXED
+set -e
+HERE=$(cd "$(dirname "$0")" && pwd)
+FW="$HERE/.."
+OUT=${1:-libarmreach.so}
+[ $# -gt 0 ] && shift
+
+g++ -std=gnu++11 -fpermissive -Wall -Wextra -O2 -shared -fPIC "$@" -I"$HERE" -I"$FW" \
+    "$HERE/armReach.cpp" "$FW/robotGeometry.cpp" "$FW/fixedMath.cpp" -o "$OUT"
+echo "$OUT"
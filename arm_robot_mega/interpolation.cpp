@@ -1,5 +1,6 @@
 // interpolation.cpp
 #include "interpolation.h"
+#include "profile.h"
 #include <math.h> // Untuk sqrt, pow
 
 Interpolation::Interpolation() {
@@ -7,9 +8,34 @@ Interpolation::Interpolation() {
     targetX = targetY = targetZ = targetE = 0.0;
     currentX = currentY = currentZ = currentE = 0.0;
     feedRate = 0.0;
-    startTime = 0;
     totalDistance = 0.0;
+    segmentLength = 0.0;
+    segmentDuration = 0.0;
+    segmentCount = 0;
+    segmentIndex = 0;
     finished = true; // Awalnya dianggap selesai
+    arc = false;
+    centerX = centerY = 0.0;
+    startRadiusX = startRadiusY = 0.0;
+    radiusX = radiusY = 0.0;
+    angleStep = 0.0;
+    cosStep = 1.0;
+    sinStep = 0.0;
+}
+
+// Bagi lintasan sepanjang distance menjadi sub-segmen yang sama panjang, masing-masing
+// <= INTERPOLATION_SEGMENT_MS pada feedrate yang diminta, dan paling sedikit minimumSegments
+void Interpolation::setSegments(float distance, float minimumSegments) {
+    totalDistance = distance;
+    float totalDuration = totalDistance / (feedRate / 60.0); // detik
+    float count = ceil(totalDuration * 1000.0 / INTERPOLATION_SEGMENT_MS);
+    if (count < minimumSegments) count = minimumSegments;
+    segmentCount = (unsigned long)count;
+    if (segmentCount < 1) segmentCount = 1;
+    segmentLength = totalDistance / segmentCount;
+    segmentDuration = totalDuration / segmentCount;
+    segmentIndex = 0;
+    finished = false;
 }
 
 // Mengatur posisi target untuk interpolasi
@@ -32,10 +58,8 @@ void Interpolation::setInterpolation(float tx, float ty, float tz, float te, flo
     float dz = targetZ - startZ;
     float de = targetE - startE; // Untuk slider
 
-    totalDistance = sqrt(dx*dx + dy*dy + dz*dz + de*de); // Jarak Euclidean di ruang 4D (XYZ + E)
-
-    startTime = millis();
-    finished = false;
+    arc = false;
+    setSegments(sqrt(dx*dx + dy*dy + dz*dz + de*de), 1); // Jarak Euclidean di ruang 4D (XYZ + E)
 
     // Jika jaraknya sangat kecil, anggap sudah selesai
     if (totalDistance < 0.001) { // Threshold kecil untuk menghindari pembagian nol atau gerakan mikro
@@ -47,23 +71,119 @@ void Interpolation::setInterpolation(float tx, float ty, float tz, float te, flo
     }
 }
 
-// Memperbarui posisi aktual selama interpolasi
+// Mengatur busur G2/G3 di bidang XY dari posisi saat ini
+ArcStatus Interpolation::setArc(float tx, float ty, float tz, float te,
+                                float offsetI, float offsetJ, float radius, bool clockwise, float fr) {
+    float dx = tx - currentX;
+    float dy = ty - currentY;
+    if (!isnan(radius)) {
+        // Pusat di garis bagi tegak lurus tali busur, sejauh h dari titik tengahnya. G2 dengan
+        // R positif (busur <= 180 derajat) berpusat di kanan arah start -> target.
+        float chord = sqrt(dx*dx + dy*dy);
+        if (chord < 0.001) return ARC_NO_CENTER; // Lingkaran penuh tidak dapat ditulis dengan R
+        float h2 = radius * radius - chord * chord / 4.0;
+        if (h2 < 0.0) {
+            if (fabs(radius) * 2.0 < chord - INTERPOLATION_ARC_RADIUS_ERROR) return ARC_RADIUS_TOO_SMALL;
+            h2 = 0.0; // Setengah lingkaran dengan galat pembulatan
+        }
+        float side = (clockwise != (radius < 0.0)) ? -1.0 : 1.0;
+        float h = side * sqrt(h2) / chord;
+        offsetI = dx / 2.0 - h * dy;
+        offsetJ = dy / 2.0 + h * dx;
+    } else if (isnan(offsetI) && isnan(offsetJ)) {
+        return ARC_NO_CENTER;
+    } else {
+        if (isnan(offsetI)) offsetI = 0.0;
+        if (isnan(offsetJ)) offsetJ = 0.0;
+    }
+
+    // Vektor jari-jari start dan target relatif terhadap pusat
+    float rsx = -offsetI, rsy = -offsetJ;
+    float rtx = dx - offsetI, rty = dy - offsetJ;
+    float r = sqrt(rsx*rsx + rsy*rsy);
+    if (r < 0.001) return ARC_RADIUS_TOO_SMALL;
+    if (fabs(sqrt(rtx*rtx + rty*rty) - r) > INTERPOLATION_ARC_RADIUS_ERROR + 0.001 * r) return ARC_RADIUS_MISMATCH;
+
+    // Sudut tempuh bertanda: negatif untuk G2; target sama dengan start = satu putaran penuh
+    float angle = atan2(rsx*rty - rsy*rtx, rsx*rtx + rsy*rty);
+    if (clockwise && angle >= 0.0) angle -= 2.0 * M_PI;
+    else if (!clockwise && angle <= 0.0) angle += 2.0 * M_PI;
+
+    startX = currentX;
+    startY = currentY;
+    startZ = currentZ;
+    startE = currentE;
+    targetX = tx;
+    targetY = ty;
+    targetZ = tz;
+    targetE = te;
+    feedRate = fr;
+
+    // Panjang heliks: busur di XY, Z dan E linear. Sudut per sub-segmen dibatasi agar tali
+    // busur menyimpang paling jauh INTERPOLATION_ARC_TOLERANCE dari lingkaran.
+    float arcLength = fabs(angle) * r;
+    float dz = targetZ - startZ;
+    float de = targetE - startE;
+    float maxStep = r > INTERPOLATION_ARC_TOLERANCE ? 2.0 * acos(1.0 - INTERPOLATION_ARC_TOLERANCE / r) : M_PI;
+    arc = true;
+    setSegments(sqrt(arcLength*arcLength + dz*dz + de*de), ceil(fabs(angle) / maxStep));
+
+    centerX = startX + offsetI;
+    centerY = startY + offsetJ;
+    startRadiusX = radiusX = rsx;
+    startRadiusY = radiusY = rsy;
+    // Satu-satunya sin/cos per busur selain koreksi berkala
+    angleStep = angle / segmentCount;
+    cosStep = cos(angleStep);
+    sinStep = sin(angleStep);
+    return ARC_OK;
+}
+
+const char* Interpolation::arcStatusName(ArcStatus status) {
+    switch (status) {
+        case ARC_OK: return "OK";
+        case ARC_NO_CENTER: return "NO_CENTER";
+        case ARC_RADIUS_MISMATCH: return "RADIUS_MISMATCH";
+        default: return "RADIUS_TOO_SMALL";
+    }
+}
+
+// Memajukan posisi ke ujung sub-segmen berikutnya.
+// Posisi ini adalah target yang direncanakan (diantrikan ke planner), bukan posisi
+// fisik saat ini; planner yang mengatur kapan motor benar-benar sampai.
 void Interpolation::updateActualPosition() {
     if (finished) return;
+    PROFILE_SCOPE(PROFILE_INTERPOLATION);
 
-    unsigned long elapsedTime = millis() - startTime; // Waktu yang telah berlalu dalam ms
-    float distanceMoved = (feedRate / 60000.0) * elapsedTime; // Jarak yang seharusnya ditempuh dalam mm (mm/ms)
-
-    if (distanceMoved >= totalDistance) {
-        // Jika sudah mencapai atau melewati target, set posisi ke target akhir
+    segmentIndex++;
+    if (segmentIndex >= segmentCount) {
+        // Sub-segmen terakhir: set posisi ke target akhir agar tidak ada galat pembulatan
         currentX = targetX;
         currentY = targetY;
         currentZ = targetZ;
         currentE = targetE;
         finished = true;
+    } else if (arc) {
+        if (segmentIndex % INTERPOLATION_ARC_CORRECTION == 0) {
+            // Koreksi eksak dari sudut awal: galat pembulatan rotasi tidak menumpuk
+            float angle = angleStep * segmentIndex;
+            float c = cos(angle), s = sin(angle);
+            radiusX = startRadiusX * c - startRadiusY * s;
+            radiusY = startRadiusX * s + startRadiusY * c;
+        } else {
+            // Putar vektor jari-jari satu langkah sudut
+            float x = radiusX * cosStep - radiusY * sinStep;
+            radiusY = radiusX * sinStep + radiusY * cosStep;
+            radiusX = x;
+        }
+        float ratio = (float)segmentIndex / segmentCount;
+        currentX = centerX + radiusX;
+        currentY = centerY + radiusY;
+        currentZ = startZ + (targetZ - startZ) * ratio;
+        currentE = startE + (targetE - startE) * ratio;
     } else {
-        // Hitung posisi saat ini berdasarkan proporsi jarak yang ditempuh
-        float ratio = distanceMoved / totalDistance;
+        // Hitung posisi berdasarkan proporsi sub-segmen yang sudah diproduksi
+        float ratio = (float)segmentIndex / segmentCount;
         currentX = startX + (targetX - startX) * ratio;
         currentY = startY + (targetY - startY) * ratio;
         currentZ = startZ + (targetZ - startZ) * ratio;
@@ -4,6 +4,28 @@
 
 #include <Arduino.h>
 
+// Durasi satu sub-segmen garis Kartesian (ms) pada feedrate yang diminta. Setiap
+// sub-segmen diselesaikan dengan IK dan menjadi satu blok planner, sehingga buffer
+// StepEngine berisi jumlah waktu gerak yang sama berapa pun feedrate-nya.
+#define INTERPOLATION_SEGMENT_MS 20
+
+// Busur (G2/G3) dibagi menjadi sub-segmen seperti garis, ditambah sebanyak yang perlu agar
+// setiap tali busur menyimpang paling jauh INTERPOLATION_ARC_TOLERANCE (mm) dari busur. Titik
+// sub-segmen didapat dengan memutar vektor jari-jari satu langkah sudut tetap (4 perkalian,
+// tanpa sin/cos); setiap INTERPOLATION_ARC_CORRECTION titik vektor dihitung ulang secara eksak
+// dari sudut awal agar galat pembulatan float tidak menumpuk. Jari-jari akhir boleh berbeda
+// dari jari-jari awal paling banyak INTERPOLATION_ARC_RADIUS_ERROR (mm) ditambah 0.1% jari-jari.
+#define INTERPOLATION_ARC_TOLERANCE 0.01
+#define INTERPOLATION_ARC_CORRECTION 16
+#define INTERPOLATION_ARC_RADIUS_ERROR 0.05
+
+enum ArcStatus : uint8_t {
+    ARC_OK,
+    ARC_NO_CENTER,        // Tidak ada I/J maupun R
+    ARC_RADIUS_MISMATCH,  // I/J: start dan target tidak pada lingkaran yang sama
+    ARC_RADIUS_TOO_SMALL  // R: kurang dari setengah jarak ke target
+};
+
 class Interpolation {
 public:
     Interpolation();
@@ -11,12 +33,26 @@ public:
     // Set target position for interpolation
     void setInterpolation(float targetX, float targetY, float targetZ, float targetE, float feedRate);
 
-    // Update actual position during interpolation
+    // Atur busur G2 (searah jarum jam) / G3 di bidang XY dari posisi saat ini. Pusatnya
+    // offsetI/offsetJ dari start, atau, jika radius bukan NAN, di sisi yang ditentukan tandanya
+    // (positif: busur paling besar 180 derajat). Z dan E bergerak linear sepanjang busur
+    // (heliks). Target sama dengan start berarti satu lingkaran penuh. Tidak ada yang berubah
+    // kecuali hasilnya ARC_OK.
+    ArcStatus setArc(float targetX, float targetY, float targetZ, float targetE,
+                     float offsetI, float offsetJ, float radius, bool clockwise, float feedRate);
+    static const char* arcStatusName(ArcStatus status);
+
+    // Advance the interpolated position to the end of the next sub-segment
     void updateActualPosition();
 
-    // Check if interpolation is finished
+    // Check if all sub-segments of the current line have been produced
     bool isFinished() const;
 
+    // Panjang (mm) dan durasi nominal (s) tiap sub-segmen, serta feedrate yang diminta (mm/min)
+    float getSegmentLength() const { return segmentLength; }
+    float getSegmentDuration() const { return segmentDuration; }
+    float getFeedRate() const { return feedRate; }
+
     // Get current interpolated position
     float getX() const { return currentX; }
     float getY() const { return currentY; }
@@ -31,9 +67,21 @@ private:
     float targetX, targetY, targetZ, targetE;
     float currentX, currentY, currentZ, currentE;
     float feedRate; // mm/min
-    unsigned long startTime;
     float totalDistance;
+    float segmentLength;
+    float segmentDuration;
+    unsigned long segmentCount;
+    unsigned long segmentIndex;
     bool finished;
+
+    // Busur saat ini (arc == false untuk garis)
+    bool arc;
+    float centerX, centerY;
+    float startRadiusX, startRadiusY; // Titik start relatif terhadap pusat
+    float radiusX, radiusY;           // Titik terakhir yang dihasilkan, relatif terhadap pusat
+    float angleStep, cosStep, sinStep;
+
+    void setSegments(float distance, float minimumSegments);
 };
 
 #endif
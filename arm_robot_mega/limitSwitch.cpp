@@ -0,0 +1,155 @@
+// limitSwitch.cpp
+#include "limitSwitch.h"
+
+// Pemantau yang dilayani ISR pin
+static LimitSwitches* activeSwitches = nullptr;
+
+// attachInterrupt() tidak meneruskan argumen, jadi satu fungsi per kanal
+template <uint8_t CHANNEL>
+static void limitEdgeIsr() {
+  activeSwitches->handleEdge(CHANNEL);
+}
+static void (*const LIMIT_EDGE_ISRS[STEP_ENGINE_AXES])() = {
+  limitEdgeIsr<0>, limitEdgeIsr<1>, limitEdgeIsr<2>, limitEdgeIsr<3>
+};
+
+#if defined(__AVR__)
+ISR(PCINT0_vect) {
+  if (activeSwitches) activeSwitches->handlePinChange();
+}
+ISR(PCINT1_vect, ISR_ALIASOF(PCINT0_vect));
+ISR(PCINT2_vect, ISR_ALIASOF(PCINT0_vect));
+#else
+static void limitPinChangeIsr() {
+  if (activeSwitches) activeSwitches->handlePinChange();
+}
+#endif
+
+LimitSwitches::LimitSwitches() {
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    axes[i] = nullptr;
+    activatedAt[i] = 0;
+  }
+  rawActive = 0;
+  pendingRelease = 0;
+  pinChangeChannels = 0;
+  polledChannels = 0;
+  stats.edges = 0;
+  stats.trips = 0;
+  stats.deferred = 0;
+}
+
+void LimitSwitches::begin(StepEngine* engine) {
+  activeSwitches = this;
+  unsigned long now = micros();
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    RampsStepper* axis = engine->getAxis(i);
+    if (axis == nullptr) continue;
+
+    // Status awal dibaca langsung; switch yang sudah tertekan dianggap stabil
+    noInterrupts();
+    axes[i] = axis;
+    bool active = axis->isLimitActive();
+    if (active) rawActive |= (1 << i);
+    axis->setLimitTripped(active);
+    activatedAt[i] = now - LIMIT_SWITCH_DEBOUNCE_US;
+    interrupts();
+
+    if (!attach(i, axis->getLimitPin())) polledChannels |= (1 << i);
+  }
+}
+
+bool LimitSwitches::attach(uint8_t channel, uint8_t pin) {
+  int irq = digitalPinToInterrupt(pin);
+  if (irq != NOT_AN_INTERRUPT) {
+    attachInterrupt(irq, LIMIT_EDGE_ISRS[channel], CHANGE);
+    return true;
+  }
+#if defined(__AVR__)
+  volatile uint8_t* pcicr = digitalPinToPCICR(pin);
+  if (pcicr == nullptr) return false;
+  uint8_t group = digitalPinToPCICRbit(pin);
+  noInterrupts();
+  *digitalPinToPCMSK(pin) |= (1 << digitalPinToPCMSKbit(pin));
+  PCIFR = (1 << group); // Buang flag lama sebelum vektor diaktifkan
+  *pcicr |= (1 << group);
+  pinChangeChannels |= (1 << channel);
+  interrupts();
+  return true;
+#else
+  // Pengganti PCMSK/PCICR di simulasi host; hanya pin yang punya PCINT di Mega
+  if (!simAttachPinChange(pin, limitPinChangeIsr)) return false;
+  pinChangeChannels |= (1 << channel);
+  return true;
+#endif
+}
+
+void LimitSwitches::handleEdge(uint8_t channel) {
+  RampsStepper* axis = axes[channel];
+  if (axis == nullptr) return;
+  uint8_t bit = 1 << channel;
+  bool active = axis->isLimitActive();
+  // Pulsa yang lebih pendek dari latensi ISR, atau kanal PCINT lain yang tidak berubah
+  if (active == ((rawActive & bit) != 0)) return;
+  stats.edges++;
+
+  unsigned long now = micros();
+  if (active) {
+    rawActive |= bit;
+    pendingRelease &= ~bit;
+    activatedAt[channel] = now;
+    if (!axis->isLimitTripped()) {
+      axis->setLimitTripped(true);
+      stats.trips++;
+    }
+  } else {
+    rawActive &= ~bit;
+    if (now - activatedAt[channel] >= LIMIT_SWITCH_DEBOUNCE_US) {
+      axis->setLimitTripped(false);
+    } else {
+      pendingRelease |= bit;
+      stats.deferred++;
+    }
+  }
+}
+
+void LimitSwitches::handlePinChange() {
+  // Satu vektor per grup port: cari kanal yang levelnya berubah
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    if (pinChangeChannels & (1 << i)) handleEdge(i);
+  }
+}
+
+void LimitSwitches::update() {
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    uint8_t bit = 1 << i;
+    if (!((pendingRelease | polledChannels) & bit)) continue;
+    noInterrupts();
+    if (polledChannels & bit) handleEdge(i);
+    if ((pendingRelease & bit) && micros() - activatedAt[i] >= LIMIT_SWITCH_DEBOUNCE_US) {
+      pendingRelease &= ~bit;
+      // Tepi tertekan yang terlewat di dalam jendela akan terlihat di sini
+      if (axes[i]->isLimitActive()) {
+        rawActive |= bit;
+        activatedAt[i] = micros();
+      } else {
+        axes[i]->setLimitTripped(false);
+      }
+    }
+    interrupts();
+  }
+}
+
+uint8_t LimitSwitches::getTrippedMask() const {
+  uint8_t mask = 0;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    if (axes[i] != nullptr && axes[i]->isLimitTripped()) mask |= (1 << i);
+  }
+  return mask;
+}
+
+void LimitSwitches::getStats(LimitSwitchStats& out) const {
+  noInterrupts();
+  out = stats;
+  interrupts();
+}
@@ -0,0 +1,65 @@
+// limitSwitch.h
+#ifndef LIMIT_SWITCH_H
+#define LIMIT_SWITCH_H
+
+#include <Arduino.h>
+#include "RampsStepper.h"
+#include "stepEngine.h"
+
+// Waktu minimum switch harus tetap tertekan sebelum pelepasan diterima (debounce kontak)
+#define LIMIT_SWITCH_DEBOUNCE_US 3000UL
+
+// Statistik sejak begin(), untuk diagnosa switch yang bergetar
+struct LimitSwitchStats {
+  unsigned long edges;    // Perubahan level yang dilihat ISR
+  unsigned long trips;    // Switch berubah dari lepas menjadi terpicu
+  unsigned long deferred; // Pelepasan di dalam jendela debounce (ditunda sampai update())
+};
+
+// Pemantau limit switch berbasis interrupt pin. Setiap perubahan level pin limit memanggil
+// ISR (INTn lewat attachInterrupt(), atau pin-change PCINT untuk pin tanpa INTn) yang
+// menjaga flag terpicu di RampsStepper (setLimitTripped). ISR step StepEngine hanya memeriksa
+// flag itu, sehingga tidak ada pembacaan pin per langkah, dan langkah berikutnya menuju
+// switch sudah terblokir begitu ISR pin selesai (vektor INT/PCINT berprioritas lebih tinggi
+// dari Timer1, jadi selalu dilayani sebelum ISR step berikutnya).
+//
+// Debounce asimetris di dalam ISR: tepi tertekan diterima seketika (keselamatan tidak
+// pernah ditunda), tepi lepas hanya diterima jika switch sudah tertekan paling tidak
+// LIMIT_SWITCH_DEBOUNCE_US. Lepas yang lebih cepat dianggap pantulan kontak; flag tetap
+// terpicu dan update() dari loop menyelesaikannya setelah jendela debounce lewat, dengan
+// membaca level pin sekali lagi. Pantulan saat lepas memicu ulang flag sesaat, yang hanya
+// memblokir langkah menuju switch.
+//
+// Pin Mega di firmware ini: 3 (INT5), 18 (INT3), 14 (PCINT10) dan 67/A13 (PCINT21). Pin
+// tanpa interrupt dipantau update() dari loop sebagai cadangan.
+// Di AVR modul ini memiliki vektor PCINT0..2 (tidak dapat digabung dengan SoftwareSerial).
+class LimitSwitches {
+public:
+  LimitSwitches();
+  // Pasang interrupt untuk pin limit setiap sumbu StepEngine dan ambil status awalnya
+  void begin(StepEngine* engine);
+  // Dari loop(): selesaikan pelepasan yang tertunda debounce dan pantau pin tanpa interrupt
+  void update();
+
+  // Dari ISR: periksa level pin kanal (sumbu) tersebut
+  void handleEdge(uint8_t channel);
+  // Dari ISR PCINT: periksa semua kanal pin-change
+  void handlePinChange();
+
+  // Bit i = flag terpicu sumbu i
+  uint8_t getTrippedMask() const;
+  void getStats(LimitSwitchStats& out) const;
+
+private:
+  RampsStepper* axes[STEP_ENGINE_AXES];
+  unsigned long activatedAt[STEP_ENGINE_AXES]; // micros() tepi tertekan terakhir
+  volatile uint8_t rawActive;      // Level terakhir yang dilihat ISR (bit = tertekan)
+  volatile uint8_t pendingRelease; // Lepas di dalam jendela debounce
+  uint8_t pinChangeChannels;       // Kanal yang dilayani PCINT
+  uint8_t polledChannels;          // Kanal tanpa interrupt, dibaca update()
+  LimitSwitchStats stats;
+
+  bool attach(uint8_t channel, uint8_t pin);
+};
+
+#endif
@@ -0,0 +1,85 @@
+// macro.cpp
+#include "macro.h"
+
+// Titik dan ketinggian yang dipakai satu langkah template
+enum MacroPoint : uint8_t { MACRO_NO_POINT, MACRO_PICK, MACRO_PLACE };
+enum MacroLevel : uint8_t { MACRO_SAFE_Z, MACRO_PICK_Z, MACRO_PLACE_Z };
+
+struct MacroStep {
+  char id;
+  uint8_t num;
+  uint8_t point;
+  uint8_t level;
+};
+
+// Sama dengan satu siklus di sim/bench/pick_place.gcode
+static const MacroStep PICK_PLACE_STEPS[] PROGMEM = {
+  {'G', 0, MACRO_PICK, MACRO_SAFE_Z},      // Ke atas titik ambil
+  {'G', 1, MACRO_PICK, MACRO_PICK_Z},      // Turun
+  {'M', 8, MACRO_NO_POINT, 0},             // Vakum hidup
+  {'G', 4, MACRO_NO_POINT, 0},             // Tunggu benda terhisap
+  {'G', 1, MACRO_PICK, MACRO_SAFE_Z},      // Angkat
+  {'G', 0, MACRO_PLACE, MACRO_SAFE_Z},     // Ke atas wadah
+  {'G', 1, MACRO_PLACE, MACRO_PLACE_Z},    // Turun
+  {'M', 9, MACRO_NO_POINT, 0},             // Vakum mati
+  {'G', 4, MACRO_NO_POINT, 0},             // Tunggu benda lepas
+  {'G', 1, MACRO_PLACE, MACRO_SAFE_Z}      // Angkat
+};
+static const uint8_t PICK_PLACE_STEP_COUNT = sizeof(PICK_PLACE_STEPS) / sizeof(PICK_PLACE_STEPS[0]);
+
+static const MacroParams DEFAULT_PARAMS PROGMEM = {
+  0.0, 250.0,                // Titik ambil default (di bawah kamera)
+  285.0,                     // Ketinggian aman
+  255.0,                     // Ketinggian ambil
+  1500.0,                    // Feedrate turun/naik
+  0.2,                       // Jeda vakum
+  {-60.0, 60.0, 0.0},        // X wadah 1..3 (hijau, kuning, merah)
+  {230.0, 230.0, 210.0},     // Y wadah 1..3
+  {260.0, 260.0, 265.0}      // Ketinggian letak wadah 1..3
+};
+
+MacroRunner::MacroRunner() {
+  loadDefaults(params);
+  active = false;
+  stepIndex = 0;
+  pickX = pickY = placeX = placeY = placeZ = 0.0;
+}
+
+void MacroRunner::loadDefaults(MacroParams &out) {
+  memcpy_P(&out, &DEFAULT_PARAMS, sizeof(out));
+}
+
+bool MacroRunner::start(const Cmd &cmd) {
+  if (cmd.num < 1 || cmd.num > MACRO_BIN_COUNT) return false;
+  pickX = isnan(cmd.valueX) ? params.pickX : cmd.valueX;
+  pickY = isnan(cmd.valueY) ? params.pickY : cmd.valueY;
+  placeX = params.binX[cmd.num - 1];
+  placeY = params.binY[cmd.num - 1];
+  placeZ = params.binZ[cmd.num - 1];
+  stepIndex = 0;
+  active = true;
+  return true;
+}
+
+bool MacroRunner::next(Cmd &cmd) {
+  if (!active) return false;
+
+  MacroStep step;
+  memcpy_P(&step, &PICK_PLACE_STEPS[stepIndex], sizeof(step));
+  if (++stepIndex >= PICK_PLACE_STEP_COUNT) active = false;
+
+  cmd.id = step.id;
+  cmd.num = step.num;
+  cmd.valueX = cmd.valueY = cmd.valueZ = NAN;
+  cmd.valueE = cmd.valueF = cmd.valueT = NAN;
+  cmd.valueI = cmd.valueJ = cmd.valueR = NAN;
+  if (step.point != MACRO_NO_POINT) {
+    cmd.valueX = step.point == MACRO_PICK ? pickX : placeX;
+    cmd.valueY = step.point == MACRO_PICK ? pickY : placeY;
+    cmd.valueZ = step.level == MACRO_PICK_Z ? params.pickZ : step.level == MACRO_PLACE_Z ? placeZ : params.safeZ;
+    if (step.num == 1) cmd.valueF = params.feedRate;
+  } else if (step.id == 'G' && step.num == 4) {
+    cmd.valueT = params.dwell;
+  }
+  return true;
+}
@@ -0,0 +1,54 @@
+// macro.h
+#ifndef MACRO_H
+#define MACRO_H
+
+#include <Arduino.h>
+#include "command.h"
+
+// Makro pick-and-place di firmware. "P<wadah> [X<x>] [Y<y>]" mengambil benda di (X, Y)
+// (default: titik ambil di MacroParams) dan meletakkannya di wadah 1..MACRO_BIN_COUNT,
+// sama seperti P1/P2/P3 yang dikirim GUI per warna bola.
+//
+// Urutan langkah (mendekat, turun, hisap, angkat, pindah, turun, lepas, angkat) disimpan
+// di PROGMEM sebagai template G0/G1/M8/M9/G4 yang titik dan ketinggiannya diisi dari
+// parameter. loop() menjabarkan langkah satu per satu lewat next() setiap kali perintah
+// berikutnya boleh dieksekusi, mendahului antrian perintah, sehingga satu baris dari host
+// menggantikan ~10 baris beserta round-trip-nya dan G0/G1 tetap disambung planner.
+#define MACRO_BIN_COUNT 3
+
+// Parameter makro (mm, mm/min, detik). Nilai awal dari PROGMEM; struct POD sehingga
+// dapat disimpan apa adanya di EEPROM.
+struct MacroParams {
+  float pickX, pickY;       // Titik ambil jika P tanpa X/Y
+  float safeZ;              // Ketinggian aman untuk berpindah
+  float pickZ;              // Ketinggian saat mengambil
+  float feedRate;           // Feedrate G1 turun/naik
+  float dwell;              // Jeda G4 setelah vakum hidup/mati
+  // Titik letak setiap wadah; Z adalah ketinggian saat meletakkan
+  float binX[MACRO_BIN_COUNT], binY[MACRO_BIN_COUNT], binZ[MACRO_BIN_COUNT];
+};
+
+class MacroRunner {
+public:
+  MacroRunner();
+
+  // Mulai makro dari perintah P. Mengembalikan false jika nomor wadah tidak dikenal.
+  bool start(const Cmd &cmd);
+  // Langkah berikutnya sebagai perintah G/M biasa; false jika tidak ada makro yang berjalan
+  bool next(Cmd &cmd);
+  // Hentikan sisa makro (mis. target tidak terjangkau); vakum dibiarkan apa adanya
+  void abort() { active = false; }
+  bool isActive() const { return active; }
+
+  MacroParams &getParams() { return params; }
+  // Nilai awal parameter dari PROGMEM (juga dipakai kalibrasi EEPROM sebagai default)
+  static void loadDefaults(MacroParams &out);
+
+private:
+  MacroParams params;
+  bool active;
+  uint8_t stepIndex;
+  float pickX, pickY, placeX, placeY, placeZ;
+};
+
+#endif
@@ -0,0 +1,319 @@
+// planner.cpp
+#include "planner.h"
+#include "profile.h"
+#include <math.h>
+
+Planner::Planner() {
+  engine = nullptr;
+  lookAheadEnabled = true;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) previousUnit[i] = 0.0;
+  previousNominalSpeed = 0.0;
+  previousSafeSpeed = 0.0;
+}
+
+void Planner::begin(StepEngine* aEngine) {
+  engine = aEngine;
+}
+
+// Jarak (event) yang dibutuhkan untuk berubah dari initialRate ke targetRate
+static float estimateAccelerationDistance(float initialRate, float targetRate, float acceleration) {
+  return (targetRate * targetRate - initialRate * initialRate) / (2.0 * acceleration);
+}
+
+// Titik (event) di mana akselerasi dari initialRate harus berganti ke deselerasi
+// agar blok berakhir tepat di finalRate (profil segitiga)
+static float intersectionDistance(float initialRate, float finalRate, float acceleration, float distance) {
+  return (2.0 * acceleration * distance - initialRate * initialRate + finalRate * finalRate) / (4.0 * acceleration);
+}
+
+void Planner::calculateTrapezoid(StepBlock* block, float acceleration, unsigned long entryRate, unsigned long exitRate) {
+  if (entryRate > block->nominalRate) entryRate = block->nominalRate;
+  if (exitRate > block->nominalRate) exitRate = block->nominalRate;
+  block->initialRate = entryRate;
+  block->finalRate = exitRate;
+
+  if (acceleration <= 0.0) {
+    // Tanpa akselerasi: seluruh blok pada kecepatan jelajah
+    block->initialRate = block->finalRate = block->nominalRate;
+    block->rateDelta = 0;
+    block->accelerateUntil = 0;
+    block->decelerateAfter = block->stepEventCount;
+    return;
+  }
+
+  float rateDelta = acceleration / ACCELERATION_TICKS_PER_SECOND;
+  block->rateDelta = (rateDelta < 1.0) ? 1 : (unsigned long)rateDelta;
+
+  // ISR menurunkan kecepatan bertangga, sekali per tick akselerasi, sehingga di akhir blok bisa
+  // tertinggal satu rateDelta dari profil kontinu. Deselerasi direncanakan sampai satu rateDelta
+  // di bawah exitRate agar kecepatan keluar yang dieksekusi tidak melebihi exitRate.
+  float plannedExitRate = (exitRate > block->rateDelta) ? (float)(exitRate - block->rateDelta) : 0.0;
+  long accelerateSteps = (long)ceil(estimateAccelerationDistance(entryRate, block->nominalRate, acceleration));
+  long decelerateSteps = (long)ceil(estimateAccelerationDistance(block->nominalRate, plannedExitRate, -acceleration));
+  long plateauSteps = block->stepEventCount - accelerateSteps - decelerateSteps;
+
+  // Kecepatan jelajah tidak tercapai: akselerasi langsung disusul deselerasi
+  if (plateauSteps < 0) {
+    accelerateSteps = (long)floor(intersectionDistance(entryRate, plannedExitRate, acceleration, block->stepEventCount));
+    if (accelerateSteps < 0) accelerateSteps = 0;
+    if (accelerateSteps > block->stepEventCount) accelerateSteps = block->stepEventCount;
+    plateauSteps = 0;
+  }
+
+  block->accelerateUntil = accelerateSteps;
+  block->decelerateAfter = accelerateSteps + plateauSteps;
+}
+
+bool Planner::bufferMove(const long target[STEP_ENGINE_AXES], float minDuration) {
+  PROFILE_SCOPE(PROFILE_PLANNER);
+  StepBlock* block = engine->reserveBlock();
+  if (block == nullptr) return false;
+
+  block->directionBits = 0;
+  block->stepEventCount = 0;
+  float lengthSquared = 0.0;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    long delta = target[i] - engine->getAxis(i)->getPlannedPosition();
+    if (delta < 0) {
+      block->directionBits |= (1 << i);
+      delta = -delta;
+    }
+    block->steps[i] = delta;
+    lengthSquared += (float)delta * delta;
+    if (delta > block->stepEventCount) block->stepEventCount = delta;
+  }
+  if (block->stepEventCount == 0) return true; // Tidak ada langkah, tidak perlu blok
+
+  // Sumbu i melangkah steps[i] kali per stepEventCount event, jadi setiap batas sumbu
+  // dikalikan stepEventCount / steps[i] untuk mendapatkan batas event sumbu dominan.
+  // Batas blok adalah yang paling ketat dari semua sumbu yang bergerak.
+  float nominalRate = (minDuration > 0.0) ? block->stepEventCount / minDuration : 1.0e9;
+  float acceleration = 1.0e9;
+  float jerkRate = 1.0e9;
+  bool accelerationLimited = false;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    if (block->steps[i] == 0) continue;
+    RampsStepper* axis = engine->getAxis(i);
+    float scale = (float)block->stepEventCount / block->steps[i];
+    if (axis->getMaxStepRate() * scale < nominalRate) nominalRate = axis->getMaxStepRate() * scale;
+    if (axis->getJerkStepRate() * scale < jerkRate) jerkRate = axis->getJerkStepRate() * scale;
+    if (axis->getAcceleration() > 0.0) {
+      accelerationLimited = true;
+      if (axis->getAcceleration() * scale < acceleration) acceleration = axis->getAcceleration() * scale;
+    }
+  }
+  if (nominalRate < MIN_STEP_RATE) nominalRate = MIN_STEP_RATE;
+  if (jerkRate > nominalRate) jerkRate = nominalRate;
+  if (!accelerationLimited) acceleration = 0.0;
+
+  block->nominalRate = (unsigned long)nominalRate;
+  block->safeRate = (unsigned long)jerkRate;
+  // Profil awal: mulai dan berhenti pada kecepatan jerk. Look-ahead menaikkannya nanti.
+  calculateTrapezoid(block, acceleration, block->safeRate, block->safeRate);
+
+  // Data look-ahead dalam satuan ruang-langkah
+  uint8_t index = engine->headIndex();
+  PlanData& data = plan[index];
+  data.length = sqrt(lengthSquared);
+  float toSpeed = data.length / block->stepEventCount;
+  data.nominalSpeed = nominalRate * toSpeed;
+  data.safeSpeed = jerkRate * toSpeed;
+  data.acceleration = acceleration * toSpeed;
+
+  float unit[STEP_ENGINE_AXES];
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    unit[i] = block->steps[i] / data.length;
+    if (block->directionBits & (1 << i)) unit[i] = -unit[i];
+  }
+
+  // Kecepatan maksimum di sambungan dengan blok sebelumnya: pada kecepatan v, perubahan
+  // kecepatan sumbu i adalah v * |unit[i] - previousUnit[i]|, dan tidak boleh melebihi
+  // jerk sumbu tersebut. Tanpa blok sebelumnya, blok mulai dari diam.
+  data.maxEntrySpeed = data.safeSpeed;
+  if (engine->isBusy() && previousNominalSpeed > 0.0) {
+    float junctionSpeed = min(data.nominalSpeed, previousNominalSpeed);
+    float fastestSpeed = max(data.nominalSpeed, previousNominalSpeed);
+    float factor = 1.0;
+    for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+      float change = fabs(unit[i] - previousUnit[i]) * junctionSpeed;
+      float jerk = engine->getAxis(i)->getJerkStepRate();
+      if (change > jerk && jerk / change < factor) factor = jerk / change;
+    }
+    data.maxEntrySpeed = junctionSpeed * factor;
+    if (factor >= 1.0 && fastestSpeed > junctionSpeed) {
+      // Blok lambat sudah pada jelajahnya di junctionSpeed; blok cepat boleh lebih cepat
+      // selama |v * fast[i] - junctionSpeed * slow[i]| <= jerk. Lompatan ini cembung dalam
+      // v, jadi cukup dibatasi di ujungnya.
+      bool entryFaster = data.nominalSpeed > previousNominalSpeed;
+      float limit = fastestSpeed;
+      for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+        float fast = entryFaster ? unit[i] : previousUnit[i];
+        float slow = entryFaster ? previousUnit[i] : unit[i];
+        if (fast == 0.0) continue;
+        float jerk = engine->getAxis(i)->getJerkStepRate();
+        float bound = (junctionSpeed * slow + ((fast > 0.0) ? jerk : -jerk)) / fast;
+        if (bound < limit) limit = bound;
+      }
+      if (limit > data.maxEntrySpeed) data.maxEntrySpeed = limit;
+    }
+    // Tanpa look-ahead: sambungan tidak melebihi kecepatan aman kedua blok
+    if (!lookAheadEnabled) data.maxEntrySpeed = min(data.maxEntrySpeed, min(previousSafeSpeed, data.safeSpeed));
+  }
+  data.entrySpeed = min(data.maxEntrySpeed, data.safeSpeed);
+
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    previousUnit[i] = unit[i];
+    engine->getAxis(i)->setPlannedPosition(target[i]);
+    engine->getAxis(i)->stepToPosition(target[i]);
+  }
+  previousNominalSpeed = data.nominalSpeed;
+  previousSafeSpeed = data.safeSpeed;
+  engine->commitBlock();
+
+  // Juga tanpa look-ahead: blok pendek mungkin tidak sempat mengerem ke sambungan berikutnya
+  recalculate();
+  return true;
+}
+
+bool Planner::bufferAction(StepAction action, long value) {
+  return engine->queueEvent(action, value, 0);
+}
+
+bool Planner::bufferDwell(float seconds) {
+  // Minimal satu tick agar blok tetap dwell (berhenti), bukan aksi yang dilewati
+  float ticks = seconds * STEP_TIMER_FREQ;
+  if (!(ticks >= 1.0)) ticks = 1.0;
+  if (ticks > 4.0e9) ticks = 4.0e9;
+  if (!engine->queueEvent(nullptr, 0, (unsigned long)ticks)) return false;
+  // Blok berikutnya mulai dari diam
+  previousNominalSpeed = 0.0;
+  return true;
+}
+
+// Blok event (StepBlock tanpa langkah) tidak punya profil. Aksi dilewati look-ahead,
+// sedangkan dwell berarti berhenti seperti akhir buffer.
+static bool isEvent(const StepBlock* block) { return block->stepEventCount == 0; }
+static bool isAction(const StepBlock* block) { return block->stepEventCount == 0 && block->dwellTicks == 0; }
+
+// Tulis ulang profil blok pada indeks tertentu, kecuali blok itu sudah dieksekusi ISR
+void Planner::applyProfile(uint8_t index, float entrySpeed, float exitSpeed) {
+  StepBlock* block = engine->blockAt(index);
+  const PlanData& data = plan[index];
+  float toRate = block->stepEventCount / data.length;
+
+  // Hitung di salinan agar interrupt hanya dimatikan selama penyalinan field
+  StepBlock profile = *block;
+  calculateTrapezoid(&profile, data.acceleration * toRate,
+                     (unsigned long)(entrySpeed * toRate), (unsigned long)(exitSpeed * toRate));
+
+  noInterrupts();
+  if (!engine->isActive(index)) {
+    block->initialRate = profile.initialRate;
+    block->finalRate = profile.finalRate;
+    block->rateDelta = profile.rateDelta;
+    block->accelerateUntil = profile.accelerateUntil;
+    block->decelerateAfter = profile.decelerateAfter;
+  }
+  interrupts();
+}
+
+void Planner::recalculate() {
+  uint8_t head = engine->headIndex();
+  uint8_t tail = engine->tailIndex();
+  if (head == tail) return;
+
+  // Blok yang sedang dieksekusi sudah terkunci; perencanaan mulai dari blok sesudahnya
+  // dan kecepatan masuknya tidak boleh melebihi kecepatan akhir blok aktif.
+  noInterrupts();
+  bool tailActive = engine->isActive(tail);
+  interrupts();
+  uint8_t first = tailActive ? StepEngine::nextIndex(tail) : tail;
+  if (first == head) return;
+  uint8_t last = StepEngine::prevIndex(head);
+
+  // Reverse pass: dari blok terakhir (berhenti pada kecepatan aman) ke depan, kecepatan
+  // sambungan dibatasi jarak yang tersedia untuk mengerem hingga kecepatan keluar blok.
+  // Batas ini hanya berlaku bila lebih kecil dari jelajah blok; di atasnya blok masuk pada
+  // jelajah, dan sambungan boleh tetap tinggi untuk blok sebelumnya yang lebih cepat.
+  bool stopAfter = true; // Blok gerak berikutnya adalah akhir buffer atau dwell
+  float nextEntrySpeed = 0.0;
+  uint8_t index = last;
+  while (true) {
+    StepBlock* block = engine->blockAt(index);
+    if (!isEvent(block)) {
+      PlanData& data = plan[index];
+      float exitSpeed = stopAfter ? data.safeSpeed : min(nextEntrySpeed, data.nominalSpeed);
+      float entrySpeed = data.maxEntrySpeed;
+      if (data.acceleration > 0.0) {
+        // Sama dengan calculateTrapezoid(): sisakan satu tick akselerasi untuk ISR
+        exitSpeed -= data.acceleration / ACCELERATION_TICKS_PER_SECOND;
+        if (exitSpeed < 0.0) exitSpeed = 0.0;
+        float reachable = sqrt(exitSpeed * exitSpeed + 2.0 * data.acceleration * data.length);
+        if (reachable < data.nominalSpeed && reachable < entrySpeed) entrySpeed = reachable;
+      }
+      data.entrySpeed = entrySpeed;
+      nextEntrySpeed = entrySpeed;
+      stopAfter = false;
+    } else if (!isAction(block)) {
+      stopAfter = true;
+    }
+    if (index == first) break;
+    index = StepEngine::prevIndex(index);
+  }
+
+  // Forward pass: kecepatan sambungan juga dibatasi kecepatan keluar yang bisa dicapai blok
+  // sebelumnya, kecuali blok itu sudah mencapai jelajahnya
+  float previousReachable = 0.0;
+  float previousNominal = 0.0;
+  bool fromRest = true;
+  if (tailActive && !isEvent(engine->blockAt(tail))) {
+    StepBlock* active = engine->blockAt(tail);
+    float toSpeed = plan[tail].length / active->stepEventCount;
+    previousReachable = active->finalRate * toSpeed;
+    previousNominal = (active->finalRate >= active->nominalRate) ? previousReachable : plan[tail].nominalSpeed;
+    fromRest = false;
+  }
+  for (index = first; index != head; index = StepEngine::nextIndex(index)) {
+    StepBlock* block = engine->blockAt(index);
+    if (isEvent(block)) {
+      if (!isAction(block)) fromRest = true;
+      continue;
+    }
+    PlanData& data = plan[index];
+    if (fromRest) {
+      // Mulai dari diam
+      if (data.entrySpeed > data.safeSpeed) data.entrySpeed = data.safeSpeed;
+    } else if (previousReachable < previousNominal && data.entrySpeed > previousReachable) {
+      data.entrySpeed = previousReachable;
+    }
+    fromRest = false;
+    float entrySpeed = min(data.entrySpeed, data.nominalSpeed);
+    previousReachable = (data.acceleration > 0.0)
+        ? sqrt(entrySpeed * entrySpeed + 2.0 * data.acceleration * data.length)
+        : data.nominalSpeed;
+    previousNominal = data.nominalSpeed;
+  }
+
+  // Terapkan profil: kecepatan keluar = kecepatan sambungan dengan blok gerak berikutnya
+  // (calculateTrapezoid() membatasi keduanya ke jelajah blok)
+  for (index = first; index != head; index = StepEngine::nextIndex(index)) {
+    if (isEvent(engine->blockAt(index))) continue;
+    uint8_t next = StepEngine::nextIndex(index);
+    while (next != head && isAction(engine->blockAt(next))) next = StepEngine::nextIndex(next);
+    float exitSpeed = (next == head || isEvent(engine->blockAt(next))) ? plan[index].safeSpeed : plan[next].entrySpeed;
+    applyProfile(index, plan[index].entrySpeed, exitSpeed);
+  }
+}
+
+void Planner::update() {
+  if (engine->handleLimitHits()) return;
+  if (engine->isBufferFull()) return;
+
+  long target[STEP_ENGINE_AXES];
+  bool changed = false;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    target[i] = engine->getAxis(i)->getTargetPosition();
+    if (target[i] != engine->getAxis(i)->getPlannedPosition()) changed = true;
+  }
+  if (changed) bufferMove(target);
+}
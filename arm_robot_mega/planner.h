@@ -0,0 +1,80 @@
+// planner.h
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include <Arduino.h>
+#include "RampsStepper.h"
+#include "stepEngine.h"
+
+// Planner mengubah target langkah sumbu menjadi StepBlock dengan profil kecepatan
+// trapesium yang menghormati batas kecepatan, akselerasi, dan jerk setiap sumbu
+// (RampsStepper::setMotionLimits).
+//
+// Look-ahead: setiap kali blok baru masuk, kecepatan masuk semua blok yang belum
+// dieksekusi dihitung ulang (seperti block buffer Grbl) sehingga segmen berurutan
+// menyambung tanpa berhenti. Kecepatan di sambungan dibatasi oleh perubahan kecepatan
+// per sumbu (jerk) dan oleh jarak yang tersisa untuk mengerem sampai blok terakhir.
+// Blok dengan kecepatan jelajah berbeda (mis. G0 lalu G1 lambat) tidak harus menyamakan
+// kecepatan: blok lambat tetap pada jelajahnya dan blok cepat masuk/keluar sampai
+// kecepatan yang lompatannya masih dalam batas jerk.
+class Planner {
+public:
+  Planner();
+  void begin(StepEngine* engine);
+
+  // Dipanggil dari loop: tangani limit switch, lalu jadikan targetStep setiap sumbu
+  // (stepToPosition*) sebagai blok baru jika buffer masih ada ruang.
+  void update();
+
+  // Antrikan gerakan ke posisi langkah absolut untuk semua sumbu dan jadikan posisi
+  // tersebut target setiap sumbu. minDuration (detik) membatasi kecepatan blok, misalnya
+  // dari feedrate G1 (0 = hanya batas sumbu). Mengembalikan false jika buffer penuh.
+  bool bufferMove(const long target[STEP_ENGINE_AXES], float minDuration = 0.0);
+
+  // Antrikan aksi (mis. vakum, gripper) di posisi ini pada timeline gerakan. Aksi tidak
+  // menghentikan gerakan: dijalankan ISR saat blok sebelumnya selesai, dan blok sesudahnya
+  // tetap disambung look-ahead. Mengembalikan false jika buffer penuh.
+  bool bufferAction(StepAction action, long value);
+  // Antrikan dwell: gerakan sebelumnya berhenti, lalu semua sumbu diam selama seconds
+  // (G4). Loop tetap berjalan selama dwell. Mengembalikan false jika buffer penuh.
+  bool bufferDwell(float seconds);
+
+  // Aktif/nonaktifkan penyambungan kecepatan antar blok. Nonaktif = pembanding berhenti
+  // per blok: setiap blok mulai dan berhenti paling cepat pada kecepatan jerk-nya, dan
+  // sambungan (termasuk titik balik arah) tetap dalam batas jerk sumbu.
+  void setLookAheadEnabled(bool enabled) { lookAheadEnabled = enabled; }
+  bool isLookAheadEnabled() const { return lookAheadEnabled; }
+
+  // Hitung accelerateUntil/decelerateAfter/rateDelta blok untuk kecepatan awal dan akhir
+  // tertentu. acceleration dalam event/s^2 (0 = tanpa akselerasi).
+  static void calculateTrapezoid(StepBlock* block, float acceleration, unsigned long entryRate, unsigned long exitRate);
+
+private:
+  // Data look-ahead per blok, paralel dengan buffer StepEngine (indeks yang sama).
+  // Kecepatan dalam satuan panjang ruang-langkah (norma Euclidean langkah semua sumbu)
+  // per detik, sehingga blok dengan sumbu dominan berbeda dapat dibandingkan.
+  struct PlanData {
+    float length;        // Panjang blok di ruang-langkah
+    float nominalSpeed;  // Kecepatan jelajah
+    // Kecepatan sambungan dengan blok sebelumnya hasil perencanaan. Blok sebelumnya keluar
+    // pada min(entrySpeed, jelajahnya) dan blok ini masuk pada min(entrySpeed, nominalSpeed).
+    float entrySpeed;
+    float maxEntrySpeed; // Batas entrySpeed dari jerk di sambungan
+    float safeSpeed;     // Kecepatan start/stop dari diam (jerk)
+    float acceleration;  // Akselerasi (0 = tanpa akselerasi)
+  };
+
+  StepEngine* engine;
+  PlanData plan[STEP_ENGINE_BUFFER_SIZE];
+  bool lookAheadEnabled;
+  // Arah (vektor satuan ruang-langkah), kecepatan jelajah, dan kecepatan aman blok
+  // terakhir yang diantrikan
+  float previousUnit[STEP_ENGINE_AXES];
+  float previousNominalSpeed;
+  float previousSafeSpeed;
+
+  void recalculate();
+  void applyProfile(uint8_t index, float entrySpeed, float exitSpeed);
+};
+
+#endif
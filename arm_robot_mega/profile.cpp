@@ -0,0 +1,87 @@
+// profile.cpp
+#include "profile.h"
+
+#if PROFILE
+
+#if !defined(__AVR__)
+#include <chrono>
+
+ProfileTime profileNow() {
+  static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+  return (ProfileTime)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - origin).count();
+}
+#endif
+
+static const char* const PROFILE_NAMES[PROFILE_COUNT] = {"parse", "ik", "interp", "planner", "step_isr"};
+
+// Probe ISR (step_isr) hanya ditulis di dalam ISR, probe lain hanya dari loop.
+// Karena itu pencatatan tidak perlu mematikan interrupt; hanya penyalinan saat laporan.
+static ProfileStats stats[PROFILE_COUNT];
+
+static void clearStats(ProfileStats& s) {
+  s.count = 0;
+  s.total = 0;
+  s.minTime = (ProfileTime)~(ProfileTime)0;
+  s.maxTime = 0;
+  for (uint8_t i = 0; i < PROFILE_BUCKETS; i++) s.buckets[i] = 0;
+}
+
+void profileBegin() {
+  for (uint8_t i = 0; i < PROFILE_COUNT; i++) clearStats(stats[i]);
+#if defined(__AVR__)
+  // Timer5 mode normal, tanpa prescaler: TCNT5 = siklus CPU modulo 65536
+  noInterrupts();
+  TCCR5A = 0;
+  TCCR5B = (1 << CS50);
+  TCNT5 = 0;
+  interrupts();
+#endif
+}
+
+void profileRecord(ProfileId id, ProfileTime elapsed) {
+  ProfileStats& s = stats[id];
+  s.count++;
+  s.total += elapsed;
+  if (elapsed < s.minTime) s.minTime = elapsed;
+  if (elapsed > s.maxTime) s.maxTime = elapsed;
+  uint8_t bucket = 0;
+  while (bucket < PROFILE_BUCKETS - 1 && (elapsed >> (bucket + 1)) != 0) bucket++;
+  s.buckets[bucket]++;
+}
+
+void profileReport() {
+  for (uint8_t i = 0; i < PROFILE_COUNT; i++) {
+    ProfileStats s;
+    noInterrupts();
+    s = stats[i];
+    clearStats(stats[i]);
+    interrupts();
+
+    Serial.print("M930: "); Serial.print(PROFILE_NAMES[i]);
+    Serial.print(" n="); Serial.print(s.count);
+    if (s.count > 0) {
+      Serial.print(" min="); Serial.print((unsigned long)s.minTime);
+      Serial.print(" avg="); Serial.print((unsigned long)(s.total / s.count));
+      Serial.print(" max="); Serial.print((unsigned long)s.maxTime);
+      // Histogram log2: hanya bucket pertama..terakhir yang terisi, "b<i>:" = bucket awal
+      uint8_t first = 0, last = PROFILE_BUCKETS - 1;
+      while (s.buckets[first] == 0) first++;
+      while (s.buckets[last] == 0) last--;
+      Serial.print(" hist=b"); Serial.print(first); Serial.print(":");
+      for (uint8_t b = first; b <= last; b++) {
+        if (b > first) Serial.print(",");
+        Serial.print(s.buckets[b]);
+      }
+    }
+    Serial.print(" "); Serial.println(PROFILE_UNIT);
+  }
+}
+
+#else
+
+void profileReport() {
+  Serial.println("M930: Profiling disabled (build with -DPROFILE=1)");
+}
+
+#endif
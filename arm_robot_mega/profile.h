@@ -0,0 +1,77 @@
+// profile.h
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <Arduino.h>
+
+// Probe profiling untuk jalur panas. Setiap PROFILE_SCOPE(id) mengukur durasi blok C++
+// tempatnya berada dan mencatat jumlah, min, rata-rata, max, serta histogram log2.
+// M930 mencetak statistik lalu mereset-nya.
+//
+// Aktif hanya jika dibangun dengan -DPROFILE=1; tanpa itu PROFILE_SCOPE kosong dan tidak
+// ada timer atau RAM yang dipakai (build rilis).
+//
+// Satuan: AVR = siklus CPU (Timer5 berjalan bebas tanpa prescaler, 62.5 ns). Pencacah 16-bit,
+// jadi scope yang lebih lama dari 65535 siklus (4.1 ms) terbaca modulo 65536.
+// Host (sim/) = nanodetik jam host, karena jam virtual simulasi tidak memajukan waktu
+// untuk komputasi murni.
+#ifndef PROFILE
+#define PROFILE 0
+#endif
+
+enum ProfileId : uint8_t {
+  PROFILE_PARSE,          // Command::parseLine / unpackFrame di decodeFrame: baris atau frame -> Cmd
+  PROFILE_IK,             // RobotGeometry::calculateIK
+  PROFILE_INTERPOLATION,  // Interpolation::updateActualPosition
+  PROFILE_PLANNER,        // Planner::bufferMove (termasuk look-ahead)
+  PROFILE_STEP_ISR,       // StepEngine::isr
+  PROFILE_COUNT
+};
+
+// Bucket i berisi durasi [2^i, 2^(i+1)); bucket terakhir juga semua yang lebih lama
+#define PROFILE_BUCKETS 16
+
+#if PROFILE
+
+#if defined(__AVR__)
+typedef uint16_t ProfileTime;
+#define PROFILE_UNIT "cycles"
+static inline ProfileTime profileNow() { return TCNT5; }
+#else
+typedef uint32_t ProfileTime;
+#define PROFILE_UNIT "ns"
+ProfileTime profileNow();
+#endif
+
+struct ProfileStats {
+  unsigned long count;
+  unsigned long long total;
+  ProfileTime minTime;
+  ProfileTime maxTime;
+  unsigned long buckets[PROFILE_BUCKETS];
+};
+
+void profileBegin();                                   // Mulai pencacah (Timer5 di AVR)
+void profileRecord(ProfileId id, ProfileTime elapsed);
+void profileReport();                                  // Cetak dan reset (M930)
+
+class ProfileScope {
+public:
+  ProfileScope(ProfileId aId) : id(aId), start(profileNow()) {}
+  ~ProfileScope() { profileRecord(id, (ProfileTime)(profileNow() - start)); }
+private:
+  ProfileId id;
+  ProfileTime start;
+};
+
+#define PROFILE_SCOPE(id) ProfileScope profileScope(id)
+
+#else
+
+static inline void profileBegin() {}
+void profileReport();
+#define PROFILE_SCOPE(id) do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,120 @@
+// ringBuffer.h
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <Arduino.h>
+
+// Orders the data accesses of a slot against the index store that publishes or releases it.
+// On AVR (single core, in-order) only the compiler can reorder, so a compiler barrier is
+// enough. The host build (sim/, stress test) may run producer and consumer on different
+// cores and needs a real fence.
+#ifdef __AVR__
+#define RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define RING_BARRIER() __atomic_thread_fence(__ATOMIC_ACQ_REL)
+#endif
+
+// Statically sized single-producer/single-consumer ring buffer.
+//
+// head and tail are free-running counters of type Index; the slot index is the counter masked
+// with N - 1, so N must be a power of two and all N slots are usable. Only the producer writes
+// tail and only the consumer writes head, and an 8-bit store is atomic on AVR. With the default
+// uint8_t Index one side may therefore run in an ISR (serial RX, step generator) and the other
+// in loop() without disabling interrupts. A uint16_t Index allows up to 32768 slots, but its
+// loads and stores are not atomic on AVR: use it only when both sides run in loop().
+//
+// A side that is not the owner of an operation must not call it: push/emplace/commit/pushBulk
+// belong to the producer, pop/peek/drop/popBulk/clear to the consumer. size(), isEmpty() and
+// isFull() may be called from either side; the value is a snapshot that can only become more
+// favourable for the caller.
+template <typename T, uint16_t N, typename Index = uint8_t>
+class RingBuffer {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "RingBuffer size must be a power of two");
+  static_assert(N <= (1UL << (8 * sizeof(Index) - 1)), "RingBuffer size must fit half the Index range");
+
+public:
+  RingBuffer() : head(0), tail(0) {}
+
+  static uint16_t capacity() { return N; }
+  Index size() const { return (Index)(tail - head); }
+  Index freeSlots() const { return N - size(); }
+  bool isEmpty() const { return head == tail; }
+  bool isFull() const { return size() == N; }
+
+  // Producer: copy item into the next slot. Returns false if the ring is full.
+  bool push(const T &item) {
+    T *slot = emplace();
+    if (!slot) return false;
+    *slot = item;
+    commit();
+    return true;
+  }
+
+  // Producer: fill the next slot in place, then publish it with commit().
+  // Returns nullptr if the ring is full. The slot is invisible to the consumer until commit().
+  T *emplace() {
+    if (isFull()) return nullptr;
+    return &buffer[tail & (N - 1)];
+  }
+  void commit() {
+    RING_BARRIER();
+    tail = tail + 1;
+  }
+
+  // Producer: copy up to count items, returns how many fit. All of them become visible at once.
+  Index pushBulk(const T *items, Index count) {
+    Index t = tail;
+    Index n = freeSlots();
+    if (count < n) n = count;
+    for (Index i = 0; i < n; i++) buffer[(Index)(t + i) & (N - 1)] = items[i];
+    RING_BARRIER();
+    tail = t + n;
+    return n;
+  }
+
+  // Consumer: oldest item, or nullptr if empty. It stays valid (and is not overwritten by the
+  // producer) until drop().
+  T *peek() {
+    if (isEmpty()) return nullptr;
+    RING_BARRIER();
+    return &buffer[head & (N - 1)];
+  }
+  void drop() {
+    RING_BARRIER();
+    head = head + 1;
+  }
+
+  // Consumer: move the oldest item into out. Returns false if the ring is empty.
+  bool pop(T &out) {
+    T *slot = peek();
+    if (!slot) return false;
+    out = *slot;
+    drop();
+    return true;
+  }
+
+  // Consumer: copy up to count items to out, returns how many were available.
+  Index popBulk(T *out, Index count) {
+    Index h = head;
+    Index n = size();
+    if (count < n) n = count;
+    RING_BARRIER();
+    for (Index i = 0; i < n; i++) out[i] = buffer[(Index)(h + i) & (N - 1)];
+    RING_BARRIER();
+    head = h + n;
+    return n;
+  }
+
+  // Consumer: discard everything published so far.
+  void clear() {
+    RING_BARRIER();
+    head = tail;
+  }
+
+private:
+  T buffer[N];
+  volatile Index head; // Next slot to read, written by the consumer only
+  volatile Index tail; // Next slot to write, written by the producer only
+};
+
+#endif
@@ -0,0 +1,29 @@
+// robotAxes.h
+#ifndef ROBOT_AXES_H
+#define ROBOT_AXES_H
+
+#include "pinout.h"
+#include "fastAxis.h"
+
+// Tipe keempat sumbu lengan: pin RAMPS (pinout.h) dan arah ditetapkan saat kompilasi.
+// FastAxis<stepPin, dirPin, enablePin, limitPin, dirHighToHome, reverseDirection>
+// dirHighToHome: TRUE jika HIGH (CW) pada dirPin menggerakkan motor menuju limit switch.
+// reverseDirection: TRUE jika arah fisik motor terbalik dari arah logis yang diinginkan (misalnya, CW motor memutar berlawanan arah dengan definisi positif).
+// PENTING: Konfigurasi ini adalah yang BENAR dan TIDAK BOLEH DIUBAH.
+typedef FastAxis<ROTATE_STEP_PIN, ROTATE_DIR_PIN, ROTATE_ENABLE_PIN, ROTATE_LIMIT_PIN, false, false> BaseAxis; // Base (RAMPS Z-Axis)
+typedef FastAxis<SHOULDER_STEP_PIN, SHOULDER_DIR_PIN, SHOULDER_ENABLE_PIN, SHOULDER_LIMIT_PIN, true, false> ShoulderAxis; // Shoulder (RAMPS Y-Axis)
+typedef FastAxis<ELBOW_STEP_PIN, ELBOW_DIR_PIN, ELBOW_ENABLE_PIN, ELBOW_LIMIT_PIN, false, false> ElbowAxis; // Elbow (RAMPS X-Axis)
+typedef FastAxis<SLIDER_STEP_PIN, SLIDER_DIR_PIN, SLIDER_ENABLE_PIN, SLIDER_LIMIT_PIN, true, false> SliderAxis; // Slider
+
+// Batas gerak per sumbu untuk planner (RampsStepper::setMotionLimits di setup()), dalam
+// langkah motor (microstep). Juga diperiksa simulasi (arm_sim --check-planner).
+// JERK adalah kecepatan yang aman dimulai dari diam tanpa stall (setara 1 langkah / 100 us
+// sebelum ada akselerasi); dari sana motor berakselerasi ke MAX_STEP_RATE.
+static const float JOINT_MAX_STEP_RATE = 16000.0;   // langkah/s (180 deg/s pada sendi 10:1)
+static const float JOINT_ACCELERATION = 40000.0;    // langkah/s^2
+static const float JOINT_JERK_STEP_RATE = 5000.0;   // langkah/s
+static const float SLIDER_MAX_STEP_RATE = 24000.0;  // langkah/s (150 mm/s)
+static const float SLIDER_ACCELERATION = 40000.0;   // langkah/s^2
+static const float SLIDER_JERK_STEP_RATE = 5000.0;  // langkah/s
+
+#endif
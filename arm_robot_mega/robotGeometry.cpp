@@ -1,6 +1,8 @@
 // robotGeometry.cpp
 #include <Arduino.h>
 #include "robotGeometry.h"
+#include "fixedMath.h"
+#include "profile.h"
 #include <math.h>
 
 // Panjang link robot dalam milimeter (mm):
@@ -9,10 +11,11 @@
 // L3: Panjang link Siku ke Pergelangan/Titik Referensi End-Effector (Elbow to Wrist)
 // PENTING: Nilai-nilai ini HARUS diukur dengan sangat akurat dari robot fisik.
 // Kesalahan pengukuran sekecil apapun akan menyebabkan ketidakakuratan dalam Inverse Kinematics.
-// Perhatikan: Variabel ini dideklarasikan di header RobotGeometry.h sebagai static const.
-// Kita hanya perlu memastikan nilainya konsisten di sini jika didefinisikan ulang,
-// atau menghapusnya jika sudah didefinisikan di header.
-// Untuk tujuan refactoring, kita akan menggunakannya dari header.
+// Nilai default ada di header RobotGeometry.h (DEFAULT_*), dan dapat diganti dengan
+// setLinkLengths() dari kalibrasi yang tersimpan di EEPROM.
+
+// REACH_TOLERANCE_MM untuk backend fixed-point, ditambah galat pembulatan Q6 dan fxSqrt
+static const long FX_REACH_TOLERANCE = 2;
 
 RobotGeometry::RobotGeometry() {
   // Inisialisasi semua variabel anggota di konstruktor
@@ -28,6 +31,42 @@ RobotGeometry::RobotGeometry() {
   cartesianOffsetX = 0.0;
   cartesianOffsetY = 0.0;
   cartesianOffsetZ = 0.0;
+  L1 = DEFAULT_L1;
+  L2 = DEFAULT_L2;
+  L3 = DEFAULT_L3;
+  eeForwardMm = DEFAULT_EE_FORWARD_OFFSET_MM;
+  eeDownMm = DEFAULT_EE_DOWN_OFFSET_MM;
+  reachStatus = REACH_OK;
+  for (uint8_t i = 0; i < GEOMETRY_JOINTS; i++) {
+    jointMinRad[i] = -INFINITY;
+    jointMaxRad[i] = INFINITY;
+  }
+  updateDerivedConstants();
+}
+
+// Hitung ulang konstanta turunan (float dan fixed-point) dari panjang link dan offset
+void RobotGeometry::updateDerivedConstants() {
+  l2SqPlusL3Sq = L2 * L2 + L3 * L3;
+  l2SqMinusL3Sq = L2 * L2 - L3 * L3;
+  invTwoL2L3 = 1.0 / (2.0 * L2 * L3);
+  twoL2 = 2.0 * L2;
+  minReach = fabs(L2 - L3);
+  maxReach = L2 + L3;
+
+  fxL1 = fxFromMm(L1);
+  fxL2 = fxFromMm(L2);
+  fxL3 = fxFromMm(L3);
+  fxEeForward = fxFromMm(eeForwardMm);
+  fxEeDown = fxFromMm(eeDownMm);
+  // Kuadrat panjang Q6 menjadi Q12
+  fxL2SqPlusL3Sq = fxL2 * fxL2 + fxL3 * fxL3;
+  fxL2SqMinusL3Sq = fxL2 * fxL2 - fxL3 * fxL3;
+  fxTwoL2L3 = 2 * fxL2 * fxL3;
+  fxMinReach = labs(fxL2 - fxL3);
+  fxMaxReach = fxL2 + fxL3;
+  fxBaseOffset = fxAngleFromFloat(kinematicBaseZeroOffsetRad);
+  fxShoulderOffset = fxAngleFromFloat(kinematicShoulderZeroOffsetRad);
+  fxElbowOffset = fxAngleFromFloat(kinematicElbowZeroOffsetRad);
 }
 
 // Mengatur target posisi End-Effector (dalam mm) dan menghitung sudut sendi (Inverse Kinematics)
@@ -40,6 +79,25 @@ void RobotGeometry::setPositionCartesianOffset(float x_mm, float y_mm, float z_m
 
 // Implementasi fungsi calculateIK (Inverse Kinematics)
 void RobotGeometry::calculateIK() {
+  PROFILE_SCOPE(PROFILE_IK);
+#if IK_BACKEND == IK_BACKEND_FIXED
+  reachStatus = calculateIKFixed();
+#else
+  reachStatus = calculateIKFloat();
+#endif
+  if (reachStatus == REACH_OK &&
+      (base_rad < jointMinRad[0] || base_rad > jointMaxRad[0] ||
+       sh_rad < jointMinRad[1] || sh_rad > jointMaxRad[1] ||
+       el_rad < jointMinRad[2] || el_rad > jointMaxRad[2])) {
+    reachStatus = REACH_JOINT_LIMIT;
+  }
+  // Sebelumnya target di luar jangkauan dibatasi diam-diam ke pose terdekat, sehingga
+  // lengan bergerak ke pose yang salah; NaN membuat pemanggil menolak gerakan
+  if (reachStatus != REACH_OK) base_rad = sh_rad = el_rad = NAN;
+}
+
+// Backend float (referensi)
+ReachStatus RobotGeometry::calculateIKFloat() {
   // === Inverse Kinematics (IK) ===
   // Tujuan: Menghitung sudut sendi (base_rad, sh_rad, el_rad) untuk mencapai target X, Y, Z.
   // Karena End-Effector memiliki offset tetap dari Wrist (titik akhir L3), kita perlu menghitung
@@ -53,26 +111,31 @@ void RobotGeometry::calculateIK() {
   // Hitung posisi Wrist Center (WC) yang diperlukan untuk mencapai target EE
   // Radial distance dari WC ke origin di bidang XY
   float ree_target = sqrt(x_ik * x_ik + y_ik * y_ik);
-  float r_wc_target = ree_target - EE_FORWARD_OFFSET_MM;
+  float r_wc_target = ree_target - eeForwardMm;
+  // Wrist di belakang sumbu Base (target lebih dekat dari offset EE ke depan)
+  if (r_wc_target < -REACH_TOLERANCE_MM) return REACH_TOO_CLOSE;
   if (r_wc_target < 0) r_wc_target = 0; // Pastikan tidak negatif
 
   // Tinggi relatif WC ke Shoulder Joint
-  // Karena EE_DOWN_OFFSET_MM adalah offset ke bawah dari Wrist,
+  // Karena eeDownMm adalah offset ke bawah dari Wrist,
   // untuk mendapatkan tinggi Wrist, kita harus MENAMBAHKAN offset ini ke target Z EE.
-  float z_wc_target_rel_sh = (z_ik - L1) + EE_DOWN_OFFSET_MM; // L1 adalah tinggi Base ke Shoulder
+  float z_wc_target_rel_sh = (z_ik - L1) + eeDownMm; // L1 adalah tinggi Base ke Shoulder
 
   // 2. Hitung d (jarak lurus dari Shoulder Joint ke Wrist Center)
   float d = sqrt(r_wc_target * r_wc_target + z_wc_target_rel_sh * z_wc_target_rel_sh);
 
-  // Batasan workspace untuk 'd':
-  // Pastikan d tidak lebih kecil dari selisih absolut L2 dan L3, atau lebih besar dari jumlah L2 dan L3
-  if (d < fabs(L2 - L3)) d = fabs(L2 - L3);
-  if (d > (L2 + L3))      d = L2 + L3;
+  // Batasan workspace untuk 'd': di luar [|L2 - L3|, L2 + L3] segitiga L2-L3-d tidak ada.
+  // Hanya galat pembulatan di batas (REACH_TOLERANCE_MM) yang dibatasi.
+  if (d > maxReach + REACH_TOLERANCE_MM) return REACH_TOO_FAR;
+  if (d < minReach - REACH_TOLERANCE_MM) return REACH_TOO_CLOSE;
+  if (d < minReach) d = minReach;
+  if (d > maxReach) d = maxReach;
   if (d < 0.001) d = 0.001; // Hindari pembagian dengan nol
 
   // 3. Hitung sudut internal elbow (phi): φ
   // Menggunakan hukum cosinus pada segitiga yang dibentuk oleh L2, L3, dan d
-  float cos_phi = (L2 * L2 + L3 * L3 - d * d) / (2.0 * L2 * L3);
+  float dSq = d * d;
+  float cos_phi = (l2SqPlusL3Sq - dSq) * invTwoL2L3;
   cos_phi = constrain(cos_phi, -1.0f, 1.0f); // Batasi nilai cos_phi antara -1 dan 1
   float phi = acos(cos_phi);
 
@@ -80,7 +143,7 @@ void RobotGeometry::calculateIK() {
   // Alpha adalah sudut dari sumbu horizontal ke garis d.
   // Beta adalah sudut dari L2 ke d.
   float alpha = atan2(z_wc_target_rel_sh, r_wc_target);
-  float cos_beta = (L2 * L2 + d * d - L3 * L3) / (2.0 * L2 * d);
+  float cos_beta = (l2SqMinusL3Sq + dSq) / (twoL2 * d);
   cos_beta = constrain(cos_beta, -1.0f, 1.0f);
   float beta = acos(cos_beta);
 
@@ -103,6 +166,63 @@ void RobotGeometry::calculateIK() {
   base_rad -= kinematicBaseZeroOffsetRad;
   sh_rad -= kinematicShoulderZeroOffsetRad;
   el_rad -= kinematicElbowZeroOffsetRad;
+  return REACH_OK;
+}
+
+// Backend fixed-point: langkah yang sama dengan calculateIKFloat(), tetapi panjang
+// dalam Q6 (1/64 mm) dan sudut dalam Q14, tanpa operasi float selain konversi masuk/keluar.
+ReachStatus RobotGeometry::calculateIKFixed() {
+  float x_mm = x_target - cartesianOffsetX;
+  float y_mm = y_target - cartesianOffsetY;
+  float z_mm = z_target - cartesianOffsetZ;
+  // Target dengan |X| atau |Y| di atas L2 + L3 + offset EE, atau Wrist lebih dari L2 + L3
+  // di atas/bawah Shoulder, pasti di luar jangkauan. Ditolak sebelum konversi dan kuadrat:
+  // sebelumnya x^2 + y^2 di atas ~1024^2 mm^2 wrap di uint32 dan X745 Y745 lolos sebagai
+  // target dekat. Perbandingan terbalik juga menolak NaN.
+  float planarLimit = maxReach + eeForwardMm + REACH_TOLERANCE_MM;
+  if (!(fabs(x_mm) <= planarLimit && fabs(y_mm) <= planarLimit &&
+        fabs(z_mm - L1 + eeDownMm) <= maxReach + REACH_TOLERANCE_MM)) {
+    return REACH_TOO_FAR;
+  }
+  long x_ik = fxFromMm(x_mm);
+  long y_ik = fxFromMm(y_mm);
+  long z_ik = fxFromMm(z_mm);
+
+  // Posisi Wrist Center (WC)
+  long ree_target = fxSqrt(fxSquareSum(x_ik, y_ik));
+  long r_wc_target = ree_target - fxEeForward;
+  if (r_wc_target < -FX_REACH_TOLERANCE) return REACH_TOO_CLOSE;
+  if (r_wc_target < 0) r_wc_target = 0;
+  long z_wc_target_rel_sh = (z_ik - fxL1) + fxEeDown;
+
+  // Jarak Shoulder ke WC; hanya galat pembulatan di batas workspace yang dibatasi
+  long d = fxSqrt(fxSquareSum(r_wc_target, z_wc_target_rel_sh));
+  if (d > fxMaxReach + FX_REACH_TOLERANCE) return REACH_TOO_FAR;
+  if (d < fxMinReach - FX_REACH_TOLERANCE) return REACH_TOO_CLOSE;
+  if (d < fxMinReach) d = fxMinReach;
+  if (d > fxMaxReach) d = fxMaxReach;
+  if (d < 1) d = 1;
+  long dSq = d * d; // Q12
+
+  // Hukum cosinus untuk phi (elbow) dan beta (shoulder)
+  long phi = fxAcosRatio(fxL2SqPlusL3Sq - dSq, fxTwoL2L3);
+  long alpha = fxAtan2(z_wc_target_rel_sh, r_wc_target);
+  long beta = fxAcosRatio(fxL2SqMinusL3Sq + dSq, 2 * fxL2 * d);
+
+  long sh, el;
+  if (_useElbowDownSolution) {
+    sh = alpha - beta;
+    el = phi - FX_PI;
+  } else {
+    sh = alpha + beta;
+    el = FX_PI - phi;
+  }
+  long base = fxAtan2(y_ik, x_ik);
+
+  base_rad = fxAngleToFloat(base - fxBaseOffset);
+  sh_rad = fxAngleToFloat(sh - fxShoulderOffset);
+  el_rad = fxAngleToFloat(el - fxElbowOffset);
+  return REACH_OK;
 }
 
 // Mengatur apakah akan menggunakan solusi Inverse Kinematics "Elbow Down"
@@ -126,11 +246,66 @@ void RobotGeometry::setKinematicZeroOffsets(float baseOffsetRad, float shoulderO
     kinematicBaseZeroOffsetRad = baseOffsetRad;
     kinematicShoulderZeroOffsetRad = shoulderOffsetRad;
     kinematicElbowZeroOffsetRad = elbowOffsetRad;
+    updateDerivedConstants();
     Serial.print("DEBUG: Offset nol kinematik diatur ke [Base="); Serial.print(degrees(baseOffsetRad), 2);
     Serial.print("deg, Shoulder="); Serial.print(degrees(shoulderOffsetRad), 2);
     Serial.print("deg, Elbow="); Serial.print(degrees(elbowOffsetRad), 2); Serial.println("deg]");
 }
 
+bool RobotGeometry::linkLengthsSupported(float l1, float l2, float l3, float aEeForwardMm, float aEeDownMm) {
+    // Perbandingan terbalik juga menolak NaN
+    if (!(l1 > 0.0 && l2 > 0.0 && l3 > 0.0 && l1 < INFINITY && l2 < INFINITY && l3 < INFINITY &&
+          fabs(aEeForwardMm) < INFINITY && fabs(aEeDownMm) < INFINITY)) {
+        return false;
+    }
+#if IK_BACKEND == IK_BACKEND_FIXED
+    return fixedIkSupports(l1, l2, l3, aEeForwardMm, aEeDownMm);
+#else
+    return true;
+#endif
+}
+
+bool RobotGeometry::fixedIkSupports(float l1, float l2, float l3, float aEeForwardMm, float aEeDownMm) {
+    const double q12 = (double)(1L << (2 * FX_LENGTH_SHIFT));
+    const double longMax = 2147483647.0 / q12;    // mm² yang muat di long sebagai Q12
+    const double ulongMax = 4294967295.0 / q12;   // mm² yang muat di uint32 sebagai Q12
+    double reach = (double)l2 + l3;
+    // fxL2SqPlusL3Sq dan dSq (d sampai L2 + L3; 2·L2·L3 lebih kecil dari keduanya)
+    if (!((double)l2 * l2 + (double)l3 * l3 < longMax && reach * reach < longMax)) return false;
+    // Penyebut beta 2·L2·d, dan pembilang + penyebut fxAcosRatio() untuk beta
+    if (!(2.0 * l2 * reach < longMax)) return false;
+    if (!((double)l2 * l2 - (double)l3 * l3 + reach * reach + 2.0 * l2 * reach < ulongMax)) return false;
+    // Target yang lolos pemeriksaan jangkauan calculateIKFixed() masuk fxSquareSum()
+    if (!(reach + fabs(aEeForwardMm) + REACH_TOLERANCE_MM < FX_LENGTH_MAX_MM)) return false;
+    return l1 < FX_LENGTH_MAX_MM && fabs(aEeDownMm) < FX_LENGTH_MAX_MM;
+}
+
+bool RobotGeometry::setLinkLengths(float l1, float l2, float l3, float aEeForwardMm, float aEeDownMm) {
+    if (!linkLengthsSupported(l1, l2, l3, aEeForwardMm, aEeDownMm)) return false;
+    L1 = l1;
+    L2 = l2;
+    L3 = l3;
+    eeForwardMm = aEeForwardMm;
+    eeDownMm = aEeDownMm;
+    updateDerivedConstants();
+    return true;
+}
+
+void RobotGeometry::setJointLimits(uint8_t joint, float minRad, float maxRad) {
+    jointMinRad[joint] = minRad;
+    jointMaxRad[joint] = maxRad;
+}
+
+const char* RobotGeometry::reachStatusName(ReachStatus status) {
+  switch (status) {
+    case REACH_OK: return "OK";
+    case REACH_TOO_FAR: return "TOO_FAR";
+    case REACH_TOO_CLOSE: return "TOO_CLOSE";
+    case REACH_JOINT_LIMIT: return "JOINT_LIMIT";
+  }
+  return "?";
+}
+
 // Getter untuk sudut Base (dari IK)
 float RobotGeometry::getBaseRad() const {
   return base_rad;
@@ -155,19 +330,15 @@ void RobotGeometry::calculateFK(float base_rad_in, float shoulder_rad_in, float
   float adjustedShoulderRad = shoulder_rad_in + kinematicShoulderZeroOffsetRad;
   float adjustedElbowRad = elbow_rad_in + kinematicElbowZeroOffsetRad;
 
-  // Sudut relatif Elbow terhadap Shoulder (phi dari IK)
-  // Ini adalah sudut yang dibentuk oleh L2 dan L3
-  float phi_fk;
-  if (_useElbowDownSolution) {
-      phi_fk = M_PI + adjustedElbowRad; 
-  } else {
-      phi_fk = M_PI - adjustedElbowRad; 
-  }
+  // Arah link L3 terhadap horizontal. IK memberi el_rad = π - φ (Elbow Up) atau φ - π
+  // (Elbow Down), dengan φ sudut dalam antara L2 dan L3; pada kedua solusi L3 berbelok
+  // sebesar -el_rad dari arah L2, sehingga rumusnya sama.
+  float l3Rad = adjustedShoulderRad - adjustedElbowRad;
 
   // 1. Hitung posisi Wrist Center (WC) relatif terhadap Shoulder Joint
   // Menggunakan L2 dan L3
-  float r_wc_rel_sh = L2 * cos(adjustedShoulderRad) + L3 * cos(adjustedShoulderRad + phi_fk);
-  float z_wc_rel_sh = L2 * sin(adjustedShoulderRad) + L3 * sin(adjustedShoulderRad + phi_fk);
+  float r_wc_rel_sh = L2 * cos(adjustedShoulderRad) + L3 * cos(l3Rad);
+  float z_wc_rel_sh = L2 * sin(adjustedShoulderRad) + L3 * sin(l3Rad);
 
   // 2. Hitung posisi Wrist Center (WC) dalam koordinat dunia (relatif terhadap Base)
   // Menambahkan tinggi Base ke Shoulder (L1) ke komponen Z
@@ -175,10 +346,10 @@ void RobotGeometry::calculateFK(float base_rad_in, float shoulder_rad_in, float
   float wc_z_world = z_wc_rel_sh + L1; // L1 adalah tinggi Base ke Shoulder
 
   // 3. Tambahkan offset End-Effector (EE) dari Wrist Center (WC)
-  // EE_FORWARD_OFFSET_MM ditambahkan ke komponen radial
-  // EE_DOWN_OFFSET_MM dikurangi dari komponen Z (karena ke bawah)
-  float ee_x_world_radial = wc_x_world_radial + EE_FORWARD_OFFSET_MM;
-  float ee_z_world = wc_z_world - EE_DOWN_OFFSET_MM; 
+  // eeForwardMm ditambahkan ke komponen radial
+  // eeDownMm dikurangi dari komponen Z (karena ke bawah)
+  float ee_x_world_radial = wc_x_world_radial + eeForwardMm;
+  float ee_z_world = wc_z_world - eeDownMm; 
 
   // 4. Rotasi berdasarkan sudut Base (adjustedBaseRad) untuk mendapatkan final X, Y, Z
   // Kemudian tambahkan offset Kartesian global
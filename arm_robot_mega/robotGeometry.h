@@ -3,15 +3,50 @@
 #define ROBOT_GEOMETRY_H
 
 #include <math.h> // Diperlukan untuk M_PI jika digunakan di header
+#include <stdint.h>
+
+// Backend Inverse Kinematics, dipilih saat kompilasi:
+// IK_BACKEND_FLOAT: float dengan sqrt/acos/atan2 dari libm (referensi)
+// IK_BACKEND_FIXED: fixed-point dengan tabel atan PROGMEM dan akar bilangan bulat,
+//                   jauh lebih murah pada ATmega2560 yang tidak memiliki FPU.
+//                   Galat posisi tipikal ~0.03 mm, membesar di dekat batas jangkauan.
+#define IK_BACKEND_FLOAT 0
+#define IK_BACKEND_FIXED 1
+#ifndef IK_BACKEND
+#define IK_BACKEND IK_BACKEND_FLOAT
+#endif
+
+// Hasil Inverse Kinematics. Selain REACH_OK, ketiga sudut IK bernilai NaN.
+enum ReachStatus : uint8_t {
+  REACH_OK,
+  REACH_TOO_FAR,     // Wrist lebih jauh dari L2 + L3 dari Shoulder
+  REACH_TOO_CLOSE,   // Wrist lebih dekat dari |L2 - L3|, atau di belakang sumbu Base
+  REACH_JOINT_LIMIT  // Sudut di luar batas sendi (setJointLimits)
+};
+
+// Toleransi di batas jangkauan: target sedikit di luar (pembulatan float) masih dibatasi
+// ke batas seperti sebelumnya, target yang lebih jauh menghasilkan NaN
+#define REACH_TOLERANCE_MM 0.01
+
+#define GEOMETRY_JOINTS 3 // Base, Shoulder, Elbow
 
 class RobotGeometry {
 public:
   RobotGeometry();
-  // Masukkan target posisi EE (dalam mm), hitung θ1, θ2, θ3 (Inverse Kinematics)
+  // Masukkan target posisi EE (dalam mm), hitung θ1, θ2, θ3 (Inverse Kinematics).
+  // Target di luar jangkauan atau batas sendi menghasilkan sudut NaN (lihat getReachStatus).
   void setPositionCartesianOffset(float x_mm, float y_mm, float z_mm); // Mengubah return type menjadi void
   float getBaseRad()    const; // θ1
   float getShoulderRad()const; // θ2
   float getElbowRad()   const; // θ3
+  ReachStatus getReachStatus() const { return reachStatus; }
+  static const char* reachStatusName(ReachStatus status);
+
+  // Batas sudut sendi (0 = Base, 1 = Shoulder, 2 = Elbow) dalam sudut yang sama dengan
+  // getBaseRad() dst. (dari '0 langkah' stepper). Default tanpa batas (±INFINITY).
+  void setJointLimits(uint8_t joint, float minRad, float maxRad);
+  float getJointMinRad(uint8_t joint) const { return jointMinRad[joint]; }
+  float getJointMaxRad(uint8_t joint) const { return jointMaxRad[joint]; }
 
   // Hitung posisi Kartesian (X, Y, Z) dari sudut-sudut sendi (Forward Kinematics)
   void calculateFK(float base_rad_in, float shoulder_rad_in, float elbow_rad_in);
@@ -28,6 +63,39 @@ public:
   // Set offset untuk posisi nol kinematik setiap sendi
   void setKinematicZeroOffsets(float baseOffsetRad, float shoulderOffsetRad, float elbowOffsetRad);
 
+  // Panjang link robot dalam milimeter (mm):
+  // L1: Tinggi vertikal sendi Bahu dari permukaan dasar robot (Base height to Shoulder)
+  // L2: Panjang link Bahu ke Siku (Shoulder to Elbow)
+  // L3: Panjang link Siku ke Pergelangan/Titik Referensi End-Effector (Elbow to Wrist)
+  // PENTING: Nilai-nilai ini HARUS diukur dengan sangat akurat dari robot fisik.
+  // Kesalahan pengukuran sekecil apapun akan menyebabkan ketidakakuratan dalam Inverse Kinematics.
+  static constexpr float DEFAULT_L1 = 160.0;   // Tinggi Base ke Shoulder (sebelumnya h_sh)
+  static constexpr float DEFAULT_L2 = 130.0;   // Shoulder ke Elbow (sebelumnya l1)
+  static constexpr float DEFAULT_L3 = 160.0;   // Elbow ke Wrist (sebelumnya l2)
+
+  // Offset End-Effector dari titik akhir L3 (Wrist)
+  // End-effector selalu mengarah horizontal, 5cm ke depan dan 5cm ke bawah dari Wrist.
+  static constexpr float DEFAULT_EE_FORWARD_OFFSET_MM = 50.0; // Offset horizontal ke depan (5cm)
+  static constexpr float DEFAULT_EE_DOWN_OFFSET_MM = 50.0;    // Offset vertikal ke bawah (5cm)
+
+  // Panjang link dan offset end-effector (mm), awalnya DEFAULT_* di atas.
+  // Dapat diganti saat runtime (M665/M666 atau kalibrasi EEPROM); konstanta turunan IK
+  // dihitung ulang sekali di sini, bukan pada setiap panggilan IK. Mengembalikan false dan
+  // tidak mengubah apa pun jika nilainya ditolak linkLengthsSupported().
+  bool setLinkLengths(float l1, float l2, float l3, float eeForwardMm, float eeDownMm);
+  // Nilai yang dapat dipakai backend IK yang dikompilasi: panjang link positif, semua nilai
+  // berhingga, dan untuk IK_BACKEND_FIXED juga dalam batas fixedIkSupports()
+  static bool linkLengthsSupported(float l1, float l2, float l3, float eeForwardMm, float eeDownMm);
+  // Batas backend fixed-point: setiap besaran Q12 di calculateIKFixed() harus muat di long,
+  // sehingga L2 + L3 harus di bawah ~724 mm (d² dengan d sampai L2 + L3), dan target sejauh
+  // L2 + L3 + |eeForward| harus di bawah FX_LENGTH_MAX_MM
+  static bool fixedIkSupports(float l1, float l2, float l3, float eeForwardMm, float eeDownMm);
+  float getL1() const { return L1; }
+  float getL2() const { return L2; }
+  float getL3() const { return L3; }
+  float getEeForwardMm() const { return eeForwardMm; }
+  float getEeDownMm() const { return eeDownMm; }
+
   // Getter untuk offset nol kinematik (BARU)
   float getKinematicBaseZeroOffsetRad() const { return kinematicBaseZeroOffsetRad; }
   float getKinematicShoulderZeroOffsetRad() const { return kinematicShoulderZeroOffsetRad; }
@@ -41,20 +109,8 @@ private:
   // Variabel anggota untuk menyimpan hasil FK
   float fk_x, fk_y, fk_z; 
 
-  // Panjang link robot dalam milimeter (mm):
-  // L1: Tinggi vertikal sendi Bahu dari permukaan dasar robot (Base height to Shoulder)
-  // L2: Panjang link Bahu ke Siku (Shoulder to Elbow)
-  // L3: Panjang link Siku ke Pergelangan/Titik Referensi End-Effector (Elbow to Wrist)
-  // PENTING: Nilai-nilai ini HARUS diukur dengan sangat akurat dari robot fisik.
-  // Kesalahan pengukuran sekecil apapun akan menyebabkan ketidakakuratan dalam Inverse Kinematics.
-  static const float L1 = 160.0;   // Tinggi Base ke Shoulder (sebelumnya h_sh)
-  static const float L2 = 130.0;   // Shoulder ke Elbow (sebelumnya l1)
-  static const float L3 = 160.0;   // Elbow ke Wrist (sebelumnya l2)
-
-  // Offset End-Effector dari titik akhir L3 (Wrist)
-  // End-effector selalu mengarah horizontal, 5cm ke depan dan 5cm ke bawah dari Wrist.
-  static const float EE_FORWARD_OFFSET_MM = 50.0; // Offset horizontal ke depan (5cm)
-  static const float EE_DOWN_OFFSET_MM = 50.0;    // Offset vertikal ke bawah (5cm)
+  float L1, L2, L3;              // Panjang link yang dipakai IK/FK
+  float eeForwardMm, eeDownMm;   // Offset end-effector yang dipakai IK/FK
 
   // Offset sudut untuk mengkalibrasi posisi fisik '0 langkah' motor ke '0' kinematik model
   float kinematicBaseZeroOffsetRad;
@@ -63,9 +119,28 @@ private:
 
   float cartesianOffsetX, cartesianOffsetY, cartesianOffsetZ; // Offset Kartesian baru
 
-  void calculateIK(); // Deklarasi fungsi private
+  ReachStatus reachStatus;
+  float jointMinRad[GEOMETRY_JOINTS], jointMaxRad[GEOMETRY_JOINTS];
+
+  void calculateIK(); // Deklarasi fungsi private, memanggil backend yang dipilih IK_BACKEND
+  ReachStatus calculateIKFloat();
+  ReachStatus calculateIKFixed();
+
+  // Konstanta turunan panjang link untuk calculateIKFloat()
+  float l2SqPlusL3Sq, l2SqMinusL3Sq; // L2² + L3², L2² - L3²
+  float invTwoL2L3, twoL2;           // 1 / (2·L2·L3), 2·L2
+  float minReach, maxReach;          // |L2 - L3|, L2 + L3
+  // Konstanta fixed-point untuk calculateIKFixed() (panjang Q6, sudut Q14)
+  long fxL1, fxL2, fxL3, fxEeForward, fxEeDown;
+  long fxL2SqPlusL3Sq, fxL2SqMinusL3Sq, fxTwoL2L3, fxMinReach, fxMaxReach;
+  long fxBaseOffset, fxShoulderOffset, fxElbowOffset;
+  // Hitung ulang semua konstanta turunan setelah panjang link atau offset nol berubah
+  void updateDerivedConstants();
 
   bool _useElbowDownSolution; // Default ke Elbow Up, inisialisasi di konstruktor
+
+  // sim/simBench.cpp memanggil kedua backend pada objek yang sama untuk membandingkannya
+  friend struct SimIkBackends;
 };
 
 #endif
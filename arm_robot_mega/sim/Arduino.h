@@ -0,0 +1,166 @@
+// Arduino.h (simulasi host)
+// Pengganti Arduino core untuk membangun firmware di Linux. Hanya API yang dipakai
+// arm_robot_mega yang disediakan. Waktu berjalan pada jam virtual (simHal.h):
+// setiap pemanggilan HAL memakan sedikit waktu simulasi, dan interrupt timer
+// step generator dijalankan saat jam virtual melewati compare berikutnya.
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <type_traits>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define DEC 10
+#define HEX 16
+
+// Ukuran ring buffer HardwareSerial ATmega2560
+#ifndef SERIAL_RX_BUFFER_SIZE
+#define SERIAL_RX_BUFFER_SIZE 64
+#endif
+#define SERIAL_TX_BUFFER_SIZE 64
+
+#define PROGMEM
+#define F(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define memcpy_P(dest, src, n) memcpy((dest), (src), (n))
+
+#define radians(deg) ((deg) * M_PI / 180.0)
+#define degrees(rad) ((rad) * 180.0 / M_PI)
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Fungsi (bukan makro seperti di AVR) agar tidak bentrok dengan header STL
+template <typename A, typename B> inline typename std::common_type<A, B>::type min(A a, B b) { return a < b ? a : b; }
+template <typename A, typename B> inline typename std::common_type<A, B>::type max(A a, B b) { return a > b ? a : b; }
+
+// GPIO dan waktu (simHal.cpp)
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void noInterrupts();
+void interrupts();
+void yield();
+// Interrupt pin (simHal.cpp): INTn seperti Arduino Mega (interrupt 0..5 = pin 2, 3, 21, 20,
+// 19, 18), dan simAttachPinChange() sebagai pengganti PCMSK/PCICR untuk pin PCINT.
+// ISR dipanggil setelah level pin model berubah, di antara ISR lain seperti di AVR.
+#define CHANGE 1
+#define NOT_AN_INTERRUPT -1
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode);
+bool simAttachPinChange(uint8_t pin, void (*isr)()); // false jika pin tidak punya PCINT
+// Akses register langsung FastPin (fastGpio.h): pin dan biaya AVR operasinya
+void simFastPinWrite(uint8_t pin, uint8_t value, uint8_t instructions, uint8_t cycles);
+int simFastPinRead(uint8_t pin, uint8_t instructions, uint8_t cycles);
+// TCNT1 (Timer1, 2 MHz) saat ini, termasuk waktu ISR yang sedang berjalan; satu pembacaan
+// membebankan `cycles` siklus CPU (menunggu lebar pulsa step di StepEngine::isr)
+uint16_t simStepTimerCount(uint8_t cycles);
+
+// Subset Arduino String di atas std::string
+class String {
+public:
+  String(const char* str = "") : s(str ? str : "") {}
+  String(const std::string& str) : s(str) {}
+  String(char c) : s(1, c) {}
+  String(int value) : s(std::to_string(value)) {}
+  String(long value) : s(std::to_string(value)) {}
+  String(unsigned long value) : s(std::to_string(value)) {}
+
+  unsigned int length() const { return s.size(); }
+  const char* c_str() const { return s.c_str(); }
+  char charAt(unsigned int i) const { return i < s.size() ? s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+
+  String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (to > s.size()) to = s.size();
+    return from < to ? String(s.substr(from, to - from)) : String();
+  }
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t p = s.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  int indexOf(const String& str, unsigned int from = 0) const {
+    size_t p = s.find(str.s, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return (float)atof(s.c_str()); }
+
+  void trim();
+  void toUpperCase();
+  void toLowerCase();
+  bool equalsIgnoreCase(const String& other) const;
+  bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+  bool endsWith(const String& suffix) const {
+    return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+  }
+
+  String& operator+=(char c) { s += c; return *this; }
+  String& operator+=(const char* str) { s += str; return *this; }
+  String& operator+=(const String& str) { s += str.s; return *this; }
+  String operator+(const String& other) const { return String(s + other.s); }
+  bool operator==(const String& other) const { return s == other.s; }
+  bool operator==(const char* other) const { return s == other; }
+  bool operator!=(const String& other) const { return s != other.s; }
+
+private:
+  std::string s;
+};
+
+// Serial: RX diisi oleh simulator, TX diteruskan ke simulator per baris atau per frame balasan
+class SimSerial {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  void setTimeout(unsigned long ms) { timeoutMs = ms; }
+  int available();
+  int read();
+  int peek();
+  int availableForWrite();
+  void flush() {}
+  String readStringUntil(char terminator);
+  size_t readBytesUntil(char terminator, char* buffer, size_t length);
+
+  size_t write(uint8_t c);
+  size_t write(const char* str);
+  size_t write(const uint8_t* buffer, size_t size);
+
+  size_t print(const char* str) { return write(str); }
+  size_t print(const String& str) { return write(str.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int value, int base = DEC) { return printNumber(value, base); }
+  size_t print(unsigned int value, int base = DEC) { return printNumber(value, base); }
+  size_t print(long value, int base = DEC) { return printNumber(value, base); }
+  size_t print(unsigned long value, int base = DEC) { return printNumber(value, base); }
+  size_t print(double value, int digits = 2);
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(const T& value) { size_t n = print(value); return n + println(); }
+  template <typename T> size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+
+private:
+  unsigned long timeoutMs = 1000;
+  size_t printNumber(long long value, int base);
+};
+
+extern SimSerial Serial;
+
+#endif
@@ -0,0 +1,35 @@
+// EEPROM.h (simulasi host)
+// Pengganti library EEPROM Arduino: 4 KB seperti ATmega2560, awalnya terhapus (0xFF).
+// Isinya dapat disimpan ke file (simSetEepromFile) agar start ulang dapat disimulasikan.
+#ifndef SIM_EEPROM_H
+#define SIM_EEPROM_H
+
+#include <Arduino.h>
+
+#define SIM_EEPROM_SIZE 4096
+
+uint8_t simEepromRead(int address);
+void simEepromWrite(int address, uint8_t value); // Memakan ~3.4 ms jam virtual seperti AVR
+
+class EEPROMClass {
+public:
+  uint8_t read(int address) { return simEepromRead(address); }
+  void write(int address, uint8_t value) { simEepromWrite(address, value); }
+  void update(int address, uint8_t value) { if (read(address) != value) write(address, value); }
+  uint16_t length() { return SIM_EEPROM_SIZE; }
+
+  template <typename T> T& get(int address, T& value) {
+    uint8_t* bytes = (uint8_t*)&value;
+    for (size_t i = 0; i < sizeof(T); i++) bytes[i] = read(address + i);
+    return value;
+  }
+  template <typename T> const T& put(int address, const T& value) {
+    const uint8_t* bytes = (const uint8_t*)&value;
+    for (size_t i = 0; i < sizeof(T); i++) update(address + i, bytes[i]);
+    return value;
+  }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
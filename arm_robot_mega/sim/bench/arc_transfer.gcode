@@ -0,0 +1,20 @@
+; Transfer melengkung G2/G3 di atas wadah: satu perintah per busur (bandingkan arc_transfer_g1.gcode)
+G0 X20 Y250 Z285
+G1 X20 Y250 Z255 F1500
+M8
+G4 T0.2
+G1 X20 Y250 Z285 F1500
+G2 X-60 Y230 I-40 J-10 F3000
+G1 X-60 Y230 Z260 F1500
+M9
+G4 T0.2
+G1 X-60 Y230 Z285 F1500
+G3 X60 Y230 R75 F3000
+G1 X60 Y230 Z260 F1500
+M8
+G4 T0.2
+G1 X60 Y230 Z285 F1500
+G2 X0 Y240 Z270 R70 F3000
+G2 X0 Y240 I0 J15 F2000
+G3 X0 Y240 Z285 I0 J-20 F2000
+G0 X0 Y240 Z285
@@ -0,0 +1,201 @@
+; Transfer yang sama dengan arc_transfer.gcode, busur dipecah pengirim menjadi tali busur G1 ~3 mm
+G0 X20 Y250 Z285
+G1 X20 Y250 Z255 F1500
+M8
+G4 T0.2
+G1 X20 Y250 Z285 F1500
+G1 X20.61 Y247.12 Z285 F3000
+G1 X21.02 Y244.21 Z285 F3000
+G1 X21.21 Y241.27 Z285 F3000
+G1 X21.2 Y238.33 Z285 F3000
+G1 X20.97 Y235.39 Z285 F3000
+G1 X20.54 Y232.48 Z285 F3000
+G1 X19.9 Y229.61 Z285 F3000
+G1 X19.06 Y226.79 Z285 F3000
+G1 X18.01 Y224.03 Z285 F3000
+G1 X16.78 Y221.36 Z285 F3000
+G1 X15.36 Y218.79 Z285 F3000
+G1 X13.75 Y216.32 Z285 F3000
+G1 X11.98 Y213.97 Z285 F3000
+G1 X10.04 Y211.76 Z285 F3000
+G1 X7.95 Y209.69 Z285 F3000
+G1 X5.71 Y207.77 Z285 F3000
+G1 X3.35 Y206.02 Z285 F3000
+G1 X0.86 Y204.44 Z285 F3000
+G1 X-1.73 Y203.04 Z285 F3000
+G1 X-4.41 Y201.83 Z285 F3000
+G1 X-7.17 Y200.82 Z285 F3000
+G1 X-10 Y200 Z285 F3000
+G1 X-12.88 Y199.39 Z285 F3000
+G1 X-15.79 Y198.98 Z285 F3000
+G1 X-18.73 Y198.79 Z285 F3000
+G1 X-21.67 Y198.8 Z285 F3000
+G1 X-24.61 Y199.03 Z285 F3000
+G1 X-27.52 Y199.46 Z285 F3000
+G1 X-30.39 Y200.1 Z285 F3000
+G1 X-33.21 Y200.94 Z285 F3000
+G1 X-35.97 Y201.99 Z285 F3000
+G1 X-38.64 Y203.22 Z285 F3000
+G1 X-41.21 Y204.64 Z285 F3000
+G1 X-43.68 Y206.25 Z285 F3000
+G1 X-46.03 Y208.02 Z285 F3000
+G1 X-48.24 Y209.96 Z285 F3000
+G1 X-50.31 Y212.05 Z285 F3000
+G1 X-52.23 Y214.29 Z285 F3000
+G1 X-53.98 Y216.65 Z285 F3000
+G1 X-55.56 Y219.14 Z285 F3000
+G1 X-56.96 Y221.73 Z285 F3000
+G1 X-58.17 Y224.41 Z285 F3000
+G1 X-59.18 Y227.17 Z285 F3000
+G1 X-60 Y230 Z285 F3000
+G1 X-60 Y230 Z260 F1500
+M9
+G4 T0.2
+G1 X-60 Y230 Z285 F1500
+G1 X-58.18 Y227.67 Z285 F3000
+G1 X-56.27 Y225.41 Z285 F3000
+G1 X-54.27 Y223.23 Z285 F3000
+G1 X-52.18 Y221.13 Z285 F3000
+G1 X-50.02 Y219.11 Z285 F3000
+G1 X-47.77 Y217.18 Z285 F3000
+G1 X-45.45 Y215.34 Z285 F3000
+G1 X-43.06 Y213.6 Z285 F3000
+G1 X-40.61 Y211.95 Z285 F3000
+G1 X-38.09 Y210.39 Z285 F3000
+G1 X-35.51 Y208.94 Z285 F3000
+G1 X-32.88 Y207.59 Z285 F3000
+G1 X-30.19 Y206.35 Z285 F3000
+G1 X-27.46 Y205.21 Z285 F3000
+G1 X-24.69 Y204.18 Z285 F3000
+G1 X-21.87 Y203.26 Z285 F3000
+G1 X-19.03 Y202.45 Z285 F3000
+G1 X-16.15 Y201.76 Z285 F3000
+G1 X-13.25 Y201.18 Z285 F3000
+G1 X-10.33 Y200.71 Z285 F3000
+G1 X-7.39 Y200.36 Z285 F3000
+G1 X-4.44 Y200.13 Z285 F3000
+G1 X-1.48 Y200.01 Z285 F3000
+G1 X1.48 Y200.01 Z285 F3000
+G1 X4.44 Y200.13 Z285 F3000
+G1 X7.39 Y200.36 Z285 F3000
+G1 X10.33 Y200.71 Z285 F3000
+G1 X13.25 Y201.18 Z285 F3000
+G1 X16.15 Y201.76 Z285 F3000
+G1 X19.03 Y202.45 Z285 F3000
+G1 X21.87 Y203.26 Z285 F3000
+G1 X24.69 Y204.18 Z285 F3000
+G1 X27.46 Y205.21 Z285 F3000
+G1 X30.19 Y206.35 Z285 F3000
+G1 X32.88 Y207.59 Z285 F3000
+G1 X35.51 Y208.94 Z285 F3000
+G1 X38.09 Y210.39 Z285 F3000
+G1 X40.61 Y211.95 Z285 F3000
+G1 X43.06 Y213.6 Z285 F3000
+G1 X45.45 Y215.34 Z285 F3000
+G1 X47.77 Y217.18 Z285 F3000
+G1 X50.02 Y219.11 Z285 F3000
+G1 X52.18 Y221.13 Z285 F3000
+G1 X54.27 Y223.23 Z285 F3000
+G1 X56.27 Y225.41 Z285 F3000
+G1 X58.18 Y227.67 Z285 F3000
+G1 X60 Y230 Z285 F3000
+G1 X60 Y230 Z260 F1500
+M8
+G4 T0.2
+G1 X60 Y230 Z285 F1500
+G1 X57.11 Y229.22 Z284.29 F3000
+G1 X54.18 Y228.57 Z283.57 F3000
+G1 X51.23 Y228.04 Z282.86 F3000
+G1 X48.26 Y227.64 Z282.14 F3000
+G1 X45.28 Y227.36 Z281.43 F3000
+G1 X42.29 Y227.22 Z280.71 F3000
+G1 X39.29 Y227.2 Z280 F3000
+G1 X36.3 Y227.31 Z279.29 F3000
+G1 X33.31 Y227.55 Z278.57 F3000
+G1 X30.34 Y227.91 Z277.86 F3000
+G1 X27.38 Y228.4 Z277.14 F3000
+G1 X24.45 Y229.02 Z276.43 F3000
+G1 X21.55 Y229.77 Z275.71 F3000
+G1 X18.68 Y230.63 Z275 F3000
+G1 X15.85 Y231.62 Z274.29 F3000
+G1 X13.07 Y232.73 Z273.57 F3000
+G1 X10.33 Y233.96 Z272.86 F3000
+G1 X7.66 Y235.3 Z272.14 F3000
+G1 X5.04 Y236.76 Z271.43 F3000
+G1 X2.48 Y238.33 Z270.71 F3000
+G1 X0 Y240 Z270 F3000
+G1 X-2.93 Y240.29 Z270 F2000
+G1 X-5.74 Y241.14 Z270 F2000
+G1 X-8.33 Y242.53 Z270 F2000
+G1 X-10.61 Y244.39 Z270 F2000
+G1 X-12.47 Y246.67 Z270 F2000
+G1 X-13.86 Y249.26 Z270 F2000
+G1 X-14.71 Y252.07 Z270 F2000
+G1 X-15 Y255 Z270 F2000
+G1 X-14.71 Y257.93 Z270 F2000
+G1 X-13.86 Y260.74 Z270 F2000
+G1 X-12.47 Y263.33 Z270 F2000
+G1 X-10.61 Y265.61 Z270 F2000
+G1 X-8.33 Y267.47 Z270 F2000
+G1 X-5.74 Y268.86 Z270 F2000
+G1 X-2.93 Y269.71 Z270 F2000
+G1 X0 Y270 Z270 F2000
+G1 X2.93 Y269.71 Z270 F2000
+G1 X5.74 Y268.86 Z270 F2000
+G1 X8.33 Y267.47 Z270 F2000
+G1 X10.61 Y265.61 Z270 F2000
+G1 X12.47 Y263.33 Z270 F2000
+G1 X13.86 Y260.74 Z270 F2000
+G1 X14.71 Y257.93 Z270 F2000
+G1 X15 Y255 Z270 F2000
+G1 X14.71 Y252.07 Z270 F2000
+G1 X13.86 Y249.26 Z270 F2000
+G1 X12.47 Y246.67 Z270 F2000
+G1 X10.61 Y244.39 Z270 F2000
+G1 X8.33 Y242.53 Z270 F2000
+G1 X5.74 Y241.14 Z270 F2000
+G1 X2.93 Y240.29 Z270 F2000
+G1 X0 Y240 Z270 F2000
+G1 X-2.98 Y239.78 Z270.36 F2000
+G1 X-5.9 Y239.11 Z270.71 F2000
+G1 X-8.68 Y238.02 Z271.07 F2000
+G1 X-11.27 Y236.52 Z271.43 F2000
+G1 X-13.6 Y234.66 Z271.79 F2000
+G1 X-15.64 Y232.47 Z272.14 F2000
+G1 X-17.32 Y230 Z272.5 F2000
+G1 X-18.62 Y227.31 Z272.86 F2000
+G1 X-19.5 Y224.45 Z273.21 F2000
+G1 X-19.94 Y221.49 Z273.57 F2000
+G1 X-19.94 Y218.51 Z273.93 F2000
+G1 X-19.5 Y215.55 Z274.29 F2000
+G1 X-18.62 Y212.69 Z274.64 F2000
+G1 X-17.32 Y210 Z275 F2000
+G1 X-15.64 Y207.53 Z275.36 F2000
+G1 X-13.6 Y205.34 Z275.71 F2000
+G1 X-11.27 Y203.48 Z276.07 F2000
+G1 X-8.68 Y201.98 Z276.43 F2000
+G1 X-5.9 Y200.89 Z276.79 F2000
+G1 X-2.98 Y200.22 Z277.14 F2000
+G1 X0 Y200 Z277.5 F2000
+G1 X2.98 Y200.22 Z277.86 F2000
+G1 X5.9 Y200.89 Z278.21 F2000
+G1 X8.68 Y201.98 Z278.57 F2000
+G1 X11.27 Y203.48 Z278.93 F2000
+G1 X13.6 Y205.34 Z279.29 F2000
+G1 X15.64 Y207.53 Z279.64 F2000
+G1 X17.32 Y210 Z280 F2000
+G1 X18.62 Y212.69 Z280.36 F2000
+G1 X19.5 Y215.55 Z280.71 F2000
+G1 X19.94 Y218.51 Z281.07 F2000
+G1 X19.94 Y221.49 Z281.43 F2000
+G1 X19.5 Y224.45 Z281.79 F2000
+G1 X18.62 Y227.31 Z282.14 F2000
+G1 X17.32 Y230 Z282.5 F2000
+G1 X15.64 Y232.47 Z282.86 F2000
+G1 X13.6 Y234.66 Z283.21 F2000
+G1 X11.27 Y236.52 Z283.57 F2000
+G1 X8.68 Y238.02 Z283.93 F2000
+G1 X5.9 Y239.11 Z284.29 F2000
+G1 X2.98 Y239.78 Z284.64 F2000
+G1 X0 Y240 Z285 F2000
+G0 X0 Y240 Z285
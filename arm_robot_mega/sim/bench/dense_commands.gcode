@@ -0,0 +1,202 @@
+; 200 G1 ke titik yang sama (gerak nol): hanya jalur serial dan parser yang membatasi throughput
+G0 X0 Y240 Z285
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
+G1 X0 Y240 Z285 F3000
@@ -0,0 +1,62 @@
+; Streaming dengan error saat eksekusi: target tak terjangkau, busur tidak valid, makro tidak dikenal.
+; Setiap baris sudah di-ack sebelum error-nya muncul (Alarm:), jadi tidak boleh mengembalikan kredit RX.
+G1 X-40 Y240 Z270 F3000
+G1 X745.4 Y745.4 Z110 F3000
+G1 X-38 Y245 Z275 F3000
+G1 X-36 Y240 Z270 F3000
+G2 X-26 Y240 I30 J0 F3000
+G1 X-34 Y245 Z275 F3000
+G1 X-32 Y240 Z270 F3000
+P9
+G1 X-30 Y245 Z275 F3000
+G1 X-28 Y240 Z270 F3000
+G1 X-28 Y60 Z270 F3000
+G1 X-26 Y245 Z275 F3000
+G1 X-24 Y240 Z270 F3000
+G1 X745.4 Y745.4 Z110 F3000
+G1 X-22 Y245 Z275 F3000
+G1 X-20 Y240 Z270 F3000
+G2 X-10 Y240 I30 J0 F3000
+G1 X-18 Y245 Z275 F3000
+G1 X-16 Y240 Z270 F3000
+P9
+G1 X-14 Y245 Z275 F3000
+G1 X-12 Y240 Z270 F3000
+G1 X-12 Y60 Z270 F3000
+G1 X-10 Y245 Z275 F3000
+G1 X-8 Y240 Z270 F3000
+G1 X745.4 Y745.4 Z110 F3000
+G1 X-6 Y245 Z275 F3000
+G1 X-4 Y240 Z270 F3000
+G2 X6 Y240 I30 J0 F3000
+G1 X-2 Y245 Z275 F3000
+G1 X0 Y240 Z270 F3000
+P9
+G1 X2 Y245 Z275 F3000
+G1 X4 Y240 Z270 F3000
+G1 X4 Y60 Z270 F3000
+G1 X6 Y245 Z275 F3000
+G1 X8 Y240 Z270 F3000
+G1 X745.4 Y745.4 Z110 F3000
+G1 X10 Y245 Z275 F3000
+G1 X12 Y240 Z270 F3000
+G2 X22 Y240 I30 J0 F3000
+G1 X14 Y245 Z275 F3000
+G1 X16 Y240 Z270 F3000
+P9
+G1 X18 Y245 Z275 F3000
+G1 X20 Y240 Z270 F3000
+G1 X20 Y60 Z270 F3000
+G1 X22 Y245 Z275 F3000
+G1 X24 Y240 Z270 F3000
+G1 X745.4 Y745.4 Z110 F3000
+G1 X26 Y245 Z275 F3000
+G1 X28 Y240 Z270 F3000
+G2 X38 Y240 I30 J0 F3000
+G1 X30 Y245 Z275 F3000
+G1 X32 Y240 Z270 F3000
+P9
+G1 X34 Y245 Z275 F3000
+G1 X36 Y240 Z270 F3000
+G1 X36 Y60 Z270 F3000
+G1 X38 Y245 Z275 F3000
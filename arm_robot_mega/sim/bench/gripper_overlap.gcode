@@ -0,0 +1,14 @@
+; Gripper menutup selama milimeter terakhir gerakan turun: G1 dipecah di Z265, M3 di antaranya
+; memulai gripper (non-blocking) saat lengan melewati Z265, lalu lengan terus turun ke Z255
+G0 X20 Y250 Z285
+G1 X20 Y250 Z265 F1500
+M3 T2400
+G1 X20 Y250 Z255 F1500
+G4 T0.1
+G1 X20 Y250 Z285 F1500
+G0 X-60 Y230 Z285
+G1 X-60 Y230 Z265 F1500
+M5 T2400
+G1 X-60 Y230 Z260 F1500
+G4 T0.1
+G1 X-60 Y230 Z285 F1500
@@ -0,0 +1,10 @@
+; Perintah sendi langsung (J0..J3, sudut kinematik dalam derajat / slider dalam mm)
+J0 60
+J0 120
+J0 90
+J1 10
+J2 -60
+J1 -10
+J2 -85
+J3 50
+J3 0
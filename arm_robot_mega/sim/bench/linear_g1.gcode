@@ -0,0 +1,13 @@
+; Raster G1 (interpolasi Kartesian + IK per sub-segmen) pada beberapa feedrate
+G0 X-40 Y230 Z280
+G1 X40 Y230 Z280 F3000
+G1 X40 Y245 Z280 F3000
+G1 X-40 Y245 Z280 F3000
+G1 X-40 Y260 Z280 F3000
+G1 X40 Y260 Z280 F3000
+G1 X40 Y260 Z260 F1200
+G1 X-40 Y260 Z260 F1200
+G1 X-40 Y240 Z270 F6000
+G1 X40 Y240 Z270 F6000
+G1 X0 Y240 Z285 E30 F3000
+G1 X0 Y240 Z285 E0 F3000
@@ -0,0 +1,33 @@
+; Pick and place: tiga bola dipindahkan ke tiga wadah (G0 di atas, G1 turun/naik, vakum M8/M9)
+G0 X0 Y240 Z285
+G0 X20 Y250 Z285
+G1 X20 Y250 Z255 F1500
+M8
+G4 T0.2
+G1 X20 Y250 Z285 F1500
+G0 X-60 Y230 Z285
+G1 X-60 Y230 Z260 F1500
+M9
+G4 T0.2
+G1 X-60 Y230 Z285 F1500
+G0 X0 Y260 Z285
+G1 X0 Y260 Z255 F1500
+M8
+G4 T0.2
+G1 X0 Y260 Z285 F1500
+G0 X60 Y230 Z285
+G1 X60 Y230 Z260 F1500
+M9
+G4 T0.2
+G1 X60 Y230 Z285 F1500
+G0 X-20 Y250 Z285
+G1 X-20 Y250 Z255 F1500
+M8
+G4 T0.2
+G1 X-20 Y250 Z285 F1500
+G0 X0 Y210 Z285
+G1 X0 Y210 Z265 F1500
+M9
+G4 T0.2
+G1 X0 Y210 Z285 F1500
+G0 X0 Y240 Z285
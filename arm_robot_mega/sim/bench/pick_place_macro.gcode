@@ -0,0 +1,6 @@
+; Pick and place yang sama dengan pick_place.gcode, tetapi setiap siklus satu makro P di firmware
+G0 X0 Y240 Z285
+P1 X20 Y250
+P2 X0 Y260
+P3 X-20 Y250
+G0 X0 Y240 Z285
@@ -0,0 +1,10 @@
+; Gerakan G0 (ruang sendi) bolak-balik antar sudut workspace
+G0 X0 Y240 Z285
+G0 X60 Y260 Z270
+G0 X-60 Y260 Z270
+G0 X40 Y220 Z290
+G0 X-40 Y220 Z290
+G0 X0 Y280 Z250
+G0 X60 Y260 Z270 E40
+G0 X-60 Y260 Z270 E0
+G0 X0 Y240 Z285
@@ -0,0 +1,99 @@
+#!/bin/sh
+# run_bench.sh [OUT_DIR] [flag g++ tambahan...]
+# Bangun simulasi host dan jalankan semua program *.gcode di direktori ini.
+# Setiap program menghasilkan OUT_DIR/<nama>.json (lihat sim/simBench.h) dan <nama>.log,
+# ditambah OUT_DIR/parser.json untuk benchmark parser baris dan OUT_DIR/flow_*.json untuk
+# protokol pengiriman (menunggu OK vs streaming ASCII vs frame biner): segmen pendek dengan
+# latensi USB-serial 16 ms, dan flow_dense_*.json tanpa latensi (batas protokol itu sendiri),
+# ditambah flow_alarms_*.json: streaming dengan error saat eksekusi (Alarm:) tanpa RX overrun.
+# OUT_DIR/kinematics.json berisi uji round-trip FK/IK untuk beberapa set panjang link, dan
+# OUT_DIR/ring.json uji stres serta throughput RingBuffer antrian perintah, dan
+# OUT_DIR/packing.json uji round-trip rekaman perintah terpaket (commandQueue.h), dan
+# OUT_DIR/gpio.json biaya GPIO per langkah RampsStepper vs FastAxis dan koil gripper
+# (instruksi/siklus AVR) serta lebar pulsa step minimum dari ISR StepEngine, dan
+# OUT_DIR/limits_bounce.json pick_place dengan pantulan kontak limit switch (debounce ISR), dan
+# OUT_DIR/arcs.json uji interpolasi busur G2/G3 terhadap referensi double, dan
+# OUT_DIR/lookahead.json waktu lintasan pick_place dengan look-ahead Planner aktif/nonaktif.
+# Contoh: sim/bench/run_bench.sh bench_fixed -DIK_BACKEND=IK_BACKEND_FIXED
+set -e
+HERE=$(cd "$(dirname "$0")" && pwd)
+FW="$HERE/../.."
+OUT=${1:-bench_out}
+[ $# -gt 0 ] && shift
+mkdir -p "$OUT"
+
+g++ -std=gnu++11 -fpermissive -Wall -Wextra -O2 -pthread "$@" -I"$FW/sim" -I"$FW" \
+    -x c++ "$FW/arm_robot_mega.ino" -x none "$FW"/*.cpp "$FW"/sim/*.cpp -o "$OUT/arm_sim"
+
+status=0
+for program in "$HERE"/*.gcode; do
+  name=$(basename "$program" .gcode)
+  if "$OUT/arm_sim" --quiet --report "$OUT/$name.json" "$program" 2> "$OUT/$name.log"; then
+    echo "$name -> $OUT/$name.json"
+  else
+    echo "$name: program tidak selesai (lihat $OUT/$name.log)" >&2
+    status=1
+  fi
+done
+
+# Protokol pengiriman: menunggu OK per baris vs streaming ASCII vs frame biner
+for mode in ack stream binary; do
+  flag=""
+  [ "$mode" != ack ] && flag="--$mode"
+  "$OUT/arm_sim" --quiet $flag --host-latency 16 --report "$OUT/flow_$mode.json" \
+      "$HERE/short_segments.gcode" 2> "$OUT/flow_$mode.log" || status=1
+  echo "flow ($mode) -> $OUT/flow_$mode.json"
+  "$OUT/arm_sim" --quiet $flag --report "$OUT/flow_dense_$mode.json" \
+      "$HERE/dense_commands.gcode" 2> "$OUT/flow_dense_$mode.log" || status=1
+  echo "flow dense ($mode) -> $OUT/flow_dense_$mode.json"
+done
+
+# Error saat eksekusi (Alarm:) tidak boleh mengembalikan kredit RX: setiap baris harus sampai
+# tanpa overrun (arm_sim keluar dengan status 3 jika ada byte RX yang hilang)
+for mode in stream binary; do
+  "$OUT/arm_sim" --quiet --$mode --report "$OUT/flow_alarms_$mode.json" \
+      "$HERE/exec_errors.gcode" 2> "$OUT/flow_alarms_$mode.log" || status=1
+  echo "flow alarms ($mode) -> $OUT/flow_alarms_$mode.json"
+done
+
+# Parser baris G-code: versi lama (String) vs Command::prepareLine() vs decode frame biner
+"$OUT/arm_sim" --bench-parser 2000 "$HERE/pick_place.gcode" > "$OUT/parser.json"
+echo "parser -> $OUT/parser.json"
+# Round-trip FK -> IK -> FK untuk beberapa varian lengan (gagal jika melebihi toleransi)
+"$OUT/arm_sim" --check-kinematics > "$OUT/kinematics.json" || status=1
+echo "kinematics -> $OUT/kinematics.json"
+# Backend IK fixed-point vs float pada target yang sama: galat dan ns per panggilan
+"$OUT/arm_sim" --bench-ik > "$OUT/ik_backends.json" || status=1
+echo "ik backends -> $OUT/ik_backends.json"
+# RingBuffer: produsen/konsumen di dua thread, lalu push/pop Cmd dibanding antrian lama
+"$OUT/arm_sim" --bench-ring 2000000 > "$OUT/ring.json" || status=1
+echo "ring -> $OUT/ring.json"
+# Rekaman terpaket antrian perintah: semua program harus kembali identik setelah pack/unpack
+cat "$HERE"/*.gcode | "$OUT/arm_sim" --check-packing > "$OUT/packing.json" || status=1
+echo "packing -> $OUT/packing.json"
+# Biaya GPIO per langkah: digitalWrite/digitalRead vs akses register FastAxis
+"$OUT/arm_sim" --bench-gpio 100000 > "$OUT/gpio.json" || status=1
+echo "gpio -> $OUT/gpio.json"
+# Limit switch memantul 8 kali per perubahan: homing dan posisi akhir harus sama dengan
+# pick_place.json, dan overtravel_steps tetap 0
+"$OUT/arm_sim" --quiet --limit-bounce 8 --report "$OUT/limits_bounce.json" \
+    "$HERE/pick_place.gcode" 2> "$OUT/limits_bounce.log" || status=1
+echo "limit bounce -> $OUT/limits_bounce.json"
+# Busur G2/G3: galat titik, titik akhir tepat, dan penolakan busur tidak valid
+"$OUT/arm_sim" --check-arcs > "$OUT/arcs.json" || status=1
+echo "arcs -> $OUT/arcs.json"
+# Planner: kecepatan jelajah, akselerasi, dan sambungan per sumbu terhadap JOINT_*/SLIDER_*
+"$OUT/arm_sim" --check-planner > "$OUT/planner.json" || status=1
+echo "planner -> $OUT/planner.json"
+# Look-ahead Planner: waktu lintasan pick_place dengan sambungan kecepatan antar blok
+# dibanding berhenti per blok (--no-lookahead: setiap sambungan paling cepat pada kecepatan
+# jerk kedua blok dan tetap dalam batas jerk). saved_pct > 0 berarti look-ahead lebih cepat.
+"$OUT/arm_sim" --quiet --no-lookahead --report "$OUT/pick_place_no_lookahead.json" \
+    "$HERE/pick_place.gcode" 2> "$OUT/pick_place_no_lookahead.log" || status=1
+on=$(sed -n 's/.*"program_s": \([0-9.]*\).*/\1/p' "$OUT/pick_place.json")
+off=$(sed -n 's/.*"program_s": \([0-9.]*\).*/\1/p' "$OUT/pick_place_no_lookahead.json")
+awk -v on="$on" -v off="$off" 'BEGIN {
+  printf "{\"program\": \"pick_place.gcode\", \"lookahead_s\": %s, \"no_lookahead_s\": %s, \"saved_pct\": %.1f}\n",
+         on, off, (off > 0) ? 100 * (off - on) / off : 0 }' > "$OUT/lookahead.json"
+echo "lookahead: pick_place ${on} s (aktif) vs ${off} s (nonaktif) -> $OUT/lookahead.json"
+exit $status
@@ -0,0 +1,242 @@
+; Lingkaran dari 240 segmen G1 pendek (~0.5 mm): throughput baris G-code, bukan gerak, yang membatasi
+G0 X20 Y250 Z270
+G1 X19.973 Y251.047 Z270 F1500
+G1 X19.890 Y252.091 Z270 F1500
+G1 X19.754 Y253.129 Z270 F1500
+G1 X19.563 Y254.158 Z270 F1500
+G1 X19.319 Y255.176 Z270 F1500
+G1 X19.021 Y256.180 Z270 F1500
+G1 X18.672 Y257.167 Z270 F1500
+G1 X18.271 Y258.135 Z270 F1500
+G1 X17.820 Y259.080 Z270 F1500
+G1 X17.321 Y260.000 Z270 F1500
+G1 X16.773 Y260.893 Z270 F1500
+G1 X16.180 Y261.756 Z270 F1500
+G1 X15.543 Y262.586 Z270 F1500
+G1 X14.863 Y263.383 Z270 F1500
+G1 X14.142 Y264.142 Z270 F1500
+G1 X13.383 Y264.863 Z270 F1500
+G1 X12.586 Y265.543 Z270 F1500
+G1 X11.756 Y266.180 Z270 F1500
+G1 X10.893 Y266.773 Z270 F1500
+G1 X10.000 Y267.321 Z270 F1500
+G1 X9.080 Y267.820 Z270 F1500
+G1 X8.135 Y268.271 Z270 F1500
+G1 X7.167 Y268.672 Z270 F1500
+G1 X6.180 Y269.021 Z270 F1500
+G1 X5.176 Y269.319 Z270 F1500
+G1 X4.158 Y269.563 Z270 F1500
+G1 X3.129 Y269.754 Z270 F1500
+G1 X2.091 Y269.890 Z270 F1500
+G1 X1.047 Y269.973 Z270 F1500
+G1 X0.000 Y270.000 Z270 F1500
+G1 X-1.047 Y269.973 Z270 F1500
+G1 X-2.091 Y269.890 Z270 F1500
+G1 X-3.129 Y269.754 Z270 F1500
+G1 X-4.158 Y269.563 Z270 F1500
+G1 X-5.176 Y269.319 Z270 F1500
+G1 X-6.180 Y269.021 Z270 F1500
+G1 X-7.167 Y268.672 Z270 F1500
+G1 X-8.135 Y268.271 Z270 F1500
+G1 X-9.080 Y267.820 Z270 F1500
+G1 X-10.000 Y267.321 Z270 F1500
+G1 X-10.893 Y266.773 Z270 F1500
+G1 X-11.756 Y266.180 Z270 F1500
+G1 X-12.586 Y265.543 Z270 F1500
+G1 X-13.383 Y264.863 Z270 F1500
+G1 X-14.142 Y264.142 Z270 F1500
+G1 X-14.863 Y263.383 Z270 F1500
+G1 X-15.543 Y262.586 Z270 F1500
+G1 X-16.180 Y261.756 Z270 F1500
+G1 X-16.773 Y260.893 Z270 F1500
+G1 X-17.321 Y260.000 Z270 F1500
+G1 X-17.820 Y259.080 Z270 F1500
+G1 X-18.271 Y258.135 Z270 F1500
+G1 X-18.672 Y257.167 Z270 F1500
+G1 X-19.021 Y256.180 Z270 F1500
+G1 X-19.319 Y255.176 Z270 F1500
+G1 X-19.563 Y254.158 Z270 F1500
+G1 X-19.754 Y253.129 Z270 F1500
+G1 X-19.890 Y252.091 Z270 F1500
+G1 X-19.973 Y251.047 Z270 F1500
+G1 X-20.000 Y250.000 Z270 F1500
+G1 X-19.973 Y248.953 Z270 F1500
+G1 X-19.890 Y247.909 Z270 F1500
+G1 X-19.754 Y246.871 Z270 F1500
+G1 X-19.563 Y245.842 Z270 F1500
+G1 X-19.319 Y244.824 Z270 F1500
+G1 X-19.021 Y243.820 Z270 F1500
+G1 X-18.672 Y242.833 Z270 F1500
+G1 X-18.271 Y241.865 Z270 F1500
+G1 X-17.820 Y240.920 Z270 F1500
+G1 X-17.321 Y240.000 Z270 F1500
+G1 X-16.773 Y239.107 Z270 F1500
+G1 X-16.180 Y238.244 Z270 F1500
+G1 X-15.543 Y237.414 Z270 F1500
+G1 X-14.863 Y236.617 Z270 F1500
+G1 X-14.142 Y235.858 Z270 F1500
+G1 X-13.383 Y235.137 Z270 F1500
+G1 X-12.586 Y234.457 Z270 F1500
+G1 X-11.756 Y233.820 Z270 F1500
+G1 X-10.893 Y233.227 Z270 F1500
+G1 X-10.000 Y232.679 Z270 F1500
+G1 X-9.080 Y232.180 Z270 F1500
+G1 X-8.135 Y231.729 Z270 F1500
+G1 X-7.167 Y231.328 Z270 F1500
+G1 X-6.180 Y230.979 Z270 F1500
+G1 X-5.176 Y230.681 Z270 F1500
+G1 X-4.158 Y230.437 Z270 F1500
+G1 X-3.129 Y230.246 Z270 F1500
+G1 X-2.091 Y230.110 Z270 F1500
+G1 X-1.047 Y230.027 Z270 F1500
+G1 X-0.000 Y230.000 Z270 F1500
+G1 X1.047 Y230.027 Z270 F1500
+G1 X2.091 Y230.110 Z270 F1500
+G1 X3.129 Y230.246 Z270 F1500
+G1 X4.158 Y230.437 Z270 F1500
+G1 X5.176 Y230.681 Z270 F1500
+G1 X6.180 Y230.979 Z270 F1500
+G1 X7.167 Y231.328 Z270 F1500
+G1 X8.135 Y231.729 Z270 F1500
+G1 X9.080 Y232.180 Z270 F1500
+G1 X10.000 Y232.679 Z270 F1500
+G1 X10.893 Y233.227 Z270 F1500
+G1 X11.756 Y233.820 Z270 F1500
+G1 X12.586 Y234.457 Z270 F1500
+G1 X13.383 Y235.137 Z270 F1500
+G1 X14.142 Y235.858 Z270 F1500
+G1 X14.863 Y236.617 Z270 F1500
+G1 X15.543 Y237.414 Z270 F1500
+G1 X16.180 Y238.244 Z270 F1500
+G1 X16.773 Y239.107 Z270 F1500
+G1 X17.321 Y240.000 Z270 F1500
+G1 X17.820 Y240.920 Z270 F1500
+G1 X18.271 Y241.865 Z270 F1500
+G1 X18.672 Y242.833 Z270 F1500
+G1 X19.021 Y243.820 Z270 F1500
+G1 X19.319 Y244.824 Z270 F1500
+G1 X19.563 Y245.842 Z270 F1500
+G1 X19.754 Y246.871 Z270 F1500
+G1 X19.890 Y247.909 Z270 F1500
+G1 X19.973 Y248.953 Z270 F1500
+G1 X20.000 Y250.000 Z270 F1500
+G1 X19.973 Y251.047 Z270 F1500
+G1 X19.890 Y252.091 Z270 F1500
+G1 X19.754 Y253.129 Z270 F1500
+G1 X19.563 Y254.158 Z270 F1500
+G1 X19.319 Y255.176 Z270 F1500
+G1 X19.021 Y256.180 Z270 F1500
+G1 X18.672 Y257.167 Z270 F1500
+G1 X18.271 Y258.135 Z270 F1500
+G1 X17.820 Y259.080 Z270 F1500
+G1 X17.321 Y260.000 Z270 F1500
+G1 X16.773 Y260.893 Z270 F1500
+G1 X16.180 Y261.756 Z270 F1500
+G1 X15.543 Y262.586 Z270 F1500
+G1 X14.863 Y263.383 Z270 F1500
+G1 X14.142 Y264.142 Z270 F1500
+G1 X13.383 Y264.863 Z270 F1500
+G1 X12.586 Y265.543 Z270 F1500
+G1 X11.756 Y266.180 Z270 F1500
+G1 X10.893 Y266.773 Z270 F1500
+G1 X10.000 Y267.321 Z270 F1500
+G1 X9.080 Y267.820 Z270 F1500
+G1 X8.135 Y268.271 Z270 F1500
+G1 X7.167 Y268.672 Z270 F1500
+G1 X6.180 Y269.021 Z270 F1500
+G1 X5.176 Y269.319 Z270 F1500
+G1 X4.158 Y269.563 Z270 F1500
+G1 X3.129 Y269.754 Z270 F1500
+G1 X2.091 Y269.890 Z270 F1500
+G1 X1.047 Y269.973 Z270 F1500
+G1 X0.000 Y270.000 Z270 F1500
+G1 X-1.047 Y269.973 Z270 F1500
+G1 X-2.091 Y269.890 Z270 F1500
+G1 X-3.129 Y269.754 Z270 F1500
+G1 X-4.158 Y269.563 Z270 F1500
+G1 X-5.176 Y269.319 Z270 F1500
+G1 X-6.180 Y269.021 Z270 F1500
+G1 X-7.167 Y268.672 Z270 F1500
+G1 X-8.135 Y268.271 Z270 F1500
+G1 X-9.080 Y267.820 Z270 F1500
+G1 X-10.000 Y267.321 Z270 F1500
+G1 X-10.893 Y266.773 Z270 F1500
+G1 X-11.756 Y266.180 Z270 F1500
+G1 X-12.586 Y265.543 Z270 F1500
+G1 X-13.383 Y264.863 Z270 F1500
+G1 X-14.142 Y264.142 Z270 F1500
+G1 X-14.863 Y263.383 Z270 F1500
+G1 X-15.543 Y262.586 Z270 F1500
+G1 X-16.180 Y261.756 Z270 F1500
+G1 X-16.773 Y260.893 Z270 F1500
+G1 X-17.321 Y260.000 Z270 F1500
+G1 X-17.820 Y259.080 Z270 F1500
+G1 X-18.271 Y258.135 Z270 F1500
+G1 X-18.672 Y257.167 Z270 F1500
+G1 X-19.021 Y256.180 Z270 F1500
+G1 X-19.319 Y255.176 Z270 F1500
+G1 X-19.563 Y254.158 Z270 F1500
+G1 X-19.754 Y253.129 Z270 F1500
+G1 X-19.890 Y252.091 Z270 F1500
+G1 X-19.973 Y251.047 Z270 F1500
+G1 X-20.000 Y250.000 Z270 F1500
+G1 X-19.973 Y248.953 Z270 F1500
+G1 X-19.890 Y247.909 Z270 F1500
+G1 X-19.754 Y246.871 Z270 F1500
+G1 X-19.563 Y245.842 Z270 F1500
+G1 X-19.319 Y244.824 Z270 F1500
+G1 X-19.021 Y243.820 Z270 F1500
+G1 X-18.672 Y242.833 Z270 F1500
+G1 X-18.271 Y241.865 Z270 F1500
+G1 X-17.820 Y240.920 Z270 F1500
+G1 X-17.321 Y240.000 Z270 F1500
+G1 X-16.773 Y239.107 Z270 F1500
+G1 X-16.180 Y238.244 Z270 F1500
+G1 X-15.543 Y237.414 Z270 F1500
+G1 X-14.863 Y236.617 Z270 F1500
+G1 X-14.142 Y235.858 Z270 F1500
+G1 X-13.383 Y235.137 Z270 F1500
+G1 X-12.586 Y234.457 Z270 F1500
+G1 X-11.756 Y233.820 Z270 F1500
+G1 X-10.893 Y233.227 Z270 F1500
+G1 X-10.000 Y232.679 Z270 F1500
+G1 X-9.080 Y232.180 Z270 F1500
+G1 X-8.135 Y231.729 Z270 F1500
+G1 X-7.167 Y231.328 Z270 F1500
+G1 X-6.180 Y230.979 Z270 F1500
+G1 X-5.176 Y230.681 Z270 F1500
+G1 X-4.158 Y230.437 Z270 F1500
+G1 X-3.129 Y230.246 Z270 F1500
+G1 X-2.091 Y230.110 Z270 F1500
+G1 X-1.047 Y230.027 Z270 F1500
+G1 X-0.000 Y230.000 Z270 F1500
+G1 X1.047 Y230.027 Z270 F1500
+G1 X2.091 Y230.110 Z270 F1500
+G1 X3.129 Y230.246 Z270 F1500
+G1 X4.158 Y230.437 Z270 F1500
+G1 X5.176 Y230.681 Z270 F1500
+G1 X6.180 Y230.979 Z270 F1500
+G1 X7.167 Y231.328 Z270 F1500
+G1 X8.135 Y231.729 Z270 F1500
+G1 X9.080 Y232.180 Z270 F1500
+G1 X10.000 Y232.679 Z270 F1500
+G1 X10.893 Y233.227 Z270 F1500
+G1 X11.756 Y233.820 Z270 F1500
+G1 X12.586 Y234.457 Z270 F1500
+G1 X13.383 Y235.137 Z270 F1500
+G1 X14.142 Y235.858 Z270 F1500
+G1 X14.863 Y236.617 Z270 F1500
+G1 X15.543 Y237.414 Z270 F1500
+G1 X16.180 Y238.244 Z270 F1500
+G1 X16.773 Y239.107 Z270 F1500
+G1 X17.321 Y240.000 Z270 F1500
+G1 X17.820 Y240.920 Z270 F1500
+G1 X18.271 Y241.865 Z270 F1500
+G1 X18.672 Y242.833 Z270 F1500
+G1 X19.021 Y243.820 Z270 F1500
+G1 X19.319 Y244.824 Z270 F1500
+G1 X19.563 Y245.842 Z270 F1500
+G1 X19.754 Y246.871 Z270 F1500
+G1 X19.890 Y247.909 Z270 F1500
+G1 X19.973 Y248.953 Z270 F1500
+G1 X20.000 Y250.000 Z270 F1500
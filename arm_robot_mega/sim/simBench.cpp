@@ -0,0 +1,1485 @@
+// simBench.cpp
+#include "simBench.h"
+#include "simHal.h"
+#include "robotGeometry.h"
+#include "command.h"
+#include "binaryFrame.h"
+#include "ringBuffer.h"
+#include "commandQueue.h"
+#include "robotAxes.h"
+#include "interpolation.h"
+#include "planner.h"
+#include "gripper.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <thread>
+
+static std::vector<uint32_t> loopSimTicks;
+static std::vector<uint32_t> loopHostNs;
+
+SimSummary simSummarize(const std::vector<uint32_t>& samples, double scale) {
+  SimSummary summary = {samples.size(), 0, 0, 0, 0, 0};
+  if (samples.empty()) return summary;
+  std::vector<uint32_t> sorted(samples);
+  std::sort(sorted.begin(), sorted.end());
+  double sum = 0;
+  for (size_t i = 0; i < sorted.size(); i++) sum += sorted[i];
+  // Persentil nearest-rank
+  size_t last = sorted.size() - 1;
+  summary.mean = sum / sorted.size() * scale;
+  summary.p50 = sorted[last * 50 / 100] * scale;
+  summary.p90 = sorted[last * 90 / 100] * scale;
+  summary.p99 = sorted[last * 99 / 100] * scale;
+  summary.max = sorted[last] * scale;
+  return summary;
+}
+
+void simBenchLoopSample(uint32_t simTicks, uint32_t hostNs) {
+  loopSimTicks.push_back(simTicks);
+  loopHostNs.push_back(hostNs);
+}
+
+double simBenchIkHostNs(RobotGeometry& geom, unsigned long& calls) {
+  const int repeats = 20;
+  volatile float sink = 0;
+  calls = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeats; r++) {
+    for (float x = -100; x <= 100; x += 10) {
+      for (float y = 150; y <= 300; y += 10) {
+        for (float z = 150; z <= 300; z += 10) {
+          geom.setPositionCartesianOffset(x, y, z);
+          sink = sink + geom.getBaseRad() + geom.getShoulderRad() + geom.getElbowRad();
+          calls++;
+        }
+      }
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  return (double)elapsed.count() / calls;
+}
+
+// Toleransi galat posisi round-trip: float hanya galat pembulatan, fixed-point ~0.03 mm tipikal
+static const double KINEMATICS_TOLERANCE_MM = IK_BACKEND == IK_BACKEND_FIXED ? 0.25 : 0.01;
+
+struct KinematicsSet {
+  float l1, l2, l3, eeForward, eeDown;
+  float zeroDeg[3];
+};
+
+// Lengan default, link sama panjang (jangkauan minimum 0), dan dua varian tidak simetris
+static const KinematicsSet KINEMATICS_SETS[] = {
+  {RobotGeometry::DEFAULT_L1, RobotGeometry::DEFAULT_L2, RobotGeometry::DEFAULT_L3,
+   RobotGeometry::DEFAULT_EE_FORWARD_OFFSET_MM, RobotGeometry::DEFAULT_EE_DOWN_OFFSET_MM, {90.0, -14.0, -91.77}},
+  {120.0, 200.0, 200.0, 0.0, 0.0, {0.0, 0.0, 0.0}},
+  {200.0, 250.0, 150.0, 80.0, 30.0, {45.0, 10.0, -60.0}},
+  {100.0, 100.0, 220.0, 30.0, 60.0, {-30.0, -20.0, 20.0}},
+};
+static const int KINEMATICS_SET_COUNT = sizeof(KINEMATICS_SETS) / sizeof(KINEMATICS_SETS[0]);
+
+static double wrapRad(double angle) {
+  while (angle > M_PI) angle -= 2 * M_PI;
+  while (angle < -M_PI) angle += 2 * M_PI;
+  return angle;
+}
+
+bool simBenchKinematics(FILE* out) {
+  const KinematicsSet* sets = KINEMATICS_SETS;
+  const int setCount = KINEMATICS_SET_COUNT;
+  // Satu objek untuk semua set: setiap set harus sepenuhnya menggantikan konstanta set sebelumnya
+  RobotGeometry geom;
+  bool pass = true;
+
+  fprintf(out, "{\n");
+  fprintf(out, "  \"ik_backend\": \"%s\",\n", IK_BACKEND == IK_BACKEND_FIXED ? "fixed" : "float");
+  fprintf(out, "  \"tolerance_mm\": %.3f,\n", KINEMATICS_TOLERANCE_MM);
+  fprintf(out, "  \"sets\": [\n");
+  for (int k = 0; k < setCount; k++) {
+    const KinematicsSet& set = sets[k];
+    geom.setLinkLengths(set.l1, set.l2, set.l3, set.eeForward, set.eeDown);
+    geom.setKinematicZeroOffsets(radians(set.zeroDeg[0]), radians(set.zeroDeg[1]), radians(set.zeroDeg[2]));
+    for (int down = 0; down <= 1; down++) {
+      geom.setUseElbowDownSolution(down);
+      unsigned long samples = 0;
+      double maxErrMm = 0, maxErrDeg = 0;
+      std::chrono::nanoseconds ikTime(0);
+      // Sudut kinematik; elbow menjauhi 0 dan 180 derajat (singularitas, acos kehilangan presisi)
+      for (int baseDeg = -170; baseDeg <= 170; baseDeg += 20) {
+        for (int shDeg = -60; shDeg <= 120; shDeg += 10) {
+          for (int elDeg = 10; elDeg <= 170; elDeg += 10) {
+            double q[3] = {radians(baseDeg), radians(shDeg), radians(down ? -elDeg : elDeg)};
+            double joint[3];
+            for (int j = 0; j < 3; j++) joint[j] = q[j] - radians(set.zeroDeg[j]);
+            geom.calculateFK(joint[0], joint[1], joint[2]);
+            float x = geom.getFKX(), y = geom.getFKY(), z = geom.getFKZ();
+            // Wrist harus di depan sumbu Base (searah sudut Base); IK membatasi jarak radial
+            // wrist ke >= 0 dan memilih sudut Base dari atan2
+            if (x * cos(q[0]) + y * sin(q[0]) - set.eeForward < 1.0) continue;
+
+            auto start = std::chrono::steady_clock::now();
+            geom.setPositionCartesianOffset(x, y, z);
+            ikTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            double ik[3] = {geom.getBaseRad(), geom.getShoulderRad(), geom.getElbowRad()};
+            for (int j = 0; j < 3; j++) {
+              maxErrDeg = std::max(maxErrDeg, fabs(degrees(wrapRad(ik[j] - joint[j]))));
+            }
+            geom.calculateFK(ik[0], ik[1], ik[2]);
+            double dx = geom.getFKX() - x, dy = geom.getFKY() - y, dz = geom.getFKZ() - z;
+            maxErrMm = std::max(maxErrMm, sqrt(dx * dx + dy * dy + dz * dz));
+            samples++;
+          }
+        }
+      }
+      bool ok = samples > 0 && maxErrMm <= KINEMATICS_TOLERANCE_MM;
+      pass = pass && ok;
+      fprintf(out, "    {\"l1\": %.1f, \"l2\": %.1f, \"l3\": %.1f, \"ee_forward\": %.1f, \"ee_down\": %.1f, "
+              "\"elbow\": \"%s\", \"samples\": %lu, \"max_err_mm\": %.5f, \"max_err_deg\": %.5f, "
+              "\"ik_ns\": %.1f, \"pass\": %s}%s\n",
+              set.l1, set.l2, set.l3, set.eeForward, set.eeDown, down ? "down" : "up", samples, maxErrMm,
+              maxErrDeg, samples > 0 ? (double)ikTime.count() / samples : 0.0, ok ? "true" : "false",
+              (k == setCount - 1 && down) ? "" : ",");
+    }
+  }
+  fprintf(out, "  ],\n");
+
+  // Target jauh di luar jangkauan (termasuk yang x^2 + y^2 melewati 2^32 di Q12): harus ditolak,
+  // atau kalau diterima, FK dari sudutnya harus kembali ke target
+  const float farTargets[][3] = {
+    {745.4, 745.4, 110.0}, {730.0, 730.0, 110.0}, {-745.4, 745.4, 110.0}, {1100.0, 0.0, 110.0},
+    {0.0, -1100.0, 110.0}, {2000.0, 2000.0, 110.0}, {100.0, 0.0, 1200.0}, {100.0, 0.0, -1200.0},
+    {1.0e9, 0.0, 110.0},
+  };
+  const int farCount = sizeof(farTargets) / sizeof(farTargets[0]);
+  unsigned long farCases = 0, farAccepted = 0, farViolations = 0;
+  for (int k = 0; k < setCount; k++) {
+    const KinematicsSet& set = sets[k];
+    geom.setLinkLengths(set.l1, set.l2, set.l3, set.eeForward, set.eeDown);
+    geom.setKinematicZeroOffsets(radians(set.zeroDeg[0]), radians(set.zeroDeg[1]), radians(set.zeroDeg[2]));
+    for (int i = 0; i < farCount; i++) {
+      const float* t = farTargets[i];
+      geom.setPositionCartesianOffset(t[0], t[1], t[2]);
+      farCases++;
+      if (geom.getReachStatus() != REACH_OK) continue;
+      farAccepted++;
+      geom.calculateFK(geom.getBaseRad(), geom.getShoulderRad(), geom.getElbowRad());
+      double dx = geom.getFKX() - t[0], dy = geom.getFKY() - t[1], dz = geom.getFKZ() - t[2];
+      if (!(sqrt(dx * dx + dy * dy + dz * dz) <= KINEMATICS_TOLERANCE_MM)) {
+        fprintf(stderr, "Target X%.1f Y%.1f Z%.1f (set %d) diterima, FK ke X%.2f Y%.2f Z%.2f\n", t[0], t[1], t[2], k,
+                geom.getFKX(), geom.getFKY(), geom.getFKZ());
+        farViolations++;
+      }
+    }
+  }
+  pass = pass && farViolations == 0;
+  fprintf(out, "  \"far_targets\": {\"cases\": %lu, \"accepted\": %lu, \"violations\": %lu},\n", farCases,
+          farAccepted, farViolations);
+  fprintf(out, "  \"pass\": %s\n", pass ? "true" : "false");
+  fprintf(out, "}\n");
+  return pass;
+}
+
+// Akses ke kedua backend IK privat RobotGeometry (friend), tanpa batas sendi
+struct SimIkBackends {
+  static ReachStatus solve(RobotGeometry& geom, bool fixed, const float target[3], double angles[3]) {
+    geom.x_target = target[0];
+    geom.y_target = target[1];
+    geom.z_target = target[2];
+    ReachStatus status = fixed ? geom.calculateIKFixed() : geom.calculateIKFloat();
+    angles[0] = geom.base_rad;
+    angles[1] = geom.sh_rad;
+    angles[2] = geom.el_rad;
+    return status;
+  }
+  // Lewati RobotGeometry::linkLengthsSupported() untuk mengukur galat di luar batas
+  static void forceLinkLengths(RobotGeometry& geom, float l1, float l2, float l3, float eeForward, float eeDown) {
+    geom.L1 = l1;
+    geom.L2 = l2;
+    geom.L3 = l3;
+    geom.eeForwardMm = eeForward;
+    geom.eeDownMm = eeDown;
+    geom.updateDerivedConstants();
+  }
+};
+
+struct IkCompare {
+  unsigned long mismatches;
+  double maxMm, sumMm, maxDeg, sumDeg;
+};
+
+// Target dari FK pada grid sudut yang lebih rapat dari --check-kinematics (coarse melipatgandakan
+// langkahnya), dengan batas yang sama (elbow menjauhi 0/180 derajat, wrist di depan sumbu Base),
+// lalu bandingkan kedua backend IK pada target itu
+static IkCompare compareIkBackends(RobotGeometry& geom, float eeForward, const float zeroDeg[3], bool down,
+                                   int coarse, std::vector<std::array<float, 3> >& targets) {
+  for (int baseDeg = -175; baseDeg <= 175; baseDeg += 5 * coarse) {
+    for (int shDeg = -60; shDeg <= 120; shDeg += 4 * coarse) {
+      for (int elDeg = 10; elDeg <= 170; elDeg += 4 * coarse) {
+        double q[3] = {radians(baseDeg), radians(shDeg), radians(down ? -elDeg : elDeg)};
+        geom.calculateFK(q[0] - radians(zeroDeg[0]), q[1] - radians(zeroDeg[1]), q[2] - radians(zeroDeg[2]));
+        float x = geom.getFKX(), y = geom.getFKY(), z = geom.getFKZ();
+        if (x * cos(q[0]) + y * sin(q[0]) - eeForward < 1.0) continue;
+        targets.push_back({{x, y, z}});
+      }
+    }
+  }
+
+  IkCompare r = {0, 0, 0, 0, 0};
+  for (const auto& target : targets) {
+    double ref[3], fx[3];
+    ReachStatus refStatus = SimIkBackends::solve(geom, false, target.data(), ref);
+    ReachStatus fxStatus = SimIkBackends::solve(geom, true, target.data(), fx);
+    if (refStatus != fxStatus) {
+      r.mismatches++;
+      continue;
+    }
+    if (refStatus != REACH_OK) continue;
+    double errDeg = 0;
+    for (int j = 0; j < 3; j++) errDeg = std::max(errDeg, fabs(degrees(wrapRad(fx[j] - ref[j]))));
+    geom.calculateFK(ref[0], ref[1], ref[2]);
+    double rx = geom.getFKX(), ry = geom.getFKY(), rz = geom.getFKZ();
+    geom.calculateFK(fx[0], fx[1], fx[2]);
+    double dx = geom.getFKX() - rx, dy = geom.getFKY() - ry, dz = geom.getFKZ() - rz;
+    double errMm = sqrt(dx * dx + dy * dy + dz * dz);
+    r.maxMm = std::max(r.maxMm, errMm);
+    r.maxDeg = std::max(r.maxDeg, errDeg);
+    r.sumMm += errMm;
+    r.sumDeg += errDeg;
+  }
+  return r;
+}
+
+bool simBenchIkBackends(FILE* out) {
+  RobotGeometry geom;
+  bool pass = true;
+  double allMaxMm = 0, allMaxDeg = 0, allSumMm = 0, allFloatNs = 0, allFixedNs = 0;
+  unsigned long allSamples = 0, allMismatches = 0;
+
+  fprintf(out, "{\n");
+  fprintf(out, "  \"tolerance_mm\": %.3f,\n", 0.25);
+  fprintf(out, "  \"sets\": [\n");
+  for (int k = 0; k < KINEMATICS_SET_COUNT; k++) {
+    const KinematicsSet& set = KINEMATICS_SETS[k];
+    geom.setLinkLengths(set.l1, set.l2, set.l3, set.eeForward, set.eeDown);
+    geom.setKinematicZeroOffsets(radians(set.zeroDeg[0]), radians(set.zeroDeg[1]), radians(set.zeroDeg[2]));
+    for (int down = 0; down <= 1; down++) {
+      geom.setUseElbowDownSolution(down);
+      std::vector<std::array<float, 3> > targets;
+      IkCompare cmp = compareIkBackends(geom, set.eeForward, set.zeroDeg, down, 1, targets);
+      unsigned long mismatches = cmp.mismatches;
+      double maxMm = cmp.maxMm, sumMm = cmp.sumMm, maxDeg = cmp.maxDeg, sumDeg = cmp.sumDeg;
+
+      // Waktu host per panggilan, target yang sama untuk kedua backend
+      double ns[2];
+      const int repeats = 5;
+      for (int fixed = 0; fixed <= 1; fixed++) {
+        volatile double sink = 0;
+        double angles[3];
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++) {
+          for (const auto& target : targets) {
+            SimIkBackends::solve(geom, fixed, target.data(), angles);
+            sink = sink + angles[0] + angles[1] + angles[2];
+          }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        ns[fixed] = targets.empty() ? 0.0 : (double)elapsed.count() / (repeats * targets.size());
+      }
+
+      unsigned long compared = targets.size() - mismatches;
+      bool ok = compared > 0 && mismatches == 0 && maxMm <= 0.25;
+      pass = pass && ok;
+      allSamples += compared;
+      allMismatches += mismatches;
+      allMaxMm = std::max(allMaxMm, maxMm);
+      allMaxDeg = std::max(allMaxDeg, maxDeg);
+      allSumMm += sumMm;
+      allFloatNs += ns[0] * targets.size();
+      allFixedNs += ns[1] * targets.size();
+      fprintf(out, "    {\"l1\": %.1f, \"l2\": %.1f, \"l3\": %.1f, \"ee_forward\": %.1f, \"ee_down\": %.1f, "
+              "\"elbow\": \"%s\", \"samples\": %lu, \"status_mismatches\": %lu, \"max_err_mm\": %.5f, "
+              "\"mean_err_mm\": %.5f, \"max_err_deg\": %.5f, \"mean_err_deg\": %.5f, \"float_ns\": %.1f, "
+              "\"fixed_ns\": %.1f, \"pass\": %s}%s\n",
+              set.l1, set.l2, set.l3, set.eeForward, set.eeDown, down ? "down" : "up", compared, mismatches, maxMm,
+              compared ? sumMm / compared : 0.0, maxDeg, compared ? sumDeg / compared : 0.0, ns[0], ns[1],
+              ok ? "true" : "false", (k == KINEMATICS_SET_COUNT - 1 && down) ? "" : ",");
+    }
+  }
+  fprintf(out, "  ],\n");
+
+  // Batas panjang link backend fixed-point: L2 = L3 disapu sampai melewati fixedIkSupports().
+  // Di dalam batas galatnya harus dalam toleransi; di luar batas hanya dilaporkan.
+  const float limitZeroDeg[3] = {0.0, 0.0, 0.0};
+  const float limitL1 = 100.0, limitEeForward = 50.0;
+  float largestSupported = 0;
+  double insideMaxMm = 0, beyondMaxMm = 0;
+  unsigned long insideMismatches = 0, beyondMismatches = 0;
+  geom.setKinematicZeroOffsets(0.0, 0.0, 0.0);
+  geom.setUseElbowDownSolution(false);
+  for (float l = 100.0; l <= 450.0; l += 25.0) {
+    bool supported = RobotGeometry::fixedIkSupports(limitL1, l, l, limitEeForward, 0.0);
+    SimIkBackends::forceLinkLengths(geom, limitL1, l, l, limitEeForward, 0.0);
+    std::vector<std::array<float, 3> > targets;
+    IkCompare cmp = compareIkBackends(geom, limitEeForward, limitZeroDeg, false, 3, targets);
+    if (supported) {
+      largestSupported = l;
+      insideMaxMm = std::max(insideMaxMm, cmp.maxMm);
+      insideMismatches += cmp.mismatches;
+    } else {
+      beyondMaxMm = std::max(beyondMaxMm, cmp.maxMm);
+      beyondMismatches += cmp.mismatches;
+    }
+  }
+
+  // setLinkLengths() menolak nilai yang tidak dapat dipakai backend yang dikompilasi dan
+  // geometri tetap seperti sebelumnya. Dua baris terakhir hanya ditolak backend fixed-point.
+  struct LinkCase {
+    float l1, l2, l3, eeForward, eeDown;
+    bool accepted;
+  };
+  const bool floatBackend = IK_BACKEND != IK_BACKEND_FIXED;
+  const LinkCase linkCases[] = {
+    {100.0, 0.0, 200.0, 0.0, 0.0, false},
+    {100.0, NAN, 200.0, 0.0, 0.0, false},
+    {100.0, 200.0, -5.0, 0.0, 0.0, false},
+    {100.0, 200.0, 200.0, INFINITY, 0.0, false},
+    {100.0, 400.0, 400.0, 50.0, 0.0, floatBackend},
+    {1100.0, 200.0, 200.0, 0.0, 0.0, floatBackend},
+  };
+  unsigned long rejectFailures = 0;
+  for (const LinkCase& c : linkCases) {
+    geom.setLinkLengths(RobotGeometry::DEFAULT_L1, RobotGeometry::DEFAULT_L2, RobotGeometry::DEFAULT_L3,
+                        RobotGeometry::DEFAULT_EE_FORWARD_OFFSET_MM, RobotGeometry::DEFAULT_EE_DOWN_OFFSET_MM);
+    bool accepted = geom.setLinkLengths(c.l1, c.l2, c.l3, c.eeForward, c.eeDown);
+    if (accepted != c.accepted || (!accepted && (geom.getL1() != RobotGeometry::DEFAULT_L1 ||
+                                                 geom.getL2() != RobotGeometry::DEFAULT_L2 ||
+                                                 geom.getL3() != RobotGeometry::DEFAULT_L3))) {
+      rejectFailures++;
+    }
+  }
+
+  bool limitsOk = largestSupported >= 350.0 && insideMismatches == 0 && insideMaxMm <= 0.25 && rejectFailures == 0;
+  pass = pass && limitsOk;
+  fprintf(out, "  \"link_limits\": {\"l1\": %.1f, \"ee_forward\": %.1f, \"largest_supported_l2_l3\": %.1f, "
+          "\"max_err_mm\": %.5f, \"status_mismatches\": %lu, \"beyond_limit_max_err_mm\": %.3f, "
+          "\"beyond_limit_status_mismatches\": %lu, \"reject_failures\": %lu, \"pass\": %s},\n",
+          limitL1, limitEeForward, largestSupported, insideMaxMm, insideMismatches, beyondMaxMm, beyondMismatches,
+          rejectFailures, limitsOk ? "true" : "false");
+  unsigned long timed = allSamples + allMismatches;
+  fprintf(out, "  \"total\": {\"samples\": %lu, \"status_mismatches\": %lu, \"max_err_mm\": %.5f, "
+          "\"mean_err_mm\": %.5f, \"max_err_deg\": %.5f, \"float_ns\": %.1f, \"fixed_ns\": %.1f},\n",
+          allSamples, allMismatches, allMaxMm, allSamples ? allSumMm / allSamples : 0.0, allMaxDeg,
+          timed ? allFloatNs / timed : 0.0, timed ? allFixedNs / timed : 0.0);
+  fprintf(out, "  \"pass\": %s\n", pass ? "true" : "false");
+  fprintf(out, "}\n");
+  return pass;
+}
+
+static void writeSummary(FILE* out, const char* name, const SimSummary& s, const char* trailer) {
+  fprintf(out, "\"%s\": {\"count\": %zu, \"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}%s",
+          name, s.count, s.mean, s.p50, s.p90, s.p99, s.max, trailer);
+}
+
+void simBenchWriteReport(FILE* out, const SimBenchResult& r) {
+  const double tickUs = 1.0 / SIM_TICKS_PER_US;
+
+  fprintf(out, "{\n");
+  fprintf(out, "  \"program\": \"%s\",\n", r.program);
+  fprintf(out, "  \"ik_backend\": \"%s\",\n", IK_BACKEND == IK_BACKEND_FIXED ? "fixed" : "float");
+  fprintf(out, "  \"finished\": %s,\n", r.finished ? "true" : "false");
+  fprintf(out, "  \"setup_s\": %.6f,\n", r.setupSeconds);
+  fprintf(out, "  \"program_s\": %.6f,\n", r.programSeconds);
+  fprintf(out, "  \"look_ahead\": %s,\n", r.lookAhead ? "true" : "false");
+  const SimSenderStats& s = r.sender;
+  fprintf(out, "  \"sender\": {\"mode\": \"%s\", \"lines\": %lu, \"lines_per_s\": %.1f, \"bytes\": %lu, "
+          "\"resends\": %lu, \"rejected\": %lu, \"alarms\": %lu, \"queue_free_min\": %d},\n",
+          r.senderMode, s.linesSent, r.programSeconds > 0 ? s.linesSent / r.programSeconds : 0.0, s.bytesSent,
+          s.resends, s.rejected, s.alarms, s.queueFreeMin);
+
+  fprintf(out, "  \"loop\": {\"count\": %lu, ", r.loops);
+  writeSummary(out, "sim_us", simSummarize(loopSimTicks, tickUs), ", ");
+  writeSummary(out, "host_ns", simSummarize(loopHostNs, 1.0), "},\n");
+
+  fprintf(out, "  \"ik\": {\"calls\": %lu, \"host_ns_per_call\": %.1f},\n", r.ikCalls, r.ikHostNs);
+
+  fprintf(out, "  ");
+  writeSummary(out, "isr_latency_us", simSummarize(simIsrLatencies(), tickUs), ",\n");
+
+  const StepEngineStats& p = r.pipeline;
+  fprintf(out, "  \"pipeline\": {\"blocks\": %lu, \"underruns\": %lu, \"depth_min\": %u, \"depth_avg\": %.2f, \"depth_max\": %u},\n",
+          p.blocksExecuted, p.underruns, p.blocksExecuted ? p.minDepth : 0,
+          p.blocksExecuted ? (double)p.depthSum / p.blocksExecuted : 0.0, p.maxDepth);
+
+  fprintf(out, "  \"serial_rx\": {\"bytes\": %lu, \"overruns\": %lu, \"blocked_us\": %.1f, \"blocked_max_us\": %.1f},\n",
+          simSerialRxBytes(), simSerialRxOverruns(), simSerialRxBlockedTicks() * tickUs,
+          simSerialRxBlockedMaxTicks() * tickUs);
+
+  // Seluruh run termasuk homing: tepi pin model (termasuk pantulan), reaksi ISR pin, dan
+  // langkah yang lolos melewati titik picu switch (harus 0)
+  const LimitSwitchStats& l = r.limits;
+  fprintf(out, "  \"limit_switches\": {\"pin_edges\": %lu, \"isr_edges\": %lu, \"trips\": %lu, \"deferred_releases\": %lu, "
+               "\"isr_latency_max_us\": %.1f, \"overtravel_steps\": %lu},\n",
+          simLimitEdges(), l.edges, l.trips, l.deferred, simLimitIsrLatencyMax() * tickUs, simLimitOvertravelSteps());
+
+  fprintf(out, "  \"axes\": [\n");
+  for (uint8_t i = 0; i < simAxisCount(); i++) {
+    unsigned long steps = simAxisStatSteps(i);
+    uint32_t minInterval = simAxisMinInterval(i);
+    double peakRate = (steps > 1 && minInterval != UINT32_MAX) ? 1e6 / (minInterval * tickUs) : 0.0;
+    fprintf(out, "    {\"name\": \"%s\", \"steps\": %lu, \"steps_per_s\": %.1f, \"peak_steps_per_s\": %.1f, ",
+            simAxisName(i), steps, r.programSeconds > 0 ? steps / r.programSeconds : 0.0, peakRate);
+    writeSummary(out, "interval_jitter_us", simSummarize(simAxisIntervalDeltas(i), tickUs), "}");
+    fprintf(out, "%s\n", i + 1 < simAxisCount() ? "," : "");
+  }
+  fprintf(out, "  ]\n");
+  fprintf(out, "}\n");
+}
+
+// Parser lama: salinan jalur loop()/Command sebelum parser tanpa alokasi
+static bool legacyHandleLine(const String& raw, Cmd& cmd) {
+  String line = raw;
+  line.trim();
+  if (line.length() == 0) return false;
+
+  // handleDebugCommands(): salinan huruf besar dan pengecekan awalan
+  String upper = line;
+  upper.toUpperCase();
+  if (upper.equalsIgnoreCase("POS") || upper.startsWith("J0") || upper.startsWith("J1") ||
+      upper.startsWith("J2") || upper.startsWith("J3") || upper.startsWith("GOTO")) {
+    return false;
+  }
+
+  if (line.charAt(0) != 'G' && line.charAt(0) != 'M') return false;
+  cmd.id = line.charAt(0);
+  cmd.num = line.substring(1).toInt();
+  cmd.valueX = cmd.valueY = cmd.valueZ = NAN;
+  cmd.valueE = cmd.valueF = cmd.valueT = NAN;
+  cmd.valueI = cmd.valueJ = cmd.valueR = NAN; // Kata busur belum dikenal parser lama
+
+  int idx = 1;
+  while (idx < (int)line.length()) {
+    char axis = line.charAt(idx);
+    idx++;
+    int nextSpace = line.indexOf(' ', idx);
+    String numStr;
+    if (nextSpace == -1) {
+      numStr = line.substring(idx);
+      idx = line.length();
+    } else {
+      numStr = line.substring(idx, nextSpace);
+      idx = nextSpace + 1;
+    }
+    float val = numStr.toFloat();
+    switch (axis) {
+      case 'X': cmd.valueX = val; break;
+      case 'Y': cmd.valueY = val; break;
+      case 'Z': cmd.valueZ = val; break;
+      case 'E': cmd.valueE = val; break;
+      case 'F': cmd.valueF = val; break;
+      case 'T': cmd.valueT = val; break;
+      default: break;
+    }
+  }
+  return true;
+}
+
+// Parser baru: jalur loop() saat ini
+static bool currentHandleLine(Command& command, const std::string& raw, Cmd& cmd) {
+  char line[COMMAND_LINE_MAX + 1];
+  size_t length = std::min(raw.size(), (size_t)COMMAND_LINE_MAX);
+  memcpy(line, raw.data(), length);
+  line[length] = '\0';
+
+  if (command.prepareLine(line) != LINE_READY) return false;
+  if (strcmp(line, "POS") == 0 || (line[0] == 'J' && line[1] >= '0' && line[1] <= '3') ||
+      strncmp(line, "GOTO", 4) == 0) {
+    return false;
+  }
+  if (!command.handleGcodeLine(line)) return false;
+  cmd = command.getCmd();
+  return true;
+}
+
+static bool sameValue(float a, float b) {
+  return (isnan(a) && isnan(b)) || fabsf(a - b) <= 1e-4f * std::max(1.0f, fabsf(a));
+}
+
+static bool sameCmd(const Cmd& a, const Cmd& b) {
+  return a.id == b.id && a.num == b.num && sameValue(a.valueX, b.valueX) && sameValue(a.valueY, b.valueY) &&
+         sameValue(a.valueZ, b.valueZ) && sameValue(a.valueE, b.valueE) && sameValue(a.valueF, b.valueF) &&
+         sameValue(a.valueT, b.valueT) && sameValue(a.valueI, b.valueI) && sameValue(a.valueJ, b.valueJ) &&
+         sameValue(a.valueR, b.valueR);
+}
+
+void simBenchParser(FILE* out, const std::vector<std::string>& lines, unsigned long repeats) {
+  std::vector<String> legacyLines(lines.begin(), lines.end());
+  Command command;
+  volatile float sink = 0;
+  unsigned long parsed = 0;
+
+  // Hasil kedua parser harus sama untuk G-code tanpa komentar
+  unsigned long mismatches = 0;
+  for (size_t i = 0; i < lines.size(); i++) {
+    Cmd legacyCmd, currentCmd;
+    bool legacyOk = legacyHandleLine(legacyLines[i], legacyCmd);
+    bool currentOk = currentHandleLine(command, lines[i], currentCmd);
+    if (legacyOk != currentOk || (legacyOk && !sameCmd(legacyCmd, currentCmd))) mismatches++;
+  }
+
+  // Baris protokol: '*' di dalam komentar bukan checksum. {baris, checksum benar ditambahkan,
+  // status yang diharapkan, hasil normalisasi}
+  struct ProtocolCase {
+    const char* line;
+    bool addChecksum;
+    LineStatus status;
+    const char* normalized;
+  };
+  const ProtocolCase protocolCases[] = {
+    {"G1 X10 ; ambil *bola", false, LINE_READY, "G1 X10"},
+    {"G1 X10 (a*b) Y5", false, LINE_READY, nullptr},
+    {"N1 G1 X10", true, LINE_READY, "G1 X10"},
+    {"N2 G1 Y2", true, LINE_READY, "G1 Y2"},
+    {"N3 G1 Z1 ; z*12", false, LINE_CHECKSUM_ERROR, nullptr}, // Bernomor tanpa checksum
+    {"N3 G1 Z1*0", false, LINE_CHECKSUM_ERROR, nullptr},
+  };
+  Command protocol;
+  unsigned long protocolFailures = 0;
+  for (const ProtocolCase& c : protocolCases) {
+    char line[COMMAND_LINE_MAX + 1];
+    snprintf(line, sizeof(line), "%s", c.line);
+    if (c.addChecksum) {
+      uint8_t checksum = 0;
+      for (const char* p = c.line; *p; p++) checksum ^= (uint8_t)*p;
+      snprintf(line, sizeof(line), "%s*%u", c.line, checksum);
+    }
+    LineStatus status = protocol.prepareLine(line);
+    if (status != c.status || (c.normalized && strcmp(line, c.normalized) != 0)) protocolFailures++;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned long r = 0; r < repeats; r++) {
+    for (size_t i = 0; i < legacyLines.size(); i++) {
+      Cmd cmd;
+      if (legacyHandleLine(legacyLines[i], cmd)) {
+        sink = sink + cmd.valueX;
+        parsed++;
+      }
+    }
+  }
+  double legacyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned long r = 0; r < repeats; r++) {
+    for (size_t i = 0; i < lines.size(); i++) {
+      Cmd cmd;
+      if (currentHandleLine(command, lines[i], cmd)) {
+        sink = sink + cmd.valueX;
+        parsed++;
+      }
+    }
+  }
+  double currentNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  // Frame biner untuk setiap perintah G/M: decode harus menghasilkan Cmd yang sama (nilai
+  // dengan lebih dari 2 desimal dibulatkan ke 0.01 dan terhitung berbeda). floatBytes adalah
+  // ukuran frame yang sama dengan nilai float 4 byte, format sebelum fixed point.
+  std::vector<std::vector<uint8_t> > frames;
+  unsigned long frameMismatches = 0;
+  size_t asciiBytes = 0, frameBytes = 0, floatBytes = 0;
+  for (size_t i = 0; i < lines.size(); i++) {
+    Cmd cmd, decoded;
+    if (!currentHandleLine(command, lines[i], cmd)) continue;
+    uint8_t frame[FRAME_MAX_SIZE];
+    uint8_t length = packFrame((uint8_t)frames.size(), cmd, frame);
+    uint8_t seq;
+    if (unpackFrame(frame, length, seq, decoded) != FRAME_OK || !sameCmd(cmd, decoded)) frameMismatches++;
+    frames.push_back(std::vector<uint8_t>(frame, frame + length));
+    asciiBytes += lines[i].size() + 1;
+    frameBytes += length;
+    floatBytes += FRAME_HEADER_SIZE + FRAME_PAYLOAD_MIN + FRAME_CRC_SIZE;
+    for (uint8_t v = 0; v < FRAME_VALUE_COUNT; v++) {
+      if (!isnan(*cmdValue(cmd, v))) floatBytes += 4;
+    }
+    if (!isnan(cmd.valueI) || !isnan(cmd.valueJ) || !isnan(cmd.valueR)) floatBytes++;
+  }
+  // Batas 16/24-bit fixed point: nilai harus kembali sama dengan parse ASCII, dan nilai di
+  // luar jangkauan 24-bit tidak dikemas (pengirim mengirimnya sebagai teks)
+  const char* edgeLines[] = {
+    "G1 X327.67 Y-327.68 Z327.68 E-327.69 F83886.07 T8388.6",
+    "G1 X-83886.07 Y0.01 Z-0.01 E0 T-32.768",
+    "G2 X1 Y2 I-327.68 J327.67 R83886.07",
+    "G3 X0.5 Y-0.5 R-83886.07 F1500",
+  };
+  unsigned long edgeMismatches = 0;
+  for (const char* line : edgeLines) {
+    Cmd cmd, decoded;
+    uint8_t frame[FRAME_MAX_SIZE];
+    uint8_t seq;
+    if (!currentHandleLine(command, line, cmd)) edgeMismatches++;
+    else if (unpackFrame(frame, packFrame(0, cmd, frame), seq, decoded) != FRAME_OK || !sameCmd(cmd, decoded)) edgeMismatches++;
+  }
+  const char* outOfRange[] = {"G1 X83886.08", "G1 T8388.608", "G2 X1 Y1 R-90000"};
+  for (const char* line : outOfRange) {
+    Cmd cmd;
+    uint8_t frame[FRAME_MAX_SIZE];
+    if (!currentHandleLine(command, line, cmd) || packFrame(0, cmd, frame) != 0) edgeMismatches++;
+  }
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned long r = 0; r < repeats; r++) {
+    for (size_t i = 0; i < frames.size(); i++) {
+      Cmd cmd;
+      uint8_t seq;
+      if (unpackFrame(frames[i].data(), frames[i].size(), seq, cmd) == FRAME_OK) {
+        sink = sink + cmd.valueX;
+        parsed++;
+      }
+    }
+  }
+  double binaryNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  double total = (double)lines.size() * repeats;
+  double frameTotal = (double)frames.size() * repeats;
+  fprintf(out, "{\n");
+  fprintf(out, "  \"lines\": %zu,\n", lines.size());
+  fprintf(out, "  \"repeats\": %lu,\n", repeats);
+  fprintf(out, "  \"mismatches\": %lu,\n", mismatches);
+  fprintf(out, "  \"protocol_failures\": %lu,\n", protocolFailures);
+  fprintf(out, "  \"legacy\": {\"ns_per_line\": %.1f, \"lines_per_s\": %.0f},\n",
+          legacyNs / total, total / (legacyNs * 1e-9));
+  fprintf(out, "  \"current\": {\"ns_per_line\": %.1f, \"lines_per_s\": %.0f},\n",
+          currentNs / total, total / (currentNs * 1e-9));
+  fprintf(out, "  \"speedup\": %.2f,\n", currentNs > 0 ? legacyNs / currentNs : 0.0);
+  fprintf(out, "  \"binary\": {\"frames\": %zu, \"mismatches\": %lu, \"edge_mismatches\": %lu, \"ns_per_frame\": %.1f, \"frames_per_s\": %.0f, "
+               "\"bytes_per_command\": %.1f, \"float_bytes_per_command\": %.1f, \"ascii_bytes_per_command\": %.1f}\n",
+          frames.size(), frameMismatches, edgeMismatches, frameTotal > 0 ? binaryNs / frameTotal : 0.0,
+          binaryNs > 0 ? frameTotal / (binaryNs * 1e-9) : 0.0,
+          frames.empty() ? 0.0 : (double)frameBytes / frames.size(),
+          frames.empty() ? 0.0 : (double)floatBytes / frames.size(),
+          frames.empty() ? 0.0 : (double)asciiBytes / frames.size());
+  fprintf(out, "}\n");
+}
+
+// Antrian lama (queue.h sebelum RingBuffer): malloc, indeks modulo, count bersama
+template <typename T>
+class LegacyQueue {
+public:
+  LegacyQueue(int capacity) : head(0), tail(0), count(0), cap(capacity) { buffer = (T*)malloc(sizeof(T) * cap); }
+  ~LegacyQueue() { free(buffer); }
+  bool push(const T& item) {
+    if (count == cap) return false;
+    buffer[tail] = item;
+    tail = (tail + 1) % cap;
+    count++;
+    return true;
+  }
+  T pop() {
+    T val = buffer[head];
+    head = (head + 1) % cap;
+    count--;
+    return val;
+  }
+  bool isEmpty() const { return count == 0; }
+
+private:
+  T* buffer;
+  int head, tail, count, cap;
+};
+
+struct RingItem {
+  uint32_t seq;
+  uint32_t check; // Fungsi dari seq: slot yang terbaca sebelum selesai ditulis akan terdeteksi
+  uint8_t pad[18]; // Ukuran mendekati Cmd
+};
+
+static uint32_t ringCheck(uint32_t seq) { return seq * 2654435761u ^ 0xA5A5A5A5u; }
+
+bool simBenchRing(FILE* out, unsigned long items) {
+  // Stres: produsen dan konsumen di thread berbeda, bergiliran memakai semua operasi
+  RingBuffer<RingItem, 16> ring;
+  unsigned long producerFull = 0, consumerEmpty = 0, errors = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer([&]() {
+    uint32_t seq = 0;
+    RingItem batch[7];
+    while (seq < items) {
+      switch (seq % 3) {
+        case 0: {
+          RingItem item = {seq, ringCheck(seq), {0}};
+          if (ring.push(item)) {
+            seq++;
+          } else {
+            producerFull++;
+            std::this_thread::yield();
+          }
+          break;
+        }
+        case 1: {
+          RingItem* slot = ring.emplace();
+          if (!slot) {
+            producerFull++;
+            std::this_thread::yield();
+            break;
+          }
+          slot->seq = seq;
+          slot->check = ringCheck(seq);
+          ring.commit();
+          seq++;
+          break;
+        }
+        default: {
+          uint8_t n = (uint8_t)(1 + seq % 7);
+          if (n > items - seq) n = (uint8_t)(items - seq);
+          for (uint8_t i = 0; i < n; i++) batch[i] = {seq + i, ringCheck(seq + i), {0}};
+          uint8_t pushed = ring.pushBulk(batch, n);
+          if (pushed == 0) {
+            producerFull++;
+            std::this_thread::yield();
+          }
+          seq += pushed;
+          break;
+        }
+      }
+    }
+  });
+  uint32_t expected = 0;
+  RingItem batch[5];
+  while (expected < items) {
+    uint8_t n = 0;
+    switch (expected % 3) {
+      case 0:
+        n = ring.pop(batch[0]) ? 1 : 0;
+        break;
+      case 1: {
+        const RingItem* slot = ring.peek();
+        if (slot) {
+          batch[0] = *slot;
+          ring.drop();
+          n = 1;
+        }
+        break;
+      }
+      default:
+        n = ring.popBulk(batch, 5);
+        break;
+    }
+    // Menyerahkan CPU saat menunggu: di host satu core, spin menahan thread lain selama satu time slice
+    if (n == 0) {
+      consumerEmpty++;
+      std::this_thread::yield();
+    }
+    for (uint8_t i = 0; i < n; i++) {
+      if (batch[i].seq != expected || batch[i].check != ringCheck(expected)) errors++;
+      expected++;
+    }
+  }
+  producer.join();
+  double stressNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  if (!ring.isEmpty()) errors++;
+
+  // Throughput satu thread (seperti loop()): push lalu pop satu Cmd, antrian lama vs RingBuffer
+  Cmd cmd = {'G', 1, 1.0f, 2.0f, 3.0f, 0.0f, 1000.0f, NAN, NAN, NAN, NAN};
+  volatile float sink = 0;
+  LegacyQueue<Cmd> legacy(15);
+  start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < items; i++) {
+    cmd.valueX = (float)i;
+    legacy.push(cmd);
+    if (i & 1) {
+      while (!legacy.isEmpty()) sink = sink + legacy.pop().valueX;
+    }
+  }
+  double legacyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  RingBuffer<Cmd, 16> queue;
+  start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < items; i++) {
+    cmd.valueX = (float)i;
+    queue.push(cmd);
+    if (i & 1) {
+      while (const Cmd* next = queue.peek()) {
+        sink = sink + next->valueX;
+        queue.drop();
+      }
+    }
+  }
+  double ringNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  // Antrian perintah firmware: pack saat push, decode saat pop
+  CommandQueue packed;
+  start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < items; i++) {
+    cmd.valueX = (float)(i & 0xFFFF);
+    packed.push(cmd);
+    if (i & 1) {
+      Cmd next;
+      while (packed.pop(next)) sink = sink + next.valueX;
+    }
+  }
+  double packedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  bool pass = errors == 0;
+  fprintf(out, "{\n");
+  fprintf(out, "  \"stress\": {\"items\": %lu, \"errors\": %lu, \"producer_full\": %lu, \"consumer_empty\": %lu, "
+          "\"ns_per_item\": %.1f, \"pass\": %s},\n",
+          items, errors, producerFull, consumerEmpty, items ? stressNs / items : 0.0, pass ? "true" : "false");
+  fprintf(out, "  \"throughput\": {\"legacy_ns_per_cmd\": %.2f, \"ring_ns_per_cmd\": %.2f, \"packed_ns_per_cmd\": %.2f}\n",
+          items ? legacyNs / items : 0.0, items ? ringNs / items : 0.0, items ? packedNs / items : 0.0);
+  fprintf(out, "}\n");
+  return pass;
+}
+
+// sizeof(Cmd) di AVR (int 16 bit, tanpa padding); di host 44
+static const int AVR_CMD_SIZE = 1 + 2 + FRAME_VALUE_COUNT * 4;
+
+// Identik bit demi bit (NAN dari parser dan dari unpackCmd() sama-sama konstanta NAN)
+static bool identicalCmd(const Cmd& a, const Cmd& b) {
+  const float* va = &a.valueX;
+  const float* vb = &b.valueX;
+  if (a.id != b.id || a.num != b.num) return false;
+  for (int i = 0; i < FRAME_VALUE_COUNT; i++) {
+    if (isnan(va[i]) && isnan(vb[i])) continue;
+    if (memcmp(&va[i], &vb[i], sizeof(float)) != 0) return false;
+  }
+  return true;
+}
+
+// Jumlah nilai yang disimpan sebagai float mentah di rekaman
+static int packedRawCount(const uint8_t* record) {
+  int index = record[1] == CMD_OPCODE_ESCAPE ? 5 : 2;
+  uint8_t flags = record[index++];
+  int count = 0;
+  if (flags & PACKED_PRESENT_RAW) count += __builtin_popcount(record[index++]);
+  if (flags & PACKED_PRESENT_ARC) count += __builtin_popcount((record[index] >> 4) & 0x07);
+  return count;
+}
+
+bool simBenchPacking(FILE* out, const std::vector<std::string>& lines) {
+  uint8_t record[PACKED_CMD_MAX_SIZE];
+  Cmd decoded;
+
+  // Perintah program
+  Command command;
+  std::vector<Cmd> commands;
+  unsigned long mismatches = 0, escapes = 0, values = 0, rawValues = 0;
+  size_t packedBytes = 0;
+  for (size_t i = 0; i < lines.size(); i++) {
+    Cmd cmd;
+    if (!currentHandleLine(command, lines[i], cmd)) continue;
+    uint8_t length = packCmd(cmd, record);
+    unpackCmd(record, decoded);
+    if (record[0] != length || !identicalCmd(cmd, decoded)) mismatches++;
+    if (record[1] == CMD_OPCODE_ESCAPE) escapes++;
+    for (const float* v = &cmd.valueX; v <= &cmd.valueR; v++) values += !isnan(*v);
+    rawValues += packedRawCount(record);
+    packedBytes += length;
+    commands.push_back(cmd);
+  }
+
+  // Nilai dari teks dengan paling banyak 2 desimal (T: 3) harus tersimpan sebagai fixed point
+  uint32_t seed = 12345;
+  auto next = [&seed]() {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+  };
+  unsigned long textValues = 0, textMismatches = 0, textRaw = 0;
+  for (int i = 0; i < 200000; i++) {
+    int field = next() % FRAME_VALUE_COUNT;
+    int decimals = next() % (field == 5 ? 4 : 3);
+    long limit = field == 5 ? 8000 : 80000;
+    char text[32];
+    int written = snprintf(text, sizeof(text), "%s%ld", (next() & 1) ? "-" : "", (long)(next() % limit));
+    if (decimals > 0) snprintf(text + written, sizeof(text) - written, ".%0*ld", decimals, (long)(next() % (decimals == 1 ? 10 : decimals == 2 ? 100 : 1000)));
+    float value;
+    Command::parseNumber(text, value);
+    if (value == 0.0f) value = 0.0f; // "-0" diparse sebagai -0.0, yang sengaja disimpan mentah
+    Cmd cmd = {'G', 1, NAN, NAN, NAN, NAN, NAN, NAN, NAN, NAN, NAN};
+    (&cmd.valueX)[field] = value;
+    packCmd(cmd, record);
+    unpackCmd(record, decoded);
+    if (!identicalCmd(cmd, decoded)) textMismatches++;
+    if (packedRawCount(record)) textRaw++;
+    textValues++;
+  }
+
+  // Pola bit acak (termasuk -0, tak hingga, subnormal, di luar jangkauan 24 bit) dan kode perintah acak
+  unsigned long randomCommands = 0, randomMismatches = 0;
+  for (int i = 0; i < 200000; i++) {
+    Cmd cmd;
+    const char ids[] = {'G', 'M', 'P', 'X'};
+    cmd.id = ids[next() % 4];
+    cmd.num = (int)(next() % 65536) - 32768;
+    if (i & 1) cmd.num = next() % 1000;
+    for (float* v = &cmd.valueX; v <= &cmd.valueR; v++) {
+      uint32_t bits = (next() << 16) ^ next();
+      switch (next() % 4) {
+        case 0: *v = NAN; break;
+        case 1: memcpy(v, &bits, sizeof(float)); if (isnan(*v)) *v = -0.0f; break;
+        case 2: *v = (float)((int32_t)(bits % 20000001) - 10000000) / 100.0f; break;
+        default: *v = (float)(bits % 2000) * 0.25f - 250.0f; break;
+      }
+    }
+    uint8_t length = packCmd(cmd, record);
+    unpackCmd(record, decoded);
+    if (length > PACKED_CMD_MAX_SIZE || !identicalCmd(cmd, decoded)) randomMismatches++;
+    randomCommands++;
+  }
+
+  // Lewat CommandQueue dengan pop berselang (indeks ring melewati batas), lalu kedalaman
+  // antrian kosong yang diisi perintah program secara berurutan
+  unsigned long queueMismatches = 0;
+  size_t depth = 0;
+  if (!commands.empty()) {
+    CommandQueue queue;
+    size_t pushIndex = 0, popIndex = 0;
+    for (int round = 0; round < 5000; round++) {
+      while (!queue.isFull()) queue.push(commands[pushIndex++ % commands.size()]);
+      for (int n = round % 7 + 1; n > 0 && queue.pop(decoded); n--) {
+        if (!identicalCmd(commands[popIndex++ % commands.size()], decoded)) queueMismatches++;
+      }
+    }
+    while (queue.pop(decoded)) {
+      if (!identicalCmd(commands[popIndex++ % commands.size()], decoded)) queueMismatches++;
+    }
+    if (pushIndex != popIndex) queueMismatches++;
+
+    CommandQueue fresh;
+    while (fresh.push(commands[depth % commands.size()])) depth++;
+  }
+
+  // Q di ack: pada setiap tingkat isi, satu rekaman terbesar (opcode escape, I/J/R, semua nilai
+  // mentah) lalu Q - 1 rekaman terbesar tanpa busur harus selalu masuk
+  Cmd arcWorst = {'G', 999, NAN, NAN, NAN, NAN, NAN, NAN, NAN, NAN, NAN};
+  for (float* v = &arcWorst.valueX; v <= &arcWorst.valueR; v++) *v = 0.0001f;
+  Cmd lineWorst = arcWorst;
+  lineWorst.valueI = lineWorst.valueJ = lineWorst.valueR = NAN;
+  unsigned long slotViolations = 0;
+  int emptySlots = CommandQueue().freeSlots();
+  if (packCmd(arcWorst, record) != PACKED_CMD_MAX_SIZE || packCmd(lineWorst, record) != PACKED_CMD_BASE_MAX_SIZE) {
+    slotViolations++;
+  }
+  for (size_t fill = 0; !commands.empty() && fill < 64; fill++) {
+    CommandQueue queue;
+    for (size_t i = 0; i < fill && !queue.isFull(); i++) queue.push(commands[(fill * 7 + i) % commands.size()]);
+    uint8_t slots = queue.freeSlots();
+    if ((slots == 0) != queue.isFull()) slotViolations++;
+    for (uint8_t i = 0; i < slots; i++) {
+      if (!queue.push(i == 0 ? arcWorst : lineWorst)) slotViolations++;
+    }
+  }
+
+  bool pass = mismatches == 0 && textMismatches == 0 && textRaw == 0 && randomMismatches == 0 && queueMismatches == 0 &&
+              slotViolations == 0;
+  fprintf(out, "{\n");
+  fprintf(out, "  \"program\": {\"commands\": %zu, \"mismatches\": %lu, \"escapes\": %lu, \"values\": %lu, \"raw_values\": %lu, "
+               "\"bytes_per_command\": %.2f, \"unpacked_bytes_avr\": %d},\n",
+          commands.size(), mismatches, escapes, values, rawValues,
+          commands.empty() ? 0.0 : (double)packedBytes / commands.size(), AVR_CMD_SIZE);
+  fprintf(out, "  \"text_values\": {\"count\": %lu, \"mismatches\": %lu, \"raw\": %lu},\n", textValues, textMismatches, textRaw);
+  fprintf(out, "  \"random\": {\"commands\": %lu, \"mismatches\": %lu},\n", randomCommands, randomMismatches);
+  fprintf(out, "  \"queue\": {\"bytes\": %d, \"depth\": %zu, \"unpacked_depth_same_sram\": %zu, \"mismatches\": %lu, "
+               "\"free_slots_empty\": %d, \"free_slot_violations\": %lu},\n",
+          COMMAND_QUEUE_BYTES, depth, (size_t)(COMMAND_QUEUE_BYTES / AVR_CMD_SIZE), queueMismatches, emptySlots,
+          slotViolations);
+  fprintf(out, "  \"pass\": %s\n", pass ? "true" : "false");
+  fprintf(out, "}\n");
+  return pass;
+}
+
+struct GpioCost {
+  double instructions, cycles; // Per langkah
+};
+
+// Tipe konkret seperti ISR StepEngine: FastAxis inline, RampsStepper lewat digitalWrite
+template <class Axis>
+static GpioCost runAxisPulses(Axis* axis, unsigned long steps) {
+  unsigned long instructions, cycles;
+  simResetGpioCost();
+  for (unsigned long i = 0; i < steps; i++) {
+    // Ganti arah setiap 64 langkah (awal blok), separuh waktu menuju limit
+    if (i % 64 == 0) axis->setStepDirection((i / 64) & 1);
+    if (axis->stepPulseHigh()) axis->stepPulseLow();
+  }
+  simGpioCost(instructions, cycles);
+  GpioCost cost = {steps ? (double)instructions / steps : 0.0, steps ? (double)cycles / steps : 0.0};
+  return cost;
+}
+
+template <class FastAxisT>
+static bool benchAxisGpio(FILE* out, const char* name, RampsStepper& legacy, FastAxisT& fast, unsigned long steps,
+                          GpioCost& legacyTotal, GpioCost& fastTotal, bool last) {
+  bool same = true;
+  for (int direction = 0; direction < 2; direction++) {
+    legacy.setStepDirection(direction);
+    int legacyLevel = simFastPinRead(legacy.getDirPin(), 0, 0);
+    fast.setStepDirection(direction);
+    if (simFastPinRead(fast.getDirPin(), 0, 0) != legacyLevel) same = false;
+  }
+  legacy.setPosition(0);
+  fast.setPosition(0);
+  GpioCost legacyCost = runAxisPulses(&legacy, steps);
+  GpioCost fastCost = runAxisPulses(&fast, steps);
+  if (legacy.getPosition() != fast.getPosition()) same = false;
+  legacyTotal.instructions += legacyCost.instructions;
+  legacyTotal.cycles += legacyCost.cycles;
+  fastTotal.instructions += fastCost.instructions;
+  fastTotal.cycles += fastCost.cycles;
+  fprintf(out, "    {\"axis\": \"%s\", \"step_pin\": %d, \"dir_pin\": %d, \"limit_pin\": %d, "
+               "\"legacy\": {\"instructions\": %.2f, \"cycles\": %.2f}, \"fast\": {\"instructions\": %.2f, \"cycles\": %.2f}, "
+               "\"same\": %s}%s\n",
+          name, legacy.getStepPin(), legacy.getDirPin(), legacy.getLimitPin(), legacyCost.instructions, legacyCost.cycles,
+          fastCost.instructions, fastCost.cycles, same ? "true" : "false", last ? "" : ",");
+  return same;
+}
+
+// Versi lama Gripper::writePhase(): satu digitalWrite() per pin koil
+static const uint8_t GRIPPER_PINS[4] = {GRIPPER_PIN0, GRIPPER_PIN1, GRIPPER_PIN2, GRIPPER_PIN3};
+
+static uint8_t gripperPinLevels() {
+  uint8_t levels = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    if (simFastPinRead(GRIPPER_PINS[i], 0, 0) == HIGH) levels |= 0b1000 >> i;
+  }
+  return levels;
+}
+
+// Satu langkah gripper di ISR Timer3: digitalWrite() lama vs FastPin Gripper::isr(), dengan
+// level koil yang sama setelah setiap langkah
+static bool benchGripperGpio(FILE* out, unsigned long steps) {
+  static const uint8_t PATTERN[4] = {0b1010, 0b0110, 0b0101, 0b1001};
+  Gripper gripper;
+  unsigned long instructions, cycles;
+  unsigned long legacyInstructions = 0, legacyCycles = 0, fastInstructions = 0, fastCycles = 0;
+  bool same = true;
+  uint8_t phase = 0;
+  for (unsigned long i = 0; i < steps; i++) {
+    // Arah berganti setiap 64 langkah, seperti M3/M5 bergantian
+    bool closing = ((i / 64) & 1) == 0;
+    phase = (phase + (closing ? 1 : 3)) & 3;
+    simResetGpioCost();
+    for (uint8_t p = 0; p < 4; p++) digitalWrite(GRIPPER_PINS[p], (PATTERN[phase] & (0b1000 >> p)) ? HIGH : LOW);
+    simGpioCost(instructions, cycles);
+    legacyInstructions += instructions;
+    legacyCycles += cycles;
+    uint8_t legacyLevels = gripperPinLevels();
+
+    gripper.move(closing ? 1 : -1);
+    simResetGpioCost();
+    gripper.isr();
+    simGpioCost(instructions, cycles);
+    fastInstructions += instructions;
+    fastCycles += cycles;
+    if (gripperPinLevels() != legacyLevels) same = false;
+  }
+  double n = steps ? (double)steps : 1.0;
+  fprintf(out, "  \"gripper\": {\"pins\": [%d, %d, %d, %d], \"legacy\": {\"instructions\": %.2f, \"cycles\": %.2f, "
+               "\"us\": %.2f}, \"fast\": {\"instructions\": %.2f, \"cycles\": %.2f, \"us\": %.2f}, \"same\": %s},\n",
+          GRIPPER_PIN0, GRIPPER_PIN1, GRIPPER_PIN2, GRIPPER_PIN3, legacyInstructions / n, legacyCycles / n,
+          legacyCycles / n / 16.0, fastInstructions / n, fastCycles / n, fastCycles / n / 16.0, same ? "true" : "false");
+  return same;
+}
+
+// Lebar pulsa step dari ISR StepEngine (bukan panggilan pulsa langsung seperti di atas): satu
+// blok dengan keempat sumbu melangkah di setiap event pada kecepatan maksimum, dijalankan
+// timer simulasi. Setiap pin step harus HIGH minimal STEP_PULSE_MIN_US.
+static bool benchStepPulse(FILE* out, BaseAxis& base, ShoulderAxis& shoulder, ElbowAxis& elbow, SliderAxis& slider,
+                           unsigned long steps) {
+  // Statis: timer simulasi tetap memegang engine aktif setelah fungsi ini selesai
+  static StepEngine engine;
+  engine.begin(&base, &shoulder, &elbow, &slider);
+  StepBlock* block = engine.reserveBlock();
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) block->steps[i] = (long)steps;
+  block->directionBits = 0;
+  block->stepEventCount = (long)steps;
+  block->nominalRate = block->initialRate = block->finalRate = block->safeRate = (unsigned long)SLIDER_MAX_STEP_RATE;
+  block->rateDelta = 0;
+  block->accelerateUntil = 0;
+  block->decelerateAfter = (long)steps;
+  block->action = nullptr;
+  block->actionValue = 0;
+  block->dwellTicks = 0;
+  engine.commitBlock();
+
+  simResetStats();
+  unsigned long isrBefore = simIsrCount();
+  uint64_t start = simNow();
+  while (engine.isBusy()) simAdvance(STEP_IDLE_INTERVAL);
+  double isrUs = (double)(simNow() - start) / SIM_TICKS_PER_US;
+
+  const uint8_t stepPins[STEP_ENGINE_AXES] = {ROTATE_STEP_PIN, SHOULDER_STEP_PIN, ELBOW_STEP_PIN, SLIDER_STEP_PIN};
+  uint32_t minCycles = UINT32_MAX;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) minCycles = std::min(minCycles, simPinMinHighCycles(stepPins[i]));
+  bool ok = minCycles != UINT32_MAX && minCycles >= STEP_PULSE_MIN_US * 16;
+  fprintf(out, "  \"step_pulse\": {\"min_required_us\": %d, \"min_high_us\": %.3f, \"step_rate\": %.0f, "
+               "\"isr_events\": %lu, \"elapsed_us\": %.1f, \"pass\": %s},\n",
+          STEP_PULSE_MIN_US, minCycles == UINT32_MAX ? 0.0 : minCycles / 16.0, SLIDER_MAX_STEP_RATE,
+          simIsrCount() - isrBefore, isrUs, ok ? "true" : "false");
+  return ok;
+}
+
+bool simBenchGpio(FILE* out, unsigned long steps) {
+  // Pin dan arah sama dengan instance firmware; versi lama memakai pin runtime
+  RampsStepper legacyBase(ROTATE_STEP_PIN, ROTATE_DIR_PIN, ROTATE_ENABLE_PIN, ROTATE_LIMIT_PIN, false, false);
+  RampsStepper legacyShoulder(SHOULDER_STEP_PIN, SHOULDER_DIR_PIN, SHOULDER_ENABLE_PIN, SHOULDER_LIMIT_PIN, true, false);
+  RampsStepper legacyElbow(ELBOW_STEP_PIN, ELBOW_DIR_PIN, ELBOW_ENABLE_PIN, ELBOW_LIMIT_PIN, false, false);
+  RampsStepper legacySlider(SLIDER_STEP_PIN, SLIDER_DIR_PIN, SLIDER_ENABLE_PIN, SLIDER_LIMIT_PIN, true, false);
+  BaseAxis fastBase;
+  ShoulderAxis fastShoulder;
+  ElbowAxis fastElbow;
+  SliderAxis fastSlider;
+
+  GpioCost legacyTotal = {0, 0}, fastTotal = {0, 0};
+  bool pass = true;
+  fprintf(out, "{\n  \"steps\": %lu,\n  \"axes\": [\n", steps);
+  pass &= benchAxisGpio(out, "Base", legacyBase, fastBase, steps, legacyTotal, fastTotal, false);
+  pass &= benchAxisGpio(out, "Shoulder", legacyShoulder, fastShoulder, steps, legacyTotal, fastTotal, false);
+  pass &= benchAxisGpio(out, "Elbow", legacyElbow, fastElbow, steps, legacyTotal, fastTotal, false);
+  pass &= benchAxisGpio(out, "Slider", legacySlider, fastSlider, steps, legacyTotal, fastTotal, true);
+  fprintf(out, "  ],\n");
+  // Semua sumbu melangkah di event yang sama (kasus terburuk ISR); batas = 16 MHz / siklus GPIO,
+  // di luar biaya ISR lainnya (Bresenham, profil kecepatan, entry/exit interrupt)
+  fprintf(out, "  \"four_axes\": {\"legacy\": {\"instructions\": %.2f, \"cycles\": %.2f, \"max_event_rate_gpio\": %.0f}, "
+               "\"fast\": {\"instructions\": %.2f, \"cycles\": %.2f, \"max_event_rate_gpio\": %.0f}, \"cycle_ratio\": %.1f},\n",
+          legacyTotal.instructions, legacyTotal.cycles, legacyTotal.cycles > 0 ? 16e6 / legacyTotal.cycles : 0.0,
+          fastTotal.instructions, fastTotal.cycles, fastTotal.cycles > 0 ? 16e6 / fastTotal.cycles : 0.0,
+          fastTotal.cycles > 0 ? legacyTotal.cycles / fastTotal.cycles : 0.0);
+  pass &= benchGripperGpio(out, steps);
+  pass &= benchStepPulse(out, fastBase, fastShoulder, fastElbow, fastSlider, steps);
+  fprintf(out, "  \"pass\": %s\n}\n", pass ? "true" : "false");
+  return pass;
+}
+
+// Galat titik busur terhadap referensi double: hanya pembulatan float di sekitar 300 mm
+static const double ARC_TOLERANCE_MM = 0.002;
+
+struct ArcCase {
+  const char* name;
+  float startX, startY, startZ;
+  float targetX, targetY, targetZ;
+  float offsetI, offsetJ, radius;
+  bool clockwise;
+  float feedRate;
+  ArcStatus expected;
+};
+
+bool simBenchArcs(FILE* out) {
+  const ArcCase cases[] = {
+    {"g2_ij_half", 20, 250, 285, -60, 230, 285, -40, -10, NAN, true, 3000, ARC_OK},
+    {"g3_r_short", -60, 230, 285, 60, 230, 285, NAN, NAN, 75, false, 3000, ARC_OK},
+    {"g2_r_long", 60, 230, 285, 0, 240, 270, NAN, NAN, -70, true, 3000, ARC_OK},
+    {"g3_half_slow", -150, 200, 250, 150, 200, 250, 150, 0, NAN, false, 300, ARC_OK},
+    {"g2_full_circle", 0, 240, 270, 0, 240, 270, 0, 15, NAN, true, 2000, ARC_OK},
+    {"g3_helix", 0, 240, 270, 0, 240, 285, 0, -20, NAN, false, 2000, ARC_OK},
+    {"g2_tiny", 0, 240, 270, 0.5, 240.5, 270, 0.5, 0, NAN, true, 3000, ARC_OK},
+    {"no_center", 0, 240, 270, 10, 240, 270, NAN, NAN, NAN, true, 3000, ARC_NO_CENTER},
+    {"ij_mismatch", 0, 240, 270, 30, 240, 270, 10, 0, NAN, true, 3000, ARC_RADIUS_MISMATCH},
+    {"r_too_small", 0, 240, 270, 30, 240, 270, NAN, NAN, 10, true, 3000, ARC_RADIUS_TOO_SMALL},
+    {"r_full_circle", 0, 240, 270, 0, 240, 270, NAN, NAN, 10, true, 3000, ARC_NO_CENTER},
+  };
+  const int caseCount = sizeof(cases) / sizeof(cases[0]);
+  Interpolation interpolation;
+  bool pass = true;
+
+  fprintf(out, "{\n");
+  fprintf(out, "  \"tolerance_mm\": %.3f,\n", ARC_TOLERANCE_MM);
+  fprintf(out, "  \"chord_tolerance_mm\": %.3f,\n", INTERPOLATION_ARC_TOLERANCE);
+  fprintf(out, "  \"correction_interval\": %d,\n", INTERPOLATION_ARC_CORRECTION);
+  fprintf(out, "  \"arcs\": [\n");
+  for (int k = 0; k < caseCount; k++) {
+    const ArcCase& c = cases[k];
+    interpolation.setCurrentPos(c.startX, c.startY, c.startZ, 0);
+    ArcStatus status = interpolation.setArc(c.targetX, c.targetY, c.targetZ, 0, c.offsetI, c.offsetJ,
+                                            c.radius, c.clockwise, c.feedRate);
+    bool ok = status == c.expected;
+    fprintf(out, "    {\"name\": \"%s\", \"status\": \"%s\", \"expected\": \"%s\"", c.name,
+            Interpolation::arcStatusName(status), Interpolation::arcStatusName(c.expected));
+
+    if (status == ARC_OK) {
+      // Referensi double: pusat dan sudut tempuh dihitung ulang, setiap titik dengan sin/cos
+      double dx = (double)c.targetX - c.startX, dy = (double)c.targetY - c.startY;
+      double ci = c.offsetI, cj = c.offsetJ;
+      if (!isnan(c.radius)) {
+        double chord = sqrt(dx * dx + dy * dy);
+        double h2 = std::max(0.0, (double)c.radius * c.radius - chord * chord / 4.0);
+        double h = ((c.clockwise != (c.radius < 0)) ? -1.0 : 1.0) * sqrt(h2) / chord;
+        ci = dx / 2.0 - h * dy;
+        cj = dy / 2.0 + h * dx;
+      }
+      if (isnan(ci)) ci = 0;
+      if (isnan(cj)) cj = 0;
+      double cx = c.startX + ci, cy = c.startY + cj;
+      double r = sqrt(ci * ci + cj * cj);
+      double startAngle = atan2(-cj, -ci);
+      double sweep = atan2(dy - cj, dx - ci) - startAngle;
+      if (c.clockwise) {
+        while (sweep >= 0) sweep -= 2 * M_PI;
+      } else {
+        while (sweep <= 0) sweep += 2 * M_PI;
+      }
+
+      // Titik yang diproduksi interpolator; jumlahnya = jumlah sub-segmen
+      std::vector<float> px, py, pz;
+      while (!interpolation.isFinished()) {
+        interpolation.updateActualPosition();
+        px.push_back(interpolation.getX());
+        py.push_back(interpolation.getY());
+        pz.push_back(interpolation.getZ());
+      }
+      size_t n = px.size();
+      double maxErr = 0, maxSag = 0, maxDrift = 0;
+      // Rotasi float yang sama tanpa koreksi berkala, sebagai pembanding drift
+      float step = (float)(sweep / n), cosStep = cos(step), sinStep = sin(step);
+      float ux = -ci, uy = -cj;
+      for (size_t i = 0; i < n; i++) {
+        double angle = startAngle + sweep * (i + 1) / n;
+        double rx = cx + r * cos(angle), ry = cy + r * sin(angle);
+        double rz = c.startZ + ((double)c.targetZ - c.startZ) * (i + 1) / n;
+        if (i + 1 == n) {
+          rx = c.targetX;
+          ry = c.targetY;
+        }
+        maxErr = std::max(maxErr, sqrt((px[i] - rx) * (px[i] - rx) + (py[i] - ry) * (py[i] - ry) + (pz[i] - rz) * (pz[i] - rz)));
+        // Simpangan tengah tali busur dari lingkaran
+        maxSag = std::max(maxSag, r * (1 - cos(sweep / n / 2)));
+        float x = ux * cosStep - uy * sinStep;
+        uy = ux * sinStep + uy * cosStep;
+        ux = x;
+        maxDrift = std::max(maxDrift, sqrt((cx + ux - rx) * (cx + ux - rx) + (cy + uy - ry) * (cy + uy - ry)));
+      }
+      bool endExact = n > 0 && px[n - 1] == c.targetX && py[n - 1] == c.targetY && pz[n - 1] == c.targetZ;
+      ok = ok && endExact && maxErr <= ARC_TOLERANCE_MM && maxSag <= INTERPOLATION_ARC_TOLERANCE * 1.001;
+      fprintf(out, ", \"radius\": %.3f, \"sweep_deg\": %.2f, \"segments\": %zu, \"corrections\": %zu, "
+              "\"max_err_mm\": %.6f, \"max_sag_mm\": %.5f, \"uncorrected_drift_mm\": %.6f, \"end_exact\": %s",
+              r, degrees(sweep), n, (n - 1) / INTERPOLATION_ARC_CORRECTION, maxErr, maxSag, maxDrift,
+              endExact ? "true" : "false");
+    }
+    pass = pass && ok;
+    fprintf(out, ", \"pass\": %s}%s\n", ok ? "true" : "false", k + 1 < caseCount ? "," : "");
+  }
+  fprintf(out, "  ],\n  \"pass\": %s\n}\n", pass ? "true" : "false");
+  return pass;
+}
+
+// Rate blok dibulatkan ke unsigned long dan interval ke tick timer (0.5 us, 125 tick pada
+// 16000 langkah/s), jadi batas diperiksa dengan kelonggaran relatif ini
+static const double PLANNER_RATE_TOLERANCE = 0.01;
+
+// Objek firmware (arm_robot_mega.ino)
+extern BaseAxis stepperBase;
+extern ShoulderAxis stepperShoulder;
+extern ElbowAxis stepperElbow;
+extern SliderAxis stepperSlider;
+extern StepEngine stepEngine;
+
+struct PlannerPattern {
+  const char* name;
+  float unit[STEP_ENGINE_AXES]; // Langkah per sumbu per satuan panjang gerakan
+};
+
+struct PlannerCheck {
+  unsigned long runs, blocks, triangles, events, violations;
+  double maxRate, maxAcceleration, maxJunction; // Rasio terhadap batas sumbu, profil blok
+  double maxExecutedRate, maxExecutedJunction;  // Rasio dari waktu event ISR
+};
+
+struct PlannerExecuted {
+  double firstRate, lastRate, maxRate; // Event/s
+};
+
+static void plannerViolation(PlannerCheck& check, const char* what, const char* label, long length, size_t block,
+                             int axis, double ratio) {
+  if (check.violations++ < 10) {
+    fprintf(stderr, "Planner %s: %s panjang %ld blok %zu sumbu %d, %.3f x batas\n", what, label, length, block, axis,
+            ratio);
+  }
+}
+
+// Kecepatan bertanda sumbu i (langkah/s) pada rate event tertentu
+static double plannerAxisVelocity(const StepBlock& block, int i, double rate) {
+  double velocity = rate * block.steps[i] / block.stepEventCount;
+  return (block.directionBits & (1 << i)) ? -velocity : velocity;
+}
+
+static void plannerRun(const std::vector<std::array<long, STEP_ENGINE_AXES> >& moves,
+                       const std::vector<float>& durations, bool lookAhead, const char* label, long length,
+                       PlannerCheck& check) {
+  BaseAxis base;
+  ShoulderAxis shoulder;
+  ElbowAxis elbow;
+  SliderAxis slider;
+  base.setMotionLimits(JOINT_MAX_STEP_RATE, JOINT_ACCELERATION, JOINT_JERK_STEP_RATE);
+  shoulder.setMotionLimits(JOINT_MAX_STEP_RATE, JOINT_ACCELERATION, JOINT_JERK_STEP_RATE);
+  elbow.setMotionLimits(JOINT_MAX_STEP_RATE, JOINT_ACCELERATION, JOINT_JERK_STEP_RATE);
+  slider.setMotionLimits(SLIDER_MAX_STEP_RATE, SLIDER_ACCELERATION, SLIDER_JERK_STEP_RATE);
+  StepEngine engine;
+  engine.begin(&base, &shoulder, &elbow, &slider);
+  // begin() juga menjadikan engine ini target ISR timer simulasi. Kembalikan ke engine firmware
+  // (diam, setup() tidak dijalankan) agar engine lokal hanya maju lewat isr() di bawah.
+  stepEngine.begin(&stepperBase, &stepperShoulder, &stepperElbow, &stepperSlider);
+  Planner planner;
+  planner.begin(&engine);
+  planner.setLookAheadEnabled(lookAhead);
+
+  long target[STEP_ENGINE_AXES] = {0, 0, 0, 0};
+  for (size_t m = 0; m < moves.size(); m++) {
+    for (int i = 0; i < STEP_ENGINE_AXES; i++) target[i] += moves[m][i];
+    planner.bufferMove(target, durations[m]);
+  }
+  std::vector<StepBlock> blocks;
+  for (uint8_t index = engine.tailIndex(); index != engine.headIndex(); index = StepEngine::nextIndex(index)) {
+    blocks.push_back(*engine.blockAt(index));
+  }
+  check.runs++;
+  check.blocks += blocks.size();
+
+  // Profil yang direncanakan: jelajah, akselerasi, dan lompatan kecepatan per sumbu di setiap
+  // sambungan (termasuk mulai dan berhenti dari diam) terhadap batas sumbu
+  double maxRate[STEP_ENGINE_AXES], acceleration[STEP_ENGINE_AXES], jerk[STEP_ENGINE_AXES];
+  for (int i = 0; i < STEP_ENGINE_AXES; i++) {
+    maxRate[i] = engine.getAxis(i)->getMaxStepRate();
+    acceleration[i] = engine.getAxis(i)->getAcceleration();
+    jerk[i] = engine.getAxis(i)->getJerkStepRate();
+  }
+  for (size_t k = 0; k < blocks.size(); k++) {
+    const StepBlock& b = blocks[k];
+    double accelerationRate = (double)b.rateDelta * ACCELERATION_TICKS_PER_SECOND;
+    double peakSquared = (double)b.initialRate * b.initialRate + 2.0 * accelerationRate * b.accelerateUntil;
+    if (b.accelerateUntil == b.decelerateAfter && peakSquared < (double)b.nominalRate * b.nominalRate) check.triangles++;
+    if (b.initialRate > b.nominalRate || b.finalRate > b.nominalRate) {
+      plannerViolation(check, "rate masuk/keluar di atas jelajah", label, length, k, -1, 0.0);
+    }
+    for (int i = 0; i < STEP_ENGINE_AXES; i++) {
+      if (b.steps[i] == 0) continue;
+      double rateRatio = fabs(plannerAxisVelocity(b, i, b.nominalRate)) / maxRate[i];
+      double accelerationRatio = fabs(plannerAxisVelocity(b, i, accelerationRate)) / acceleration[i];
+      check.maxRate = std::max(check.maxRate, rateRatio);
+      check.maxAcceleration = std::max(check.maxAcceleration, accelerationRatio);
+      if (rateRatio > 1 + PLANNER_RATE_TOLERANCE) plannerViolation(check, "jelajah", label, length, k, i, rateRatio);
+      if (accelerationRatio > 1 + PLANNER_RATE_TOLERANCE) {
+        plannerViolation(check, "akselerasi", label, length, k, i, accelerationRatio);
+      }
+    }
+    for (int i = 0; i < STEP_ENGINE_AXES; i++) {
+      double before = (k == 0) ? 0.0 : plannerAxisVelocity(blocks[k - 1], i, blocks[k - 1].finalRate);
+      double jump = fabs(plannerAxisVelocity(b, i, b.initialRate) - before) / jerk[i];
+      if (k + 1 == blocks.size()) jump = std::max(jump, fabs(plannerAxisVelocity(b, i, b.finalRate)) / jerk[i]);
+      check.maxJunction = std::max(check.maxJunction, jump);
+      if (jump > 1 + PLANNER_RATE_TOLERANCE) plannerViolation(check, "sambungan (jerk)", label, length, k, i, jump);
+    }
+  }
+
+  // Eksekusi ISR: rate tiap event dari jarak waktu ke panggilan ISR sebelumnya. Selama gerak
+  // setiap panggilan adalah event, dan panggilan pertama hanya memuat blok.
+  std::vector<PlannerExecuted> executed(blocks.size(), PlannerExecuted{0, 0, 0});
+  size_t current = 0;
+  unsigned long calls = 0;
+  uint16_t interval = 0;
+  while (engine.isBusy() && calls++ < 100000000UL) {
+    long before = engine.getAxis(0)->getPosition() + engine.getAxis(1)->getPosition() * 3 +
+                  engine.getAxis(2)->getPosition() * 7 + engine.getAxis(3)->getPosition() * 13;
+    uint8_t tail = engine.tailIndex();
+    uint16_t next = engine.isr();
+    long after = engine.getAxis(0)->getPosition() + engine.getAxis(1)->getPosition() * 3 +
+                 engine.getAxis(2)->getPosition() * 7 + engine.getAxis(3)->getPosition() * 13;
+    if (after != before && current < executed.size()) {
+      double rate = (double)STEP_TIMER_FREQ / interval;
+      PlannerExecuted& e = executed[current];
+      if (e.maxRate == 0) e.firstRate = rate;
+      e.lastRate = rate;
+      e.maxRate = std::max(e.maxRate, rate);
+      check.events++;
+    }
+    if (engine.tailIndex() != tail) current++;
+    interval = next;
+  }
+  for (int i = 0; i < STEP_ENGINE_AXES; i++) {
+    if (engine.getAxis(i)->getPosition() != target[i]) plannerViolation(check, "posisi akhir", label, length, 0, i, 0.0);
+  }
+  // ISR mengubah rate sekali per tick akselerasi, jadi rate eksekusi boleh tertinggal satu
+  // rateDelta dari profil di sambungan
+  for (size_t k = 0; k < blocks.size(); k++) {
+    const StepBlock& b = blocks[k];
+    for (int i = 0; i < STEP_ENGINE_AXES; i++) {
+      if (b.steps[i] != 0) {
+        double rateRatio = fabs(plannerAxisVelocity(b, i, executed[k].maxRate)) / maxRate[i];
+        check.maxExecutedRate = std::max(check.maxExecutedRate, rateRatio);
+        if (rateRatio > 1 + PLANNER_RATE_TOLERANCE) plannerViolation(check, "rate eksekusi", label, length, k, i, rateRatio);
+      }
+      double before = (k == 0) ? 0.0 : plannerAxisVelocity(blocks[k - 1], i, executed[k - 1].lastRate);
+      double slack = (k == 0) ? 0.0 : fabs(plannerAxisVelocity(blocks[k - 1], i, blocks[k - 1].rateDelta));
+      double jump = fabs(plannerAxisVelocity(b, i, executed[k].firstRate) - before);
+      if (k + 1 == blocks.size()) {
+        jump = std::max(jump, fabs(plannerAxisVelocity(b, i, executed[k].lastRate)));
+        slack = std::max(slack, fabs(plannerAxisVelocity(b, i, b.rateDelta)));
+      }
+      double ratio = std::max(0.0, jump - slack) / jerk[i];
+      check.maxExecutedJunction = std::max(check.maxExecutedJunction, ratio);
+      if (ratio > 1 + PLANNER_RATE_TOLERANCE) plannerViolation(check, "sambungan eksekusi", label, length, k, i, ratio);
+    }
+  }
+}
+
+bool simBenchPlanner(FILE* out) {
+  // Satu sumbu, dua sumbu dengan rasio 2:1, dan keempat sumbu (termasuk Slider dengan batas
+  // sendiri) dengan arah campuran
+  const PlannerPattern patterns[] = {
+    {"base", {1.0, 0.0, 0.0, 0.0}},
+    {"base_shoulder", {1.0, 0.5, 0.0, 0.0}},
+    {"all_axes", {0.6, -0.3, 0.45, 1.0}},
+  };
+  // single: satu gerakan dari diam ke diam. collinear: enam gerakan searah (look-ahead
+  // menyambung tanpa berhenti). zigzag: sumbu pertama berbalik arah di setiap sambungan.
+  // short_long: panjang L dan L/8 bergantian (profil segitiga di tengah rantai).
+  // fast_slow: gerakan searah dengan setiap gerakan kedua dibatasi feedrate ke 1/4 rate
+  // maksimum (sambungan G0/G1 dengan kecepatan jelajah berbeda).
+  const char* sequences[] = {"single", "collinear", "zigzag", "short_long", "fast_slow"};
+  // Dari 1 langkah sampai jauh di atas jarak akselerasi penuh; di bawah ~5800 langkah
+  // (5000 -> 16000 -> 5000 langkah/s pada 40000 langkah/s^2) profilnya segitiga
+  const long lengths[] = {1, 2, 3, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 3000, 4000, 5000, 6000, 8000,
+                          12000, 20000, 40000};
+  bool pass = true;
+
+  fprintf(out, "{\n");
+  fprintf(out, "  \"limits\": {\"joint\": {\"max_step_rate\": %.0f, \"acceleration\": %.0f, \"jerk\": %.0f}, "
+               "\"slider\": {\"max_step_rate\": %.0f, \"acceleration\": %.0f, \"jerk\": %.0f}},\n",
+          JOINT_MAX_STEP_RATE, JOINT_ACCELERATION, JOINT_JERK_STEP_RATE, SLIDER_MAX_STEP_RATE, SLIDER_ACCELERATION,
+          SLIDER_JERK_STEP_RATE);
+  fprintf(out, "  \"tolerance\": %.3f,\n", PLANNER_RATE_TOLERANCE);
+  fprintf(out, "  \"cases\": [\n");
+  const int patternCount = sizeof(patterns) / sizeof(patterns[0]);
+  const int sequenceCount = sizeof(sequences) / sizeof(sequences[0]);
+  // Setiap kasus juga dengan look-ahead nonaktif (pembanding berhenti per blok), yang tetap
+  // harus dalam batas jerk di setiap sambungan
+  for (int mode = 0; mode < 2; mode++) {
+    for (int p = 0; p < patternCount; p++) {
+      for (int s = 0; s < sequenceCount; s++) {
+        PlannerCheck check = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+        char label[64];
+        snprintf(label, sizeof(label), "%s/%s%s", patterns[p].name, sequences[s], mode ? "/no_lookahead" : "");
+        for (long length : lengths) {
+          std::vector<std::array<long, STEP_ENGINE_AXES> > moves;
+          std::vector<float> durations;
+          int count = (s == 0) ? 1 : 6;
+          for (int m = 0; m < count; m++) {
+            long moveLength = (s == 3 && (m & 1)) ? std::max(1L, length / 8) : length;
+            std::array<long, STEP_ENGINE_AXES> move;
+            for (int i = 0; i < STEP_ENGINE_AXES; i++) move[i] = lround(moveLength * patterns[p].unit[i]);
+            if (s == 2 && (m & 1)) move[0] = -move[0];
+            moves.push_back(move);
+            durations.push_back((s == 4 && (m & 1)) ? 4.0f * moveLength / JOINT_MAX_STEP_RATE : 0.0f);
+          }
+          plannerRun(moves, durations, mode == 0, label, length, check);
+        }
+        pass = pass && check.violations == 0;
+        fprintf(out, "    {\"case\": \"%s\", \"runs\": %lu, \"blocks\": %lu, \"triangle_blocks\": %lu, \"events\": %lu, "
+                     "\"max_rate_ratio\": %.4f, \"max_acceleration_ratio\": %.4f, \"max_junction_ratio\": %.4f, "
+                     "\"max_executed_rate_ratio\": %.4f, \"max_executed_junction_ratio\": %.4f, \"violations\": %lu}%s\n",
+                label, check.runs, check.blocks, check.triangles, check.events, check.maxRate, check.maxAcceleration,
+                check.maxJunction, check.maxExecutedRate, check.maxExecutedJunction, check.violations,
+                (mode == 1 && p == patternCount - 1 && s == sequenceCount - 1) ? "" : ",");
+      }
+    }
+  }
+  fprintf(out, "  ],\n  \"pass\": %s\n}\n", pass ? "true" : "false");
+  return pass;
+}
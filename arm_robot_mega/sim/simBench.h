@@ -0,0 +1,106 @@
+// simBench.h
+// Laporan benchmark simulasi host dalam format JSON, agar hasil antar revisi firmware
+// dapat dibandingkan dengan skrip. Waktu "sim" berasal dari jam virtual (simHal.h),
+// sedangkan waktu "host" adalah waktu CPU PC yang menjalankan simulasi dan hanya
+// berguna sebagai perbandingan relatif (AVR 16 MHz jauh lebih lambat).
+#ifndef SIM_BENCH_H
+#define SIM_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "stepEngine.h"
+#include "limitSwitch.h"
+#include "simSender.h"
+
+class RobotGeometry;
+
+// Rangkuman distribusi sampel (sudah dikalikan scale)
+struct SimSummary {
+  size_t count;
+  double mean, p50, p90, p99, max;
+};
+SimSummary simSummarize(const std::vector<uint32_t>& samples, double scale);
+
+// Satu iterasi loop(): durasi pada jam virtual (tick) dan di host (ns)
+void simBenchLoopSample(uint32_t simTicks, uint32_t hostNs);
+
+// Ukur waktu host per panggilan IK pada grid workspace. Mengubah target geom.
+double simBenchIkHostNs(RobotGeometry& geom, unsigned long& calls);
+
+// Uji round-trip FK -> IK -> FK untuk beberapa set panjang link (RobotGeometry::setLinkLengths)
+// dan kedua solusi elbow, pada grid sudut sendi di dalam workspace. Menulis JSON (galat
+// posisi dan sudut maksimum per set, ns per IK) ke out. Mengembalikan false jika galat posisi
+// melebihi toleransi backend IK, termasuk jika konstanta turunan tidak ikut diperbarui.
+bool simBenchKinematics(FILE* out);
+
+// Bandingkan backend IK fixed-point dengan float (referensi) pada objek yang sama, terlepas dari
+// IK_BACKEND build ini: grid target di dalam workspace untuk set panjang link yang sama dengan
+// simBenchKinematics(), galat posisi (FK dari sudut kedua backend) dan sudut maks/rata-rata, dan
+// ns host per panggilan tiap backend. Menulis JSON ke out; false jika status jangkauan berbeda
+// atau galat posisi melebihi 0.25 mm. Siklus AVR diukur di hardware dengan -DPROFILE=1 (M930).
+bool simBenchIkBackends(FILE* out);
+
+struct SimBenchResult {
+  const char* program;
+  bool finished;
+  double setupSeconds;   // setup(): homing dan kalibrasi
+  double programSeconds; // Dari baris pertama dikirim sampai semua gerakan selesai
+  unsigned long loops;
+  bool lookAhead;        // Planner::isLookAheadEnabled() (opsi --no-lookahead)
+  const char* senderMode;
+  SimSenderStats sender;
+  StepEngineStats pipeline;
+  LimitSwitchStats limits; // Sejak setup(), termasuk homing
+  double ikHostNs;
+  unsigned long ikCalls;
+};
+void simBenchWriteReport(FILE* out, const SimBenchResult& result);
+
+// Bandingkan parser baris lama (berbasis String, disalin dari revisi sebelumnya) dengan
+// Command::prepareLine()/handleGcodeLine() pada baris program, diulang repeats kali.
+// Menulis laporan JSON (baris/detik, ns/baris, jumlah hasil yang berbeda) ke out, ditambah
+// decode frame biner (binaryFrame.h) untuk perintah G/M yang sama dan ukuran per perintah.
+// Catatan: String di host memakai std::string dengan small-string optimization, sehingga
+// biaya alokasi heap versi lama di AVR tidak sepenuhnya terlihat di sini.
+void simBenchParser(FILE* out, const std::vector<std::string>& lines, unsigned long repeats);
+
+// Uji stres RingBuffer (ringBuffer.h): produsen dan konsumen di dua thread memindahkan items
+// item dengan semua operasi (push, emplace/commit, pushBulk, pop, peek/drop, popBulk) dan
+// memeriksa urutan serta isinya, lalu membandingkan throughput push/pop Cmd satu thread dengan
+// antrian lama (malloc + modulo) dan CommandQueue (pack/unpack). Menulis JSON ke out; false
+// jika ada item hilang atau rusak.
+bool simBenchRing(FILE* out, unsigned long items);
+
+// Biaya GPIO per langkah tiap sumbu: RampsStepper (digitalWrite) dibanding FastAxis
+// (robotAxes.h), masing-masing steps pulsa lewat tipe konkretnya seperti ISR StepEngine, dengan
+// penghitung instruksi/siklus AVR simulasi (simGpioCost). Menulis JSON (per sumbu, total empat
+// sumbu per event, dan batas kecepatan event dari GPIO saja) ke out. Mengembalikan false jika
+// posisi atau level pin arah kedua versi berbeda.
+bool simBenchGpio(FILE* out, unsigned long steps);
+
+// Uji round-trip rekaman terpaket (commandQueue.h): perintah dari baris program, nilai acak
+// yang dibaca dari teks (maks. 2 desimal, T 3 desimal; harus tersimpan fixed point) dan pola
+// bit float acak harus kembali identik bit demi bit setelah packCmd()/unpackCmd() dan setelah
+// melewati CommandQueue. Menulis JSON (byte per perintah, kedalaman antrian) ke out; false
+// jika ada perintah yang berubah atau nilai teks yang tidak tersimpan sebagai fixed point.
+bool simBenchPacking(FILE* out, const std::vector<std::string>& lines);
+
+// Uji interpolasi busur G2/G3 (Interpolation::setArc): busur I/J, R positif/negatif, lingkaran
+// penuh, heliks, dan busur panjang dengan ribuan sub-segmen dibandingkan titik demi titik dengan
+// referensi double (sin/cos per titik), ditambah busur tidak valid yang harus ditolak dengan
+// ArcStatus yang benar. Menulis JSON (galat maksimum, simpangan tali busur, drift rotasi tanpa
+// koreksi berkala) ke out; false jika ada galat di atas toleransi atau titik akhir tidak tepat.
+bool simBenchArcs(FILE* out);
+
+// Uji batas Planner: gerakan satu sumbu, dua sumbu, dan keempat sumbu dengan panjang 1 sampai
+// 40000 langkah (termasuk profil segitiga pendek), sendiri atau berantai (searah, berbalik arah,
+// panjang-pendek bergantian), direncanakan dengan batas JOINT_* / SLIDER_* (robotAxes.h) lalu
+// dieksekusi lewat StepEngine::isr(). Setiap blok diperiksa: kecepatan jelajah dan akselerasi
+// per sumbu, lompatan kecepatan masuk/keluar per sumbu di sambungan (jerk, termasuk mulai dan
+// berhenti dari diam), serta rate yang benar-benar dihasilkan ISR. Menulis JSON ke out; false
+// jika ada batas yang dilanggar atau posisi akhir salah.
+bool simBenchPlanner(FILE* out);
+
+#endif
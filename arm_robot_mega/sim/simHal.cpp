@@ -0,0 +1,702 @@
+// simHal.cpp
+#include "simHal.h"
+#include "stepEngine.h"
+#include "gripper.h"
+#include "binaryFrame.h"
+#include <EEPROM.h>
+#include <ctype.h>
+#include <deque>
+#include <vector>
+
+SimSerial Serial;
+
+// ===== Jam virtual dan interrupt timer =====
+static uint64_t nowTicks = 0;
+static uint64_t nextTimerTick = STEP_IDLE_INTERVAL;
+static uint64_t nextGripperTick = GRIPPER_IDLE_INTERVAL; // Timer3 (gripper.h)
+static bool interruptsEnabled = true;
+static bool inIsr = false;
+static uint64_t isrElapsed = 0;      // Waktu yang dipakai pemanggilan HAL di dalam ISR
+static uint32_t callCost = 2;
+static uint32_t isrCost = 0;
+static unsigned long isrCount = 0;
+
+static bool statsEnabled = false;
+static std::vector<uint32_t> isrLatencies;
+
+uint64_t simNow() { return nowTicks; }
+void simSetCallCost(uint32_t ticks) { callCost = ticks; }
+void simSetIsrCost(uint32_t ticks) { isrCost = ticks; }
+unsigned long simIsrCount() { return isrCount; }
+
+// Interrupt pin dan pantulan limit switch (didefinisikan bersama model sumbu di bawah)
+static unsigned pinIsrPendingCount = 0;
+static void runPendingPinIsr(uint64_t& end);
+static uint64_t nextLimitBounceTick();
+static void runLimitBounce();
+
+void simAdvance(uint64_t ticks) {
+  if (inIsr) {
+    // Waktu di dalam ISR dibebankan ke ISR, bukan ke loop
+    isrElapsed += ticks;
+    return;
+  }
+  uint64_t end = nowTicks + ticks;
+  while (interruptsEnabled) {
+    // Vektor INTn/PCINT berprioritas di atas Timer1/Timer3: dilayani sebelum ISR timer berikutnya
+    if (pinIsrPendingCount > 0) {
+      runPendingPinIsr(end);
+      continue;
+    }
+    uint64_t bounceTick = nextLimitBounceTick();
+    if (bounceTick <= end && bounceTick <= nextTimerTick && bounceTick <= nextGripperTick) {
+      if (bounceTick > nowTicks) nowTicks = bounceTick;
+      runLimitBounce();
+      continue;
+    }
+    if (nextGripperTick < nextTimerTick && nextGripperTick <= end) {
+      // Timer3 gripper: AVR tidak menyela ISR, jadi ISR ini juga menunda ISR step generator
+      if (nextGripperTick > nowTicks) nowTicks = nextGripperTick;
+      inIsr = true;
+      isrElapsed = 0;
+      uint16_t interval = gripperTimerIsr();
+      inIsr = false;
+      nowTicks += isrElapsed;
+      end += isrElapsed;
+      nextGripperTick += interval;
+      continue;
+    }
+    if (nextTimerTick > end) break;
+    // ISR tertunda (noInterrupts() atau ISR sebelumnya) mulai setelah compare match
+    uint32_t latency = 0;
+    if (nextTimerTick > nowTicks) nowTicks = nextTimerTick;
+    else latency = (uint32_t)(nowTicks - nextTimerTick);
+    if (statsEnabled) isrLatencies.push_back(latency);
+    inIsr = true;
+    isrElapsed = isrCost;
+    uint16_t interval = stepEngineTimerIsr();
+    inIsr = false;
+    isrCount++;
+    // ISR mencuri waktu dari kode yang sedang disela
+    nowTicks += isrElapsed;
+    end += isrElapsed;
+    // Mode CTC: interval dihitung dari compare match. Jika ISR lebih lama dari
+    // interval berikutnya, ISR asli memaksa compare sedikit di depan TCNT1.
+    nextTimerTick += interval;
+    if (nextTimerTick < nowTicks + 16) nextTimerTick = nowTicks + 16;
+  }
+  nowTicks = end;
+}
+
+static inline void halCall() { simAdvance(callCost); }
+
+void noInterrupts() {
+  halCall();
+  interruptsEnabled = false;
+}
+
+void interrupts() {
+  interruptsEnabled = true;
+  // Interrupt yang tertunda selama noInterrupts() langsung dilayani
+  halCall();
+}
+
+unsigned long millis() {
+  halCall();
+  return (unsigned long)(nowTicks / (1000UL * SIM_TICKS_PER_US));
+}
+
+unsigned long micros() {
+  halCall();
+  return (unsigned long)(nowTicks / SIM_TICKS_PER_US);
+}
+
+void yield() { halCall(); }
+
+void delay(unsigned long ms) { simAdvance((uint64_t)ms * 1000UL * SIM_TICKS_PER_US); }
+void delayMicroseconds(unsigned int us) { simAdvance((uint64_t)us * SIM_TICKS_PER_US); }
+
+// ===== GPIO dan model sumbu =====
+struct SimAxis {
+  const char* name;
+  uint8_t stepPin, dirPin, limitPin;
+  uint8_t towardsLimitLevel;
+  long position;
+  unsigned long steps;
+  bool limitActive;
+  bool pinActive;           // Level pin limit (aktif LOW), termasuk pantulan kontak
+  unsigned bounceLeft;      // Tepi pantulan yang belum terjadi
+  uint64_t nextBounceTick;
+
+  // Statistik benchmark
+  uint64_t lastStepTick;
+  uint32_t lastInterval;
+  uint32_t minInterval;
+  unsigned long statSteps;
+  std::vector<uint32_t> intervalDeltas;
+};
+
+static uint8_t pinModes[SIM_PIN_COUNT];
+static uint8_t pinLevels[SIM_PIN_COUNT];
+static uint64_t pinHighCycle[SIM_PIN_COUNT];  // Saat tepi naik terakhir (siklus CPU)
+static uint32_t pinMinHigh[SIM_PIN_COUNT];
+static SimAxis axes[SIM_MAX_AXES];
+static uint8_t axisCount = 0;
+static FILE* traceFile = nullptr;
+static long limitHysteresis = 20;
+
+static void (*pinIsrs[SIM_PIN_COUNT])() = {};
+static bool pinIsrPending[SIM_PIN_COUNT] = {};
+static uint64_t pinEdgeTick[SIM_PIN_COUNT];
+static unsigned limitBounceEdges = 0;
+static uint32_t limitBounceTicks = 0;
+static unsigned long limitEdges = 0, limitOvertravel = 0;
+static uint32_t limitIsrLatencyMax = 0;
+
+void simAddAxis(const char* name, uint8_t stepPin, uint8_t dirPin, uint8_t limitPin,
+                uint8_t towardsLimitLevel, long startDistance) {
+  if (axisCount >= SIM_MAX_AXES) return;
+  SimAxis& a = axes[axisCount++];
+  a.name = name;
+  a.stepPin = stepPin;
+  a.dirPin = dirPin;
+  a.limitPin = limitPin;
+  a.towardsLimitLevel = towardsLimitLevel;
+  a.position = startDistance;
+  a.steps = 0;
+  a.limitActive = startDistance <= 0;
+  a.pinActive = a.limitActive;
+  a.bounceLeft = 0;
+}
+
+uint8_t simAxisCount() { return axisCount; }
+const char* simAxisName(uint8_t axis) { return axes[axis].name; }
+long simAxisPosition(uint8_t axis) { return axes[axis].position; }
+unsigned long simAxisSteps(uint8_t axis) { return axes[axis].steps; }
+void simSetTrace(FILE* file) { traceFile = file; }
+void simSetLimitHysteresis(long steps) { limitHysteresis = steps; }
+
+void simSetLimitBounce(unsigned edges, uint32_t intervalTicks) {
+  limitBounceEdges = edges;
+  limitBounceTicks = intervalTicks;
+}
+unsigned long simLimitEdges() { return limitEdges; }
+unsigned long simLimitOvertravelSteps() { return limitOvertravel; }
+uint32_t simLimitIsrLatencyMax() { return limitIsrLatencyMax; }
+
+// Nomor interrupt Arduino Mega 0..5 = INT4, INT5, INT0, INT1, INT2, INT3
+static const uint8_t INTERRUPT_PINS[] = {2, 3, 21, 20, 19, 18};
+
+int digitalPinToInterrupt(uint8_t pin) {
+  for (uint8_t i = 0; i < sizeof(INTERRUPT_PINS); i++) {
+    if (INTERRUPT_PINS[i] == pin) return i;
+  }
+  return NOT_AN_INTERRUPT;
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode) {
+  (void)mode; // Hanya CHANGE yang dimodelkan
+  halCall();
+  if (interruptNum < sizeof(INTERRUPT_PINS)) pinIsrs[INTERRUPT_PINS[interruptNum]] = isr;
+}
+
+bool simAttachPinChange(uint8_t pin, void (*isr)()) {
+  halCall();
+  // PCINT0..23 di Mega: pin 10-13 dan 50-53 (PB), 0 dan 14-15 (PE0, PJ0-1), A8-A15 (PK)
+  bool pcint = (pin >= 10 && pin <= 15) || (pin >= 50 && pin <= 53) || pin == 0 || (pin >= 62 && pin <= 69);
+  if (!pcint) return false;
+  pinIsrs[pin] = isr;
+  return true;
+}
+
+// Tandai interrupt pin tertunda (flag INTFn/PCIFn); tepi kedua sebelum dilayani tidak menambah apa pun
+static void limitPinChanged(SimAxis& a) {
+  limitEdges++;
+  uint8_t pin = a.limitPin;
+  if (pinIsrs[pin] == nullptr || pinIsrPending[pin]) return;
+  pinIsrPending[pin] = true;
+  pinEdgeTick[pin] = nowTicks;
+  pinIsrPendingCount++;
+}
+
+// Level pin mengikuti model, lalu (opsional) memantul limitBounceEdges kali sebelum stabil
+static void setLimitLevel(SimAxis& a) {
+  a.pinActive = a.limitActive;
+  a.bounceLeft = 2 * limitBounceEdges;
+  a.nextBounceTick = nowTicks + limitBounceTicks;
+  limitPinChanged(a);
+}
+
+static uint64_t nextLimitBounceTick() {
+  uint64_t next = UINT64_MAX;
+  for (uint8_t i = 0; i < axisCount; i++) {
+    if (axes[i].bounceLeft > 0 && axes[i].nextBounceTick < next) next = axes[i].nextBounceTick;
+  }
+  return next;
+}
+
+static void runLimitBounce() {
+  for (uint8_t i = 0; i < axisCount; i++) {
+    SimAxis& a = axes[i];
+    if (a.bounceLeft == 0 || a.nextBounceTick > nowTicks) continue;
+    a.pinActive = !a.pinActive;
+    a.bounceLeft--;
+    a.nextBounceTick += limitBounceTicks;
+    limitPinChanged(a);
+  }
+}
+
+static void runPendingPinIsr(uint64_t& end) {
+  for (uint8_t pin = 0; pin < SIM_PIN_COUNT; pin++) {
+    if (!pinIsrPending[pin]) continue;
+    pinIsrPending[pin] = false;
+    pinIsrPendingCount--;
+    uint32_t latency = (uint32_t)(nowTicks - pinEdgeTick[pin]);
+    if (latency > limitIsrLatencyMax) limitIsrLatencyMax = latency;
+    inIsr = true;
+    isrElapsed = 0;
+    pinIsrs[pin]();
+    inIsr = false;
+    nowTicks += isrElapsed;
+    end += isrElapsed;
+    return;
+  }
+}
+
+static void serialResetStats();
+
+void simResetStats() {
+  statsEnabled = true;
+  isrLatencies.clear();
+  serialResetStats();
+  for (uint8_t i = 0; i < axisCount; i++) {
+    axes[i].lastStepTick = 0;
+    axes[i].lastInterval = 0;
+    axes[i].minInterval = UINT32_MAX;
+    axes[i].statSteps = 0;
+    axes[i].intervalDeltas.clear();
+  }
+  for (uint8_t pin = 0; pin < SIM_PIN_COUNT; pin++) pinMinHigh[pin] = UINT32_MAX;
+}
+
+const std::vector<uint32_t>& simIsrLatencies() { return isrLatencies; }
+const std::vector<uint32_t>& simAxisIntervalDeltas(uint8_t axis) { return axes[axis].intervalDeltas; }
+uint32_t simAxisMinInterval(uint8_t axis) { return axes[axis].minInterval; }
+unsigned long simAxisStatSteps(uint8_t axis) { return axes[axis].statSteps; }
+uint32_t simPinMinHighCycles(uint8_t pin) { return pin < SIM_PIN_COUNT ? pinMinHigh[pin] : UINT32_MAX; }
+
+static void recordStep(SimAxis& a) {
+  if (!statsEnabled) return;
+  a.statSteps++;
+  if (a.statSteps > 1) {
+    uint64_t interval = nowTicks - a.lastStepTick;
+    if (interval > SIM_STEP_GAP_TICKS) {
+      a.lastInterval = 0; // Awal gerakan baru
+    } else {
+      if (interval < a.minInterval) a.minInterval = (uint32_t)interval;
+      if (a.lastInterval != 0) {
+        a.intervalDeltas.push_back(interval > a.lastInterval ? interval - a.lastInterval : a.lastInterval - interval);
+      }
+      a.lastInterval = (uint32_t)interval;
+    }
+  }
+  a.lastStepTick = nowTicks;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  halCall();
+  if (pin >= SIM_PIN_COUNT) return;
+  pinModes[pin] = mode;
+  if (mode == INPUT_PULLUP) pinLevels[pin] = HIGH;
+}
+
+// Biaya AVR digitalWrite()/digitalRead() untuk penghitung GPIO, diperkirakan dari Arduino AVR
+// core (wiring_digital.c) di ATmega2560: tiga pembacaan tabel PROGMEM (timer, bit, port),
+// tabel register port, pemeriksaan NOT_A_PIN, simpan SREG + cli, baca-ubah-tulis, call/ret.
+// Pin yang punya output PWM juga memanggil turnOffPWM() setiap kali.
+#define SIM_DIGITAL_WRITE_INSTRUCTIONS 38
+#define SIM_DIGITAL_WRITE_CYCLES 64
+#define SIM_DIGITAL_READ_INSTRUCTIONS 32
+#define SIM_DIGITAL_READ_CYCLES 56
+#define SIM_TURN_OFF_PWM_INSTRUCTIONS 10
+#define SIM_TURN_OFF_PWM_CYCLES 16
+// Siklus CPU 16 MHz per tick jam virtual
+#define SIM_CYCLES_PER_TICK (16 / SIM_TICKS_PER_US)
+
+static unsigned long gpioInstructions = 0, gpioCycles = 0;
+static uint32_t pendingCycles = 0; // Siklus FastPin/TCNT1 yang belum genap satu tick
+
+// Waktu sekarang dalam siklus CPU, termasuk waktu ISR yang sedang berjalan
+static uint64_t cpuCycleNow() {
+  return (nowTicks + (inIsr ? isrElapsed : 0)) * SIM_CYCLES_PER_TICK + pendingCycles;
+}
+
+// Pin Arduino Mega dengan timer PWM (digitalPinToTimer() != NOT_ON_TIMER)
+static bool pinHasTimer(uint8_t pin) {
+  return (pin >= 2 && pin <= 13) || (pin >= 44 && pin <= 46);
+}
+
+static void countDigitalCall(uint8_t pin, unsigned long instructions, unsigned long cycles) {
+  if (pinHasTimer(pin)) {
+    instructions += SIM_TURN_OFF_PWM_INSTRUCTIONS;
+    cycles += SIM_TURN_OFF_PWM_CYCLES;
+  }
+  gpioInstructions += instructions;
+  gpioCycles += cycles;
+}
+
+void simGpioCost(unsigned long& instructions, unsigned long& cycles) {
+  instructions = gpioInstructions;
+  cycles = gpioCycles;
+}
+
+void simResetGpioCost() {
+  gpioInstructions = 0;
+  gpioCycles = 0;
+}
+
+static void pinWrite(uint8_t pin, uint8_t value) {
+  if (pin >= SIM_PIN_COUNT) return;
+  value = value ? HIGH : LOW;
+  if (pinLevels[pin] == value) return;
+  pinLevels[pin] = value;
+  uint64_t cycle = cpuCycleNow();
+  if (value == HIGH) pinHighCycle[pin] = cycle;
+  else if (cycle - pinHighCycle[pin] < pinMinHigh[pin]) pinMinHigh[pin] = (uint32_t)(cycle - pinHighCycle[pin]);
+
+  for (uint8_t i = 0; i < axisCount; i++) {
+    SimAxis& a = axes[i];
+    if (pin != a.stepPin && pin != a.dirPin) continue;
+    if (traceFile) {
+      fprintf(traceFile, "%llu,%u,%u\n", (unsigned long long)nowTicks, pin, value);
+    }
+    if (pin == a.stepPin && value == HIGH) {
+      bool towardsLimit = pinLevels[a.dirPin] == a.towardsLimitLevel;
+      // Langkah menuju switch yang sudah melewati titik picu
+      if (towardsLimit && a.position <= 0) limitOvertravel++;
+      a.position += towardsLimit ? -1 : 1;
+      a.steps++;
+      bool wasActive = a.limitActive;
+      if (a.position <= 0) a.limitActive = true;
+      else if (a.position > limitHysteresis) a.limitActive = false;
+      if (a.limitActive != wasActive) setLimitLevel(a);
+      recordStep(a);
+    }
+  }
+}
+
+static int pinRead(uint8_t pin) {
+  if (pin >= SIM_PIN_COUNT) return LOW;
+  for (uint8_t i = 0; i < axisCount; i++) {
+    if (axes[i].limitPin == pin) return axes[i].pinActive ? LOW : HIGH;
+  }
+  return pinLevels[pin];
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  halCall();
+  countDigitalCall(pin, SIM_DIGITAL_WRITE_INSTRUCTIONS, SIM_DIGITAL_WRITE_CYCLES);
+  pinWrite(pin, value);
+}
+
+int digitalRead(uint8_t pin) {
+  halCall();
+  countDigitalCall(pin, SIM_DIGITAL_READ_INSTRUCTIONS, SIM_DIGITAL_READ_CYCLES);
+  return pinRead(pin);
+}
+
+// Siklus CPU yang belum genap satu tick dibawa ke pemanggilan berikutnya
+static void chargeCycles(uint8_t cycles) {
+  pendingCycles += cycles;
+  if (pendingCycles >= SIM_CYCLES_PER_TICK) {
+    uint32_t ticks = pendingCycles / SIM_CYCLES_PER_TICK;
+    pendingCycles -= ticks * SIM_CYCLES_PER_TICK;
+    simAdvance(ticks);
+  }
+}
+
+// FastPin (fastGpio.h): hanya biaya instruksinya sendiri, dalam siklus CPU
+static void fastPinCost(uint8_t instructions, uint8_t cycles) {
+  gpioInstructions += instructions;
+  gpioCycles += cycles;
+  chargeCycles(cycles);
+}
+
+void simFastPinWrite(uint8_t pin, uint8_t value, uint8_t instructions, uint8_t cycles) {
+  fastPinCost(instructions, cycles);
+  pinWrite(pin, value);
+}
+
+int simFastPinRead(uint8_t pin, uint8_t instructions, uint8_t cycles) {
+  fastPinCost(instructions, cycles);
+  return pinRead(pin);
+}
+
+uint16_t simStepTimerCount(uint8_t cycles) {
+  chargeCycles(cycles);
+  return (uint16_t)(nowTicks + (inIsr ? isrElapsed : 0));
+}
+
+void analogWrite(uint8_t pin, int value) {
+  digitalWrite(pin, value > 127 ? HIGH : LOW);
+}
+
+// ===== Serial =====
+// TX dimodelkan seperti HardwareSerial 115200 baud: buffer 64 byte yang dikosongkan
+// satu byte setiap ~87 us, dan write() memblokir saat buffer penuh.
+// RX juga 115200 baud: byte dari simSerialInput() tiba satu per satu di "kabel" dan
+// masuk ke ring buffer RX seperti ISR HardwareSerial (maksimal SIZE - 1 byte); byte yang
+// tiba saat buffer penuh hilang (overrun).
+#define SIM_SERIAL_BYTE_TICKS (10UL * 1000000UL * SIM_TICKS_PER_US / 115200UL)
+
+struct RxByte {
+  uint64_t arrival;
+  char c;
+};
+static std::deque<RxByte> rxWire;
+static uint64_t rxWireFreeAt = 0;  // Tick saat byte terakhir di kabel selesai diterima
+static std::deque<char> rxBuffer;
+static unsigned long rxBytes = 0, rxOverruns = 0;
+static unsigned long rxCorruptEvery = 0, rxWireCount = 0;
+static uint64_t rxBlockedTicks = 0, rxBlockedMaxTicks = 0;
+static uint64_t txDrainedAt = 0;   // Tick saat byte terakhir di buffer TX selesai dikirim
+static std::string txLine;
+static bool txInFrame = false;     // Byte TX sedang membentuk frame biner (balasan atau telemetri)
+static void (*serialListener)(const char* line) = nullptr;
+static void (*serialFrameListener)(const uint8_t* frame, size_t length) = nullptr;
+
+void simSerialInput(const uint8_t* data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    rxWireFreeAt = (rxWireFreeAt > nowTicks ? rxWireFreeAt : nowTicks) + SIM_SERIAL_BYTE_TICKS;
+    char c = data[i];
+    // Gangguan saluran: balik satu bit (terminator dibiarkan agar batas baris tetap ada)
+    if (rxCorruptEvery && ++rxWireCount % rxCorruptEvery == 0 && c != '\n') c ^= 0x04;
+    rxWire.push_back({rxWireFreeAt, c});
+  }
+}
+void simSerialInput(const char* data) { simSerialInput((const uint8_t*)data, strlen(data)); }
+void simSetSerialCorruption(unsigned long everyBytes) { rxCorruptEvery = everyBytes; }
+size_t simSerialRxPending() { return rxWire.size() + rxBuffer.size(); }
+void simSetSerialListener(void (*onLine)(const char* line)) { serialListener = onLine; }
+void simSetSerialFrameListener(void (*onFrame)(const uint8_t* frame, size_t length)) { serialFrameListener = onFrame; }
+
+unsigned long simSerialRxBytes() { return rxBytes; }
+unsigned long simSerialRxOverruns() { return rxOverruns; }
+uint64_t simSerialRxBlockedTicks() { return rxBlockedTicks; }
+uint64_t simSerialRxBlockedMaxTicks() { return rxBlockedMaxTicks; }
+
+static void serialResetStats() {
+  rxBytes = rxOverruns = 0;
+  rxBlockedTicks = rxBlockedMaxTicks = 0;
+}
+
+// Pindahkan byte yang sudah tiba ke buffer RX (pekerjaan ISR RX, dihitung saat dibaca)
+static void rxReceive() {
+  while (!rxWire.empty() && rxWire.front().arrival <= nowTicks) {
+    if (rxBuffer.size() < SERIAL_RX_BUFFER_SIZE - 1) rxBuffer.push_back(rxWire.front().c);
+    else if (statsEnabled) rxOverruns++;
+    rxWire.pop_front();
+  }
+}
+
+// Catat waktu yang dihabiskan Stream::timedRead() menunggu byte berikutnya
+static void rxBlocked(uint64_t since) {
+  uint64_t ticks = nowTicks - since;
+  if (!statsEnabled || ticks == 0) return;
+  rxBlockedTicks += ticks;
+  if (ticks > rxBlockedMaxTicks) rxBlockedMaxTicks = ticks;
+}
+
+int SimSerial::available() {
+  halCall();
+  rxReceive();
+  return rxBuffer.size();
+}
+
+int SimSerial::read() {
+  halCall();
+  rxReceive();
+  if (rxBuffer.empty()) return -1;
+  if (statsEnabled) rxBytes++;
+  char c = rxBuffer.front();
+  rxBuffer.pop_front();
+  return (uint8_t)c;
+}
+
+int SimSerial::peek() {
+  halCall();
+  rxReceive();
+  return rxBuffer.empty() ? -1 : (uint8_t)rxBuffer.front();
+}
+
+int SimSerial::availableForWrite() {
+  halCall();
+  uint64_t pending = txDrainedAt > nowTicks ? (txDrainedAt - nowTicks + SIM_SERIAL_BYTE_TICKS - 1) / SIM_SERIAL_BYTE_TICKS : 0;
+  return pending >= SERIAL_TX_BUFFER_SIZE ? 0 : SERIAL_TX_BUFFER_SIZE - pending;
+}
+
+String SimSerial::readStringUntil(char terminator) {
+  String result;
+  uint64_t blockedSince = nowTicks;
+  unsigned long start = millis();
+  while (true) {
+    int c = read();
+    if (c < 0) {
+      // Stream::timedRead(): tunggu data sampai timeout
+      if (millis() - start >= timeoutMs) break;
+      delay(1);
+      continue;
+    }
+    if (c == terminator) break;
+    result += (char)c;
+  }
+  rxBlocked(blockedSince);
+  return result;
+}
+
+size_t SimSerial::readBytesUntil(char terminator, char* buffer, size_t length) {
+  size_t count = 0;
+  uint64_t blockedSince = nowTicks;
+  unsigned long start = millis();
+  while (count < length) {
+    int c = read();
+    if (c < 0) {
+      if (millis() - start >= timeoutMs) break;
+      delay(1);
+      continue;
+    }
+    if (c == terminator) break;
+    buffer[count++] = (char)c;
+  }
+  rxBlocked(blockedSince);
+  return count;
+}
+
+size_t SimSerial::write(uint8_t c) {
+  halCall();
+  // Tunggu sampai ada slot kosong di buffer TX
+  uint64_t bufferSpan = (uint64_t)SERIAL_TX_BUFFER_SIZE * SIM_SERIAL_BYTE_TICKS;
+  if (txDrainedAt > nowTicks + bufferSpan) simAdvance(txDrainedAt - nowTicks - bufferSpan);
+  txDrainedAt = (txDrainedAt > nowTicks ? txDrainedAt : nowTicks) + SIM_SERIAL_BYTE_TICKS;
+
+  // Frame biner: byte-nya boleh berisi '\n'. Frame balasan panjangnya tetap, frame
+  // telemetri membawa panjang payload di byte kedua.
+  if (txInFrame || (txLine.empty() && (c == FRAME_SYNC || c == FRAME_TELEMETRY_SYNC))) {
+    txInFrame = true;
+    txLine += (char)c;
+    size_t frameSize = FRAME_REPLY_SIZE;
+    if ((uint8_t)txLine[0] == FRAME_TELEMETRY_SYNC) {
+      frameSize = txLine.size() >= 2 ? 2 + (uint8_t)txLine[1] + FRAME_CRC_SIZE : 0;
+    }
+    if (txLine.size() == frameSize) {
+      if (serialFrameListener) serialFrameListener((const uint8_t*)txLine.data(), txLine.size());
+      txLine.clear();
+      txInFrame = false;
+    }
+  } else if (c == '\n') {
+    if (!txLine.empty() && txLine[txLine.size() - 1] == '\r') txLine.erase(txLine.size() - 1);
+    if (serialListener) serialListener(txLine.c_str());
+    txLine.clear();
+  } else {
+    txLine += (char)c;
+  }
+  return 1;
+}
+
+size_t SimSerial::write(const char* str) {
+  size_t n = 0;
+  while (*str) n += write((uint8_t)*str++);
+  return n;
+}
+
+size_t SimSerial::write(const uint8_t* buffer, size_t size) {
+  for (size_t i = 0; i < size; i++) write(buffer[i]);
+  return size;
+}
+
+size_t SimSerial::printNumber(long long value, int base) {
+  char buffer[32];
+  if (base == HEX) snprintf(buffer, sizeof(buffer), "%llX", (unsigned long long)value);
+  else snprintf(buffer, sizeof(buffer), "%lld", value);
+  return write(buffer);
+}
+
+size_t SimSerial::print(double value, int digits) {
+  char buffer[48];
+  if (isnan(value)) return write("nan");
+  if (isinf(value)) return write("inf");
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return write(buffer);
+}
+
+// ===== EEPROM =====
+EEPROMClass EEPROM;
+static uint8_t eeprom[SIM_EEPROM_SIZE];
+static bool eepromLoaded = false;
+static const char* eepromPath = nullptr;
+static unsigned long eepromWrites = 0;
+// Waktu tulis satu byte EEPROM ATmega2560 (datasheet: 3.3 ms), interrupt tetap berjalan
+static const uint64_t EEPROM_WRITE_TICKS = 3400ULL * SIM_TICKS_PER_US;
+
+static void eepromLoad() {
+  if (eepromLoaded) return;
+  eepromLoaded = true;
+  memset(eeprom, 0xFF, sizeof(eeprom));
+  if (!eepromPath) return;
+  FILE* file = fopen(eepromPath, "rb");
+  if (!file) return;
+  size_t n = fread(eeprom, 1, sizeof(eeprom), file);
+  (void)n;
+  fclose(file);
+}
+
+void simSetEepromFile(const char* path) {
+  eepromPath = path;
+  eepromLoaded = false;
+}
+
+unsigned long simEepromWrites() { return eepromWrites; }
+
+uint8_t simEepromRead(int address) {
+  eepromLoad();
+  halCall();
+  if (address < 0 || address >= SIM_EEPROM_SIZE) return 0xFF;
+  return eeprom[address];
+}
+
+void simEepromWrite(int address, uint8_t value) {
+  eepromLoad();
+  simAdvance(EEPROM_WRITE_TICKS);
+  if (address < 0 || address >= SIM_EEPROM_SIZE) return;
+  eeprom[address] = value;
+  eepromWrites++;
+  if (!eepromPath) return;
+  FILE* file = fopen(eepromPath, "wb");
+  if (!file) return;
+  fwrite(eeprom, 1, sizeof(eeprom), file);
+  fclose(file);
+}
+
+// ===== String =====
+void String::trim() {
+  size_t begin = 0, end = s.size();
+  while (begin < end && isspace((unsigned char)s[begin])) begin++;
+  while (end > begin && isspace((unsigned char)s[end - 1])) end--;
+  s = s.substr(begin, end - begin);
+}
+
+void String::toUpperCase() {
+  for (size_t i = 0; i < s.size(); i++) s[i] = toupper((unsigned char)s[i]);
+}
+
+void String::toLowerCase() {
+  for (size_t i = 0; i < s.size(); i++) s[i] = tolower((unsigned char)s[i]);
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+  if (s.size() != other.s.size()) return false;
+  for (size_t i = 0; i < s.size(); i++) {
+    if (tolower((unsigned char)s[i]) != tolower((unsigned char)other.s[i])) return false;
+  }
+  return true;
+}
@@ -0,0 +1,89 @@
+// simHal.h
+// Kontrol simulator untuk build host: jam virtual, trace GPIO step/dir,
+// model limit switch, dan jalur Serial. Dipakai oleh simMain.cpp.
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <vector>
+
+// Jam virtual berjalan pada resolusi timer step engine (Timer1, 2 MHz)
+#define SIM_TICKS_PER_US 2
+// Jumlah pin digital ATmega2560
+#define SIM_PIN_COUNT 70
+#define SIM_MAX_AXES 4
+
+// Jam virtual
+uint64_t simNow();                           // Tick sejak awal simulasi
+void simAdvance(uint64_t ticks);             // Majukan jam dan jalankan interrupt timer yang jatuh tempo
+void simSetCallCost(uint32_t ticks);         // Biaya waktu setiap pemanggilan HAL di luar ISR (default 2 = 1 us)
+void simSetIsrCost(uint32_t ticks);          // Biaya waktu tetap setiap ISR step generator (default 0)
+unsigned long simIsrCount();                 // Jumlah ISR step generator yang sudah dijalankan
+
+// Model sumbu: setiap pulsa step (tepi naik) menggeser posisi model sesuai level pin dir.
+// Limit switch (aktif LOW) terpicu saat posisi <= 0 dan baru lepas setelah posisi melewati
+// histeresis (seperti differential travel microswitch). startDistance adalah jarak awal
+// dari switch dalam langkah; towardsLimitLevel adalah level pin dir yang bergerak ke switch.
+void simAddAxis(const char* name, uint8_t stepPin, uint8_t dirPin, uint8_t limitPin,
+                uint8_t towardsLimitLevel, long startDistance);
+uint8_t simAxisCount();
+const char* simAxisName(uint8_t axis);
+long simAxisPosition(uint8_t axis);          // Jarak model dari switch (langkah)
+unsigned long simAxisSteps(uint8_t axis);    // Total pulsa step
+void simSetLimitHysteresis(long steps);      // Default 20 langkah
+
+// Pantulan kontak: setiap perubahan status switch model diikuti edges pulsa balik (2 * edges
+// tepi) berjarak intervalTicks sebelum level stabil. Default 0 (tanpa pantulan).
+// Perubahan level pin limit memicu ISR yang dipasang lewat attachInterrupt()/simAttachPinChange().
+void simSetLimitBounce(unsigned edges, uint32_t intervalTicks);
+// Statistik limit switch sejak awal simulasi (termasuk homing di setup()):
+unsigned long simLimitEdges();               // Perubahan level pin limit, termasuk pantulan
+uint32_t simLimitIsrLatencyMax();            // Tepi pin sampai ISR pin mulai (tick)
+unsigned long simLimitOvertravelSteps();     // Pulsa menuju switch dari posisi <= titik picu
+
+// Catat setiap perubahan pin step/dir sumbu model ke file CSV "tick,pin,level"
+void simSetTrace(FILE* file);
+
+// Penghitung biaya GPIO dalam instruksi dan siklus AVR: digitalWrite()/digitalRead() menurut
+// perkiraan Arduino core, FastPin menurut instruksi register yang dihasilkannya (fastGpio.h).
+// Waktu simulasi FastPin mengikuti siklus itu; HAL lain tetap memakai biaya tetap per panggilan.
+void simGpioCost(unsigned long& instructions, unsigned long& cycles);
+void simResetGpioCost();
+// Lebar HIGH terpendek pin sejak simResetStats(), dalam siklus CPU 16 MHz (UINT32_MAX jika
+// belum ada pulsa). Waktu di dalam ISR ikut dihitung, jadi ini lebar pulsa step yang dilihat driver.
+uint32_t simPinMinHighCycles(uint8_t pin);
+
+// Statistik timing untuk benchmark (sim/simBench.h), dikumpulkan setelah simResetStats().
+// Semua sampel dalam tick. Interval langkah yang lebih panjang dari SIM_STEP_GAP_TICKS
+// dianggap jeda antar gerakan dan tidak dihitung sebagai jitter.
+#define SIM_STEP_GAP_TICKS (100000UL * SIM_TICKS_PER_US)
+void simResetStats();
+const std::vector<uint32_t>& simIsrLatencies();                   // Keterlambatan ISR dari compare match
+const std::vector<uint32_t>& simAxisIntervalDeltas(uint8_t axis); // |interval langkah - interval sebelumnya|
+uint32_t simAxisMinInterval(uint8_t axis);                         // Interval langkah terpendek
+unsigned long simAxisStatSteps(uint8_t axis);                      // Langkah sejak simResetStats()
+
+// Serial: simulator mengisi RX, dan menerima setiap baris TX lengkap (tanpa CR/LF).
+// Byte RX tiba dengan kecepatan 115200 baud ke buffer RX 64 byte.
+// Frame biner (balasan dan telemetri, binaryFrame.h) di awal baris TX diteruskan utuh ke
+// frame listener.
+void simSerialInput(const char* data);
+void simSerialInput(const uint8_t* data, size_t length);   // Data biner (frame)
+size_t simSerialRxPending();                 // Byte yang belum dibaca firmware (termasuk yang belum tiba)
+void simSetSerialCorruption(unsigned long everyBytes); // Ubah satu bit pada setiap byte RX ke-N (0 = mati)
+void simSetSerialListener(void (*onLine)(const char* line));
+void simSetSerialFrameListener(void (*onFrame)(const uint8_t* frame, size_t length));
+
+// Statistik RX sejak simResetStats(). "Blocked" adalah waktu loop() tertahan di dalam
+// readStringUntil()/readBytesUntil() menunggu sisa baris; selama itu planner tidak diisi.
+unsigned long simSerialRxBytes();
+unsigned long simSerialRxOverruns();         // Byte hilang karena buffer RX penuh
+uint64_t simSerialRxBlockedTicks();
+uint64_t simSerialRxBlockedMaxTicks();
+
+// EEPROM (sim/EEPROM.h) dibaca dari file ini jika ada, dan ditulis ulang setiap kali berubah
+void simSetEepromFile(const char* path);
+unsigned long simEepromWrites();             // Byte EEPROM yang benar-benar ditulis
+
+#endif
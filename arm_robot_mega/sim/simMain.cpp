@@ -0,0 +1,339 @@
+// simMain.cpp
+// Simulasi host: menjalankan setup()/loop() firmware terhadap HAL virtual (simHal.h),
+// mengirim program G-code lewat Serial (simSender.h), dan melaporkan waktu simulasi
+// serta langkah tiap sumbu.
+//
+// Penggunaan: arm_sim [opsi] [program.gcode]   (tanpa program: baca dari stdin)
+//   --trace FILE        tulis trace pin step/dir (CSV: tick,pin,level; 1 tick = 0.5 us)
+//   --max-seconds N     batas waktu simulasi (default 600)
+//   --home-distance N   jarak awal setiap sumbu dari limit switch, dalam langkah (default 3000)
+//   --limit-hysteresis N  jarak lepas limit switch setelah terpicu, dalam langkah (default 20)
+//   --limit-bounce N    setiap perubahan status limit switch diikuti N pulsa pantulan kontak
+//                       berjarak 100 us, untuk menguji debounce ISR limitSwitch.h (default 0)
+//   --isr-cost N        biaya waktu tetap tiap ISR step generator, dalam tick (default 0)
+//   --no-lookahead      nonaktifkan look-ahead Planner setelah setup(): setiap blok mulai dan
+//                       berhenti paling cepat pada kecepatan jerk (sambungan tetap dalam batas
+//                       jerk), pembanding berhenti per blok untuk waktu lintasan
+//   --quiet             jangan cetak output Serial firmware
+//   --stream            kirim dengan protokol streaming (N/checksum + penghitungan byte RX)
+//                       seperti python/gcode_sender.py; default menunggu "OK" per baris
+//   --binary            kirim G/M sebagai frame biner (binaryFrame.h) dengan go-back-N seperti
+//                       python/binary_protocol.py
+//   --corrupt-rx N      ubah satu bit setiap byte RX ke-N untuk menguji checksum/Resend
+//   --link              hubungkan Serial firmware ke stdin/stdout secara real time (jam virtual
+//                       mengikuti jam dinding), untuk menguji pengirim host seperti
+//                       python/gcode_sender.py --sim; pesan simulator ke stderr
+//   --host-latency MS   latensi jalur USB-serial ke pengirim (mis. latency timer FTDI 16 ms);
+//                       output firmware baru terlihat oleh pengirim setelah MS (default 0)
+//   --eeprom FILE       isi EEPROM (sim/EEPROM.h) dibaca dari dan ditulis ke FILE, untuk menguji
+//                       M500/M501 dan start tanpa homing antar run (posisi model sumbu tidak disimpan)
+//   --report FILE       tulis laporan benchmark JSON (simBench.h) setelah program selesai; "-" = stdout
+//   --bench-parser N    tanpa simulasi gerak: bandingkan parser baris lama dan baru pada baris
+//                       program (diulang N kali) dan cetak hasil JSON ke stdout
+//   --bench-ring N      tanpa simulasi gerak: uji stres RingBuffer antar thread dengan N item dan
+//                       throughput push/pop dibanding antrian lama, JSON ke stdout; exit 1 jika gagal
+//   --check-kinematics  tanpa simulasi gerak: uji round-trip FK/IK untuk beberapa set panjang
+//                       link, cetak JSON ke stdout; exit 1 jika galat melebihi toleransi
+//   --bench-ik          tanpa simulasi gerak: galat IK fixed-point terhadap float dan ns per
+//                       panggilan kedua backend, JSON ke stdout; exit 1 jika galat di atas 0.25 mm
+//   --bench-gpio N      tanpa simulasi gerak: biaya GPIO per langkah (instruksi/siklus AVR)
+//                       RampsStepper vs FastAxis untuk keempat sumbu dan digitalWrite() vs FastPin
+//                       untuk koil gripper, N pulsa per sumbu, serta lebar pulsa step dari ISR
+//                       StepEngine, JSON ke stdout; exit 1 jika kedua versi berbeda atau pulsa
+//                       lebih pendek dari STEP_PULSE_MIN_US
+//   --check-packing     tanpa simulasi gerak: uji round-trip pack/unpack perintah antrian
+//                       (commandQueue.h) pada baris program dan nilai acak, JSON ke stdout;
+//                       exit 1 jika ada perintah yang berubah
+//   --check-arcs        tanpa simulasi gerak: uji busur G2/G3 Interpolation terhadap referensi
+//                       double dan busur tidak valid, JSON ke stdout; exit 1 jika gagal
+//   --check-planner     tanpa simulasi gerak: kecepatan dan akselerasi blok Planner terhadap
+//                       batas sumbu untuk berbagai panjang gerakan, dengan look-ahead aktif dan
+//                       nonaktif, JSON ke stdout; exit 1 jika gagal
+//
+// Status keluar simulasi program: 0 selesai, 2 batas waktu habis, 3 ada byte RX yang hilang
+// (buffer RX Serial meluap, berarti flow control pengirim salah)
+#include <Arduino.h>
+#include "simHal.h"
+#include "simBench.h"
+#include "simSender.h"
+#include "pinout.h"
+#include "RampsStepper.h"
+#include "robotAxes.h"
+#include "stepEngine.h"
+#include "planner.h"
+#include "interpolation.h"
+#include "commandQueue.h"
+#include "robotGeometry.h"
+#include "gripper.h"
+#include "limitSwitch.h"
+#include "binaryFrame.h"
+#include <chrono>
+#include <deque>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Sketch (arm_robot_mega.ino)
+void setup();
+void loop();
+extern BaseAxis stepperBase;
+extern ShoulderAxis stepperShoulder;
+extern ElbowAxis stepperElbow;
+extern SliderAxis stepperSlider;
+extern StepEngine stepEngine;
+extern Planner planner;
+extern Interpolation interpolator;
+extern CommandQueue queue;
+extern RobotGeometry geom;
+extern Gripper gripper;
+extern LimitSwitches limitSwitches;
+
+static bool quiet = false;
+static SimSender* sender = nullptr;
+static uint64_t hostLatencyTicks = 0;
+
+// Output firmware yang masih dalam perjalanan ke pengirim
+struct PendingLine {
+  uint64_t deliverAt;
+  std::string text;
+  bool frame;        // text berisi frame balasan biner
+};
+static std::deque<PendingLine> toHost;
+
+static void onSerialLine(const char* line) {
+  if (!quiet) printf("%s\n", line);
+  if (sender) toHost.push_back({simNow() + hostLatencyTicks, line, false});
+}
+
+static void onSerialFrame(const uint8_t* frame, size_t length) {
+  if (frame[0] == FRAME_TELEMETRY_SYNC) {
+    if (!quiet) printf("<telemetry seq=%u blocks=%u queue=%u>\n", frame[2], frame[23], frame[24]);
+    return;
+  }
+  if (!quiet) printf("<frame seq=%u status=%u Q=%u B=%u>\n", frame[1], frame[2], frame[3], frame[4]);
+  if (sender) toHost.push_back({simNow() + hostLatencyTicks, std::string((const char*)frame, length), true});
+}
+
+// Mode --link: output firmware langsung ke stdout per baris
+static void onLinkLine(const char* line) {
+  printf("%s\n", line);
+  fflush(stdout);
+}
+
+static void onLinkFrame(const uint8_t* frame, size_t length) {
+  fwrite(frame, 1, length, stdout);
+  fflush(stdout);
+}
+
+// Mode --link: byte stdin diteruskan ke RX firmware, dan jam virtual ditahan agar tidak
+// mendahului jam dinding. Selesai saat stdin ditutup dan semua gerakan selesai.
+static bool runLink(uint64_t maxTicks, unsigned long& loops) {
+  fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+  bool inputClosed = false;
+  uint64_t simStart = simNow();
+  auto wallStart = std::chrono::steady_clock::now();
+
+  while (simNow() < maxTicks) {
+    if (!inputClosed) {
+      uint8_t buffer[256];
+      ssize_t n = read(STDIN_FILENO, buffer, sizeof(buffer));
+      if (n > 0) {
+        simSerialInput(buffer, n);
+      } else if (n == 0) {
+        inputClosed = true;
+      }
+    }
+
+    loop();
+    loops++;
+
+    if (inputClosed && simSerialRxPending() == 0 && queue.isEmpty() && interpolator.isFinished() && !stepEngine.isBusy() && !gripper.isMoving()) {
+      return true;
+    }
+
+    uint64_t wallTicks = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - wallStart).count() * SIM_TICKS_PER_US;
+    uint64_t simTicks = simNow() - simStart;
+    if (simTicks > wallTicks + 1000 * SIM_TICKS_PER_US) usleep((simTicks - wallTicks) / SIM_TICKS_PER_US);
+  }
+  return false;
+}
+
+static void deliverToHost() {
+  while (!toHost.empty() && toHost.front().deliverAt <= simNow()) {
+    const PendingLine& pending = toHost.front();
+    if (pending.frame) sender->onFrame((const uint8_t*)pending.text.data(), pending.text.size());
+    else sender->onLine(pending.text.c_str());
+    toHost.pop_front();
+  }
+}
+
+// Level pin dir yang menggerakkan sumbu menuju limit switch (langkah negatif, lihat
+// RampsStepper::setStepDirection)
+static uint8_t towardsLimitLevel(RampsStepper& stepper) {
+  bool high = stepper.getReverseDirection() ? !stepper.getDirHighToHome() : stepper.getDirHighToHome();
+  return high ? HIGH : LOW;
+}
+
+static bool readProgram(FILE* file, std::vector<std::string>& lines) {
+  char buffer[256];
+  while (fgets(buffer, sizeof(buffer), file)) {
+    std::string line(buffer);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r' || line.back() == ' ')) line.pop_back();
+    if (line.empty() || line[0] == ';') continue;
+    lines.push_back(line);
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const char* programPath = nullptr;
+  const char* tracePath = nullptr;
+  const char* reportPath = nullptr;
+  double maxSeconds = 600.0;
+  long homeDistance = 3000;
+  unsigned long parserRepeats = 0;
+  bool checkPacking = false;
+  SimSenderMode senderMode = SENDER_ACK;
+  bool link = false;
+  bool lookAhead = true;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg == "--trace" && i + 1 < argc) tracePath = argv[++i];
+    else if (arg == "--max-seconds" && i + 1 < argc) maxSeconds = atof(argv[++i]);
+    else if (arg == "--home-distance" && i + 1 < argc) homeDistance = atol(argv[++i]);
+    else if (arg == "--limit-hysteresis" && i + 1 < argc) simSetLimitHysteresis(atol(argv[++i]));
+    else if (arg == "--limit-bounce" && i + 1 < argc) simSetLimitBounce(strtoul(argv[++i], nullptr, 10), 100 * SIM_TICKS_PER_US);
+    else if (arg == "--isr-cost" && i + 1 < argc) simSetIsrCost(atol(argv[++i]));
+    else if (arg == "--no-lookahead") lookAhead = false;
+    else if (arg == "--report" && i + 1 < argc) reportPath = argv[++i];
+    else if (arg == "--bench-parser" && i + 1 < argc) parserRepeats = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--bench-ring" && i + 1 < argc) return simBenchRing(stdout, strtoul(argv[++i], nullptr, 10)) ? 0 : 1;
+    else if (arg == "--check-kinematics") return simBenchKinematics(stdout) ? 0 : 1;
+    else if (arg == "--bench-ik") return simBenchIkBackends(stdout) ? 0 : 1;
+    else if (arg == "--bench-gpio" && i + 1 < argc) return simBenchGpio(stdout, strtoul(argv[++i], nullptr, 10)) ? 0 : 1;
+    else if (arg == "--check-packing") checkPacking = true;
+    else if (arg == "--check-arcs") return simBenchArcs(stdout) ? 0 : 1;
+    else if (arg == "--check-planner") return simBenchPlanner(stdout) ? 0 : 1;
+    else if (arg == "--quiet") quiet = true;
+    else if (arg == "--stream") senderMode = SENDER_STREAM;
+    else if (arg == "--binary") senderMode = SENDER_BINARY;
+    else if (arg == "--link") link = true;
+    else if (arg == "--corrupt-rx" && i + 1 < argc) simSetSerialCorruption(strtoul(argv[++i], nullptr, 10));
+    else if (arg == "--eeprom" && i + 1 < argc) simSetEepromFile(argv[++i]);
+    else if (arg == "--host-latency" && i + 1 < argc) hostLatencyTicks = (uint64_t)(atof(argv[++i]) * 1000 * SIM_TICKS_PER_US);
+    else if (arg[0] != '-') programPath = argv[i];
+    else {
+      fprintf(stderr, "Opsi tidak dikenal: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  // Mode --link menerima perintah dari stdin, bukan dari program
+  std::vector<std::string> program;
+  if (!link) {
+    FILE* programFile = programPath ? fopen(programPath, "r") : stdin;
+    if (!programFile) {
+      fprintf(stderr, "Tidak dapat membuka %s\n", programPath);
+      return 1;
+    }
+    readProgram(programFile, program);
+    if (programPath) fclose(programFile);
+  }
+
+  if (parserRepeats > 0) {
+    simBenchParser(stdout, program, parserRepeats);
+    return 0;
+  }
+  if (checkPacking) return simBenchPacking(stdout, program) ? 0 : 1;
+
+  FILE* traceFile = nullptr;
+  if (tracePath) {
+    traceFile = fopen(tracePath, "w");
+    if (!traceFile) {
+      fprintf(stderr, "Tidak dapat menulis %s\n", tracePath);
+      return 1;
+    }
+    fprintf(traceFile, "tick,pin,level\n");
+    simSetTrace(traceFile);
+  }
+
+  simAddAxis("Base", ROTATE_STEP_PIN, ROTATE_DIR_PIN, ROTATE_LIMIT_PIN, towardsLimitLevel(stepperBase), homeDistance);
+  simAddAxis("Shoulder", SHOULDER_STEP_PIN, SHOULDER_DIR_PIN, SHOULDER_LIMIT_PIN, towardsLimitLevel(stepperShoulder), homeDistance);
+  simAddAxis("Elbow", ELBOW_STEP_PIN, ELBOW_DIR_PIN, ELBOW_LIMIT_PIN, towardsLimitLevel(stepperElbow), homeDistance);
+  simAddAxis("Slider", SLIDER_STEP_PIN, SLIDER_DIR_PIN, SLIDER_LIMIT_PIN, towardsLimitLevel(stepperSlider), homeDistance);
+  simSetSerialListener(link ? onLinkLine : onSerialLine);
+  simSetSerialFrameListener(link ? onLinkFrame : onSerialFrame);
+
+  setup();
+  planner.setLookAheadEnabled(lookAhead);
+  uint64_t programStart = simNow();
+  simResetStats();
+  stepEngine.resetStats();
+
+  SimSender programSender(program, senderMode);
+  uint64_t maxTicks = (uint64_t)(maxSeconds * 1e6 * SIM_TICKS_PER_US);
+  unsigned long loops = 0;
+  bool finished = false;
+  if (link) finished = runLink(maxTicks, loops);
+  else sender = &programSender;
+  while (!link && simNow() < maxTicks) {
+    deliverToHost();
+    programSender.poll();
+
+    uint64_t loopStart = simNow();
+    auto hostStart = std::chrono::steady_clock::now();
+    loop();
+    auto hostElapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - hostStart);
+    simBenchLoopSample((uint32_t)(simNow() - loopStart), (uint32_t)hostElapsed.count());
+    loops++;
+
+    if (programSender.isDone() && toHost.empty() && queue.isEmpty() && interpolator.isFinished() && !stepEngine.isBusy() && !gripper.isMoving()) {
+      finished = true;
+      break;
+    }
+  }
+
+  if (traceFile) fclose(traceFile);
+  fflush(stdout);
+
+  if (reportPath) {
+    SimBenchResult result;
+    result.program = programPath ? programPath : "stdin";
+    result.finished = finished;
+    result.setupSeconds = programStart / (1e6 * SIM_TICKS_PER_US);
+    result.programSeconds = (simNow() - programStart) / (1e6 * SIM_TICKS_PER_US);
+    result.loops = loops;
+    result.lookAhead = planner.isLookAheadEnabled();
+    result.senderMode = link ? "link" : programSender.modeName();
+    result.sender = programSender.getStats();
+    stepEngine.getStats(result.pipeline);
+    limitSwitches.getStats(result.limits);
+    result.ikHostNs = simBenchIkHostNs(geom, result.ikCalls);
+
+    FILE* reportFile = strcmp(reportPath, "-") == 0 ? stdout : fopen(reportPath, "w");
+    if (!reportFile) {
+      fprintf(stderr, "Tidak dapat menulis %s\n", reportPath);
+      return 1;
+    }
+    simBenchWriteReport(reportFile, result);
+    if (reportFile != stdout) fclose(reportFile);
+  }
+
+  fprintf(stderr, "%s: t=%.6f s, loop=%lu, isr=%lu\n", finished ? "Selesai" : "Timeout",
+          simNow() / (1e6 * SIM_TICKS_PER_US), loops, simIsrCount());
+  for (uint8_t i = 0; i < simAxisCount(); i++) {
+    fprintf(stderr, "  %-8s langkah=%lu jarak_dari_limit=%ld\n", simAxisName(i), simAxisSteps(i), simAxisPosition(i));
+  }
+  fprintf(stderr, "  Gripper  posisi=%ld\n", gripper.getPosition());
+  // Flow control pengirim menjamin buffer RX tidak pernah meluap; byte yang hilang berarti
+  // baris rusak atau hilang walaupun program tampak selesai
+  if (simSerialRxOverruns() > 0) {
+    fprintf(stderr, "RX overrun: %lu byte hilang\n", simSerialRxOverruns());
+    return 3;
+  }
+  return finished ? 0 : 2;
+}
@@ -0,0 +1,306 @@
+// simSender.cpp
+#include "simSender.h"
+#include "simHal.h"
+#include "binaryFrame.h"
+#include <stdio.h>
+
+// Jeda sebelum mengirim ulang baris yang ditolak karena antrian penuh (SENDER_ACK)
+#define SIM_RESEND_DELAY_TICKS (50000UL * SIM_TICKS_PER_US)
+// SENDER_BINARY: frame yang hilang seluruhnya (mis. byte SYNC rusak) tidak pernah dijawab;
+// tanpa balasan selama ini, pengirim mengulang dari frame tertua yang belum diterima
+#define SIM_FRAME_TIMEOUT_TICKS (2000000UL * SIM_TICKS_PER_US)
+// Seq frame sync pertama; perintah pertama memakai seq 0
+#define SIM_SYNC_SEQ 0xFF
+
+static bool isQueuedCommand(const std::string& line) {
+  return !line.empty() && (line[0] == 'G' || line[0] == 'M' || line[0] == 'P');
+}
+
+// Ambil nilai field "<letter><angka>" dari ack "OK Q.. B.."
+static bool ackField(const char* line, char letter, long& value) {
+  for (const char* p = line; *p; p++) {
+    if (p[0] == ' ' && p[1] == letter) {
+      value = strtol(p + 2, nullptr, 10);
+      return true;
+    }
+  }
+  return false;
+}
+
+SimSender::SimSender(const std::vector<std::string>& program, SimSenderMode mode)
+    : program(program), mode(mode), nextLine(0), waitingAck(false), resendLine(false), sendAfter(0),
+      inFlightBytes(0), rxWindow(0), nextNumber(1), started(false), acked(0), staleBytes(0), lastReplyAt(0) {
+  if (mode == SENDER_BINARY) {
+    // Parse sekali dengan parser firmware; yang bukan G/M/P tetap dikirim sebagai teks
+    Command parser;
+    char buffer[COMMAND_LINE_MAX + 1];
+    for (size_t i = 0; i < program.size(); i++) {
+      snprintf(buffer, sizeof(buffer), "%s", program[i].c_str());
+      Cmd cmd = {};
+      if (parser.prepareLine(buffer) == LINE_READY && parser.handleGcodeLine(buffer)) cmd = parser.getCmd();
+      // Nilai di luar jangkauan 24-bit frame: kirim sebagai baris ASCII seperti perintah debug
+      uint8_t frame[FRAME_MAX_SIZE];
+      if (cmd.id != 0 && packFrame(0, cmd, frame) == 0) cmd = Cmd();
+      commands.push_back(cmd);
+    }
+    nextNumber = 0;
+    for (size_t i = 0; i < 256; i++) seqIndex[i] = SIZE_MAX;
+  }
+  stats.linesSent = 0;
+  stats.bytesSent = 0;
+  stats.resends = 0;
+  stats.rejected = 0;
+  stats.alarms = 0;
+  stats.queueFreeMin = -1;
+}
+
+void SimSender::send(size_t index, const std::string& text, bool tracked) {
+  std::string frame = text;
+  if (mode == SENDER_STREAM) {
+    // Format RepRap: "N<n> <baris>*<xor semua byte sebelum '*'>"
+    long number = index == SIZE_MAX ? 0 : nextNumber++;
+    if (index != SIZE_MAX) frame = "N" + std::to_string(number) + " " + text;
+    uint8_t checksum = 0;
+    for (size_t i = 0; i < frame.size(); i++) checksum ^= (uint8_t)frame[i];
+    frame += "*" + std::to_string(checksum);
+    if (tracked) {
+      inFlight.push_back({index, number, frame.size() + 1});
+      inFlightBytes += frame.size() + 1;
+    }
+  }
+  frame += "\n";
+  stats.bytesSent += frame.size();
+  simSerialInput(frame.c_str());
+}
+
+const char* SimSender::modeName() const {
+  switch (mode) {
+    case SENDER_STREAM: return "stream";
+    case SENDER_BINARY: return "binary";
+    default: return "ack";
+  }
+}
+
+void SimSender::poll() {
+  if (mode == SENDER_STREAM) pollStream();
+  else if (mode == SENDER_BINARY) pollBinary();
+  else pollAck();
+}
+
+void SimSender::pollAck() {
+  if (resendLine) {
+    resendLine = false;
+    nextLine--;
+    sendAfter = simNow() + SIM_RESEND_DELAY_TICKS;
+  }
+  // Kirim baris berikutnya setelah baris sebelumnya dibaca (dan di-ack untuk G/M)
+  if (!waitingAck && simSerialRxPending() == 0 && nextLine < program.size() && simNow() >= sendAfter) {
+    const std::string& line = program[nextLine++];
+    waitingAck = isQueuedCommand(line);
+    if (!waitingAck) stats.linesSent++;
+    send(nextLine - 1, line, false);
+  }
+}
+
+void SimSender::pollStream() {
+  if (!started) {
+    // Sinkronkan nomor baris; ack-nya juga memberi ukuran buffer RX
+    started = true;
+    send(SIZE_MAX, "M110 N0", true);
+    return;
+  }
+  if (rxWindow == 0) return;
+
+  while (nextLine < program.size()) {
+    const std::string& line = program[nextLine];
+    if (!isQueuedCommand(line)) {
+      // Perintah debug (POS, J0..J3, GOTO) tidak di-ack: kirim setelah semua baris
+      // sebelumnya selesai, lalu tunggu sampai firmware membacanya
+      if (!inFlight.empty() || simSerialRxPending() > 0) return;
+      send(nextLine++, line, false);
+      stats.linesSent++;
+      return;
+    }
+    // Penghitungan byte: baris baru hanya dikirim jika masih muat di buffer RX
+    size_t bytes = line.size() + std::to_string(nextNumber).size() + 7;
+    if (bytes - 1 > COMMAND_LINE_MAX) {
+      // Seperti gcode_sender.py: firmware tidak akan pernah menerimanya, Resend akan berulang
+      fprintf(stderr, "Baris %zu lebih dari %d karakter, tidak dikirim\n", nextLine + 1, COMMAND_LINE_MAX);
+      stats.rejected++;
+      nextLine++;
+      continue;
+    }
+    if (inFlightBytes + bytes > rxWindow) return;
+    send(nextLine++, line, true);
+  }
+}
+
+void SimSender::sendFrame(size_t index, const Cmd& cmd) {
+  uint8_t frame[FRAME_MAX_SIZE];
+  uint8_t seq = index == SIZE_MAX ? SIM_SYNC_SEQ : (uint8_t)nextNumber++;
+  uint8_t length = packFrame(seq, cmd, frame);
+  if (index != SIZE_MAX) seqIndex[seq] = index;
+  inFlight.push_back({index, seq, length});
+  inFlightBytes += length;
+  stats.bytesSent += length;
+  simSerialInput(frame, length);
+}
+
+void SimSender::pollBinary() {
+  if (!started) {
+    // Frame sync: perintah pertama memakai seq 0; balasannya memberi ukuran buffer RX
+    Cmd sync = {};
+    sync.valueX = sync.valueY = sync.valueZ = sync.valueE = sync.valueF = sync.valueT = NAN;
+    sync.valueI = sync.valueJ = sync.valueR = NAN;
+    started = true;
+    lastReplyAt = simNow();
+    sendFrame(SIZE_MAX, sync);
+    return;
+  }
+  if (!inFlight.empty() && simNow() - lastReplyAt > SIM_FRAME_TIMEOUT_TICKS) {
+    lastReplyAt = simNow();
+    rewind((uint8_t)(inFlight.front().number));
+  }
+  if (rxWindow == 0) return;
+
+  while (nextLine < program.size()) {
+    if (commands[nextLine].id == 0) {
+      // Perintah debug sebagai baris ASCII, setelah semua frame sebelumnya diterima
+      if (!inFlight.empty() || staleBytes > 0 || simSerialRxPending() > 0) return;
+      send(nextLine, program[nextLine], false);
+      acked = ++nextLine;
+      stats.linesSent++;
+      return;
+    }
+    // Frame yang dibatalkan saat rewind mungkin masih di buffer RX, jadi ikut dihitung;
+    // frame pertama setelah rewind selalu boleh dikirim agar pengiriman ulang tidak macet
+    uint8_t frame[FRAME_MAX_SIZE];
+    size_t bytes = packFrame(0, commands[nextLine], frame);
+    if (!inFlight.empty() && inFlightBytes + staleBytes + bytes > rxWindow) return;
+    sendFrame(nextLine, commands[nextLine]);
+    nextLine++;
+  }
+}
+
+// Go-back-N: batalkan semua frame yang belum diterima dan kirim ulang mulai dari seq
+void SimSender::rewind(uint8_t seq) {
+  staleBytes += inFlightBytes;
+  inFlight.clear();
+  inFlightBytes = 0;
+  stats.resends++;
+  if (rxWindow == 0) {
+    // Frame sync sendiri hilang
+    started = false;
+    return;
+  }
+  nextLine = acked;
+  nextNumber = seq;
+}
+
+void SimSender::onFrame(const uint8_t* frame, size_t length) {
+  if (mode != SENDER_BINARY || length != FRAME_REPLY_SIZE) return;
+  uint16_t crc = 0;
+  for (size_t i = 1; i < FRAME_REPLY_SIZE - 2; i++) crc = frameCrc16(crc, frame[i]);
+  if (crc != (frame[5] | (frame[6] << 8))) return;
+
+  uint8_t seq = frame[1];
+  uint8_t status = frame[2];
+  lastReplyAt = simNow();
+  if (rxWindow == 0 && status != FRAME_CRC_ERROR && status != FRAME_SEQUENCE_ERROR) {
+    // Balasan frame sync: belum ada byte lain yang menunggu, jadi B = kapasitas buffer RX
+    rxWindow = frame[4] > 0 ? frame[4] : SERIAL_RX_BUFFER_SIZE - 1;
+    inFlight.clear();
+    inFlightBytes = staleBytes = 0;
+    return;
+  }
+
+  if (status == FRAME_CRC_ERROR || status == FRAME_SEQUENCE_ERROR) {
+    rewind(seq);
+    return;
+  }
+
+  if (stats.queueFreeMin < 0 || frame[3] < stats.queueFreeMin) stats.queueFreeMin = frame[3];
+  // Balasan kumulatif: semua frame sampai seq sudah diterima firmware
+  while (!inFlight.empty() && (uint8_t)(seq - inFlight.front().number) < 128) {
+    inFlightBytes -= inFlight.front().bytes;
+    inFlight.pop_front();
+  }
+  staleBytes = 0;
+  if (seqIndex[seq] == SIZE_MAX) return;
+  size_t index = seqIndex[seq] + 1;
+  if (index > acked) {
+    stats.linesSent += index - acked;
+    acked = index;
+  }
+  // Frame yang diterima dari salinan lama (sebelum rewind) tidak perlu dikirim lagi
+  if (nextLine < acked) {
+    nextLine = acked;
+    nextNumber = seq + 1;
+  }
+}
+
+void SimSender::completeHead(bool accepted) {
+  if (inFlight.empty()) return;
+  if (accepted && inFlight.front().index != SIZE_MAX) stats.linesSent++;
+  inFlightBytes -= inFlight.front().bytes;
+  inFlight.pop_front();
+}
+
+void SimSender::onLine(const char* line) {
+  // Error saat eksekusi: baris pemicunya sudah di-ack, jadi tidak menjawab baris apa pun
+  if (strncmp(line, "Alarm: ", 7) == 0) {
+    stats.alarms++;
+    return;
+  }
+  // SENDER_BINARY hanya menunggu frame balasan; teks firmware lainnya diabaikan
+  if (mode == SENDER_BINARY) return;
+  if (mode == SENDER_ACK) {
+    if (!waitingAck) return;
+    if (strncmp(line, "OK", 2) == 0 || strncmp(line, "Error: Unknown command", 22) == 0 ||
+        strncmp(line, "Error: Link lengths", 19) == 0 || strncmp(line, "Error: Line too long", 20) == 0) {
+      waitingAck = false;
+      stats.linesSent++;
+    } else if (strncmp(line, "Error: Command queue is full", 28) == 0) {
+      // Baris dibuang firmware: kirim ulang
+      waitingAck = false;
+      resendLine = true;
+      stats.rejected++;
+    }
+    return;
+  }
+
+  if (inFlight.empty()) return;
+  if (strncmp(line, "OK", 2) == 0) {
+    long value;
+    if (ackField(line, 'Q', value) && (stats.queueFreeMin < 0 || value < stats.queueFreeMin)) {
+      stats.queueFreeMin = value;
+    }
+    // Ack M110 pertama: belum ada byte lain yang menunggu, jadi B = kapasitas buffer RX
+    if (rxWindow == 0) rxWindow = ackField(line, 'B', value) && value > 0 ? value : SERIAL_RX_BUFFER_SIZE - 1;
+    completeHead(true);
+  } else if (strncmp(line, "Resend: ", 8) == 0) {
+    long number = strtol(line + 8, nullptr, 10);
+    InFlight head = inFlight.front();
+    completeHead(false);
+    // Baris setelahnya yang sudah terkirim juga akan ditolak (nomor baris salah) dan
+    // menghasilkan "Resend" untuk nomor yang sama; hanya baris yang diminta yang diulang
+    if (head.number == number && head.index != SIZE_MAX) {
+      nextLine = head.index;
+      nextNumber = number;
+      stats.resends++;
+    }
+  } else if (strncmp(line, "Error: Command queue is full", 28) == 0) {
+    stats.rejected++;
+    completeHead(false);
+  } else if (strncmp(line, "Error: Unknown command", 22) == 0 ||
+             strncmp(line, "Error: Link lengths", 19) == 0) {
+    // Penolakan saat baris dibaca menjawab baris tersebut; Checksum/Line number/Line too
+    // long (baris bernomor) selalu diikuti "Resend", yang menjawabnya
+    completeHead(true);
+  }
+}
+
+bool SimSender::isDone() const {
+  if (nextLine < program.size() || simSerialRxPending() > 0) return false;
+  return mode == SENDER_ACK ? !waitingAck : inFlight.empty();
+}
@@ -0,0 +1,88 @@
+// simSender.h
+// Pengirim program G-code untuk simulasi host, meniru host di sisi PC:
+//  - SENDER_ACK: kirim satu baris, tunggu "OK" (seperti GUI lama)
+//  - SENDER_STREAM: protokol streaming python/gcode_sender.py. Baris diberi nomor N dan
+//    checksum, dan host menghitung byte baris yang belum di-ack agar selalu muat di buffer
+//    RX firmware (kapasitas dipelajari dari B pada ack pertama). Baris berikutnya sudah
+//    menunggu di buffer saat firmware siap, jadi tidak ada round-trip yang ditunggu per baris.
+//    Kredit antrian (Q) tidak cukup untuk mengirim lebih jauh: loop() bisa tertahan menulis
+//    output Serial, dan selama itu buffer RX tidak dikosongkan.
+//  - SENDER_BINARY: frame biner (binaryFrame.h) dengan penghitungan byte yang sama.
+//    Setiap frame dijawab frame balasan 7 byte; balasan OK bersifat kumulatif, dan balasan
+//    error membuat pengirim mengulang mulai dari seq di balasan (go-back-N). Perintah debug
+//    (POS, J0..J3, GOTO) tetap dikirim sebagai baris ASCII.
+#ifndef SIM_SENDER_H
+#define SIM_SENDER_H
+
+#include <stdint.h>
+#include "command.h"
+#include <deque>
+#include <string>
+#include <vector>
+
+enum SimSenderMode { SENDER_ACK, SENDER_STREAM, SENDER_BINARY };
+
+struct SimSenderStats {
+  unsigned long linesSent;     // Baris program yang sudah di-ack/diterima firmware
+  unsigned long bytesSent;
+  unsigned long resends;       // Permintaan "Resend: n" / frame error yang dilayani
+  unsigned long rejected;      // "Error: Command queue is full"
+  unsigned long alarms;        // "Alarm: ..." saat eksekusi (bukan jawaban baris, tanpa kredit)
+  int queueFreeMin;            // Q terkecil yang dilaporkan ack (-1 jika tidak ada)
+};
+
+class SimSender {
+public:
+  SimSender(const std::vector<std::string>& program, SimSenderMode mode);
+  // Dipanggil setiap iterasi loop(): kirim baris berikutnya jika protokol mengizinkan
+  void poll();
+  // Satu baris output firmware
+  void onLine(const char* line);
+  // Satu frame balasan biner
+  void onFrame(const uint8_t* frame, size_t length);
+  // Semua baris program sudah dikirim dan dijawab
+  bool isDone() const;
+  const SimSenderStats& getStats() const { return stats; }
+  const char* modeName() const;
+
+private:
+  struct InFlight {
+    size_t index;   // Indeks baris program (SIZE_MAX untuk M110)
+    long number;
+    size_t bytes;
+  };
+
+  void send(size_t index, const std::string& text, bool tracked);
+  void pollAck();
+  void pollStream();
+  void pollBinary();
+  void sendFrame(size_t index, const Cmd& cmd);
+  void rewind(uint8_t seq);
+  void completeHead(bool accepted);
+
+  const std::vector<std::string>& program;
+  SimSenderMode mode;
+  size_t nextLine;
+  SimSenderStats stats;
+
+  // SENDER_ACK
+  bool waitingAck;
+  bool resendLine;
+  uint64_t sendAfter;
+
+  // SENDER_STREAM
+  std::deque<InFlight> inFlight;
+  size_t inFlightBytes;
+  size_t rxWindow;          // Kapasitas buffer RX firmware (0 = belum diketahui)
+  long nextNumber;
+  bool started;             // M110 N0 (atau frame sync) sudah dikirim
+
+  // SENDER_BINARY
+  std::vector<Cmd> commands;  // Hasil parse program; id 0 = dikirim sebagai baris ASCII
+  size_t seqIndex[256];       // Indeks baris program untuk setiap seq yang terkirim
+  size_t acked;               // Baris program sebelum indeks ini sudah diterima firmware
+  size_t staleBytes;          // Byte frame yang dibatalkan saat rewind, mungkin masih di buffer RX
+  uint64_t lastReplyAt;
+};
+
+#endif
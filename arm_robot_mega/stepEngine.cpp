@@ -0,0 +1,291 @@
+// stepEngine.cpp
+#include "stepEngine.h"
+#include <Arduino.h>
+#include "profile.h"
+
+// Engine yang dilayani ISR timer
+static StepEngine* activeEngine = nullptr;
+
+#if defined(__AVR__)
+ISR(TIMER1_COMPA_vect) {
+  uint16_t interval = activeEngine->isr();
+  // Jika ISR berjalan lebih lama dari interval berikutnya, TCNT1 sudah melewati OCR1A
+  // dan timer akan wrap (~32 ms). Paksa compare berikutnya sedikit di depan TCNT1.
+  uint16_t minimum = TCNT1 + 16;
+  OCR1A = (interval < minimum) ? minimum : interval;
+}
+
+// Tick Timer1 sejak start. Mode CTC mereset TCNT1 pada OCR1A (interval yang sedang berjalan)
+static inline uint16_t stepTimerElapsed(uint16_t start) {
+  uint16_t now = TCNT1;
+  return (now >= start) ? now - start : now + OCR1A + 1 - start;
+}
+#else
+uint16_t stepEngineTimerIsr() {
+  if (activeEngine == nullptr) return STEP_IDLE_INTERVAL;
+  return activeEngine->isr();
+}
+
+// Jam simulasi sebagai TCNT1; satu putaran polling (2x lds, sub/sbc, cp/cpc, branch) ~10 siklus
+static inline uint16_t stepTimerElapsed(uint16_t start) {
+  return (uint16_t)(simStepTimerCount(10) - start);
+}
+#endif
+
+StepEngine::StepEngine() {
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    axes[i] = nullptr;
+    counters[i] = 0;
+  }
+  base = nullptr;
+  shoulder = nullptr;
+  elbow = nullptr;
+  slider = nullptr;
+  blockHead = 0;
+  blockTail = 0;
+  currentBlock = nullptr;
+  eventsCompleted = 0;
+  stepRate = 0;
+  stepInterval = STEP_IDLE_INTERVAL;
+  accelerationTicks = 0;
+  dwellRemaining = 0;
+  clearStats();
+}
+
+void StepEngine::begin(BaseAxis* aBase, ShoulderAxis* aShoulder, ElbowAxis* aElbow, SliderAxis* aSlider) {
+  base = aBase;
+  shoulder = aShoulder;
+  elbow = aElbow;
+  slider = aSlider;
+  axes[0] = base;
+  axes[1] = shoulder;
+  axes[2] = elbow;
+  axes[3] = slider;
+  activeEngine = this;
+
+#if defined(__AVR__)
+  // Timer1 mode CTC (reset pada OCR1A), prescaler 8 -> 2 MHz
+  noInterrupts();
+  TCCR1A = 0;
+  TCCR1B = (1 << WGM12) | (1 << CS11);
+  TCNT1 = 0;
+  OCR1A = STEP_IDLE_INTERVAL;
+  TIMSK1 |= (1 << OCIE1A);
+  interrupts();
+#endif
+}
+
+bool StepEngine::isBusy() const {
+  // blockTail baru maju setelah blok selesai dieksekusi
+  return blockHead != blockTail;
+}
+
+bool StepEngine::isBufferFull() const {
+  return nextIndex(blockHead) == blockTail;
+}
+
+uint8_t StepEngine::bufferedBlocks() const {
+  return (blockHead - blockTail) & (STEP_ENGINE_BUFFER_SIZE - 1);
+}
+
+void StepEngine::flush() {
+  noInterrupts();
+  currentBlock = nullptr;
+  blockTail = blockHead;
+  interrupts();
+}
+
+void StepEngine::getStats(StepEngineStats& out) const {
+  noInterrupts();
+  out = stats;
+  interrupts();
+}
+
+void StepEngine::resetStats() {
+  noInterrupts();
+  clearStats();
+  interrupts();
+}
+
+void StepEngine::clearStats() {
+  stats.blocksExecuted = 0;
+  stats.underruns = 0;
+  stats.depthSum = 0;
+  stats.minDepth = 0xFF;
+  stats.maxDepth = 0;
+}
+
+StepBlock* StepEngine::reserveBlock() {
+  if (isBufferFull()) return nullptr;
+  return &blocks[blockHead];
+}
+
+void StepEngine::commitBlock() {
+  // Publikasikan blok ke ISR setelah semua field selesai ditulis
+  blockHead = nextIndex(blockHead);
+}
+
+bool StepEngine::queueEvent(StepAction action, long value, unsigned long dwellTicks) {
+  StepBlock* block = reserveBlock();
+  if (block == nullptr) return false;
+  block->stepEventCount = 0;
+  block->action = action;
+  block->actionValue = value;
+  block->dwellTicks = dwellTicks;
+  commitBlock();
+  return true;
+}
+
+bool StepEngine::handleLimitHits() {
+  // Sumbu yang terblokir limit switch: hentikan semua gerakan agar sumbu tetap sinkron
+  bool limitStop = false;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    if (axes[i]->consumeLimitHit()) {
+      Serial.print("WARNING: Limit switch ");
+      Serial.print(axes[i]->getLimitPin());
+      Serial.print(" active for stepper ");
+      Serial.print(axes[i]->getStepPin());
+      Serial.println(". Stopping movement.");
+      limitStop = true;
+    }
+  }
+  if (!limitStop) return false;
+
+  flush();
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    axes[i]->syncTargetToPosition();
+  }
+  return true;
+}
+
+uint16_t StepEngine::intervalForRate(unsigned long rate) {
+  if (rate < MIN_STEP_RATE) rate = MIN_STEP_RATE;
+  return (uint16_t)(STEP_TIMER_FREQ / rate);
+}
+
+// Mulai blok di blockTail: atur pin arah dan profil kecepatan awal
+uint16_t StepEngine::loadBlock(bool fromStandstill) {
+  // Aksi tanpa dwell langsung dijalankan dan dilewati, tanpa jeda di antara blok gerak
+  while (blocks[blockTail].stepEventCount == 0 && blocks[blockTail].dwellTicks == 0) {
+    if (blocks[blockTail].action != nullptr) blocks[blockTail].action(blocks[blockTail].actionValue);
+    blockTail = nextIndex(blockTail);
+    if (blockTail == blockHead) return STEP_IDLE_INTERVAL;
+  }
+  currentBlock = &blocks[blockTail];
+
+  uint8_t depth = bufferedBlocks();
+  stats.blocksExecuted++;
+  stats.depthSum += depth;
+  if (depth < stats.minDepth) stats.minDepth = depth;
+  if (depth > stats.maxDepth) stats.maxDepth = depth;
+
+  if (currentBlock->stepEventCount == 0) {
+    // Dwell: jalankan aksi (jika ada) lalu diam tanpa langkah
+    if (currentBlock->action != nullptr) currentBlock->action(currentBlock->actionValue);
+    dwellRemaining = currentBlock->dwellTicks;
+    return dwellInterval();
+  }
+  uint8_t directionBits = currentBlock->directionBits;
+  base->setStepDirection(!(directionBits & (1 << 0)));
+  shoulder->setStepDirection(!(directionBits & (1 << 1)));
+  elbow->setStepDirection(!(directionBits & (1 << 2)));
+  slider->setStepDirection(!(directionBits & (1 << 3)));
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    counters[i] = -(currentBlock->stepEventCount >> 1);
+  }
+  eventsCompleted = 0;
+  stepRate = currentBlock->initialRate;
+  // Blok yang direncanakan menyambung dari blok sebelumnya, tetapi buffer sempat kosong
+  // (underrun): motor diam, jadi mulai dari kecepatan yang aman.
+  if (fromStandstill && stepRate > currentBlock->safeRate) {
+    stepRate = currentBlock->safeRate;
+    stats.underruns++;
+  }
+  stepInterval = intervalForRate(stepRate);
+  // Mulai dari tengah periode agar perubahan kecepatan pertama tidak terlalu cepat/lambat
+  accelerationTicks = STEP_TICKS_PER_ACCELERATION_TICK / 2;
+  // Langkah pertama satu interval kemudian, memberi waktu setup pin arah
+  return stepInterval;
+}
+
+// Tahan pin step HIGH minimal STEP_PULSE_MIN_US sejak pin terakhir dinaikkan (sumbu yang naik
+// lebih awal mendapat pulsa sedikit lebih lebar). Menambah ~2.5 us ke ISR setiap event langkah.
+void StepEngine::waitStepPulse() {
+#if defined(__AVR__)
+  uint16_t start = TCNT1;
+#else
+  uint16_t start = simStepTimerCount(4);
+#endif
+  while (stepTimerElapsed(start) < STEP_PULSE_MIN_TICKS) {
+  }
+}
+
+// Potongan dwell berikutnya
+uint16_t StepEngine::dwellInterval() {
+  uint16_t interval = (dwellRemaining > STEP_DWELL_MAX_INTERVAL) ? STEP_DWELL_MAX_INTERVAL : (uint16_t)dwellRemaining;
+  dwellRemaining -= interval;
+  return interval;
+}
+
+// Blok saat ini selesai: lepaskan slotnya dan langsung siapkan blok berikutnya
+// agar tidak ada jeda ganda di batas blok
+uint16_t StepEngine::finishBlock() {
+  currentBlock = nullptr;
+  blockTail = nextIndex(blockTail);
+  if (blockTail != blockHead) return loadBlock(false);
+  return STEP_IDLE_INTERVAL;
+}
+
+uint16_t StepEngine::isr() {
+  PROFILE_SCOPE(PROFILE_STEP_ISR);
+  if (currentBlock == nullptr) {
+    if (blockTail == blockHead) return STEP_IDLE_INTERVAL;
+    return loadBlock(true);
+  }
+
+  if (currentBlock->stepEventCount == 0) {
+    if (dwellRemaining > 0) return dwellInterval();
+    return finishBlock();
+  }
+
+  // Bresenham: sumbu i melangkah setiap kali akumulatornya melewati nol. Sumbu dipanggil
+  // lewat tipe konkretnya, jadi pulsa FastAxis inline tanpa vcall
+  bool baseStepped = stepAxis(base, 0);
+  bool shoulderStepped = stepAxis(shoulder, 1);
+  bool elbowStepped = stepAxis(elbow, 2);
+  bool sliderStepped = stepAxis(slider, 3);
+  if (baseStepped || shoulderStepped || elbowStepped || sliderStepped) waitStepPulse();
+  if (baseStepped) base->stepPulseLow();
+  if (shoulderStepped) shoulder->stepPulseLow();
+  if (elbowStepped) elbow->stepPulseLow();
+  if (sliderStepped) slider->stepPulseLow();
+
+  if (++eventsCompleted >= currentBlock->stepEventCount) return finishBlock();
+
+  // Profil trapesium: kecepatan diubah sebesar rateDelta setiap tick akselerasi
+  accelerationTicks += stepInterval;
+  if (accelerationTicks >= STEP_TICKS_PER_ACCELERATION_TICK) {
+    accelerationTicks -= STEP_TICKS_PER_ACCELERATION_TICK;
+    unsigned long newRate = stepRate;
+    if (eventsCompleted <= currentBlock->accelerateUntil) {
+      newRate += currentBlock->rateDelta;
+      if (newRate > currentBlock->nominalRate) newRate = currentBlock->nominalRate;
+    } else if (eventsCompleted > currentBlock->decelerateAfter) {
+      if (newRate > currentBlock->finalRate + currentBlock->rateDelta) {
+        newRate -= currentBlock->rateDelta;
+      } else {
+        newRate = currentBlock->finalRate;
+      }
+    } else {
+      newRate = currentBlock->nominalRate;
+    }
+    if (newRate != stepRate) {
+      stepRate = newRate;
+      stepInterval = intervalForRate(stepRate);
+    }
+  } else if (eventsCompleted == currentBlock->decelerateAfter + 1) {
+    // Awal fase deselerasi: sinkronkan tick akselerasi agar deselerasi mulai tepat waktu
+    accelerationTicks = STEP_TICKS_PER_ACCELERATION_TICK / 2;
+  }
+  return stepInterval;
+}
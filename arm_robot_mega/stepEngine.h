@@ -0,0 +1,158 @@
+// stepEngine.h
+#ifndef STEP_ENGINE_H
+#define STEP_ENGINE_H
+
+#include <Arduino.h>
+#include "RampsStepper.h"
+#include "robotAxes.h"
+
+// Jumlah sumbu yang digerakkan StepEngine: Base, Shoulder, Elbow, Slider
+#define STEP_ENGINE_AXES 4
+// Kapasitas ring buffer blok langkah (harus pangkat dua)
+#define STEP_ENGINE_BUFFER_SIZE 16
+// Frekuensi tick timer: Timer1 dengan prescaler 8 pada 16 MHz = 2 MHz (0.5 us per tick)
+#define STEP_TIMER_FREQ 2000000UL
+// Interval ISR saat tidak ada blok (tick), untuk memeriksa blok baru
+#define STEP_IDLE_INTERVAL 1000
+// Kecepatan diperbarui sebanyak ini per detik selama akselerasi/deselerasi.
+// Pembagian 32-bit untuk interval hanya terjadi pada tick ini, bukan setiap langkah.
+#define ACCELERATION_TICKS_PER_SECOND 200
+#define STEP_TICKS_PER_ACCELERATION_TICK (STEP_TIMER_FREQ / ACCELERATION_TICKS_PER_SECOND)
+// Kecepatan minimum (event/s) agar interval tetap muat di register 16-bit
+#define MIN_STEP_RATE 32
+// Dwell dijalankan dalam potongan sepanjang ini (tick) agar muat di register 16-bit
+#define STEP_DWELL_MAX_INTERVAL 50000
+// Lebar HIGH pulsa step minimum (us): DRV8825 butuh 1.9 us, A4988 1 us. Tulis pin FastPin
+// saja hanya ~1.5 us, jadi ISR menunggu TCNT1 sebelum menurunkan pin step.
+#define STEP_PULSE_MIN_US 2
+// Tick yang ditunggu sejak pin step terakhir naik; +1 karena TCNT1 bisa naik tepat setelah dibaca
+#define STEP_PULSE_MIN_TICKS (STEP_PULSE_MIN_US * (STEP_TIMER_FREQ / 1000000UL) + 1)
+
+// Aksi blok event, dipanggil dari ISR step generator tepat saat blok dicapai.
+// Harus singkat: menulis pin atau memberi target baru ke perangkat lain (mis. gripper).
+typedef void (*StepAction)(long value);
+
+// Satu blok gerakan multi-sumbu yang sudah dihitung sebelumnya.
+// Semua sumbu mulai dan selesai bersama (Bresenham/DDA terhadap sumbu dominan).
+// Semua kecepatan dalam event/s, yaitu langkah/s sumbu dominan.
+// Blok tanpa langkah (stepEventCount == 0) adalah blok event: ISR menjalankan action lalu
+// diam selama dwellTicks. Event tanpa dwell tidak menghentikan gerakan (look-ahead melewatinya),
+// sehingga aksi terjadi tepat di sambungan dua blok gerak; dwell berarti berhenti.
+struct StepBlock {
+  long steps[STEP_ENGINE_AXES]; // Jumlah langkah absolut tiap sumbu
+  uint8_t directionBits;        // Bit i = 1 jika sumbu i bergerak ke arah langkah negatif
+  long stepEventCount;          // Jumlah langkah sumbu dominan (= event Bresenham)
+
+  // Profil trapesium (dihitung oleh Planner)
+  unsigned long nominalRate;    // Kecepatan jelajah
+  unsigned long initialRate;    // Kecepatan awal blok
+  unsigned long finalRate;      // Kecepatan akhir blok
+  unsigned long safeRate;       // Kecepatan start dari diam (jerk), dipakai jika buffer sempat kosong
+  unsigned long rateDelta;      // Perubahan kecepatan per tick akselerasi
+  long accelerateUntil;         // Event terakhir fase akselerasi
+  long decelerateAfter;         // Event pertama fase deselerasi
+
+  // Blok event
+  StepAction action;            // nullptr jika tidak ada aksi (dwell saja)
+  long actionValue;             // Argumen action
+  unsigned long dwellTicks;     // Lama diam setelah aksi (tick timer)
+};
+
+// Statistik pipeline untuk tuning ukuran buffer dan durasi sub-segmen.
+// Kedalaman buffer dicatat setiap kali ISR memulai blok (termasuk blok tersebut).
+struct StepEngineStats {
+  unsigned long blocksExecuted; // Jumlah blok yang dimulai
+  unsigned long underruns;      // Blok yang direncanakan menyambung, tetapi buffer sempat kosong
+  unsigned long depthSum;       // Jumlah kedalaman buffer, untuk rata-rata
+  uint8_t minDepth;             // Kedalaman minimum saat blok dimulai
+  uint8_t maxDepth;             // Kedalaman maksimum saat blok dimulai
+};
+
+class StepEngine {
+public:
+  StepEngine();
+
+  // Hubungkan keempat sumbu dan mulai timer interrupt. Tipe konkret (robotAxes.h), agar ISR
+  // memanggil fungsi langkah FastAxis secara inline.
+  void begin(BaseAxis* base, ShoulderAxis* shoulder, ElbowAxis* elbow, SliderAxis* slider);
+
+  // Produsen (Planner): isi blok yang dikembalikan reserveBlock(), lalu commitBlock().
+  // reserveBlock() mengembalikan nullptr jika buffer penuh.
+  StepBlock* reserveBlock();
+  void commitBlock();
+  // Antrikan blok event (lihat StepBlock). Mengembalikan false jika buffer penuh.
+  bool queueEvent(StepAction action, long value, unsigned long dwellTicks);
+
+  // Dipanggil dari loop: jika ISR memblokir sumbu karena limit switch, laporkan,
+  // buang semua blok, dan samakan target tiap sumbu dengan posisinya.
+  // Mengembalikan true jika gerakan dihentikan.
+  bool handleLimitHits();
+
+  bool isBusy() const;                 // Masih ada blok yang dieksekusi / diantrikan
+  bool isBufferFull() const;
+  uint8_t bufferedBlocks() const;
+  void flush();                        // Buang semua blok dan hentikan gerakan
+
+  RampsStepper* getAxis(uint8_t i) const { return axes[i]; }
+
+  // Salin statistik pipeline secara atomik / mulai periode statistik baru
+  void getStats(StepEngineStats& out) const;
+  void resetStats();
+
+  // Akses buffer untuk look-ahead planner. Blok antara tailIndex() dan headIndex()
+  // (eksklusif) masih diantrikan; blok yang isActive() sedang dieksekusi ISR dan
+  // profilnya tidak boleh diubah.
+  uint8_t headIndex() const { return blockHead; }
+  uint8_t tailIndex() const { return blockTail; }
+  StepBlock* blockAt(uint8_t index) { return &blocks[index]; }
+  bool isActive(uint8_t index) const { return currentBlock == &blocks[index]; }
+  static uint8_t nextIndex(uint8_t i) { return (i + 1) & (STEP_ENGINE_BUFFER_SIZE - 1); }
+  static uint8_t prevIndex(uint8_t i) { return (i - 1) & (STEP_ENGINE_BUFFER_SIZE - 1); }
+
+  // Satu event step generator. Dipanggil dari ISR timer (atau timer simulasi di host).
+  // Mengembalikan interval sampai event berikutnya, dalam tick timer.
+  uint16_t isr();
+
+private:
+  RampsStepper* axes[STEP_ENGINE_AXES]; // Untuk loop (getAxis); ISR memakai pointer bertipe di bawah
+  BaseAxis* base;
+  ShoulderAxis* shoulder;
+  ElbowAxis* elbow;
+  SliderAxis* slider;
+  StepBlock blocks[STEP_ENGINE_BUFFER_SIZE];
+  volatile uint8_t blockHead; // Indeks tulis (loop)
+  volatile uint8_t blockTail; // Indeks baca (ISR)
+
+  // Status eksekusi blok saat ini (hanya diubah oleh ISR)
+  StepBlock* volatile currentBlock;
+  long counters[STEP_ENGINE_AXES];
+  long eventsCompleted;
+  unsigned long stepRate;          // Kecepatan saat ini (event/s)
+  uint16_t stepInterval;           // Interval saat ini (tick)
+  unsigned long accelerationTicks; // Akumulator tick menuju tick akselerasi berikutnya
+  unsigned long dwellRemaining;    // Sisa dwell blok event saat ini (tick)
+
+  StepEngineStats stats;           // Diubah oleh ISR di loadBlock()
+
+  // Bresenham satu sumbu pada event ini; true jika pin step dinaikkan
+  template <class Axis> bool stepAxis(Axis* axis, uint8_t i) {
+    counters[i] += currentBlock->steps[i];
+    if (counters[i] <= 0) return false;
+    counters[i] -= currentBlock->stepEventCount;
+    return axis->stepPulseHigh();
+  }
+  uint16_t loadBlock(bool fromStandstill);
+  uint16_t finishBlock();
+  uint16_t dwellInterval();
+  void waitStepPulse();
+  void clearStats();
+  static uint16_t intervalForRate(unsigned long rate);
+};
+
+#if !defined(__AVR__)
+// Build host (sim/): jam virtual memanggil fungsi ini sebagai pengganti ISR Timer1.
+// Mengembalikan interval sampai compare berikutnya, dalam tick timer.
+uint16_t stepEngineTimerIsr();
+#endif
+
+#endif
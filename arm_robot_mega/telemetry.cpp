@@ -0,0 +1,98 @@
+// telemetry.cpp
+#include "telemetry.h"
+#include "binaryFrame.h"
+
+Telemetry::Telemetry() {
+  engine = nullptr;
+  intervalUs = 0;
+  lastSampleUs = 0;
+  lastLoopUs = 0;
+  loopMaxUs = 0;
+  head = 0;
+  count = 0;
+  sequence = 0;
+  dropped = 0;
+}
+
+void Telemetry::begin(StepEngine* aEngine) {
+  engine = aEngine;
+}
+
+void Telemetry::setInterval(unsigned long aIntervalUs) {
+  if (aIntervalUs > 0 && aIntervalUs < TELEMETRY_MIN_INTERVAL_US) aIntervalUs = TELEMETRY_MIN_INTERVAL_US;
+  intervalUs = aIntervalUs;
+  // Sampel pertama langsung pada update() berikutnya
+  lastSampleUs = micros() - intervalUs;
+  lastLoopUs = 0;
+  loopMaxUs = 0;
+  count = 0;
+  dropped = 0;
+}
+
+void Telemetry::update(uint8_t queueUsed) {
+  if (intervalUs == 0) return;
+
+  unsigned long now = micros();
+  if (lastLoopUs != 0 && now - lastLoopUs > loopMaxUs) loopMaxUs = now - lastLoopUs;
+  lastLoopUs = now;
+
+  if (now - lastSampleUs >= intervalUs) {
+    // Jadwal tetap (bukan now + interval) agar rata-rata laju sampel tepat
+    lastSampleUs += intervalUs;
+    if (now - lastSampleUs >= intervalUs) lastSampleUs = now; // Tertinggal jauh: mulai ulang
+    sample(now, queueUsed);
+  }
+
+  while (count > 0 && Serial.availableForWrite() >= FRAME_TELEMETRY_SIZE) {
+    uint8_t index = (head - count) & (TELEMETRY_BUFFER_SIZE - 1);
+    send(samples[index], (uint8_t)(sequence - count));
+    count--;
+  }
+}
+
+void Telemetry::sample(unsigned long now, uint8_t queueUsed) {
+  TelemetrySample& s = samples[head];
+  s.timeUs = now;
+  s.limitBits = 0;
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) {
+    RampsStepper* axis = engine->getAxis(i);
+    s.position[i] = axis->getPosition();
+    if (axis->isLimitTripped()) s.limitBits |= (1 << i);
+  }
+  s.plannerBlocks = engine->bufferedBlocks();
+  s.queueUsed = queueUsed;
+  s.loopMaxUs = loopMaxUs > 0xFFFF ? 0xFFFF : (uint16_t)loopMaxUs;
+  loopMaxUs = 0;
+
+  head = (head + 1) & (TELEMETRY_BUFFER_SIZE - 1);
+  sequence++;
+  if (count < TELEMETRY_BUFFER_SIZE) {
+    count++;
+  } else if (dropped < 0xFF) {
+    dropped++; // Sampel terlama ditimpa
+  }
+}
+
+// Tulis nilai little-endian ke payload
+static uint8_t* putLE(uint8_t* p, uint32_t value, uint8_t bytes) {
+  for (uint8_t i = 0; i < bytes; i++) {
+    *p++ = value & 0xFF;
+    value >>= 8;
+  }
+  return p;
+}
+
+void Telemetry::send(const TelemetrySample& s, uint8_t seq) {
+  uint8_t payload[FRAME_TELEMETRY_PAYLOAD];
+  uint8_t* p = payload;
+  *p++ = seq;
+  p = putLE(p, s.timeUs, 4);
+  for (uint8_t i = 0; i < STEP_ENGINE_AXES; i++) p = putLE(p, (uint32_t)s.position[i], 4);
+  *p++ = s.plannerBlocks;
+  *p++ = s.queueUsed;
+  p = putLE(p, s.loopMaxUs, 2);
+  *p++ = s.limitBits;
+  *p++ = dropped;
+  dropped = 0;
+  writeTelemetryFrame(payload);
+}
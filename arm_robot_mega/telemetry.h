@@ -0,0 +1,58 @@
+// telemetry.h
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "stepEngine.h"
+
+// Telemetri realtime (M155 T<detik>): setiap interval, loop() menyalin posisi langkah,
+// kedalaman buffer planner, isi antrian perintah, waktu loop() terlama, dan status limit
+// switch ke ring buffer. Sampel dikirim sebagai frame biner 31 byte (binaryFrame.h) hanya
+// jika buffer TX Serial cukup, sehingga loop() dan ISR step tidak pernah menunggu. Jika
+// jalur Serial tidak sanggup, sampel terlama ditimpa dan dihitung sebagai "dropped".
+// Penerima host: python/telemetry.py.
+#define TELEMETRY_BUFFER_SIZE 8
+// Interval terpendek: 200 Hz x 31 byte = ~54% kapasitas 115200 baud
+#define TELEMETRY_MIN_INTERVAL_US 5000UL
+
+struct TelemetrySample {
+  uint32_t timeUs;                       // micros() saat sampel diambil
+  long position[STEP_ENGINE_AXES];       // Posisi langkah aktual tiap sumbu
+  uint8_t plannerBlocks;                 // Blok di buffer StepEngine
+  uint8_t queueUsed;                     // Perintah di antrian
+  uint16_t loopMaxUs;                    // Iterasi loop() terlama sejak sampel sebelumnya
+  uint8_t limitBits;                     // Bit i = limit switch sumbu i terpicu
+};
+
+class Telemetry {
+public:
+  Telemetry();
+  void begin(StepEngine* engine);
+
+  // Interval sampling dalam mikrodetik (0 = mati). Dibatasi TELEMETRY_MIN_INTERVAL_US.
+  void setInterval(unsigned long intervalUs);
+  unsigned long getInterval() const { return intervalUs; }
+  bool isEnabled() const { return intervalUs > 0; }
+
+  // Dipanggil sekali di awal setiap loop(): ukur waktu iterasi, ambil sampel jika sudah
+  // waktunya, lalu kirim sampel dari ring selama buffer TX masih muat satu frame.
+  void update(uint8_t queueUsed);
+
+private:
+  StepEngine* engine;
+  unsigned long intervalUs;
+  unsigned long lastSampleUs;
+  unsigned long lastLoopUs;
+  unsigned long loopMaxUs;
+
+  TelemetrySample samples[TELEMETRY_BUFFER_SIZE];
+  uint8_t head;      // Slot sampel berikutnya
+  uint8_t count;     // Sampel yang belum dikirim
+  uint8_t sequence;  // Nomor sampel berikutnya
+  uint8_t dropped;   // Sampel yang ditimpa sejak frame terakhir dikirim
+
+  void sample(unsigned long now, uint8_t queueUsed);
+  void send(const TelemetrySample& s, uint8_t seq);
+};
+
+#endif
@@ -0,0 +1,113 @@
+"""Uji jangkauan titik ambil di PC dengan pustaka libarmreach (arm_robot_mega/host/armReach.h).
+
+Pustaka dibangun dari robotGeometry.cpp firmware, jadi status sama dengan jawaban M870
+dan dengan penolakan G0/G1 di firmware: OK, TOO_FAR, TOO_CLOSE, JOINT_LIMIT. Satu panggilan
+menguji sekumpulan titik, sehingga deteksi yang tidak terjangkau dapat dibuang sebelum
+dikirim ke antrian robot.
+
+Bangun pustaka dulu:
+  arm_robot_mega/host/build.sh python/libarmreach.so
+
+Penggunaan:
+  python arm_reach.py titik.csv                 (baris "x,y,z" dalam mm)
+  python arm_reach.py titik.csv --l2 140 --zero 90 -14 -91.77 --slider 20
+"""
+import argparse
+import ctypes
+import math
+import os
+import sys
+
+STATUS_NAMES = ("OK", "TOO_FAR", "TOO_CLOSE", "JOINT_LIMIT")
+DEFAULT_LIBRARY = os.path.join(os.path.dirname(os.path.abspath(__file__)), "libarmreach.so")
+
+
+class ArmReachConfig(ctypes.Structure):
+    """Sama dengan ArmReachConfig di armReach.h."""
+    _fields_ = [
+        ("l1", ctypes.c_float), ("l2", ctypes.c_float), ("l3", ctypes.c_float),
+        ("ee_forward", ctypes.c_float), ("ee_down", ctypes.c_float),
+        ("zero_deg", ctypes.c_float * 3),
+        ("joint_min_deg", ctypes.c_float * 3),
+        ("joint_max_deg", ctypes.c_float * 3),
+        ("slider_mm", ctypes.c_float),
+        ("elbow_down", ctypes.c_int32),
+    ]
+
+
+class ArmReach:
+    def __init__(self, library=DEFAULT_LIBRARY):
+        self.lib = ctypes.CDLL(library)
+        self.lib.armReachDefaults.argtypes = [ctypes.POINTER(ArmReachConfig)]
+        self.lib.armReachDefaults.restype = None
+        self.lib.armReachCheck.argtypes = [
+            ctypes.POINTER(ArmReachConfig), ctypes.POINTER(ctypes.c_float), ctypes.c_int32,
+            ctypes.POINTER(ctypes.c_uint8), ctypes.POINTER(ctypes.c_float)]
+        self.lib.armReachCheck.restype = ctypes.c_int32
+        self.config = ArmReachConfig()
+        self.lib.armReachDefaults(ctypes.byref(self.config))
+
+    def check(self, points):
+        """points: daftar (x, y, z) mm -> daftar (status, (base, shoulder, elbow) derajat)."""
+        count = len(points)
+        flat = (ctypes.c_float * (3 * count))(*[v for p in points for v in p])
+        status = (ctypes.c_uint8 * count)()
+        joints = (ctypes.c_float * (3 * count))()
+        self.lib.armReachCheck(ctypes.byref(self.config), flat, count, status, joints)
+        return [(STATUS_NAMES[status[i]], tuple(joints[3 * i:3 * i + 3])) for i in range(count)]
+
+    def reachable(self, points):
+        """Hanya titik yang terjangkau, urutan tetap."""
+        return [p for p, (status, _) in zip(points, self.check(points)) if status == "OK"]
+
+
+def load_points(stream):
+    points = []
+    for line in stream:
+        line = line.split("#", 1)[0].strip()
+        if line:
+            points.append(tuple(float(v) for v in line.replace(",", " ").split()[:3]))
+    return points
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Uji jangkauan titik ambil (pustaka libarmreach)")
+    parser.add_argument("points", nargs="?", help="berkas titik x,y,z per baris (default stdin)")
+    parser.add_argument("--library", default=DEFAULT_LIBRARY)
+    parser.add_argument("--l1", type=float, help="panjang link L1 (M665 X)")
+    parser.add_argument("--l2", type=float, help="panjang link L2 (M665 Y)")
+    parser.add_argument("--l3", type=float, help="panjang link L3 (M665 Z)")
+    parser.add_argument("--ee", type=float, nargs=2, metavar=("MAJU", "TURUN"), help="offset end-effector (M666 X Z)")
+    parser.add_argument("--zero", type=float, nargs=3, metavar=("BASE", "SHOULDER", "ELBOW"),
+                        help="sudut nol kinematik (M206 X Y Z)")
+    parser.add_argument("--slider", type=float, default=0.0, help="posisi slider mm")
+    parser.add_argument("--elbow-up", action="store_true", help="solusi Elbow Up (firmware: Elbow Down)")
+    args = parser.parse_args()
+
+    reach = ArmReach(args.library)
+    config = reach.config
+    for name in ("l1", "l2", "l3"):
+        if getattr(args, name) is not None:
+            setattr(config, name, getattr(args, name))
+    if args.ee:
+        config.ee_forward, config.ee_down = args.ee
+    if args.zero:
+        config.zero_deg[:] = args.zero
+    config.slider_mm = args.slider
+    config.elbow_down = 0 if args.elbow_up else 1
+
+    if args.points:
+        with open(args.points) as stream:
+            points = load_points(stream)
+    else:
+        points = load_points(sys.stdin)
+    results = reach.check(points)
+    for (x, y, z), (status, joints) in zip(points, results):
+        angles = "" if math.isnan(joints[0]) else " A%.2f B%.2f C%.2f" % joints
+        print("%s X%.2f Y%.2f Z%.2f%s" % (status, x, y, z, angles))
+    ok = sum(1 for status, _ in results if status == "OK")
+    print("%d/%d titik terjangkau" % (ok, len(points)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
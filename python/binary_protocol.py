@@ -0,0 +1,334 @@
+"""Frame perintah biner untuk firmware arm_robot_mega (lihat arm_robot_mega/binaryFrame.h).
+
+Frame dapat dicampur dengan baris G-code ASCII; byte SYNC 0xA5 tidak pernah muncul di G-code.
+- Host -> firmware: [0xA5][seq][len][id][num u16][present][ext][short][nilai LE][crc16 LE]
+  Bit present 0..5 = X Y Z E F T; bit 7 = byte ext ada, bit ext 0..2 = I J R (G2/G3), nilainya
+  setelah nilai present. Bit present 6 = byte short ada: bit i = nilai i 16-bit; bit ext 4..6
+  sama untuk I J R. Nilai lain 24-bit. Tanpa I/J/R tidak ada byte ext, tanpa nilai 16-bit tidak
+  ada byte short. Nilai adalah fixed point bertanda dalam satuan 0.01 (T 0.001): +-327.67 mm
+  dalam 16 bit, +-83886.07 mm dalam 24 bit; nilai dengan lebih banyak desimal dibulatkan, dan
+  perintah dengan nilai di luar jangkauan dikirim sebagai teks. CRC-16/XMODEM atas seq sampai
+  payload terakhir.
+  Frame sync (id 0) menyamakan urutan: perintah berikutnya memakai seq + 1.
+- Firmware -> host: [0xA5][seq][status][Q][B][crc16 LE], 7 byte per perintah. Q dan B sama
+  dengan ack teks "OK Q.. B..". Selama host mengirim frame, echo teks G0/G1 dimatikan.
+- Telemetri (M155, lihat telemetry.py): [0xA6][len][payload][crc16 LE] dapat muncul di antara
+  baris teks dan balasan; ReplyReader meneruskannya ke callback on_telemetry.
+- Host menghitung byte frame yang belum dijawab agar muat di buffer RX (seperti
+  gcode_sender.py). Balasan OK bersifat kumulatif; CRC/sequence error berarti kirim ulang
+  mulai dari seq di balasan (go-back-N). Frame yang tidak dijawab sampai timeout port
+  (mis. byte SYNC rusak) juga dikirim ulang.
+
+Penggunaan:
+  python binary_protocol.py program.gcode --port COM3
+  python binary_protocol.py program.gcode --sim ../arm_sim
+"""
+import argparse
+import collections
+import re
+import struct
+import sys
+import time
+
+from gcode_sender import READY_BANNER, RX_WINDOW_DEFAULT, SimPort, load_program
+
+FRAME_SYNC = 0xA5
+FRAME_TELEMETRY_SYNC = 0xA6
+FRAME_ID_SYNC = 0
+FRAME_REPLY_SIZE = 7
+FIELDS = "XYZEFTIJR"
+BASE_FIELD_COUNT = 6  # Bit byte present; sisanya di byte ext
+PRESENT_EXT = 0x80
+PRESENT_SHORT = 0x40
+EXT_SHORT_SHIFT = 4  # Bit ext 4..6: I J R 16-bit
+FIXED_MAX = 0x7FFFFF  # 24-bit bertanda
+SHORT_MAX = 0x7FFF
+
+STATUS_OK = 0
+STATUS_DUPLICATE = 1
+STATUS_CRC_ERROR = 2
+STATUS_SEQUENCE_ERROR = 3
+STATUS_UNKNOWN_COMMAND = 4
+STATUS_REJECTED = 6  # Diterima, tetapi nilai M665/M666 di luar batas; tidak masuk antrian
+
+SYNC_SEQ = 0xFF  # Perintah pertama memakai seq 0
+
+Reply = collections.namedtuple("Reply", "seq status queue_free rx_free")
+
+_WORD = re.compile(r"([A-Z])([-+]?(?:\d+\.?\d*|\.\d+))")
+
+
+def crc16(data, crc=0):
+    """CRC-16/XMODEM (poly 0x1021, init 0), sama dengan _crc_xmodem_update() di AVR."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def _float32(value):
+    return struct.unpack("<f", struct.pack("<f", value))[0]
+
+
+def to_fixed(letter, value):
+    """Nilai -> fixed point frame (0.01, T 0.001), dibulatkan ke titik terdekat.
+
+    Dihitung dalam float 32-bit seperti packFrame() (binaryFrame.cpp), agar nilai di
+    tengah dua titik grid dibulatkan ke arah yang sama.
+    """
+    scaled = _float32(abs(_float32(value)) * (1000 if letter == "T" else 100))
+    fixed = int(scaled + 0.5)
+    return -fixed if value < 0 else fixed
+
+
+def parse_command(line):
+    """"G1 X10 Y20 F3000" -> ("G", 1, {"X": 10.0, ...}); None jika bukan perintah G/M/P
+    atau ada nilai di luar jangkauan frame (baris itu dikirim sebagai teks)."""
+    line = line.split(";", 1)[0].strip().upper()
+    match = re.match(r"([GMP])(\d+)", line)
+    if not match:
+        return None
+    values = {}
+    for letter, number in _WORD.findall(line[match.end():]):
+        if letter in FIELDS:
+            values[letter] = float(number)
+            if abs(to_fixed(letter, values[letter])) > FIXED_MAX:
+                return None
+    return match.group(1), int(match.group(2)), values
+
+
+def encode_frame(seq, command_id, number, values):
+    present = 0
+    short = 0
+    data = b""
+    for i, letter in enumerate(FIELDS):
+        if letter not in values:
+            continue
+        fixed = to_fixed(letter, values[letter])
+        present |= 1 << i
+        if -SHORT_MAX - 1 <= fixed <= SHORT_MAX:
+            short |= 1 << i
+            data += struct.pack("<h", fixed)
+        else:
+            data += struct.pack("<i", fixed)[:3]
+    base_mask = (1 << BASE_FIELD_COUNT) - 1
+    flags = present & base_mask
+    header = b""
+    ext = (present >> BASE_FIELD_COUNT) | ((short >> BASE_FIELD_COUNT) << EXT_SHORT_SHIFT)
+    if ext:
+        flags |= PRESENT_EXT
+        header += bytes([ext])
+    if short & base_mask:
+        flags |= PRESENT_SHORT
+        header += bytes([short & base_mask])
+    payload = struct.pack("<BHB", command_id, number & 0xFFFF, flags) + header + data
+    body = bytes([seq & 0xFF, len(payload)]) + payload
+    return bytes([FRAME_SYNC]) + body + struct.pack("<H", crc16(body))
+
+
+def encode_command(seq, command):
+    command_id, number, values = command
+    return encode_frame(seq, ord(command_id), number, values)
+
+
+def encode_sync(seq=SYNC_SEQ):
+    return encode_frame(seq, FRAME_ID_SYNC, 0, {})
+
+
+class ReplyReader:
+    """Pisahkan frame balasan biner dari baris teks firmware pada satu port.
+
+    Payload frame telemetri diteruskan ke on_telemetry, dan read() mengembalikan str
+    kosong seperti baris teks kosong, sehingga pengirim tidak perlu mengetahuinya.
+    """
+
+    def __init__(self, port, log=None, on_telemetry=None):
+        self.port = port
+        self.log = log
+        self.on_telemetry = on_telemetry
+
+    def read(self):
+        """Kembalikan Reply, str (baris teks), atau None jika timeout."""
+        first = self.port.read(1)
+        if not first:
+            return None
+        if first[0] == FRAME_TELEMETRY_SYNC:
+            self._read_telemetry()
+            return ""
+        if first[0] == FRAME_SYNC:
+            rest = self.port.read(FRAME_REPLY_SIZE - 1)
+            if len(rest) < FRAME_REPLY_SIZE - 1:
+                return None
+            frame = first + rest
+            if crc16(frame[1:5]) != frame[5] | (frame[6] << 8):
+                return None
+            reply = Reply(*frame[1:5])
+            if self.log:
+                self.log(f"<frame seq={reply.seq} status={reply.status} Q={reply.queue_free} B={reply.rx_free}>")
+            return reply
+        line = (first + self.port.readline()).decode(errors="replace").strip()
+        if self.log and line:
+            self.log(line)
+        return line
+
+    def _read_telemetry(self):
+        header = self.port.read(1)
+        if not header:
+            return
+        rest = self.port.read(header[0] + 2)
+        if len(rest) < header[0] + 2:
+            return
+        payload = rest[:-2]
+        if crc16(header + payload) != rest[-2] | (rest[-1] << 8):
+            return
+        if self.on_telemetry:
+            self.on_telemetry(payload)
+
+
+class BinarySender:
+    def __init__(self, port, log=None, on_telemetry=None):
+        self.port = port
+        self.reader = ReplyReader(port, log, on_telemetry)
+        # Tanpa balasan selama ini (teks dan telemetri tidak dihitung), frame dianggap hilang
+        self.reply_timeout = getattr(port, "timeout", None) or 2.0
+
+    def wait_ready(self, timeout=120.0):
+        """Tunggu banner setelah reset/homing."""
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            reply = self.reader.read()
+            if isinstance(reply, str) and READY_BANNER in reply:
+                return True
+        return False
+
+    def stream(self, lines):
+        """Kirim semua baris (G/M/P sebagai frame, sisanya teks) dan kembalikan statistik."""
+        commands = [parse_command(line) for line in lines]
+        stats = {"lines": 0, "bytes": 0, "resends": 0, "queue_free_min": None}
+
+        # Frame sync; balasannya memberi kapasitas buffer RX
+        window = None
+        while window is None:
+            sync = encode_sync()
+            self.port.write(sync)
+            stats["bytes"] += len(sync)
+            reply = self.reader.read()
+            while isinstance(reply, str):
+                reply = self.reader.read()
+            if reply is not None and reply.status == STATUS_OK:
+                window = reply.rx_free or RX_WINDOW_DEFAULT
+
+        in_flight = collections.deque()  # (indeks, seq, byte)
+        in_flight_bytes = 0
+        stale_bytes = 0  # Frame yang dibatalkan saat rewind, mungkin masih di buffer RX
+        seq_index = {}
+        next_seq = 0
+        index = 0
+        acked = 0  # Baris sebelum indeks ini sudah diterima firmware
+        start = time.monotonic()
+        last_progress = start  # Balasan terakhir, atau frame pertama setelah semua dijawab
+
+        while acked < len(commands):
+            while index < len(commands):
+                command = commands[index]
+                if command is None:
+                    # Perintah debug (POS, J0..J3, GOTO) sebagai teks, setelah semua frame diterima
+                    if in_flight or stale_bytes:
+                        break
+                    data = (lines[index] + "\n").encode()
+                    self.port.write(data)
+                    stats["bytes"] += len(data)
+                    index += 1
+                    acked = index
+                    stats["lines"] += 1
+                    continue
+                frame = encode_command(next_seq, command)
+                # Frame pertama setelah rewind selalu boleh dikirim agar pengiriman ulang tidak macet
+                if in_flight and in_flight_bytes + stale_bytes + len(frame) > window:
+                    break
+                if not in_flight:
+                    last_progress = time.monotonic()
+                self.port.write(frame)
+                stats["bytes"] += len(frame)
+                seq_index[next_seq] = index
+                in_flight.append((index, next_seq, len(frame)))
+                in_flight_bytes += len(frame)
+                next_seq = (next_seq + 1) & 0xFF
+                index += 1
+
+            if not in_flight:
+                continue
+            reply = self.reader.read()
+            if isinstance(reply, str):
+                if time.monotonic() - last_progress < self.reply_timeout:
+                    continue
+                reply = None
+            else:
+                last_progress = time.monotonic()
+            if reply is None or reply.status in (STATUS_CRC_ERROR, STATUS_SEQUENCE_ERROR):
+                # Go-back-N: kirim ulang mulai dari frame tertua yang belum diterima
+                stale_bytes += in_flight_bytes
+                next_seq = in_flight[0][1] if reply is None else reply.seq
+                in_flight.clear()
+                in_flight_bytes = 0
+                index = acked
+                stats["resends"] += 1
+                continue
+
+            if stats["queue_free_min"] is None or reply.queue_free < stats["queue_free_min"]:
+                stats["queue_free_min"] = reply.queue_free
+            # Balasan kumulatif: semua frame sampai seq sudah diterima
+            while in_flight and ((reply.seq - in_flight[0][1]) & 0xFF) < 128:
+                in_flight_bytes -= in_flight.popleft()[2]
+            stale_bytes = 0
+            if reply.seq in seq_index and seq_index[reply.seq] + 1 > acked:
+                stats["lines"] += seq_index[reply.seq] + 1 - acked
+                acked = seq_index[reply.seq] + 1
+            if index < acked:
+                index = acked
+                next_seq = (reply.seq + 1) & 0xFF
+
+        elapsed = time.monotonic() - start
+        stats["seconds"] = elapsed
+        stats["lines_per_s"] = stats["lines"] / elapsed if elapsed > 0 else 0.0
+        stats["rx_window"] = window
+        return stats
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Kirim program G-code sebagai frame biner")
+    parser.add_argument("program")
+    target = parser.add_mutually_exclusive_group(required=True)
+    target.add_argument("--port", help="port serial, mis. COM3 atau /dev/ttyACM0")
+    target.add_argument("--sim", help="path arm_sim (simulasi host)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=2.0, help="detik tanpa balasan sebelum frame dikirim ulang")
+    parser.add_argument("--no-wait", action="store_true", help="jangan tunggu banner siap setelah koneksi")
+    parser.add_argument("--verbose", action="store_true", help="tampilkan output firmware")
+    args = parser.parse_args()
+
+    lines = load_program(args.program)
+    if args.sim:
+        port = SimPort(args.sim, timeout=args.timeout)
+    else:
+        import serial
+        port = serial.Serial(args.port, args.baud, timeout=args.timeout)
+
+    log = (lambda line: print("<<", line, file=sys.stderr)) if args.verbose else None
+    sender = BinarySender(port, log)
+    if not args.no_wait and not sender.wait_ready():
+        print("Firmware tidak mengirim banner siap", file=sys.stderr)
+        return 1
+
+    stats = sender.stream(lines)
+    port.close()
+    print(f"{stats['lines']} perintah dalam {stats['seconds']:.2f} s: {stats['lines_per_s']:.1f} perintah/s, "
+          f"{stats['bytes']} byte, resend {stats['resends']}, "
+          f"Q minimum {stats['queue_free_min']}, jendela RX {stats['rx_window']} byte")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
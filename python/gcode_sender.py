@@ -0,0 +1,263 @@
+"""Pengirim G-code streaming untuk firmware arm_robot_mega.
+
+Protokol (lihat sendAck() di arm_robot_mega.ino):
+- Setiap baris dikirim sebagai "N<n> <perintah>*<checksum>" (checksum = XOR semua byte
+  sebelum '*'). "M110 N0" di awal menyamakan nomor baris.
+- Firmware menjawab setiap perintah G/M/P dengan "OK Q<slot antrian kosong> B<byte RX kosong>".
+  Saat antrian perintah penuh, firmware tidak membaca baris berikutnya, jadi ack tertunda
+  dan tidak ada perintah yang ditolak.
+- Host menghitung byte baris yang belum di-ack dan terus mengirim selama totalnya muat di
+  buffer RX firmware (kapasitasnya dipelajari dari B pada ack pertama). Baris berikutnya
+  sudah menunggu di buffer saat firmware siap, jadi tidak ada round-trip yang ditunggu.
+- "Resend: n" (checksum atau nomor baris salah) mengulang pengiriman mulai dari baris n.
+- "Error: Unknown command ..." menjawab baris yang ditolak saat dibaca (kreditnya kembali).
+  "Alarm: ..." muncul saat perintah yang sudah di-ack dieksekusi (target tidak terjangkau,
+  busur tidak valid, makro tidak dikenal): bukan jawaban baris, jadi hanya dicatat.
+- Baris lebih panjang dari COMMAND_LINE_MAX tidak pernah dieksekusi firmware ("Error: Line
+  too long"); pengirim menolaknya sebelum dikirim agar tidak diulang terus lewat Resend.
+
+Penggunaan:
+  python gcode_sender.py program.gcode --port COM3
+  python gcode_sender.py program.gcode --sim ../arm_sim      (simulasi host, mode --link)
+"""
+import argparse
+import collections
+import select
+import subprocess
+import sys
+import time
+
+READY_BANNER = "Robot siap menerima perintah"
+RX_WINDOW_DEFAULT = 63  # Buffer RX HardwareSerial 64 byte
+COMMAND_LINE_MAX = 96  # command.h, tanpa terminator
+# Penolakan sinkron yang menjawab baris tertua yang belum dijawab. Checksum, Line number, dan
+# Line too long (baris bernomor) diikuti "Resend", yang menjawab baris tersebut.
+SYNC_ERRORS = ("Error: Unknown command", "Error: Command queue is full")
+
+
+def checksum(text):
+    value = 0
+    for c in text.encode():
+        value ^= c
+    return value
+
+
+def frame_line(number, command):
+    """Bentuk baris bernomor dengan checksum, termasuk terminator."""
+    text = f"N{number} {command}"
+    return f"{text}*{checksum(text)}\n".encode()
+
+
+def parse_ack(line):
+    """Ambil field Q dan B dari "OK Q.. B..", None jika tidak ada."""
+    fields = {}
+    for word in line.split()[1:]:
+        if len(word) > 1 and word[1:].isdigit():
+            fields[word[0]] = int(word[1:])
+    return fields.get("Q"), fields.get("B")
+
+
+def load_program(path):
+    """Baca file G-code: buang komentar ';' dan baris kosong."""
+    lines = []
+    with open(path) as f:
+        for raw in f:
+            line = raw.split(";", 1)[0].strip()
+            if line:
+                lines.append(line)
+    return lines
+
+
+class SimPort:
+    """Port serial tiruan: simulasi firmware (arm_sim --link) lewat stdin/stdout.
+
+    read() dan readline() berperilaku seperti serial.Serial: mengembalikan data yang
+    sempat diterima (b"" jika kosong) setelah timeout detik tanpa byte baru.
+    """
+
+    def __init__(self, sim_path, extra_args=(), timeout=5.0):
+        self.proc = subprocess.Popen([sim_path, "--link", *extra_args], bufsize=0,
+                                     stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        self.timeout = timeout
+
+    def write(self, data):
+        self.proc.stdin.write(data)
+        self.proc.stdin.flush()
+
+    def read(self, size=1):
+        data = b""
+        while len(data) < size:
+            ready, _, _ = select.select([self.proc.stdout], [], [], self.timeout)
+            if not ready:
+                break
+            chunk = self.proc.stdout.read(size - len(data))
+            if not chunk:
+                break
+            data += chunk
+        return data
+
+    def readline(self):
+        line = b""
+        while not line.endswith(b"\n"):
+            c = self.read(1)
+            if not c:
+                break
+            line += c
+        return line
+
+    def close(self):
+        self.proc.stdin.close()
+        self.proc.wait()
+
+
+class StreamingSender:
+    def __init__(self, port, log=None):
+        self.port = port
+        self.log = log
+        self.next_number = 1
+
+    def _readline(self):
+        raw = self.port.readline()
+        if not raw:
+            raise TimeoutError("Tidak ada jawaban dari firmware")
+        line = raw.decode(errors="replace").strip()
+        if self.log and line:
+            self.log(line)
+        return line
+
+    def wait_ready(self, timeout=120.0):
+        """Tunggu banner setelah reset/homing."""
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            try:
+                if READY_BANNER in self._readline():
+                    return True
+            except TimeoutError:
+                pass
+        return False
+
+    def stream(self, commands):
+        """Kirim semua perintah dan kembalikan statistik pengiriman."""
+        stats = {"lines": 0, "bytes": 0, "resends": 0, "alarms": 0, "queue_free_min": None}
+        for command in commands:
+            # Perkiraan terburuk nomor baris N<n> untuk program ini
+            if len(frame_line(len(commands), command)) - 1 > COMMAND_LINE_MAX:
+                raise ValueError(f"Baris lebih dari {COMMAND_LINE_MAX} karakter: {command}")
+
+        # Sinkronkan nomor baris; ack-nya juga memberi kapasitas buffer RX
+        sync = b"M110 N0*%d\n" % checksum("M110 N0")
+        self.port.write(sync)
+        stats["bytes"] += len(sync)
+        window = RX_WINDOW_DEFAULT
+        while True:
+            line = self._readline()
+            if line.startswith("OK"):
+                _, free_rx = parse_ack(line)
+                if free_rx:
+                    window = free_rx
+                break
+        self.next_number = 1
+
+        # Antrian baris yang sudah dikirim tetapi belum dijawab: (indeks, nomor, byte)
+        in_flight = collections.deque()
+        in_flight_bytes = 0
+        # Byte perintah debug (tanpa ack) ikut dihitung sampai ack berikutnya tiba
+        unacked_extra = 0
+        index = 0
+        start = time.monotonic()
+
+        while index < len(commands) or in_flight:
+            while index < len(commands):
+                command = commands[index]
+                data = frame_line(self.next_number, command)
+                if command[0] not in "GMP":
+                    # POS, J0..J3, GOTO tidak di-ack: kirim setelah baris sebelumnya selesai
+                    if in_flight:
+                        break
+                    self.port.write(data)
+                    unacked_extra += len(data)
+                    stats["bytes"] += len(data)
+                    stats["lines"] += 1
+                    self.next_number += 1
+                    index += 1
+                    continue
+                # Baris pertama selalu boleh dikirim, meski lebih panjang dari jendela
+                if in_flight and in_flight_bytes + unacked_extra + len(data) > window:
+                    break
+                self.port.write(data)
+                in_flight.append((index, self.next_number, len(data) + unacked_extra))
+                in_flight_bytes += len(data) + unacked_extra
+                unacked_extra = 0
+                stats["bytes"] += len(data)
+                self.next_number += 1
+                index += 1
+
+            if not in_flight:
+                continue
+            line = self._readline()
+            if line.startswith("OK"):
+                free_queue, _ = parse_ack(line)
+                if free_queue is not None and (stats["queue_free_min"] is None or free_queue < stats["queue_free_min"]):
+                    stats["queue_free_min"] = free_queue
+                _, _, size = in_flight.popleft()
+                in_flight_bytes -= size
+                stats["lines"] += 1
+            elif line.startswith("Resend:"):
+                number = int(line.split(":", 1)[1])
+                head_index, head_number, size = in_flight.popleft()
+                in_flight_bytes -= size
+                # Baris setelahnya juga ditolak dengan "Resend" untuk nomor yang sama;
+                # hanya baris yang diminta yang memicu pengiriman ulang
+                if head_number == number:
+                    index = head_index
+                    self.next_number = number
+                    stats["resends"] += 1
+            elif line.startswith("Alarm:"):
+                stats["alarms"] += 1
+            elif line.startswith(SYNC_ERRORS):
+                # Baris ditolak saat dibaca: firmware sudah membuang byte-nya
+                _, _, size = in_flight.popleft()
+                in_flight_bytes -= size
+                stats["lines"] += 1
+
+        elapsed = time.monotonic() - start
+        stats["seconds"] = elapsed
+        stats["lines_per_s"] = stats["lines"] / elapsed if elapsed > 0 else 0.0
+        stats["rx_window"] = window
+        return stats
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Kirim program G-code dengan protokol streaming")
+    parser.add_argument("program")
+    target = parser.add_mutually_exclusive_group(required=True)
+    target.add_argument("--port", help="port serial, mis. COM3 atau /dev/ttyACM0")
+    target.add_argument("--sim", help="path arm_sim (simulasi host)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--no-wait", action="store_true", help="jangan tunggu banner siap setelah koneksi")
+    parser.add_argument("--verbose", action="store_true", help="tampilkan output firmware")
+    args = parser.parse_args()
+
+    commands = load_program(args.program)
+    if args.sim:
+        port = SimPort(args.sim)
+    else:
+        import serial
+        port = serial.Serial(args.port, args.baud, timeout=5)
+
+    log = (lambda line: print("<<", line, file=sys.stderr)) if args.verbose else None
+    sender = StreamingSender(port, log)
+    if not args.no_wait and not sender.wait_ready():
+        print("Firmware tidak mengirim banner siap", file=sys.stderr)
+        return 1
+
+    stats = sender.stream(commands)
+    port.close()
+    print(f"{stats['lines']} baris dalam {stats['seconds']:.2f} s: {stats['lines_per_s']:.1f} perintah/s, "
+          f"{stats['bytes']} byte, resend {stats['resends']}, alarm {stats['alarms']}, "
+          f"Q minimum {stats['queue_free_min']}, jendela RX {stats['rx_window']} byte")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
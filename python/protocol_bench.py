@@ -0,0 +1,116 @@
+"""Bandingkan throughput pengiriman ASCII (gcode_sender.py) dan frame biner (binary_protocol.py).
+
+Setiap protokol dijalankan pada simulasi firmware baru (arm_sim --link, berjalan real time)
+atau pada robot lewat port serial, lalu dicetak perintah/detik dan byte per perintah di
+kedua arah. Sebelumnya dicetak ukuran tiap perintah G/M/P program sebagai baris ASCII dan
+sebagai frame biner (nilai fixed point 16/24-bit, lihat binary_protocol.py). Program dengan gerak nol (sim/bench/dense_commands.gcode) mengukur batas
+protokol itu sendiri; program gerak biasa dibatasi oleh kecepatan motor.
+
+Penggunaan:
+  python protocol_bench.py ../arm_robot_mega/sim/bench/dense_commands.gcode --sim ../arm_sim
+  python protocol_bench.py program.gcode --port /dev/ttyACM0 --json hasil.json
+"""
+import argparse
+import json
+import sys
+
+from binary_protocol import BinarySender, encode_command, parse_command
+from gcode_sender import SimPort, StreamingSender, load_program
+
+SENDERS = {"ascii": StreamingSender, "binary": BinarySender}
+
+
+class CountingPort:
+    """Hitung byte yang diterima dari firmware setelah banner siap."""
+
+    def __init__(self, port):
+        self.port = port
+        self.bytes_in = 0
+        self.counting = False
+
+    def write(self, data):
+        self.port.write(data)
+
+    def read(self, size=1):
+        data = self.port.read(size)
+        if self.counting:
+            self.bytes_in += len(data)
+        return data
+
+    def readline(self):
+        data = self.port.readline()
+        if self.counting:
+            self.bytes_in += len(data)
+        return data
+
+    def close(self):
+        self.port.close()
+
+
+def encoded_sizes(lines):
+    """Byte per perintah G/M/P: baris ASCII (dengan newline) dan frame biner."""
+    ascii_bytes = frame_bytes = commands = text = 0
+    for line in lines:
+        command = parse_command(line)
+        if command is None:
+            text += 1
+            continue
+        commands += 1
+        ascii_bytes += len(line.encode()) + 1
+        frame_bytes += len(encode_command(0, command))
+    return {"commands": commands, "text_lines": text,
+            "ascii_bytes_per_command": ascii_bytes / max(commands, 1),
+            "frame_bytes_per_command": frame_bytes / max(commands, 1)}
+
+
+def run(protocol, lines, args):
+    if args.sim:
+        raw = SimPort(args.sim, timeout=2.0)
+    else:
+        import serial
+        raw = serial.Serial(args.port, args.baud, timeout=2.0)
+    port = CountingPort(raw)
+    sender = SENDERS[protocol](port)
+    if not sender.wait_ready():
+        raise RuntimeError("Firmware tidak mengirim banner siap")
+    port.counting = True
+    stats = sender.stream(lines)
+    port.close()
+    stats["bytes_in"] = port.bytes_in
+    stats["bytes_per_command"] = stats["bytes"] / max(stats["lines"], 1)
+    stats["bytes_in_per_command"] = port.bytes_in / max(stats["lines"], 1)
+    return stats
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark protokol ASCII vs frame biner")
+    parser.add_argument("program")
+    target = parser.add_mutually_exclusive_group(required=True)
+    target.add_argument("--port", help="port serial (robot di-reset setiap protokol)")
+    target.add_argument("--sim", help="path arm_sim (simulasi host)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--json", help="tulis hasil ke file JSON")
+    args = parser.parse_args()
+
+    lines = load_program(args.program)
+    sizes = encoded_sizes(lines)
+    print(f"encoding: {sizes['commands']} perintah, {sizes['ascii_bytes_per_command']:.1f} byte/perintah ASCII, "
+          f"{sizes['frame_bytes_per_command']:.1f} byte/perintah frame ({sizes['text_lines']} baris tetap teks)")
+    results = {"encoding": sizes}
+    for protocol in SENDERS:
+        stats = run(protocol, lines, args)
+        results[protocol] = stats
+        print(f"{protocol:>6}: {stats['lines_per_s']:7.1f} perintah/s, "
+              f"{stats['bytes_per_command']:5.1f} byte/perintah ke firmware, "
+              f"{stats['bytes_in_per_command']:5.1f} byte/perintah dari firmware, resend {stats['resends']}")
+    if results["ascii"]["lines_per_s"] > 0:
+        print(f"speedup: {results['binary']['lines_per_s'] / results['ascii']['lines_per_s']:.2f}x")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
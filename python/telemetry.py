@@ -0,0 +1,147 @@
+"""Penerima telemetri realtime firmware arm_robot_mega (M155, lihat arm_robot_mega/telemetry.h).
+
+Firmware mengirim frame [0xA6][len][payload][crc16 LE] setiap interval M155 T<detik>.
+Payload (little-endian): nomor sampel, waktu us, posisi langkah Base/Shoulder/Elbow/Slider,
+blok di buffer planner, perintah di antrian, iterasi loop() terlama (us), bit limit switch,
+dan jumlah sampel yang dibuang firmware karena jalur Serial penuh.
+
+Penerima menyalakan telemetri, menyimpan setiap sampel sebagai baris CSV, dan (opsional)
+mengirim program G-code sebagai frame biner (binary_protocol.py) sambil merekam. Pengirim
+ASCII gcode_sender.py membaca per baris, jadi tidak dapat dipakai selama telemetri aktif.
+
+Penggunaan:
+  python telemetry.py --port COM3 --interval 0.02 --out rekaman.csv --duration 30
+  python telemetry.py --sim ../arm_sim --program program.gcode --out rekaman.csv
+"""
+import argparse
+import collections
+import csv
+import struct
+import sys
+import time
+
+from binary_protocol import BinarySender, ReplyReader
+from gcode_sender import READY_BANNER, SimPort, load_program
+
+PAYLOAD = struct.Struct("<BI4iBBHBB")
+AXES = ("base", "shoulder", "elbow", "slider")
+
+Sample = collections.namedtuple(
+    "Sample", "seq time_us base shoulder elbow slider planner_blocks queue_used loop_max_us limit_bits dropped")
+
+
+def parse_payload(payload):
+    """Payload frame telemetri -> Sample; None jika panjangnya tidak cocok."""
+    if len(payload) != PAYLOAD.size:
+        return None
+    return Sample(*PAYLOAD.unpack(payload))
+
+
+class TelemetryRecorder:
+    """Tulis sampel ke CSV dan hitung sampel yang hilang (celah nomor sampel)."""
+
+    COLUMNS = ("host_s",) + Sample._fields + ("time_s",)
+
+    def __init__(self, out):
+        self.writer = csv.writer(out)
+        self.writer.writerow(self.COLUMNS)
+        self.start = time.monotonic()
+        self.frames = 0
+        self.lost = 0      # Celah nomor sampel (frame rusak/hilang di jalur atau dibuang firmware)
+        self.dropped = 0   # Dilaporkan firmware
+        self.last_seq = None
+        self.time_base = 0  # Pembukaan wrap micros() 32-bit
+        self.last_time = None
+        self.idle_samples = 0  # Sampel berturut-turut tanpa blok planner dan perintah antrian
+
+    def __call__(self, payload):
+        sample = parse_payload(payload)
+        if sample is None:
+            return
+        if self.last_seq is not None:
+            self.lost += (sample.seq - self.last_seq - 1) & 0xFF
+        self.last_seq = sample.seq
+        if self.last_time is not None and sample.time_us < self.last_time:
+            self.time_base += 1 << 32
+        self.last_time = sample.time_us
+        self.frames += 1
+        self.dropped += sample.dropped
+        self.idle_samples = self.idle_samples + 1 if sample.planner_blocks == 0 and sample.queue_used == 0 else 0
+        time_s = (self.time_base + sample.time_us) / 1e6
+        self.writer.writerow((f"{time.monotonic() - self.start:.4f}",) + tuple(sample) + (f"{time_s:.6f}",))
+
+
+def command_line(port, reader, line, timeout=5.0):
+    """Kirim satu baris ASCII dan tunggu ack-nya."""
+    port.write((line + "\n").encode())
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        reply = reader.read()
+        if isinstance(reply, str) and reply.startswith("OK"):
+            return True
+    return False
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Rekam telemetri firmware ke CSV")
+    target = parser.add_mutually_exclusive_group(required=True)
+    target.add_argument("--port", help="port serial, mis. COM3 atau /dev/ttyACM0")
+    target.add_argument("--sim", help="path arm_sim (simulasi host)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--interval", type=float, default=0.02, help="interval sampel dalam detik (min 0.005)")
+    parser.add_argument("--out", required=True, help="file CSV keluaran")
+    parser.add_argument("--program", help="kirim program G-code (frame biner) sambil merekam")
+    parser.add_argument("--duration", type=float, help="lama rekaman tanpa program (detik; default sampai Ctrl-C)")
+    parser.add_argument("--no-wait", action="store_true", help="jangan tunggu banner siap setelah koneksi")
+    parser.add_argument("--verbose", action="store_true", help="tampilkan output firmware")
+    args = parser.parse_args()
+
+    if args.sim:
+        port = SimPort(args.sim, timeout=2.0)
+    else:
+        import serial
+        port = serial.Serial(args.port, args.baud, timeout=2.0)
+
+    log = (lambda line: print("<<", line, file=sys.stderr)) if args.verbose else None
+    with open(args.out, "w", newline="") as out:
+        recorder = TelemetryRecorder(out)
+        reader = ReplyReader(port, log, recorder)
+        if not args.no_wait:
+            deadline = time.monotonic() + 120.0
+            while time.monotonic() < deadline:
+                reply = reader.read()
+                if isinstance(reply, str) and READY_BANNER in reply:
+                    break
+            else:
+                print("Firmware tidak mengirim banner siap", file=sys.stderr)
+                return 1
+        if not command_line(port, reader, f"M155 T{args.interval:g}"):
+            print("Firmware tidak menjawab M155", file=sys.stderr)
+            return 1
+
+        try:
+            if args.program:
+                sender = BinarySender(port, log, recorder)
+                stats = sender.stream(load_program(args.program))
+                print(f"{stats['lines']} perintah dalam {stats['seconds']:.2f} s", file=sys.stderr)
+                # Perintah terakhir sudah diterima, tetapi gerakannya belum selesai
+                recorder.idle_samples = 0
+                while recorder.idle_samples < 3:
+                    reader.read()
+            else:
+                deadline = time.monotonic() + args.duration if args.duration else None
+                while deadline is None or time.monotonic() < deadline:
+                    reader.read()
+        except KeyboardInterrupt:
+            pass
+        command_line(port, reader, "M155 T0")
+        port.close()
+
+    elapsed = time.monotonic() - recorder.start
+    print(f"{recorder.frames} sampel dalam {elapsed:.1f} s ({recorder.frames / max(elapsed, 1e-9):.1f}/s), "
+          f"hilang {recorder.lost}, dibuang firmware {recorder.dropped} -> {args.out}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())